@@ -38,8 +38,13 @@
         "src/ab_initio_mass.cpp",
         "src/trefoil_closure_kernels.cpp",
         "src/biot_savart.cpp",
+        "src/biot_savart_treecode.cpp",
+        "src/biot_savart_batch.cpp",
+        "src/biot_savart_pm.cpp",
+        "src/fft.cpp",
         "src/fluid_dynamics.cpp",
         "src/field_kernels.cpp",
+        "src/field_kernels_treecode.cpp",
         "src/frenet_helicity.cpp",
         "src/potential_timefield.cpp",
         "src/magnus_integrator.cpp",
@@ -66,9 +71,16 @@
         "src/filament/evolution.cpp",
         "src/filament/velocity_solver.cpp",
         "src/filament/integrator.cpp",
+        "src/filament/remesh.cpp",
+        "src/filament/trajectory.cpp",
+        "src/filament/ensemble.cpp",
         "src/geometry/periodic_spline.cpp",
+        "src/geometry/segment_octree.cpp",
         "src/geometry/continuous_reach.cpp",
         "src/geometry/polygonal_clearance.cpp",
+        "src/geometry/neighbour_list.cpp",
+        "src/geometry/segment_bvh.cpp",
+        "src/geometry/swept_contact.cpp",
         "src/topology/topology_guard.cpp",
         "src/analysis/intrinsic_frame.cpp",
         "src/analysis/rigid_motion.cpp",
@@ -5,11 +5,46 @@
 
 #include "sst/types.h"
 #include <cstddef>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 namespace sst {
 
+// Velocity model of FilamentEvolution::evolve.
+enum class FilamentVelocityModel {
+    BiotSavart,        // full O(N²) point sum over central-difference tangents (legacy)
+    LocalInduction,    // O(N) local induction approximation only
+    CutoffBiotSavart   // midpoint Biot–Savart over segments within cutoff_arclength + LIA term
+};
+
+enum class FilamentTimeScheme { Euler, RK2, RK4 };
+
+struct FilamentEvolutionOptions {
+    FilamentVelocityModel model = FilamentVelocityModel::BiotSavart;
+    FilamentTimeScheme scheme = FilamentTimeScheme::Euler;
+    // CutoffBiotSavart: segments whose midpoint lies within this arc length of the target.
+    double cutoff_arclength = 1.0;
+    // LIA term of LocalInduction / CutoffBiotSavart (same form as FilamentVelocitySolver):
+    // Γ/(4π) [ln(2 sqrt(l- l+) / a) + lia_constant] κb with a = core_radius.
+    double core_radius = 0.01;
+    double lia_constant = 0.25;
+};
+
+inline FilamentVelocityModel filament_velocity_model_from_name(const std::string& name) {
+    if (name == "biot_savart" || name == "full") return FilamentVelocityModel::BiotSavart;
+    if (name == "lia" || name == "local_induction") return FilamentVelocityModel::LocalInduction;
+    if (name == "cutoff" || name == "cutoff_biot_savart") return FilamentVelocityModel::CutoffBiotSavart;
+    throw std::invalid_argument("unknown filament velocity model: " + name);
+}
+
+inline FilamentTimeScheme filament_time_scheme_from_name(const std::string& name) {
+    if (name == "euler") return FilamentTimeScheme::Euler;
+    if (name == "rk2" || name == "midpoint") return FilamentTimeScheme::RK2;
+    if (name == "rk4") return FilamentTimeScheme::RK4;
+    throw std::invalid_argument("unknown filament time scheme: " + name);
+}
+
 class FilamentEvolution {
 public:
     explicit FilamentEvolution(double gamma = 1.0);
@@ -18,8 +53,17 @@ public:
     static FilamentEvolution make_figure8(std::size_t resolution = 400, double gamma = 1.0);
     static FilamentEvolution make_from_fseries(const std::string& knot_id, std::size_t resolution = 1000, double gamma = 1.0);
 
+    // Advances with options() (default: Euler + full Biot–Savart, the original behaviour).
+    // Stage and velocity buffers are members, so repeated calls do not reallocate.
     void evolve(double dt, std::size_t steps);
 
+    /** Throws std::invalid_argument on a non-positive core radius or negative cutoff. */
+    void set_options(const FilamentEvolutionOptions& options);
+    [[nodiscard]] const FilamentEvolutionOptions& options() const { return options_; }
+
+    // Velocity of every point under options().model for the current positions and tangents.
+    [[nodiscard]] std::vector<Vec3> velocity();
+
     [[nodiscard]] const std::vector<Vec3>& positions() const { return positions_; }
     [[nodiscard]] const std::vector<Vec3>& tangents() const { return tangents_; }
     [[nodiscard]] double circulation() const { return circulation_; }
@@ -31,8 +75,15 @@ private:
     std::vector<Vec3> positions_;
     std::vector<Vec3> tangents_;
     double circulation_;
+    FilamentEvolutionOptions options_;
+    // Scratch reused across steps.
+    std::vector<Vec3> y0_, y_, stage_tangents_, k_, acc_;
+    std::vector<Vec3> dl_, mid_;
+    std::vector<double> len_;
 
     void compute_tangents();
+    static void central_tangents(const std::vector<Vec3>& x, std::vector<Vec3>& out);
+    void velocity_into(const std::vector<Vec3>& x, const std::vector<Vec3>& t, std::vector<Vec3>& out);
     static void init_trefoil(std::vector<Vec3>& out, std::size_t resolution);
     static void init_figure8(std::vector<Vec3>& out, std::size_t resolution);
     static void init_from_fseries(std::vector<Vec3>& out, const std::string& knot_id, std::size_t resolution);
@@ -21,6 +21,7 @@ public:
     void initialize_knot_from_name(const std::string& knot_id, std::size_t resolution = 1000);
 
     void evolve(double dt, std::size_t steps);
+    void set_evolution_options(const FilamentEvolutionOptions& options);
 
     [[nodiscard]] const std::vector<Vec3>& get_positions() const;
     [[nodiscard]] const std::vector<Vec3>& get_tangents() const;
@@ -75,7 +75,8 @@ public:
         int grid_size = 32,
         double spacing = 0.1,
         int interior_margin = 8,
-        int nsamples = 1000);
+        int nsamples = 1000,
+        bool particle_mesh = false);  // P3M velocity (free space) instead of the direct sum
 };
 
 KnotInvariants build_invariants_from_fourier_block(
@@ -9,6 +9,10 @@
 
 namespace sst {
 
+namespace geometry {
+class SegmentBvhAccelerator;
+}
+
 class ResolvedTubeGeometry {
 public:
     [[nodiscard]] static double length(const std::vector<Vec3>& pts);
@@ -26,16 +30,20 @@ public:
         double* s_out = nullptr,
         double* t_out = nullptr);
 
+    // With an accelerator, large curves search candidates through its (refit) slot-0 tree;
+    // the result is the same list either way.
     [[nodiscard]] static std::vector<SegmentPair> dcsd_candidates(
         const std::vector<Vec3>& pts,
         int skip_neighbors = 2,
-        double distance_tol = 0.0);
+        double distance_tol = 0.0,
+        geometry::SegmentBvhAccelerator* accelerator = nullptr);
 
     [[nodiscard]] static ResolvedTubeMetrics analyze(
         const std::vector<Vec3>& pts,
         int skip_neighbors = 2,
         double contact_tol = 1e-3,
-        double equilateral_tol = 1e-3);
+        double equilateral_tol = 1e-3,
+        geometry::SegmentBvhAccelerator* accelerator = nullptr);
 
     [[nodiscard]] static std::vector<double> length_gradient_flat(const std::vector<Vec3>& pts);
     [[nodiscard]] static std::vector<double> strut_gradient_flat(
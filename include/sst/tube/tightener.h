@@ -8,6 +8,11 @@
 
 namespace sst {
 
+namespace geometry {
+class SegmentBvhAccelerator;
+}
+
+// The optional accelerator is handed to every ResolvedTubeGeometry::analyze call.
 class ResolvedTubeTightener {
 public:
     [[nodiscard]] static std::vector<Vec3> rescale_to_thickness(
@@ -15,12 +20,14 @@ public:
         double target_thickness,
         int skip_neighbors = 2,
         double contact_tol = 1e-3,
-        double equilateral_tol = 1e-3);
+        double equilateral_tol = 1e-3,
+        geometry::SegmentBvhAccelerator* accelerator = nullptr);
 
     [[nodiscard]] static std::vector<Vec3> correct_thickness(
         const std::vector<Vec3>& pts,
         double target_thickness,
-        const TighteningOptions& options = TighteningOptions());
+        const TighteningOptions& options = TighteningOptions(),
+        geometry::SegmentBvhAccelerator* accelerator = nullptr);
 
     [[nodiscard]] static std::vector<double> projected_gradient_flat(
         const std::vector<Vec3>& pts,
@@ -28,6 +35,7 @@ public:
         const TighteningOptions& options,
         ContactStressDiagnostics* diagnostics_out = nullptr);
 
+    /** Line-search trials share one segment BVH, refit to each candidate curve. */
     [[nodiscard]] static TighteningResult tighten(
         const std::vector<Vec3>& initial_points,
         const TighteningOptions& options = TighteningOptions());
@@ -142,6 +142,8 @@ struct TighteningResult {
     std::vector<TighteningStepRecord> steps;
     bool converged = false;
     std::string reason;
+    std::size_t bvh_builds = 0;  // segment BVH shared by the analyses: full builds and refits
+    std::size_t bvh_refits = 0;
 };
 
 struct ContactStressDiagnostics {
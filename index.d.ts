@@ -37,6 +37,84 @@ export interface BiotSavartInvariants {
   aMu: number;
 }
 
+export interface BiotSavartFieldOptions {
+  method?: 'direct' | 'treecode';
+  theta?: number;
+  tolerance?: number;
+  leafSize?: number;
+  kernel?: 'midpoint' | 'straight_segment';
+  /** Worker threads over grid tiles (default 1, 0 = all cores); results do not depend on it. */
+  numThreads?: number;
+}
+
+export interface BiotSavartFieldResult {
+  velocity: Float64Array;
+  method: string;
+  kernel: string;
+  errorEstimate: number;
+  directInteractions: number;
+  clusterInteractions: number;
+}
+
+export interface ParticleMeshOptions {
+  /** Treat the grid box as the periodic cell (default: free space). */
+  periodic?: boolean;
+  /** Add the short-range direct correction (default true). */
+  p3m?: boolean;
+  /** Gaussian split width (0 = 1.5 * spacing). */
+  sigma?: number;
+  /** Short-range radius (0 = 5.5 * sigma). */
+  cutoff?: number;
+  /** Worker threads (default 1, 0 = all cores); results do not depend on it. */
+  numThreads?: number;
+}
+
+export interface InteriorFieldOptions {
+  /** 'central' reproduces computeVorticity; 'analytic' sums the exact kernel curl. */
+  vorticity?: 'central' | 'analytic';
+  /** Shell velocity by particle-mesh (central differences only). */
+  particleMesh?: boolean;
+  /** Worker threads (default 1, 0 = all cores); results do not depend on it. */
+  numThreads?: number;
+}
+
+export interface InteriorFieldResult {
+  velocity: Float64Array;
+  vorticity: Float64Array;
+  shape: [number, number, number];
+  vorticityScheme: string;
+}
+
+export interface ParticleMeshResult {
+  velocity: Float64Array;
+  meshShape: [number, number, number];
+  nearInteractions: number;
+}
+
+export interface RemeshOptions {
+  /** Split segments until each turns by at most this angle (kappa * ds, default 0.25). */
+  maxTurningAngle?: number;
+  /** Drop points whose merged segment turns by less than this angle (default 0.05). */
+  minTurningAngle?: number;
+  maxSegmentLength?: number;
+  minSegmentLength?: number;
+  minPoints?: number;
+  maxPoints?: number;
+}
+
+/** Final points of an ensemble run, packed member after member and filament after filament. */
+export interface EnsembleStepResult {
+  /** Flat [x, y, z, ...] over all points of all members. */
+  positions: Float64Array;
+  /** Point offsets (in points) of every filament, plus the total. */
+  filamentOffsets: number[];
+  /** Member m owns filaments memberFilaments[m] .. memberFilaments[m + 1]. */
+  memberFilaments: number[];
+  maximumStageSpeed: number[];
+  /** Members stepped by the lane-batched kernel. */
+  batchedMembers: number;
+}
+
 export interface FrenetFrames {
   T: Float64Array;
   N: Float64Array;
@@ -86,13 +164,56 @@ export interface SSTcoreModule {
     circulation?: number,
   ): Vec3;
   biotSavartVelocityGrid(polyline: Vec3Array, grid: Vec3Array): Float64Array;
+  biotSavartVelocityField?: (
+    polyline: Vec3Array,
+    grid: Vec3Array,
+    circulation?: number,
+    options?: BiotSavartFieldOptions,
+  ) => BiotSavartFieldResult;
+  biotSavartVelocityBatch?: (
+    polylines: Vec3Array[],
+    grid: Vec3Array,
+    circulations?: number[],
+    options?: BiotSavartFieldOptions & { superpose?: boolean },
+  ) => Float64Array[] | Float64Array;
+  biotSavartInvariantsBatch?: (
+    polylines: Vec3Array[],
+    origin: Vec3,
+    spacing: number,
+    shape: [number, number, number],
+    margin: number,
+    circulations?: number[],
+    /** Workers over curves (default 1, 0 = all cores). */
+    numThreads?: number,
+  ) => BiotSavartInvariants[];
+  biotSavartVelocityParticleMesh?: (
+    polyline: Vec3Array,
+    origin: Vec3,
+    spacing: number,
+    shape: [number, number, number],
+    circulation?: number,
+    options?: ParticleMeshOptions,
+  ) => ParticleMeshResult;
+  biotSavartInteriorVelocityVorticity?: (
+    polyline: Vec3Array,
+    origin: Vec3,
+    spacing: number,
+    shape: [number, number, number],
+    margin: number,
+    circulation?: number,
+    options?: InteriorFieldOptions,
+  ) => InteriorFieldResult;
 
   // Field kernels / ops
   dipoleFieldAtPoint?: (...args: any[]) => any;
+  /** Trailing options { isa?, reproducible?, numThreads? } (numThreads default 1, 0 = all cores). */
   biotSavartWireGrid?: (...args: any[]) => any;
   dipoleRingFieldGrid?: (...args: any[]) => any;
+  /** Trailing options { theta?, tolerance?, leafSize?, numThreads? } (numThreads default 1). */
+  dipoleRingFieldGridTreecode?: (...args: any[]) => any;
   biotSavartVectorPotentialGrid?: (...args: any[]) => any;
   fieldKernelsAvailable?: boolean;
+  fieldKernelsIsa?: string;
   curl3dCentral?: (...args: any[]) => any;
   fieldOpsAvailable?: boolean;
 
@@ -207,7 +328,8 @@ export interface SSTcoreModule {
     selfMin: number;
     interMin: number;
   };
-  computeContinuousReach?: (curves: Vec3Array[]) => {
+  /** numThreads: seed-refinement workers (default 1, 0 = all cores); results do not depend on it. */
+  computeContinuousReach?: (curves: Vec3Array[], numThreads?: number) => {
     reach: number;
     limiter: string;
     curvatureRadius: number;
@@ -223,10 +345,98 @@ export interface SSTcoreModule {
     velocity: Vec3[][];
     maximumSpeed: number;
   };
-  rk4Step?: (filaments: any[], dt: number, options?: object) => {
+  rk4Step?: (
+    filaments: any[],
+    dt: number,
+    options?: object,
+    steps?: number,
+    remesh?: RemeshOptions,
+  ) => {
+    filaments: any[];
+    maximumStageSpeed: number;
+    inserted?: number;
+    removed?: number;
+    neighbourBuilds?: number;
+    neighbourPairs?: number;
+  };
+  ensembleRk4Step?: (
+    members: any[][],
+    dt: number,
+    options?: object | object[],
+    steps?: number,
+    /** numThreads: workers over members (default 1, 0 = all cores). */
+    ensemble?: { numThreads?: number; lanes?: number },
+  ) => EnsembleStepResult;
+  remeshFilaments?: (
+    filaments: any[],
+    remesh?: RemeshOptions,
+  ) => {
+    filaments: any[];
+    inserted: number;
+    removed: number;
+    points: number;
+    filamentsChanged: number;
+  };
+  integrateAdaptive?: (
+    filaments: any[],
+    tEnd: number,
+    options?: object,
+    adaptive?: {
+      scheme?: 'dopri5' | 'bs32';
+      rtol?: number;
+      atol?: number;
+      dtInitial?: number;
+      cfl?: number;
+      dtMin?: number;
+      dtMax?: number;
+      safety?: number;
+      minShrink?: number;
+      maxGrowth?: number;
+      maxSteps?: number;
+    },
+    t0?: number,
+  ) => {
+    filaments: any[];
+    time: number;
+    completed: boolean;
+    acceptedSteps: number;
+    rejectedSteps: number;
+    velocityEvaluations: number;
+    lastErrorNorm: number;
+    maxErrorNorm: number;
+    nextDt: number;
+    maximumStageSpeed: number;
+  };
+  multirateStep?: (
+    filaments: any[],
+    dt: number,
+    options?: object,
+    multirate?: { cfl?: number; liaStability?: number; maxLevel?: number },
+    steps?: number,
+  ) => {
+    filaments: any[];
+    substeps: number[];
+    velocityEvaluations: number;
+    targetEvaluations: number;
+    maximumStageSpeed: number;
+  };
+  imexStep?: (
+    filaments: any[],
+    dt: number,
+    options?: object,
+    imex?: { scheme?: 'midpoint' | 'euler'; theta?: number },
+    steps?: number,
+  ) => {
     filaments: any[];
+    /** Explicit (non-local) speed: the one that bounds dt. */
+    maximumMutualSpeed: number;
     maximumStageSpeed: number;
   };
+  estimateFilamentDt?: (
+    filaments: any[],
+    options?: object,
+    multirate?: { cfl?: number; liaStability?: number; maxLevel?: number },
+  ) => number[];
   estimateCflDt?: (filaments: any[], options?: object, cfl?: number) => number;
   guardTopologyStep?: (
     before: Vec3Array[],
@@ -237,6 +447,9 @@ export interface SSTcoreModule {
   ) => {
     contact: boolean;
     safeDtFraction: number;
+    sweptPairs: number;
+    /** [componentA, segmentA, componentB, segmentB] of the first contact; -1s without one. */
+    hitPair: [number, number, number, number];
     message: string;
   };
   computeIntrinsicFrame?: (points: Vec3Array, weights?: number[]) => {
@@ -252,6 +465,48 @@ export interface SSTcoreModule {
     omega: Vec3;
     reconstructionRelativeError: number;
   };
+  /** Append-only .ssttraj writer: new (path, diagnosticNames?, { append?, flushEvery? }). */
+  FilamentTrajectoryWriter?: new (
+    path: string,
+    diagnosticNames?: string[],
+    options?: { append?: boolean; flushEvery?: number },
+  ) => {
+    append(
+      filaments: any[],
+      time: number,
+      step: number,
+      channels?: { velocity?: Vec3Array[]; diagnostics?: number[] },
+    ): void;
+    flush(): void;
+    close(): void;
+    frameCount(): number;
+  };
+  /** Memory-mapped .ssttraj reader; refresh() indexes frames appended since opening. */
+  FilamentTrajectoryReader?: new (path: string) => {
+    frameCount(): number;
+    diagnosticNames(): string[];
+    frame(index: number): {
+      step: number;
+      time: number;
+      filaments: any[];
+      diagnostics: Record<string, number>;
+      velocity?: number[][][];
+    };
+    refresh(): number;
+  };
+  saveFilamentCheckpoint?: (
+    path: string,
+    filaments: any[],
+    time: number,
+    step?: number,
+    values?: Record<string, number>,
+  ) => void;
+  loadFilamentCheckpoint?: (path: string) => {
+    filaments: any[];
+    time: number;
+    step: number;
+    values: Record<string, number>;
+  };
 
   [key: string]: any;
 }
@@ -413,6 +413,13 @@ class CustomBuildExt(build_ext):
                 # Suppress some warnings that might cause issues
                 if '-Wno-deprecated-declarations' not in ext.extra_compile_args:
                     ext.extra_compile_args.append('-Wno-deprecated-declarations')
+                # std::thread workers in the tiled grid kernels
+                if '-pthread' not in ext.extra_compile_args:
+                    ext.extra_compile_args.append('-pthread')
+                if not hasattr(ext, 'extra_link_args') or ext.extra_link_args is None:
+                    ext.extra_link_args = []
+                if '-pthread' not in ext.extra_link_args:
+                    ext.extra_link_args.append('-pthread')
         
         # Windows: huge generated TUs; /GL raises compile memory — disable; keep bigobj + heap
         if sys.platform == "win32":
@@ -913,8 +920,13 @@ src_files = [
     "src/clock_field_eft.cpp",
     "src/trefoil_closure_kernels.cpp",
     "src/biot_savart.cpp",
+    "src/biot_savart_treecode.cpp",
+    "src/biot_savart_batch.cpp",
+    "src/biot_savart_pm.cpp",
+    "src/fft.cpp",
     "src/fluid_dynamics.cpp",
     "src/field_kernels.cpp",
+    "src/field_kernels_treecode.cpp",
     "src/frenet_helicity.cpp",
     "src/potential_timefield.cpp",
     "src/magnus_integrator.cpp",
@@ -934,9 +946,16 @@ src_files = [
     "src/filament/evolution.cpp",
     "src/filament/velocity_solver.cpp",
     "src/filament/integrator.cpp",
+    "src/filament/remesh.cpp",
+    "src/filament/trajectory.cpp",
+    "src/filament/ensemble.cpp",
     "src/geometry/periodic_spline.cpp",
+    "src/geometry/segment_octree.cpp",
     "src/geometry/continuous_reach.cpp",
     "src/geometry/polygonal_clearance.cpp",
+    "src/geometry/neighbour_list.cpp",
+    "src/geometry/segment_bvh.cpp",
+    "src/geometry/swept_contact.cpp",
     "src/topology/topology_guard.cpp",
     "src/analysis/intrinsic_frame.cpp",
     "src/analysis/rigid_motion.cpp",
@@ -134,11 +134,16 @@ namespace sst {
         double k_repulsion = 0.5;
         double repulsion_radius = 0.2;
         double damping = 0.70;
+        double repulsion_skin = 0.1;    // Verlet skin: the pair list survives 0.05 of motion
 
         std::vector<std::vector<Vec3>> velocities(filaments.size());
+        std::vector<size_t> offsets(filaments.size() + 1, 0);
         for (size_t f = 0; f < filaments.size(); ++f) {
             velocities[f].resize(filaments[f].size(), {0.0, 0.0, 0.0});
+            offsets[f + 1] = offsets[f] + filaments[f].size();
         }
+        std::vector<Vec3> flat(offsets.back());
+        repulsion_list_.set_radius(repulsion_radius, repulsion_skin);
 
         auto start_time = std::chrono::high_resolution_clock::now();
 
@@ -159,6 +164,10 @@ namespace sst {
             std::vector<std::vector<Vec3>> forces = velocities; // init met 0
             for (auto& row : forces) std::fill(row.begin(), row.end(), Vec3{0,0,0});
 
+            for (size_t f = 0; f < filaments.size(); ++f)
+                std::copy(filaments[f].begin(), filaments[f].end(), flat.begin() + offsets[f]);
+            repulsion_list_.update(flat.data(), flat.size(), flat.data(), flat.size());
+
             #pragma omp parallel for
             for (int f = 0; f < (int)filaments.size(); ++f) {
                 int N = filaments[f].size();
@@ -177,24 +186,27 @@ namespace sst {
                     forces[f][i][1] += k_pressure * (global_centroid[1] - pt[1]);
                     forces[f][i][2] += k_pressure * (global_centroid[2] - pt[2]);
 
-                    // Afstoting: tegen ELK punt in ELKE draad (inter- én intra-filament Pauli uitsluiting)
-                    for (size_t f_other = 0; f_other < filaments.size(); ++f_other) {
-                        for (size_t j = 0; j < filaments[f_other].size(); ++j) {
-                            if (f == f_other && (i == (int)j || (int)j == prev || (int)j == next)) continue;
-
-                            double dx = pt[0] - filaments[f_other][j][0];
-                            double dy = pt[1] - filaments[f_other][j][1];
-                            double dz = pt[2] - filaments[f_other][j][2];
-                            double dist_sq = dx*dx + dy*dy + dz*dz;
-
-                            if (dist_sq < repulsion_radius * repulsion_radius && dist_sq > 1e-8) {
-                                double dist = std::sqrt(dist_sq);
-                                double rep = k_repulsion * (1.0 / (dist_sq * dist_sq));
-                                if (rep > 200.0) rep = 200.0;
-                                forces[f][i][0] += rep * (dx / dist);
-                                forces[f][i][1] += rep * (dy / dist);
-                                forces[f][i][2] += rep * (dz / dist);
-                            }
+                    // Afstoting: tegen ELK punt in ELKE draad (inter- én intra-filament Pauli uitsluiting).
+                    // Only listed neighbours can be within the radius; they come in (f_other, j) order.
+                    size_t f_other = 0;
+                    const size_t g = offsets[f] + i;
+                    for (const size_t* it = repulsion_list_.begin(g); it != repulsion_list_.end(g); ++it) {
+                        while (*it >= offsets[f_other + 1]) ++f_other;
+                        const size_t j = *it - offsets[f_other];
+                        if (f == (int)f_other && (i == (int)j || (int)j == prev || (int)j == next)) continue;
+
+                        double dx = pt[0] - flat[*it][0];
+                        double dy = pt[1] - flat[*it][1];
+                        double dz = pt[2] - flat[*it][2];
+                        double dist_sq = dx*dx + dy*dy + dz*dz;
+
+                        if (dist_sq < repulsion_radius * repulsion_radius && dist_sq > 1e-8) {
+                            double dist = std::sqrt(dist_sq);
+                            double rep = k_repulsion * (1.0 / (dist_sq * dist_sq));
+                            if (rep > 200.0) rep = 200.0;
+                            forces[f][i][0] += rep * (dx / dist);
+                            forces[f][i][1] += rep * (dy / dist);
+                            forces[f][i][2] += rep * (dz / dist);
                         }
                     }
                 }
@@ -7,6 +7,7 @@
 
 #pragma once
 #include "sst/types.h"
+#include "geometry/neighbour_list.h"
 #include "../include/SST_Constants.h"
 #include <cmath>
 #include <cstddef>
@@ -41,6 +42,8 @@ public:
   explicit ParticleEvaluator(const std::vector<std::vector<Vec3>>& input_filaments);
 
   void relax_hamiltonian(int iterations, double timestep, std::function<void()> interrupt_callback = nullptr);
+  // Rebuilds / size of the neighbour list behind the relaxation's short-range repulsion.
+  const geometry::NeighbourListStats& repulsion_neighbour_stats() const { return repulsion_list_.stats(); }
 
   // Existing API
   double get_dimless_ropelength(double stretch_lambda = 1.0) const;
@@ -96,6 +99,8 @@ public:
 
 private:
   TailApproxConfig tail_cfg_{};
+  // Point pairs within the repulsion radius, kept across relaxation iterations and calls.
+  geometry::VerletNeighbourList repulsion_list_;
 
   // Vector helpers for Biot–Savart surrogate
   static Vec3 v_add(const Vec3& a, const Vec3& b);
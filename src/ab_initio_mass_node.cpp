@@ -64,6 +64,7 @@ private:
     Napi::Value ComputeTailEnergySurrogateJ(const Napi::CallbackInfo& info);
     Napi::Value ComputeRelativisticMetrics(const Napi::CallbackInfo& info);
     Napi::Value GetFilaments(const Napi::CallbackInfo& info);
+    Napi::Value GetRepulsionNeighbourStats(const Napi::CallbackInfo& info);
 };
 
 class ZooEvaluatorWrap : public Napi::ObjectWrap<ZooEvaluatorWrap> {
@@ -121,6 +122,7 @@ Napi::Object ParticleEvaluatorWrap::Init(Napi::Env env, Napi::Object exports) {
         InstanceMethod("computeTailEnergySurrogateJ", &ParticleEvaluatorWrap::ComputeTailEnergySurrogateJ),
         InstanceMethod("computeRelativisticMetrics", &ParticleEvaluatorWrap::ComputeRelativisticMetrics),
         InstanceMethod("getFilaments", &ParticleEvaluatorWrap::GetFilaments),
+        InstanceMethod("getRepulsionNeighbourStats", &ParticleEvaluatorWrap::GetRepulsionNeighbourStats),
     });
     exports.Set("ParticleEvaluator", func);
     return exports;
@@ -163,6 +165,16 @@ Napi::Value ParticleEvaluatorWrap::Relax(const Napi::CallbackInfo& info) {
     return info.Env().Undefined();
 }
 
+Napi::Value ParticleEvaluatorWrap::GetRepulsionNeighbourStats(const Napi::CallbackInfo& info) {
+    const auto& st = pe_->repulsion_neighbour_stats();
+    Napi::Object o = Napi::Object::New(info.Env());
+    o.Set("updates", static_cast<double>(st.updates));
+    o.Set("builds", static_cast<double>(st.builds));
+    o.Set("pairs", static_cast<double>(st.pairs));
+    o.Set("maxNeighbours", static_cast<double>(st.max_neighbours));
+    return o;
+}
+
 Napi::Value ParticleEvaluatorWrap::GetDimlessRopelength(const Napi::CallbackInfo& info) {
     const double lam = (info.Length() >= 1) ? info[0].As<Napi::Number>().DoubleValue() : 1.0;
     return Napi::Number::New(info.Env(), pe_->get_dimless_ropelength(lam));
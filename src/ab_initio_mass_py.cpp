@@ -40,6 +40,11 @@ void bind_ab_initio(py::module_& m) {
                 }
             });
         }, py::arg("iterations") = 1000, py::arg("timestep") = 0.01)
+        .def("repulsion_neighbour_stats", [](const ParticleEvaluator& self) {
+            const auto& st = self.repulsion_neighbour_stats();
+            return py::dict(py::arg("updates") = st.updates, py::arg("builds") = st.builds,
+                            py::arg("pairs") = st.pairs, py::arg("max_neighbours") = st.max_neighbours);
+        }, "Verlet list behind relax()'s repulsion: update / rebuild counts and current pair total.")
 
         // Expose the stretch_lambda parameter to Python
         .def("get_dimless_ropelength", &ParticleEvaluator::get_dimless_ropelength, py::arg("stretch_lambda") = 1.0)
@@ -1,10 +1,17 @@
 #include "biot_savart.h"
+#include "parallel_for.h"
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <stdexcept>
 
 namespace sst {
 
+    namespace {
+      // Below this many segment-point pairs a tile loop is cheaper than starting workers.
+      constexpr size_t kMinParallelPairs = size_t{1} << 16;
+    }
+
     std::vector<Vec3> BiotSavart::computeVelocity(
         const std::vector<Vec3>& curve,
         const std::vector<Vec3>& grid_points
@@ -17,6 +24,15 @@ namespace sst {
         const std::vector<Vec3>& curve,
         const std::vector<Vec3>& grid_points,
         double Gamma
+    ) {
+      return directVelocity(curve, grid_points, Gamma, BiotSavartOptions{});
+    }
+
+    std::vector<Vec3> BiotSavart::directVelocity(
+        const std::vector<Vec3>& curve,
+        const std::vector<Vec3>& grid_points,
+        double Gamma,
+        const BiotSavartOptions& options
     ) {
       std::vector<Vec3> vel(grid_points.size(), {0.0, 0.0, 0.0});
 
@@ -25,34 +41,66 @@ namespace sst {
       }
 
       const size_t N = curve.size();
+      const size_t G = grid_points.size();
       const double factor = Gamma / (4.0 * M_PI);
 
+      std::vector<Vec3> mids(N), dls(N);
       for (size_t i = 0; i < N; ++i) {
         const Vec3& r0 = curve[i];
         const Vec3& r1 = curve[(i + 1) % N];
-        Vec3 dl = { r1[0] - r0[0], r1[1] - r0[1], r1[2] - r0[2] };
-        Vec3 mid = { 0.5*(r0[0] + r1[0]), 0.5*(r0[1] + r1[1]), 0.5*(r0[2] + r1[2]) };
-
-        for (size_t g = 0; g < grid_points.size(); ++g) {
-          Vec3 R = { grid_points[g][0] - mid[0],
-                    grid_points[g][1] - mid[1],
-                    grid_points[g][2] - mid[2] };
-
-          double normR = std::pow(R[0]*R[0] + R[1]*R[1] + R[2]*R[2], 1.5) + 1e-12;
-          Vec3 cross = {
-              dl[1]*R[2] - dl[2]*R[1],
-              dl[2]*R[0] - dl[0]*R[2],
-              dl[0]*R[1] - dl[1]*R[0]
-          };
-          vel[g][0] += cross[0] / normR;
-          vel[g][1] += cross[1] / normR;
-          vel[g][2] += cross[2] / normR;
-        }
+        dls[i] = { r1[0] - r0[0], r1[1] - r0[1], r1[2] - r0[2] };
+        mids[i] = { 0.5*(r0[0] + r1[0]), 0.5*(r0[1] + r1[1]), 0.5*(r0[2] + r1[2]) };
       }
 
-      for (auto& v : vel) {
-        v[0] *= factor; v[1] *= factor; v[2] *= factor;
-      }
+      // Grid tiles stay resident in L1 while a segment block (L2) streams past them; each point
+      // still accumulates segments 0..N-1 in order, exactly as the historical segment-outer loop.
+      const size_t grid_tile = std::max<size_t>(1, options.grid_tile);
+      const size_t segment_tile = std::max<size_t>(1, options.segment_tile);
+      const size_t n_tiles = (G + grid_tile - 1) / grid_tile;
+      const size_t threads = N * G < kMinParallelPairs ? 1 : options.num_threads;
+
+      const bool exact = options.kernel == geometry::SegmentKernel::StraightSegment;
+
+      parallel_for(n_tiles, threads, [&](size_t t) {
+        const size_t g0 = t * grid_tile;
+        const size_t g1 = std::min(G, g0 + grid_tile);
+        for (size_t s0 = 0; s0 < N; s0 += segment_tile) {
+          const size_t s1 = std::min(N, s0 + segment_tile);
+          for (size_t g = g0; g < g1; ++g) {
+            const Vec3& x = grid_points[g];
+            Vec3 v = vel[g];
+            if (exact) {
+              for (size_t i = s0; i < s1; ++i) {
+                const Vec3 u = geometry::straight_segment_velocity(x, curve[i], curve[i + 1 == N ? 0 : i + 1]);
+                v[0] += u[0];
+                v[1] += u[1];
+                v[2] += u[2];
+              }
+              vel[g] = v;
+              continue;
+            }
+            for (size_t i = s0; i < s1; ++i) {
+              const Vec3& mid = mids[i];
+              const Vec3& dl = dls[i];
+              Vec3 R = { x[0] - mid[0], x[1] - mid[1], x[2] - mid[2] };
+
+              double normR = std::pow(R[0]*R[0] + R[1]*R[1] + R[2]*R[2], 1.5) + 1e-12;
+              Vec3 cross = {
+                  dl[1]*R[2] - dl[2]*R[1],
+                  dl[2]*R[0] - dl[0]*R[2],
+                  dl[0]*R[1] - dl[1]*R[0]
+              };
+              v[0] += cross[0] / normR;
+              v[1] += cross[1] / normR;
+              v[2] += cross[2] / normR;
+            }
+            vel[g] = v;
+          }
+        }
+        for (size_t g = g0; g < g1; ++g) {
+          vel[g][0] *= factor; vel[g][1] *= factor; vel[g][2] *= factor;
+        }
+      });
       return vel;
     }
 
@@ -106,6 +154,150 @@ namespace sst {
       return sub;
     }
 
+    InteriorFieldResult BiotSavart::computeInteriorVelocityVorticity(
+        const std::vector<Vec3>& curve,
+        const RegularGrid3D& grid,
+        int margin,
+        double Gamma,
+        const InteriorFieldOptions& options
+    ) {
+      if (grid.shape[0] <= 0 || grid.shape[1] <= 0 || grid.shape[2] <= 0) {
+        throw std::invalid_argument("computeInteriorVelocityVorticity: grid shape must be positive");
+      }
+      if (!(grid.spacing > 0.0)) {
+        throw std::invalid_argument("computeInteriorVelocityVorticity: grid spacing must be > 0");
+      }
+      if (margin < 0 || 2 * margin >= std::min({grid.shape[0], grid.shape[1], grid.shape[2]})) {
+        throw std::invalid_argument("computeInteriorVelocityVorticity: margin leaves no interior nodes");
+      }
+      const bool analytic = options.vorticity == VorticityScheme::Analytic;
+      if (analytic && options.particle_mesh) {
+        throw std::invalid_argument("computeInteriorVelocityVorticity: analytic vorticity requires the direct sum");
+      }
+
+      InteriorFieldResult out;
+      const double h = grid.spacing;
+      for (int a = 0; a < 3; ++a) out.shape[a] = grid.shape[a] - 2 * margin;
+      const int ni = out.shape[0], nj = out.shape[1], nk = out.shape[2];
+      const size_t n_out = static_cast<size_t>(ni) * nj * nk;
+
+      if (!analytic) {
+        // Velocity on the nodes the stencil reads: interior plus one node (the whole grid for
+        // margin 0, where computeVorticity wraps periodically).
+        const int pad = margin > 0 ? 1 : 0;
+        RegularGrid3D sub = grid;
+        for (int a = 0; a < 3; ++a) {
+          sub.origin[a] = grid.origin[a] + h * (margin - pad);
+          sub.shape[a] = out.shape[a] + 2 * pad;
+        }
+        std::vector<Vec3> vel;
+        if (options.particle_mesh) {
+          ParticleMeshOptions pm;
+          pm.num_threads = options.num_threads;
+          vel = computeVelocityParticleMesh(curve, sub, Gamma, pm).velocity;
+        } else {
+          std::vector<Vec3> points;
+          points.reserve(static_cast<size_t>(sub.shape[0]) * sub.shape[1] * sub.shape[2]);
+          for (int i = margin - pad; i < grid.shape[0] - margin + pad; ++i) {
+            for (int j = margin - pad; j < grid.shape[1] - margin + pad; ++j) {
+              for (int k = margin - pad; k < grid.shape[2] - margin + pad; ++k) {
+                points.push_back({grid.origin[0] + h * i, grid.origin[1] + h * j, grid.origin[2] + h * k});
+              }
+            }
+          }
+          BiotSavartOptions direct;
+          direct.num_threads = options.num_threads;
+          vel = directVelocity(curve, points, Gamma, direct);
+        }
+        if (pad == 0) {
+          out.vorticity = computeVorticity(vel, sub.shape, h);
+          out.velocity = std::move(vel);
+          return out;
+        }
+
+        const int sy = sub.shape[1], sz = sub.shape[2];
+        auto idx = [&](int i, int j, int k) { return (static_cast<size_t>(i) * sy + j) * sz + k; };
+        out.velocity.reserve(n_out);
+        out.vorticity.reserve(n_out);
+        for (int i = 1; i <= ni; ++i) {
+          for (int j = 1; j <= nj; ++j) {
+            for (int k = 1; k <= nk; ++k) {
+              const Vec3& vx_ip = vel[idx(i+1,j,k)];
+              const Vec3& vx_im = vel[idx(i-1,j,k)];
+              const Vec3& vy_ip = vel[idx(i,j+1,k)];
+              const Vec3& vy_im = vel[idx(i,j-1,k)];
+              const Vec3& vz_ip = vel[idx(i,j,k+1)];
+              const Vec3& vz_im = vel[idx(i,j,k-1)];
+
+              double curl_x = (vz_ip[1] - vz_im[1])/(2*h) - (vy_ip[2] - vy_im[2])/(2*h);
+              double curl_y = (vx_ip[2] - vx_im[2])/(2*h) - (vz_ip[0] - vz_im[0])/(2*h);
+              double curl_z = (vy_ip[0] - vy_im[0])/(2*h) - (vx_ip[1] - vx_im[1])/(2*h);
+
+              out.velocity.push_back(vel[idx(i,j,k)]);
+              out.vorticity.push_back({curl_x, curl_y, curl_z});
+            }
+          }
+        }
+        return out;
+      }
+
+      // Analytic curl of dl x R g(r), g = 1/(r^3 + 1e-12) (the direct kernel, regulariser included):
+      //   curl = dl (2g - 3 r^3 g^2) + 3 r g^2 (dl . R) R.
+      // Velocity accumulates exactly as directVelocity, so it matches computeVelocity bit for bit.
+      out.velocity.assign(n_out, {0.0, 0.0, 0.0});
+      out.vorticity.assign(n_out, {0.0, 0.0, 0.0});
+      const size_t N = curve.size();
+      if (N < 2) {
+        return out;
+      }
+      const double factor = Gamma / (4.0 * M_PI);
+      std::vector<Vec3> mids(N), dls(N);
+      for (size_t s = 0; s < N; ++s) {
+        const Vec3& r0 = curve[s];
+        const Vec3& r1 = curve[(s + 1) % N];
+        dls[s] = { r1[0] - r0[0], r1[1] - r0[1], r1[2] - r0[2] };
+        mids[s] = { 0.5*(r0[0] + r1[0]), 0.5*(r0[1] + r1[1]), 0.5*(r0[2] + r1[2]) };
+      }
+      const size_t threads = N * n_out < kMinParallelPairs ? 1 : options.num_threads;
+      parallel_for(static_cast<size_t>(ni), threads, [&](size_t i) {
+        for (int j = 0; j < nj; ++j) {
+          for (int k = 0; k < nk; ++k) {
+            const Vec3 x = {grid.origin[0] + h * (static_cast<int>(i) + margin),
+                            grid.origin[1] + h * (j + margin),
+                            grid.origin[2] + h * (k + margin)};
+            Vec3 v{0.0, 0.0, 0.0}, w{0.0, 0.0, 0.0};
+            for (size_t s = 0; s < N; ++s) {
+              const Vec3& mid = mids[s];
+              const Vec3& dl = dls[s];
+              Vec3 R = { x[0] - mid[0], x[1] - mid[1], x[2] - mid[2] };
+              const double r2 = R[0]*R[0] + R[1]*R[1] + R[2]*R[2];
+              const double r3 = std::pow(r2, 1.5);
+              double normR = r3 + 1e-12;
+              Vec3 cross = {
+                  dl[1]*R[2] - dl[2]*R[1],
+                  dl[2]*R[0] - dl[0]*R[2],
+                  dl[0]*R[1] - dl[1]*R[0]
+              };
+              v[0] += cross[0] / normR;
+              v[1] += cross[1] / normR;
+              v[2] += cross[2] / normR;
+
+              const double g = 1.0 / normR;
+              const double a = 2.0 * g - 3.0 * r3 * g * g;
+              const double b = 3.0 * std::sqrt(r2) * g * g * (dl[0]*R[0] + dl[1]*R[1] + dl[2]*R[2]);
+              w[0] += a * dl[0] + b * R[0];
+              w[1] += a * dl[1] + b * R[1];
+              w[2] += a * dl[2] + b * R[2];
+            }
+            const size_t o = (i * nj + j) * nk + k;
+            out.velocity[o] = {v[0] * factor, v[1] * factor, v[2] * factor};
+            out.vorticity[o] = {w[0] * factor, w[1] * factor, w[2] * factor};
+          }
+        }
+      });
+      return out;
+    }
+
     std::tuple<double,double,double> BiotSavart::computeInvariants(
         const std::vector<Vec3>& v_sub,
         const std::vector<Vec3>& w_sub,
@@ -160,69 +352,170 @@ namespace sst {
         return v;
     }
 
+    namespace {
+      // Fixed task decomposition (independent of the worker count) for the pair scans.
+      constexpr std::size_t kEnergyScanTasks = 64;
+
+      inline double cutoff_pair_weight(const double* p, const double* t, const double* ds,
+                                       std::size_t i, std::size_t j, double& dist) {
+        const double rx = p[j * 3 + 0] - p[i * 3 + 0];
+        const double ry = p[j * 3 + 1] - p[i * 3 + 1];
+        const double rz = p[j * 3 + 2] - p[i * 3 + 2];
+        const double dist2 = rx * rx + ry * ry + rz * rz;
+        if (!(dist2 > 0.0)) {
+          dist = 0.0;
+          return 0.0;
+        }
+        dist = std::sqrt(dist2);
+        const double dot_tt = t[i * 3 + 0] * t[j * 3 + 0] + t[i * 3 + 1] * t[j * 3 + 1] + t[i * 3 + 2] * t[j * 3 + 2];
+        return (dot_tt / dist) * ds[i] * ds[j];
+      }
+    }
+
     std::vector<double> bs_cutoff_energy_scan(
         const double* p,
         const double* t,
         const double* ds,
         std::size_t n,
         const double* a_values,
-        std::size_t m)
+        std::size_t m,
+        std::size_t num_threads)
     {
-        std::vector<double> cutoffs(m);
-        for (std::size_t k = 0; k < m; ++k) {
-            cutoffs[k] = a_values[k];
-        }
-
-        std::vector<double> diff(m + 1, 0.0);
+      // E(a_k) = T - N(a_k): T sums every pair once (i < j, doubled at the end) and N(a_k) the
+      // pairs with dist <= a_k. Only pairs within a_max = a_{m-1} need the cutoff histogram; a
+      // cell list of size a_max finds them, every other pair just adds to T.
+      std::vector<double> out(m, 0.0);
+      if (m == 0 || n < 2) {
+        return out;
+      }
+      const std::vector<double> cutoffs(a_values, a_values + m);
+      const double a_max = cutoffs.back();
 
+      // Cell list over the points (cells of side >= a_max, at most ~4n of them).
+      double lo[3], hi[3];
+      for (int c = 0; c < 3; ++c) {
+        lo[c] = hi[c] = p[c];
+      }
+      for (std::size_t i = 1; i < n; ++i) {
+        for (int c = 0; c < 3; ++c) {
+          lo[c] = std::min(lo[c], p[i * 3 + c]);
+          hi[c] = std::max(hi[c], p[i * 3 + c]);
+        }
+      }
+      double h = a_max > 0.0 ? a_max : 0.0;
+      std::size_t dims[3] = {1, 1, 1};
+      if (h > 0.0) {
+        for (;;) {
+          double cells = 1.0;
+          for (int c = 0; c < 3; ++c) {
+            cells *= std::floor((hi[c] - lo[c]) / h) + 1.0;
+          }
+          if (cells <= 4.0 * static_cast<double>(n) + 64.0) break;
+          h *= 2.0;
+        }
+        for (int c = 0; c < 3; ++c) {
+          dims[c] = static_cast<std::size_t>(std::floor((hi[c] - lo[c]) / h)) + 1;
+        }
+      }
+      // With at most two cells per axis every pair is a neighbour pair: bin in the total pass.
+      const bool bin_all = h > 0.0 && dims[0] <= 2 && dims[1] <= 2 && dims[2] <= 2;
+
+      // Pass 1: T over i < j (rows split into equal-work triangular blocks); optionally binned.
+      const std::size_t tasks = std::min(kEnergyScanTasks, n);
+      std::vector<std::size_t> row_begin(tasks + 1, n);
+      {
+        const double total = 0.5 * static_cast<double>(n) * static_cast<double>(n - 1);
+        std::size_t task = 0;
+        double done = 0.0;
+        row_begin[0] = 0;
+        for (std::size_t i = 0; i < n && task + 1 < tasks; ++i) {
+          done += static_cast<double>(n - 1 - i);
+          if (done >= total * static_cast<double>(task + 1) / static_cast<double>(tasks)) {
+            row_begin[++task] = i + 1;
+          }
+        }
+      }
+      std::vector<double> task_total(tasks, 0.0);
+      std::vector<std::vector<double>> task_diff(tasks);
+      parallel_for(tasks, num_threads, [&](std::size_t task) {
+        double sum = 0.0;
+        if (bin_all) task_diff[task].assign(m + 1, 0.0);
+        for (std::size_t i = row_begin[task]; i < row_begin[task + 1]; ++i) {
+          for (std::size_t j = i + 1; j < n; ++j) {
+            double dist = 0.0;
+            const double q = cutoff_pair_weight(p, t, ds, i, j, dist);
+            if (!(dist > 0.0)) continue;
+            sum += q;
+            if (bin_all && dist <= a_max) {
+              const auto it = std::lower_bound(cutoffs.begin(), cutoffs.end(), dist);
+              task_diff[task][static_cast<std::size_t>(it - cutoffs.begin())] -= q;
+            }
+          }
+        }
+        task_total[task] = sum;
+      });
+
+      // Pass 2: near pairs from the 27 neighbouring cells of each point.
+      if (!bin_all && h > 0.0) {
+        auto cell_coord = [&](std::size_t i, int c) {
+          const std::size_t k = static_cast<std::size_t>(std::floor((p[i * 3 + c] - lo[c]) / h));
+          return std::min(k, dims[c] - 1);
+        };
+        auto cell_of = [&](std::size_t cx, std::size_t cy, std::size_t cz) {
+          return (cx * dims[1] + cy) * dims[2] + cz;
+        };
+        const std::size_t n_cells = dims[0] * dims[1] * dims[2];
+        std::vector<std::size_t> cell(n), cell_start(n_cells + 1, 0), sorted(n);
         for (std::size_t i = 0; i < n; ++i) {
-            const double pix = p[i * 3 + 0];
-            const double piy = p[i * 3 + 1];
-            const double piz = p[i * 3 + 2];
-
-            const double tix = t[i * 3 + 0];
-            const double tiy = t[i * 3 + 1];
-            const double tiz = t[i * 3 + 2];
-
-            const double dsi = ds[i];
-
-            for (std::size_t j = 0; j < n; ++j) {
-                if (i == j) {
-                    continue;
-                }
-
-                const double rx = p[j * 3 + 0] - pix;
-                const double ry = p[j * 3 + 1] - piy;
-                const double rz = p[j * 3 + 2] - piz;
-
-                const double dist2 = rx * rx + ry * ry + rz * rz;
-                if (dist2 <= 0.0) {
-                    continue;
-                }
-
-                const double dist = std::sqrt(dist2);
-                const auto it = std::lower_bound(cutoffs.begin(), cutoffs.end(), dist);
-                const std::size_t k = static_cast<std::size_t>(it - cutoffs.begin());
+          cell[i] = cell_of(cell_coord(i, 0), cell_coord(i, 1), cell_coord(i, 2));
+          ++cell_start[cell[i] + 1];
+        }
+        for (std::size_t c = 0; c < n_cells; ++c) cell_start[c + 1] += cell_start[c];
+        {
+          std::vector<std::size_t> fill(cell_start.begin(), cell_start.end() - 1);
+          for (std::size_t i = 0; i < n; ++i) sorted[fill[cell[i]]++] = i;
+        }
 
-                if (k == 0) {
-                    continue;
+        parallel_for(tasks, num_threads, [&](std::size_t task) {
+          std::vector<double>& diff = task_diff[task];
+          diff.assign(m + 1, 0.0);
+          const std::size_t k0 = n * task / tasks;
+          const std::size_t k1 = n * (task + 1) / tasks;
+          for (std::size_t k = k0; k < k1; ++k) {
+            const std::size_t i = sorted[k];
+            const std::size_t cx = cell_coord(i, 0), cy = cell_coord(i, 1), cz = cell_coord(i, 2);
+            for (std::size_t x = (cx > 0 ? cx - 1 : 0); x <= std::min(cx + 1, dims[0] - 1); ++x)
+              for (std::size_t y = (cy > 0 ? cy - 1 : 0); y <= std::min(cy + 1, dims[1] - 1); ++y)
+                for (std::size_t z = (cz > 0 ? cz - 1 : 0); z <= std::min(cz + 1, dims[2] - 1); ++z) {
+                  const std::size_t c = cell_of(x, y, z);
+                  for (std::size_t s = cell_start[c]; s < cell_start[c + 1]; ++s) {
+                    const std::size_t j = sorted[s];
+                    if (j <= i) continue;
+                    double dist = 0.0;
+                    const double q = cutoff_pair_weight(p, t, ds, i, j, dist);
+                    if (!(dist > 0.0) || dist > a_max) continue;
+                    const auto it = std::lower_bound(cutoffs.begin(), cutoffs.end(), dist);
+                    diff[static_cast<std::size_t>(it - cutoffs.begin())] -= q;
+                  }
                 }
+          }
+        });
+      }
 
-                const double dot_tt = tix * t[j * 3 + 0] + tiy * t[j * 3 + 1] + tiz * t[j * 3 + 2];
-                const double q = (dot_tt / dist) * dsi * ds[j];
-
-                diff[0] += q;
-                diff[k] -= q;
-            }
-        }
-
-        std::vector<double> out(m);
-        double running = 0.0;
-        for (std::size_t k = 0; k < m; ++k) {
-            running += diff[k];
-            out[k] = running / (8.0 * M_PI);
-        }
-        return out;
+      // Deterministic merge in task order; factor 2 restores the i != j double sum.
+      double total = 0.0;
+      std::vector<double> diff(m + 1, 0.0);
+      for (std::size_t task = 0; task < tasks; ++task) {
+        total += task_total[task];
+        if (task_diff[task].empty()) continue;
+        for (std::size_t k = 0; k <= m; ++k) diff[k] += task_diff[task][k];
+      }
+      double running = 2.0 * total;
+      for (std::size_t k = 0; k < m; ++k) {
+        running += 2.0 * diff[k];
+        out[k] = running / (8.0 * M_PI);
+      }
+      return out;
     }
 
 }
@@ -7,6 +7,11 @@
 
 #pragma once
 #include "sst/types.h"
+#include "geometry/segment_kernels.h"
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include <tuple>
 
@@ -16,6 +21,115 @@
 
 namespace sst {
 
+        // Evaluation backend for the options overload of BiotSavart::computeVelocity.
+        enum class BiotSavartMethod {
+          Direct,    // dense segment x grid double loop (reference)
+          Treecode   // Barnes–Hut octree over segment midpoints, quadrupole clusters
+        };
+
+        struct BiotSavartOptions {
+          BiotSavartMethod method = BiotSavartMethod::Direct;
+          // Opening angle: a cluster of radius rho at distance d is expanded when rho < theta * d.
+          double theta = 0.5;
+          // Absolute velocity tolerance (> 0 enables the per-cluster error-bound test on top of theta).
+          double tolerance = 0.0;
+          // Maximum segments per octree leaf.
+          std::size_t leaf_size = 16;
+          // Per-segment quadrature for the direct sum and treecode leaves. StraightSegment is the
+          // exact field of each polygon edge (far clusters then expand the straight segments too).
+          geometry::SegmentKernel kernel = geometry::SegmentKernel::Midpoint;
+          // Worker threads over grid tiles; multithreading is opt-in (0 = hardware concurrency), so
+          // callers that already parallelise outside keep one thread per call. Each grid point sums
+          // its segments in a fixed order, so results do not depend on the thread count.
+          std::size_t num_threads = 1;
+          // Cache blocking of the direct sum: grid points per tile, segments per inner block.
+          std::size_t grid_tile = 256;
+          std::size_t segment_tile = 512;
+        };
+
+        struct BiotSavartFieldResult {
+          std::vector<Vec3> velocity;
+          // Upper estimate of max_g |v_tree(g) - v_direct(g)| (0 for the direct backend).
+          double error_estimate = 0.0;
+          std::size_t direct_interactions = 0;
+          std::size_t cluster_interactions = 0;
+        };
+
+        // Regular cubic-cell grid: node (i, j, k) sits at origin + spacing * (i, j, k) and is stored
+        // at flat index (i * shape[1] + j) * shape[2] + k (the computeVelocity grid order).
+        struct RegularGrid3D {
+          Vec3 origin{{0.0, 0.0, 0.0}};
+          double spacing = 1.0;
+          std::array<int, 3> shape{{0, 0, 0}};
+        };
+
+        // Particle-mesh (P3M) evaluation on a regular grid. The midpoint-rule kernel is split with a
+        // Gaussian of width sigma: the smooth part is spread to a mesh (TSC), convolved by FFT and
+        // its curl taken in Fourier space; the short-range remainder is summed directly within
+        // cutoff (p3m = true), so the result approaches the direct sum as the split is resolved.
+        struct ParticleMeshOptions {
+          // false: free-space field (zero-padded mesh); true: the grid box is the periodic cell.
+          bool periodic = false;
+          // Add the short-range direct correction; without it the field is Gaussian-smoothed.
+          bool p3m = true;
+          double sigma = 0.0;   // split width (0 -> 1.5 * spacing)
+          double cutoff = 0.0;  // short-range radius (0 -> 5.5 * sigma)
+          std::size_t num_threads = 1;  // opt-in (0 = hardware concurrency)
+        };
+
+        struct ParticleMeshResult {
+          std::vector<Vec3> velocity;
+          std::array<std::size_t, 3> mesh_shape{{0, 0, 0}};  // FFT mesh (padded in free space)
+          std::size_t near_interactions = 0;
+        };
+
+        enum class VorticityScheme {
+          CentralDifference,  // computeVorticity stencil on the velocity (historical pipeline)
+          Analytic            // exact curl of the midpoint-rule kernel, summed per point
+        };
+
+        // Fused interior evaluation: velocity and vorticity at the nodes at least `margin` away from
+        // every face of the grid, without a full-grid velocity or vorticity temporary.
+        struct InteriorFieldOptions {
+          VorticityScheme vorticity = VorticityScheme::CentralDifference;
+          // Shell velocity from computeVelocityParticleMesh (central differences only).
+          bool particle_mesh = false;
+          // Worker threads (0 = hardware concurrency); opt-in, as for BiotSavartOptions.
+          std::size_t num_threads = 1;
+        };
+
+        struct InteriorFieldResult {
+          std::vector<Vec3> velocity;   // interior nodes, extractInterior order
+          std::vector<Vec3> vorticity;
+          std::array<int, 3> shape{{0, 0, 0}};
+        };
+
+        inline BiotSavartMethod biot_savart_method_from_name(const std::string& name) {
+          if (name == "direct") return BiotSavartMethod::Direct;
+          if (name == "treecode" || name == "tree" || name == "barnes_hut") return BiotSavartMethod::Treecode;
+          throw std::invalid_argument("Unknown Biot–Savart method: " + name);
+        }
+
+        inline const char* biot_savart_method_name(BiotSavartMethod method) {
+          switch (method) {
+            case BiotSavartMethod::Treecode: return "treecode";
+            default: return "direct";
+          }
+        }
+
+        inline VorticityScheme vorticity_scheme_from_name(const std::string& name) {
+          if (name == "central" || name == "central_difference" || name == "fd") return VorticityScheme::CentralDifference;
+          if (name == "analytic" || name == "exact") return VorticityScheme::Analytic;
+          throw std::invalid_argument("Unknown vorticity scheme: " + name);
+        }
+
+        inline const char* vorticity_scheme_name(VorticityScheme scheme) {
+          switch (scheme) {
+            case VorticityScheme::Analytic: return "analytic";
+            default: return "central";
+          }
+        }
+
         class BiotSavart {
         public:
 
@@ -28,13 +142,75 @@ namespace sst {
           );
 
           // New overload:
-          // Same computation, but with explicit circulation Gamma.
+          // Same computation, but with explicit circulation Gamma
+          // (tiled direct sum with default BiotSavartOptions, single-threaded).
           static std::vector<Vec3> computeVelocity(
               const std::vector<Vec3>& curve,
               const std::vector<Vec3>& grid_points,
               double Gamma
           );
 
+          // Options overload: same closed-curve midpoint-rule field, evaluated with the
+          // backend selected in options (direct sum or Barnes–Hut treecode).
+          static BiotSavartFieldResult computeVelocity(
+              const std::vector<Vec3>& curve,
+              const std::vector<Vec3>& grid_points,
+              double Gamma,
+              const BiotSavartOptions& options
+          );
+
+          // Particle-mesh overload for regular grids: O(M³ log M) plus the near-field correction,
+          // instead of O(G³ N). Throws std::invalid_argument on an empty shape or spacing <= 0.
+          static ParticleMeshResult computeVelocityParticleMesh(
+              const std::vector<Vec3>& curve,
+              const RegularGrid3D& grid,
+              double Gamma,
+              const ParticleMeshOptions& options = {}
+          );
+
+          // Velocity and vorticity at the interior of grid (extractInterior order). With central
+          // differences and margin >= 1 only the interior plus a one-node shell is evaluated, and the
+          // result equals computeVelocity -> computeVorticity -> extractInterior bit for bit; margin
+          // 0 keeps the periodic wrap of computeVorticity. Throws std::invalid_argument on a bad
+          // grid, a margin that leaves no interior, or Analytic combined with particle_mesh.
+          static InteriorFieldResult computeInteriorVelocityVorticity(
+              const std::vector<Vec3>& curve,
+              const RegularGrid3D& grid,
+              int margin,
+              double Gamma = 1.0,
+              const InteriorFieldOptions& options = {}
+          );
+
+          // K closed curves against one shared grid (catalog sweeps), one options-overload call per
+          // curve: field k is computeVelocity(curves[k], grid_points, circulations[k], options).
+          // circulations is empty (all 1) or holds one value per curve (else std::invalid_argument).
+          static std::vector<std::vector<Vec3>> computeVelocityBatch(
+              const std::vector<std::vector<Vec3>>& curves,
+              const std::vector<Vec3>& grid_points,
+              const std::vector<double>& circulations = {},
+              const BiotSavartOptions& options = {}
+          );
+
+          // Superposition of the batch fields (summed in curve order) without the K fields.
+          static std::vector<Vec3> computeVelocitySuperposed(
+              const std::vector<std::vector<Vec3>>& curves,
+              const std::vector<Vec3>& grid_points,
+              const std::vector<double>& circulations = {},
+              const BiotSavartOptions& options = {}
+          );
+
+          // Per-curve (H_charge, H_mass, a_mu) over the interior of grid with central-difference
+          // vorticity and r_sq = |node|^2: equal to computeInteriorVelocityVorticity followed by
+          // computeInvariants, but no field is materialised (a rolling three-plane velocity window per
+          // curve). Curves are distributed over num_threads workers (opt-in; 0 = all cores).
+          static std::vector<std::tuple<double, double, double>> computeInvariantsBatch(
+              const std::vector<std::vector<Vec3>>& curves,
+              const RegularGrid3D& grid,
+              int margin,
+              const std::vector<double>& circulations = {},
+              std::size_t num_threads = 1
+          );
+
           // Compute vorticity from velocity field on a regular grid
           static std::vector<Vec3> computeVorticity(
               const std::vector<Vec3>& velocity,
@@ -60,6 +236,15 @@ namespace sst {
               const std::vector<Vec3>& X,
               const std::vector<Vec3>& T,
               double Gamma = 1.0);
+
+        private:
+          // Direct backend: grid tiles x segment blocks, tiles spread over options.num_threads.
+          static std::vector<Vec3> directVelocity(
+              const std::vector<Vec3>& curve,
+              const std::vector<Vec3>& grid_points,
+              double Gamma,
+              const BiotSavartOptions& options
+          );
         };
 
         inline Vec3 biot_savart_velocity(const Vec3& r,
@@ -72,13 +257,17 @@ namespace sst {
         // Cutoff-scanned Biot–Savart / Neumann-style filament energy (trefoil sweep kernel).
         // points, tangents: row-major (n, 3); ds length n; a_values length m, sorted ascending.
         // Returns E(a_k) for k = 0..m-1 with E_BS(a) = (1/8pi) * sum_{i!=j, dist>a} (t_i·t_j)/dist * ds_i ds_j.
+        // Each pair is visited once (i < j); only pairs within a_{m-1} (found via a cell list) are
+        // binned against the cutoffs. Multithreading is opt-in (num_threads = 0 uses all cores); the
+        // result does not depend on it.
         std::vector<double> bs_cutoff_energy_scan(
             const double* points,
             const double* tangents,
             const double* ds,
             std::size_t n,
             const double* a_values,
-            std::size_t m);
+            std::size_t m,
+            std::size_t num_threads = 1);
 }
 
 #endif //SSTCORE_BIOT_SAVART_H
@@ -1,6 +1,7 @@
 // node_biot_savart.cpp - Node.js bindings for BiotSavart
 #include <napi.h>
 #include <cstdint>
+#include <stdexcept>
 #include <string>
 #include "node_utils.h"
 #include "biot_savart.h"
@@ -57,6 +58,78 @@ std::vector<double> value_to_doubles(Napi::Env env, const Napi::Value& v, const
     return js_array_to_double_vector(v.As<Napi::Array>());
 }
 
+std::vector<Vec3> value_to_points(Napi::Env env, const Napi::Value& v, const char* name) {
+    const std::vector<double> flat = value_to_flat_xyz(env, v, name);
+    std::vector<Vec3> pts(flat.size() / 3u);
+    for (std::size_t i = 0; i < pts.size(); ++i) {
+        pts[i] = {flat[3 * i], flat[3 * i + 1], flat[3 * i + 2]};
+    }
+    return pts;
+}
+
+std::vector<std::vector<Vec3>> value_to_curves(Napi::Env env, const Napi::Value& v) {
+    if (!v.IsArray()) {
+        throw Napi::TypeError::New(env, "polylines must be an array of polylines");
+    }
+    Napi::Array arr = v.As<Napi::Array>();
+    std::vector<std::vector<Vec3>> curves(arr.Length());
+    for (uint32_t c = 0; c < arr.Length(); ++c) curves[c] = value_to_points(env, arr.Get(c), "polylines[i]");
+    return curves;
+}
+
+BiotSavartOptions read_biot_savart_options(const Napi::Value& v) {
+    BiotSavartOptions o;
+    if (!v.IsObject()) return o;
+    Napi::Object d = v.As<Napi::Object>();
+    if (d.Has("method")) o.method = biot_savart_method_from_name(d.Get("method").As<Napi::String>().Utf8Value());
+    if (d.Has("theta")) o.theta = d.Get("theta").As<Napi::Number>().DoubleValue();
+    if (d.Has("tolerance")) o.tolerance = d.Get("tolerance").As<Napi::Number>().DoubleValue();
+    if (d.Has("leafSize")) o.leaf_size = d.Get("leafSize").As<Napi::Number>().Uint32Value();
+    if (d.Has("leaf_size")) o.leaf_size = d.Get("leaf_size").As<Napi::Number>().Uint32Value();
+    if (d.Has("kernel")) o.kernel = geometry::segment_kernel_from_name(d.Get("kernel").As<Napi::String>().Utf8Value());
+    if (d.Has("numThreads")) o.num_threads = d.Get("numThreads").As<Napi::Number>().Uint32Value();
+    if (d.Has("num_threads")) o.num_threads = d.Get("num_threads").As<Napi::Number>().Uint32Value();
+    return o;
+}
+
+ParticleMeshOptions read_particle_mesh_options(const Napi::Value& v) {
+    ParticleMeshOptions o;
+    if (!v.IsObject()) return o;
+    Napi::Object d = v.As<Napi::Object>();
+    if (d.Has("periodic")) o.periodic = d.Get("periodic").ToBoolean().Value();
+    if (d.Has("p3m")) o.p3m = d.Get("p3m").ToBoolean().Value();
+    if (d.Has("sigma")) o.sigma = d.Get("sigma").As<Napi::Number>().DoubleValue();
+    if (d.Has("cutoff")) o.cutoff = d.Get("cutoff").As<Napi::Number>().DoubleValue();
+    if (d.Has("numThreads")) o.num_threads = d.Get("numThreads").As<Napi::Number>().Uint32Value();
+    if (d.Has("num_threads")) o.num_threads = d.Get("num_threads").As<Napi::Number>().Uint32Value();
+    return o;
+}
+
+InteriorFieldOptions read_interior_field_options(const Napi::Value& v) {
+    InteriorFieldOptions o;
+    if (!v.IsObject()) return o;
+    Napi::Object d = v.As<Napi::Object>();
+    if (d.Has("vorticity")) o.vorticity = vorticity_scheme_from_name(d.Get("vorticity").As<Napi::String>().Utf8Value());
+    if (d.Has("particleMesh")) o.particle_mesh = d.Get("particleMesh").ToBoolean().Value();
+    if (d.Has("particle_mesh")) o.particle_mesh = d.Get("particle_mesh").ToBoolean().Value();
+    if (d.Has("numThreads")) o.num_threads = d.Get("numThreads").As<Napi::Number>().Uint32Value();
+    if (d.Has("num_threads")) o.num_threads = d.Get("num_threads").As<Napi::Number>().Uint32Value();
+    return o;
+}
+
+RegularGrid3D read_regular_grid(Napi::Env env, const Napi::CallbackInfo& info, size_t first) {
+    const std::vector<double> origin = value_to_doubles(env, info[first], "origin");
+    const std::vector<double> shape = value_to_doubles(env, info[first + 2], "shape");
+    if (origin.size() != 3 || shape.size() != 3) {
+        throw Napi::TypeError::New(env, "origin and shape must have 3 entries");
+    }
+    RegularGrid3D grid;
+    grid.origin = {origin[0], origin[1], origin[2]};
+    grid.spacing = info[first + 1].As<Napi::Number>().DoubleValue();
+    grid.shape = {static_cast<int>(shape[0]), static_cast<int>(shape[1]), static_cast<int>(shape[2])};
+    return grid;
+}
+
 } // namespace
 
 void bind_biot_savart(Napi::Env env, Napi::Object exports) {
@@ -267,6 +340,167 @@ void bind_biot_savart(Napi::Env env, Napi::Object exports) {
         return vec3_list_to_js_typedarray(env, result);
     }, "biotSavartVelocityGrid"));
 
+    // Backend-selectable grid velocity: (polyline, grid, circulation?, options?) -> result object
+    exports.Set("biotSavartVelocityField", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
+        Napi::Env env = info.Env();
+        if (info.Length() < 2) {
+            throw Napi::Error::New(env, "Expected at least 2 arguments: polyline, grid[, circulation, options]");
+        }
+        const std::vector<double> wire_flat = value_to_flat_xyz(env, info[0], "polyline");
+        const std::vector<double> grid_flat = value_to_flat_xyz(env, info[1], "grid");
+        std::vector<Vec3> polyline(wire_flat.size() / 3u), grid(grid_flat.size() / 3u);
+        for (std::size_t i = 0; i < polyline.size(); ++i) {
+            polyline[i] = {wire_flat[3 * i], wire_flat[3 * i + 1], wire_flat[3 * i + 2]};
+        }
+        for (std::size_t i = 0; i < grid.size(); ++i) {
+            grid[i] = {grid_flat[3 * i], grid_flat[3 * i + 1], grid_flat[3 * i + 2]};
+        }
+        const double circulation = (info.Length() > 2 && info[2].IsNumber())
+            ? info[2].As<Napi::Number>().DoubleValue() : 1.0;
+        BiotSavartOptions opt;
+        try {
+            opt = read_biot_savart_options(info.Length() > 3 ? info[3] : env.Undefined());
+        } catch (const std::invalid_argument& e) {
+            throw Napi::TypeError::New(env, e.what());
+        }
+
+        BiotSavartFieldResult r = BiotSavart::computeVelocity(polyline, grid, circulation, opt);
+        Napi::Object o = Napi::Object::New(env);
+        o.Set("velocity", vec3_list_to_js_typedarray(env, r.velocity));
+        o.Set("method", biot_savart_method_name(opt.method));
+        o.Set("kernel", geometry::segment_kernel_name(opt.kernel));
+        o.Set("errorEstimate", r.error_estimate);
+        o.Set("directInteractions", static_cast<double>(r.direct_interactions));
+        o.Set("clusterInteractions", static_cast<double>(r.cluster_interactions));
+        return o;
+    }, "biotSavartVelocityField"));
+
+    // Batched curves against one grid: (polylines, grid, circulations?, options?) -> Float64Array[]
+    // (options.superpose = true returns the single summed field).
+    exports.Set("biotSavartVelocityBatch", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
+        Napi::Env env = info.Env();
+        if (info.Length() < 2) {
+            throw Napi::Error::New(env, "Expected at least 2 arguments: polylines, grid[, circulations, options]");
+        }
+        const std::vector<std::vector<Vec3>> curves = value_to_curves(env, info[0]);
+        const std::vector<Vec3> grid = value_to_points(env, info[1], "grid");
+        std::vector<double> circulations;
+        if (info.Length() > 2 && !info[2].IsUndefined() && !info[2].IsNull()) {
+            circulations = value_to_doubles(env, info[2], "circulations");
+        }
+        const Napi::Value options = info.Length() > 3 ? info[3] : env.Undefined();
+        const bool superpose = options.IsObject() && options.As<Napi::Object>().Has("superpose")
+            && options.As<Napi::Object>().Get("superpose").ToBoolean().Value();
+        try {
+            const BiotSavartOptions opt = read_biot_savart_options(options);
+            if (superpose) {
+                return vec3_list_to_js_typedarray(env, BiotSavart::computeVelocitySuperposed(curves, grid, circulations, opt));
+            }
+            const auto fields = BiotSavart::computeVelocityBatch(curves, grid, circulations, opt);
+            Napi::Array out = Napi::Array::New(env, fields.size());
+            for (uint32_t c = 0; c < fields.size(); ++c) out.Set(c, vec3_list_to_js_typedarray(env, fields[c]));
+            return out;
+        } catch (const std::invalid_argument& e) {
+            throw Napi::TypeError::New(env, e.what());
+        }
+    }, "biotSavartVelocityBatch"));
+
+    // Batched helicity invariants: (polylines, origin, spacing, shape, margin, circulations?, numThreads?)
+    exports.Set("biotSavartInvariantsBatch", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
+        Napi::Env env = info.Env();
+        if (info.Length() < 5) {
+            throw Napi::Error::New(env, "Expected at least 5 arguments: polylines, origin, spacing, shape, margin[, circulations, numThreads]");
+        }
+        const std::vector<std::vector<Vec3>> curves = value_to_curves(env, info[0]);
+        const RegularGrid3D grid = read_regular_grid(env, info, 1);
+        const int margin = info[4].As<Napi::Number>().Int32Value();
+        std::vector<double> circulations;
+        if (info.Length() > 5 && !info[5].IsUndefined() && !info[5].IsNull()) {
+            circulations = value_to_doubles(env, info[5], "circulations");
+        }
+        const std::size_t threads = (info.Length() > 6 && info[6].IsNumber()) ? info[6].As<Napi::Number>().Uint32Value() : 1;
+        std::vector<std::tuple<double, double, double>> inv;
+        try {
+            inv = BiotSavart::computeInvariantsBatch(curves, grid, margin, circulations, threads);
+        } catch (const std::invalid_argument& e) {
+            throw Napi::TypeError::New(env, e.what());
+        }
+        Napi::Array out = Napi::Array::New(env, inv.size());
+        for (uint32_t c = 0; c < inv.size(); ++c) {
+            Napi::Object o = Napi::Object::New(env);
+            o.Set("hCharge", std::get<0>(inv[c]));
+            o.Set("hMass", std::get<1>(inv[c]));
+            o.Set("aMu", std::get<2>(inv[c]));
+            out.Set(c, o);
+        }
+        return out;
+    }, "biotSavartInvariantsBatch"));
+
+    // Particle-mesh grid velocity: (polyline, origin, spacing, shape, circulation?, options?) -> result object
+    exports.Set("biotSavartVelocityParticleMesh", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
+        Napi::Env env = info.Env();
+        if (info.Length() < 4) {
+            throw Napi::Error::New(env, "Expected at least 4 arguments: polyline, origin, spacing, shape[, circulation, options]");
+        }
+        const std::vector<double> wire_flat = value_to_flat_xyz(env, info[0], "polyline");
+        std::vector<Vec3> polyline(wire_flat.size() / 3u);
+        for (std::size_t i = 0; i < polyline.size(); ++i) {
+            polyline[i] = {wire_flat[3 * i], wire_flat[3 * i + 1], wire_flat[3 * i + 2]};
+        }
+        const RegularGrid3D grid = read_regular_grid(env, info, 1);
+        const double circulation = (info.Length() > 4 && info[4].IsNumber())
+            ? info[4].As<Napi::Number>().DoubleValue() : 1.0;
+
+        ParticleMeshResult r;
+        try {
+            r = BiotSavart::computeVelocityParticleMesh(
+                polyline, grid, circulation, read_particle_mesh_options(info.Length() > 5 ? info[5] : env.Undefined()));
+        } catch (const std::invalid_argument& e) {
+            throw Napi::TypeError::New(env, e.what());
+        }
+        Napi::Object o = Napi::Object::New(env);
+        o.Set("velocity", vec3_list_to_js_typedarray(env, r.velocity));
+        Napi::Array mesh = Napi::Array::New(env, 3);
+        for (uint32_t a = 0; a < 3; ++a) mesh.Set(a, static_cast<double>(r.mesh_shape[a]));
+        o.Set("meshShape", mesh);
+        o.Set("nearInteractions", static_cast<double>(r.near_interactions));
+        return o;
+    }, "biotSavartVelocityParticleMesh"));
+
+    // Fused interior velocity + vorticity: (polyline, origin, spacing, shape, margin, circulation?, options?)
+    exports.Set("biotSavartInteriorVelocityVorticity", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
+        Napi::Env env = info.Env();
+        if (info.Length() < 5) {
+            throw Napi::Error::New(env, "Expected at least 5 arguments: polyline, origin, spacing, shape, margin[, circulation, options]");
+        }
+        const std::vector<double> wire_flat = value_to_flat_xyz(env, info[0], "polyline");
+        std::vector<Vec3> polyline(wire_flat.size() / 3u);
+        for (std::size_t i = 0; i < polyline.size(); ++i) {
+            polyline[i] = {wire_flat[3 * i], wire_flat[3 * i + 1], wire_flat[3 * i + 2]};
+        }
+        const RegularGrid3D grid = read_regular_grid(env, info, 1);
+        const int margin = info[4].As<Napi::Number>().Int32Value();
+        const double circulation = (info.Length() > 5 && info[5].IsNumber())
+            ? info[5].As<Napi::Number>().DoubleValue() : 1.0;
+
+        InteriorFieldOptions opt;
+        InteriorFieldResult r;
+        try {
+            opt = read_interior_field_options(info.Length() > 6 ? info[6] : env.Undefined());
+            r = BiotSavart::computeInteriorVelocityVorticity(polyline, grid, margin, circulation, opt);
+        } catch (const std::invalid_argument& e) {
+            throw Napi::TypeError::New(env, e.what());
+        }
+        Napi::Object o = Napi::Object::New(env);
+        o.Set("velocity", vec3_list_to_js_typedarray(env, r.velocity));
+        o.Set("vorticity", vec3_list_to_js_typedarray(env, r.vorticity));
+        Napi::Array shape = Napi::Array::New(env, 3);
+        for (uint32_t a = 0; a < 3; ++a) shape.Set(a, r.shape[a]);
+        o.Set("shape", shape);
+        o.Set("vorticityScheme", vorticity_scheme_name(opt.vorticity));
+        return o;
+    }, "biotSavartInteriorVelocityVorticity"));
+
     // Trefoil-closure / sst_core compatibility free functions (parity with biot_savart_py.cpp)
     exports.Set("calculateNeumannSelfEnergy", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
         Napi::Env e = info.Env();
@@ -324,7 +558,7 @@ void bind_biot_savart(Napi::Env env, Napi::Object exports) {
     exports.Set("calculateBsCutoffEnergyScan", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
         Napi::Env e = info.Env();
         if (info.Length() < 4) {
-            throw Napi::TypeError::New(e, "Expected (points, tangents, dsArr, aValues)");
+            throw Napi::TypeError::New(e, "Expected (points, tangents, dsArr, aValues[, numThreads])");
         }
         std::vector<double> pts = value_to_flat_xyz(e, info[0], "points");
         std::vector<double> tans = value_to_flat_xyz(e, info[1], "tangents");
@@ -334,15 +568,18 @@ void bind_biot_savart(Napi::Env env, Napi::Object exports) {
         if (tans.size() / 3u != n || ds.size() != n) {
             throw Napi::Error::New(e, "calculateBsCutoffEnergyScan: inconsistent N dimensions");
         }
+        // Optional numThreads (default 1, 0 = all cores).
+        const std::size_t threads =
+            info.Length() > 4 && info[4].IsNumber() ? info[4].As<Napi::Number>().Uint32Value() : 1;
         std::vector<double> out = bs_cutoff_energy_scan(
-            pts.data(), tans.data(), ds.data(), n, avals.data(), avals.size());
+            pts.data(), tans.data(), ds.data(), n, avals.data(), avals.size(), threads);
         return double_vector_to_js_array(e, out);
     }));
 
     exports.Set("calculateBsCutoffEnergy", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
         Napi::Env e = info.Env();
         if (info.Length() < 4) {
-            throw Napi::TypeError::New(e, "Expected (points, tangents, dsArr, aCutoff)");
+            throw Napi::TypeError::New(e, "Expected (points, tangents, dsArr, aCutoff[, numThreads])");
         }
         std::vector<double> pts = value_to_flat_xyz(e, info[0], "points");
         std::vector<double> tans = value_to_flat_xyz(e, info[1], "tangents");
@@ -352,8 +589,10 @@ void bind_biot_savart(Napi::Env env, Napi::Object exports) {
         if (tans.size() / 3u != n || ds.size() != n) {
             throw Napi::Error::New(e, "calculateBsCutoffEnergy: inconsistent N dimensions");
         }
+        const std::size_t threads =
+            info.Length() > 4 && info[4].IsNumber() ? info[4].As<Napi::Number>().Uint32Value() : 1;
         double aone = a_cutoff;
-        std::vector<double> out = bs_cutoff_energy_scan(pts.data(), tans.data(), ds.data(), n, &aone, 1);
+        std::vector<double> out = bs_cutoff_energy_scan(pts.data(), tans.data(), ds.data(), n, &aone, 1, threads);
         return Napi::Number::New(e, out.empty() ? 0.0 : out[0]);
     }));
 }
\ No newline at end of file
@@ -0,0 +1,357 @@
+// Particle-mesh (P3M) backend for BiotSavart on regular grids.
+//
+// The midpoint-rule field v(x) = Γ/4π Σ_j dl_j × R_j / |R_j|³ (R_j = x - y_j) is split with
+//   1/r³ = f(r/σ)/r³ + (1 - f(r/σ))/r³,   f(ρ) = erf(ρ/√2) - √(2/π) ρ e^{-ρ²/2},
+// where f/r³ R = -∇[erf(r/√2σ)/r] is the field of Gaussian-smoothed line elements. The smooth
+// part is evaluated on a mesh: dl_j is spread with triangular-shaped-cloud (TSC) weights, the
+// window is deconvolved in Fourier space and v̂ = Ω̂ × K̂ (the curl as a k-space cross product).
+// Free space uses Hockney zero padding with the real-space kernel sampled on the mesh; the
+// periodic mode uses the analytic transform -i k 4π e^{-k²σ²/2} / k². The short-range part
+// (1 - f) decays like a Gaussian and is summed directly within the cutoff (p3m).
+#include "biot_savart.h"
+
+#include "fft.h"
+#include "parallel_for.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace sst {
+namespace {
+
+constexpr double kSqrt2OverPi = 0.79788456080286535587989211986876;  // √(2/π)
+
+// f(r/σ) / r³: the smooth share of the 1/r³ kernel (finite at r = 0).
+double smooth_kernel(double r, double sigma) {
+    const double rho = r / sigma;
+    if (rho < 0.1) {
+        const double r2 = rho * rho;
+        return kSqrt2OverPi / (sigma * sigma * sigma) * (1.0 / 3.0 - r2 / 10.0 + r2 * r2 / 56.0);
+    }
+    const double f = std::erf(rho * 0.70710678118654752440) - kSqrt2OverPi * rho * std::exp(-0.5 * rho * rho);
+    return f / (r * r * r);
+}
+
+// TSC weights for the three nodes around u (node index units): nodes i0-1, i0, i0+1.
+long tsc_weights(double u, double w[3]) {
+    const long i0 = static_cast<long>(std::floor(u + 0.5));
+    const double d = u - static_cast<double>(i0);
+    w[0] = 0.5 * (0.5 - d) * (0.5 - d);
+    w[1] = 0.75 - d * d;
+    w[2] = 0.5 * (0.5 + d) * (0.5 + d);
+    return i0;
+}
+
+// Fourier transform of the TSC window at mode m of an n-point axis: sinc³(π m / n).
+double tsc_window(long m, std::size_t n) {
+    if (m == 0) return 1.0;
+    const double x = M_PI * static_cast<double>(m) / static_cast<double>(n);
+    const double s = std::sin(x) / x;
+    return s * s * s;
+}
+
+long signed_mode(std::size_t k, std::size_t n) {
+    return k <= n / 2 ? static_cast<long>(k) : static_cast<long>(k) - static_cast<long>(n);
+}
+
+std::size_t wrap(long i, std::size_t n) {
+    const long m = static_cast<long>(n);
+    return static_cast<std::size_t>(((i % m) + m) % m);
+}
+
+}  // namespace
+
+ParticleMeshResult BiotSavart::computeVelocityParticleMesh(
+    const std::vector<Vec3>& curve,
+    const RegularGrid3D& grid,
+    double Gamma,
+    const ParticleMeshOptions& options
+) {
+    if (grid.shape[0] <= 0 || grid.shape[1] <= 0 || grid.shape[2] <= 0) {
+        throw std::invalid_argument("computeVelocityParticleMesh: grid shape must be positive");
+    }
+    if (!(grid.spacing > 0.0)) {
+        throw std::invalid_argument("computeVelocityParticleMesh: grid spacing must be > 0");
+    }
+
+    ParticleMeshResult out;
+    const std::size_t G[3] = {static_cast<std::size_t>(grid.shape[0]),
+                              static_cast<std::size_t>(grid.shape[1]),
+                              static_cast<std::size_t>(grid.shape[2])};
+    const std::size_t n_grid = G[0] * G[1] * G[2];
+    out.velocity.assign(n_grid, {0.0, 0.0, 0.0});
+    if (curve.size() < 2) {
+        return out;
+    }
+
+    const double h = grid.spacing;
+    const double sigma = options.sigma > 0.0 ? options.sigma : 1.5 * h;
+    double cutoff = options.cutoff > 0.0 ? options.cutoff : 5.5 * sigma;
+    if (options.periodic) {
+        // Minimum-image short-range sum: the cutoff cannot exceed half the shortest period.
+        cutoff = std::min(cutoff, 0.5 * h * static_cast<double>(std::min({G[0], G[1], G[2]})));
+    }
+    const std::size_t threads = options.num_threads;
+
+    const std::size_t N = curve.size();
+    std::vector<Vec3> mids(N), dls(N), cell_pos(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        const Vec3& r0 = curve[i];
+        const Vec3& r1 = curve[(i + 1) % N];
+        dls[i] = { r1[0] - r0[0], r1[1] - r0[1], r1[2] - r0[2] };
+        mids[i] = { 0.5*(r0[0] + r1[0]), 0.5*(r0[1] + r1[1]), 0.5*(r0[2] + r1[2]) };
+        for (int a = 0; a < 3; ++a) cell_pos[i][a] = (mids[i][a] - grid.origin[a]) / h;
+    }
+
+    // Mesh: grid nodes (plus every particle's TSC stencil in free space), padded to P >= 2M - 1.
+    long lo[3] = {0, 0, 0};
+    std::size_t M[3], P[3];
+    for (int a = 0; a < 3; ++a) {
+        if (options.periodic) {
+            M[a] = P[a] = G[a];
+            continue;
+        }
+        long hi = static_cast<long>(G[a]) - 1;
+        for (const Vec3& u : cell_pos) {
+            lo[a] = std::min(lo[a], static_cast<long>(std::floor(u[a])) - 2);
+            hi = std::max(hi, static_cast<long>(std::ceil(u[a])) + 2);
+        }
+        M[a] = static_cast<std::size_t>(hi - lo[a] + 1);
+        P[a] = fft_good_size(2 * M[a] - 1);
+    }
+    const std::array<std::size_t, 3> shape{{P[0], P[1], P[2]}};
+    out.mesh_shape = shape;
+    const std::size_t n_mesh = P[0] * P[1] * P[2];
+    auto flat = [&](std::size_t i, std::size_t j, std::size_t k) { return (i * P[1] + j) * P[2] + k; };
+
+    // Kernel transform K̂ = i (A, B, C) (the kernel is real and odd, so its transform is imaginary).
+    std::vector<double> A(n_mesh), B(n_mesh), C(n_mesh);
+    std::vector<Complex> z1(n_mesh), z2(n_mesh);
+    if (options.periodic) {
+        const double norm = 4.0 * M_PI / (h * h * h);
+        parallel_for(P[0], threads, [&](std::size_t i) {
+            const long mi = signed_mode(i, P[0]);
+            const double kx = 2.0 * M_PI * static_cast<double>(mi) / (static_cast<double>(P[0]) * h);
+            for (std::size_t j = 0; j < P[1]; ++j) {
+                const long mj = signed_mode(j, P[1]);
+                const double ky = 2.0 * M_PI * static_cast<double>(mj) / (static_cast<double>(P[1]) * h);
+                for (std::size_t k = 0; k < P[2]; ++k) {
+                    const long mk = signed_mode(k, P[2]);
+                    const double kz = 2.0 * M_PI * static_cast<double>(mk) / (static_cast<double>(P[2]) * h);
+                    const double k2 = kx * kx + ky * ky + kz * kz;
+                    const std::size_t idx = flat(i, j, k);
+                    if (k2 == 0.0) continue;
+                    const double s = norm * std::exp(-0.5 * k2 * sigma * sigma) / k2;
+                    // Nyquist planes carry no odd (derivative) component.
+                    A[idx] = (2 * static_cast<std::size_t>(std::abs(mi)) == P[0]) ? 0.0 : -kx * s;
+                    B[idx] = (2 * static_cast<std::size_t>(std::abs(mj)) == P[1]) ? 0.0 : -ky * s;
+                    C[idx] = (2 * static_cast<std::size_t>(std::abs(mk)) == P[2]) ? 0.0 : -kz * s;
+                }
+            }
+        });
+    } else {
+        parallel_for(2 * M[0] - 1, threads, [&](std::size_t ii) {
+            const long di = static_cast<long>(ii) - static_cast<long>(M[0] - 1);
+            for (long dj = -static_cast<long>(M[1] - 1); dj <= static_cast<long>(M[1] - 1); ++dj) {
+                for (long dk = -static_cast<long>(M[2] - 1); dk <= static_cast<long>(M[2] - 1); ++dk) {
+                    const Vec3 R{{h * static_cast<double>(di), h * static_cast<double>(dj), h * static_cast<double>(dk)}};
+                    const double g = smooth_kernel(norm(R), sigma);
+                    const std::size_t idx = flat(wrap(di, P[0]), wrap(dj, P[1]), wrap(dk, P[2]));
+                    z1[idx] = Complex(R[0] * g, R[1] * g);
+                    z2[idx] = Complex(R[2] * g, 0.0);
+                }
+            }
+        });
+        fft3d(z1, shape, false, threads);
+        fft3d(z2, shape, false, threads);
+        for (std::size_t idx = 0; idx < n_mesh; ++idx) {
+            A[idx] = z1[idx].imag();
+            B[idx] = -z1[idx].real();
+            C[idx] = z2[idx].imag();
+        }
+    }
+
+    // Spread dl with TSC weights: z1 = Ωx + i Ωy, z3 = Ωz.
+    std::fill(z1.begin(), z1.end(), Complex(0.0, 0.0));
+    std::vector<Complex> z3(n_mesh, Complex(0.0, 0.0));
+    for (std::size_t s = 0; s < N; ++s) {
+        double w[3][3];
+        long base[3];
+        for (int a = 0; a < 3; ++a) base[a] = tsc_weights(cell_pos[s][a], w[a]) - 1 - lo[a];
+        for (int di = 0; di < 3; ++di) {
+            const std::size_t i = wrap(base[0] + di, P[0]);
+            for (int dj = 0; dj < 3; ++dj) {
+                const std::size_t j = wrap(base[1] + dj, P[1]);
+                const double wij = w[0][di] * w[1][dj];
+                for (int dk = 0; dk < 3; ++dk) {
+                    const std::size_t idx = flat(i, j, wrap(base[2] + dk, P[2]));
+                    const double wt = wij * w[2][dk];
+                    z1[idx] += Complex(wt * dls[s][0], wt * dls[s][1]);
+                    z3[idx] += Complex(wt * dls[s][2], 0.0);
+                }
+            }
+        }
+    }
+    fft3d(z1, shape, false, threads);
+    fft3d(z3, shape, false, threads);
+
+    // Separate the packed real transforms, deconvolve the window and form v̂ = Ω̂ × K̂:
+    //   v̂x = i (Ω̂y C - Ω̂z B),  v̂y = i (Ω̂z A - Ω̂x C),  v̂z = i (Ω̂x B - Ω̂y A).
+    // Results are packed back as z1 = v̂x + i v̂y, z2 = v̂z (both fields are real).
+    const Complex I(0.0, 1.0);
+    parallel_for(P[0], threads, [&](std::size_t i) {
+        const std::size_t ni = (P[0] - i) % P[0];
+        const double wi = tsc_window(signed_mode(i, P[0]), P[0]);
+        for (std::size_t j = 0; j < P[1]; ++j) {
+            const std::size_t nj = (P[1] - j) % P[1];
+            const double wij = wi * tsc_window(signed_mode(j, P[1]), P[1]);
+            for (std::size_t k = 0; k < P[2]; ++k) {
+                const std::size_t idx = flat(i, j, k);
+                const Complex zk = z1[idx];
+                const Complex zm = std::conj(z1[flat(ni, nj, (P[2] - k) % P[2])]);
+                const double inv_w = 1.0 / (wij * tsc_window(signed_mode(k, P[2]), P[2]));
+                const Complex ox = 0.5 * (zk + zm) * inv_w;
+                const Complex oy = -0.5 * I * (zk - zm) * inv_w;
+                const Complex oz = z3[idx] * inv_w;
+                const Complex vx = I * (oy * C[idx] - oz * B[idx]);
+                const Complex vy = I * (oz * A[idx] - ox * C[idx]);
+                const Complex vz = I * (ox * B[idx] - oy * A[idx]);
+                z2[idx] = vx + I * vy;
+                A[idx] = vz.real();
+                B[idx] = vz.imag();
+            }
+        }
+    });
+    // z1 is still read at mirrored indices above, so the packed results were staged elsewhere.
+    for (std::size_t idx = 0; idx < n_mesh; ++idx) {
+        z1[idx] = z2[idx];
+        z3[idx] = Complex(A[idx], B[idx]);
+    }
+    fft3d(z1, shape, true, threads);
+    fft3d(z3, shape, true, threads);
+
+    const double factor = Gamma / (4.0 * M_PI);
+    const double mesh_scale = factor / static_cast<double>(n_mesh);
+    for (std::size_t i = 0; i < G[0]; ++i) {
+        const std::size_t mi = wrap(static_cast<long>(i) - lo[0], P[0]);
+        for (std::size_t j = 0; j < G[1]; ++j) {
+            const std::size_t mj = wrap(static_cast<long>(j) - lo[1], P[1]);
+            for (std::size_t k = 0; k < G[2]; ++k) {
+                const std::size_t idx = flat(mi, mj, wrap(static_cast<long>(k) - lo[2], P[2]));
+                out.velocity[(i * G[1] + j) * G[2] + k] = {
+                    z1[idx].real() * mesh_scale, z1[idx].imag() * mesh_scale, z3[idx].real() * mesh_scale};
+            }
+        }
+    }
+    if (!options.p3m) {
+        return out;
+    }
+
+    // Short-range correction: (direct - smooth) kernel for particles within the cutoff, found
+    // through a cell list of side >= cutoff over the grid box (periodic: the box itself).
+    const double L[3] = {h * static_cast<double>(G[0]), h * static_cast<double>(G[1]), h * static_cast<double>(G[2])};
+    double cell_lo[3];
+    std::size_t cells[3];
+    for (int a = 0; a < 3; ++a) {
+        const double extent = options.periodic ? L[a] : h * static_cast<double>(G[a] - 1) + 2.0 * cutoff;
+        cell_lo[a] = options.periodic ? grid.origin[a] : grid.origin[a] - cutoff;
+        cells[a] = std::max<std::size_t>(1, static_cast<std::size_t>(std::floor(extent / cutoff)));
+    }
+    auto cell_coord = [&](double x, int a) -> long {
+        const double u = (x - cell_lo[a]) / (options.periodic ? L[a] : h * static_cast<double>(G[a] - 1) + 2.0 * cutoff);
+        const long c = static_cast<long>(std::floor(u * static_cast<double>(cells[a])));
+        if (options.periodic) return static_cast<long>(wrap(c, cells[a]));
+        return c;
+    };
+    const std::size_t n_cells = cells[0] * cells[1] * cells[2];
+    std::vector<std::size_t> cell_start(n_cells + 1, 0), cell_of(N, n_cells), sorted;
+    for (std::size_t s = 0; s < N; ++s) {
+        long c[3];
+        bool inside = true;
+        for (int a = 0; a < 3; ++a) {
+            c[a] = cell_coord(mids[s][a], a);
+            inside = inside && c[a] >= 0 && c[a] < static_cast<long>(cells[a]);
+        }
+        if (!inside) continue;  // free space: too far from every grid node
+        cell_of[s] = (static_cast<std::size_t>(c[0]) * cells[1] + static_cast<std::size_t>(c[1])) * cells[2]
+                     + static_cast<std::size_t>(c[2]);
+        ++cell_start[cell_of[s] + 1];
+    }
+    for (std::size_t c = 0; c < n_cells; ++c) cell_start[c + 1] += cell_start[c];
+    sorted.resize(cell_start[n_cells]);
+    {
+        std::vector<std::size_t> fill(cell_start.begin(), cell_start.end() - 1);
+        for (std::size_t s = 0; s < N; ++s) {
+            if (cell_of[s] < n_cells) sorted[fill[cell_of[s]]++] = s;
+        }
+    }
+
+    const double cutoff2 = cutoff * cutoff;
+    std::vector<std::size_t> near_count(G[0], 0);
+    parallel_for(G[0], threads, [&](std::size_t i) {
+        std::vector<std::size_t> neighbours;
+        for (std::size_t j = 0; j < G[1]; ++j) {
+            for (std::size_t k = 0; k < G[2]; ++k) {
+                const Vec3 x{{grid.origin[0] + h * static_cast<double>(i),
+                              grid.origin[1] + h * static_cast<double>(j),
+                              grid.origin[2] + h * static_cast<double>(k)}};
+                long c[3];
+                for (int a = 0; a < 3; ++a) c[a] = cell_coord(x[a], a);
+                // Unique neighbour cells (axes with fewer than three cells are scanned once).
+                neighbours.clear();
+                long span[3][3];
+                int count[3];
+                for (int a = 0; a < 3; ++a) {
+                    count[a] = 0;
+                    const long n = static_cast<long>(cells[a]);
+                    if (n <= 3) {
+                        for (long v = 0; v < n; ++v) span[a][count[a]++] = v;
+                        continue;
+                    }
+                    for (long d = -1; d <= 1; ++d) {
+                        const long v = c[a] + d;
+                        if (options.periodic) span[a][count[a]++] = static_cast<long>(wrap(v, cells[a]));
+                        else if (v >= 0 && v < n) span[a][count[a]++] = v;
+                    }
+                }
+                for (int p = 0; p < count[0]; ++p)
+                    for (int q = 0; q < count[1]; ++q)
+                        for (int r = 0; r < count[2]; ++r)
+                            neighbours.push_back((static_cast<std::size_t>(span[0][p]) * cells[1]
+                                                  + static_cast<std::size_t>(span[1][q])) * cells[2]
+                                                 + static_cast<std::size_t>(span[2][r]));
+
+                Vec3 v{{0.0, 0.0, 0.0}};
+                for (std::size_t cell : neighbours) {
+                    for (std::size_t t = cell_start[cell]; t < cell_start[cell + 1]; ++t) {
+                        const std::size_t s = sorted[t];
+                        Vec3 R{{x[0] - mids[s][0], x[1] - mids[s][1], x[2] - mids[s][2]}};
+                        if (options.periodic) {
+                            for (int a = 0; a < 3; ++a) R[a] -= L[a] * std::round(R[a] / L[a]);
+                        }
+                        const double r2 = R[0] * R[0] + R[1] * R[1] + R[2] * R[2];
+                        if (r2 >= cutoff2) continue;
+                        const double normR = std::pow(r2, 1.5) + 1e-12;
+                        const double g = 1.0 / normR - smooth_kernel(std::sqrt(r2), sigma);
+                        const Vec3& dl = dls[s];
+                        v[0] += (dl[1] * R[2] - dl[2] * R[1]) * g;
+                        v[1] += (dl[2] * R[0] - dl[0] * R[2]) * g;
+                        v[2] += (dl[0] * R[1] - dl[1] * R[0]) * g;
+                        ++near_count[i];
+                    }
+                }
+                Vec3& out_v = out.velocity[(i * G[1] + j) * G[2] + k];
+                out_v[0] += factor * v[0];
+                out_v[1] += factor * v[1];
+                out_v[2] += factor * v[2];
+            }
+        }
+    });
+    for (std::size_t c : near_count) out.near_interactions += c;
+    return out;
+}
+
+}  // namespace sst
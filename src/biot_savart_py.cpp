@@ -33,6 +33,29 @@ static void require_points_n3(py::ssize_t rows, py::ssize_t cols, const char* ct
   }
 }
 
+static BiotSavartOptions read_biot_savart_options(const py::dict& options) {
+  BiotSavartOptions opt;
+  if (options.contains("method")) opt.method = biot_savart_method_from_name(py::cast<std::string>(options["method"]));
+  if (options.contains("theta")) opt.theta = py::cast<double>(options["theta"]);
+  if (options.contains("tolerance")) opt.tolerance = py::cast<double>(options["tolerance"]);
+  if (options.contains("leaf_size")) opt.leaf_size = py::cast<std::size_t>(options["leaf_size"]);
+  if (options.contains("kernel")) opt.kernel = geometry::segment_kernel_from_name(py::cast<std::string>(options["kernel"]));
+  if (options.contains("num_threads")) opt.num_threads = py::cast<std::size_t>(options["num_threads"]);
+  return opt;
+}
+
+static py::array_t<double> to_numpy_n3(const std::vector<Vec3>& V) {
+  const py::ssize_t G = (py::ssize_t)V.size();
+  py::array_t<double> out({G,(py::ssize_t)3});
+  auto o = out.mutable_unchecked<2>();
+  for(py::ssize_t i=0;i<G;++i){
+    o(i,0)=V[(size_t)i][0];
+    o(i,1)=V[(size_t)i][1];
+    o(i,2)=V[(size_t)i][2];
+  }
+  return out;
+}
+
 void bind_biot_savart(py::module_& m) {
   py::class_<BiotSavart>(m, "BiotSavart")
       .def_static(
@@ -81,6 +104,181 @@ void bind_biot_savart(py::module_& m) {
         "Biot–Savart velocity at arbitrary grid points for a polyline.\n"
         "Backward compatible with the historical 2-argument call; circulation defaults to 1.0.");
 
+  // Backend-selectable grid velocity (direct | treecode); options dict mirrors BiotSavartOptions.
+  m.def("biot_savart_velocity_field",
+        [](py::array_t<double, py::array::c_style | py::array::forcecast> polyline,
+           py::array_t<double, py::array::c_style | py::array::forcecast> grid,
+           double circulation,
+           py::dict options)
+        {
+          BiotSavartOptions opt = read_biot_savart_options(options);
+
+          auto wire = to_vec3_list(polyline);
+          auto pts  = to_vec3_list(grid);
+          BiotSavartFieldResult r = BiotSavart::computeVelocity(wire, pts, circulation, opt);
+
+          const py::ssize_t G = (py::ssize_t)r.velocity.size();
+          py::array_t<double> vel({G,(py::ssize_t)3});
+          auto o = vel.mutable_unchecked<2>();
+          for(py::ssize_t i=0;i<G;++i){
+            o(i,0)=r.velocity[(size_t)i][0];
+            o(i,1)=r.velocity[(size_t)i][1];
+            o(i,2)=r.velocity[(size_t)i][2];
+          }
+          py::dict out;
+          out["velocity"] = vel;
+          out["method"] = biot_savart_method_name(opt.method);
+          out["kernel"] = geometry::segment_kernel_name(opt.kernel);
+          out["error_estimate"] = r.error_estimate;
+          out["direct_interactions"] = r.direct_interactions;
+          out["cluster_interactions"] = r.cluster_interactions;
+          return out;
+        },
+        py::arg("polyline"), py::arg("grid"), py::arg("circulation") = 1.0,
+        py::arg("options") = py::dict(),
+        "Biot–Savart velocity at grid points with a selectable backend.\n"
+        "options: method ('direct' | 'treecode'), theta, tolerance, leaf_size,\n"
+        "kernel ('midpoint' | 'straight_segment'), num_threads (default 1; 0 = all cores).\n"
+        "Returns dict(velocity (G,3), method, kernel, error_estimate, direct_interactions, cluster_interactions).");
+
+  // Batched curves against one shared grid: K fields, or their superposition with superpose=True.
+  m.def("biot_savart_velocity_batch",
+        [](const std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>>& polylines,
+           py::array_t<double, py::array::c_style | py::array::forcecast> grid,
+           const std::vector<double>& circulations,
+           py::dict options,
+           bool superpose) -> py::object
+        {
+          std::vector<std::vector<Vec3>> curves;
+          curves.reserve(polylines.size());
+          for (const auto& p : polylines) curves.push_back(to_vec3_list(p));
+          auto pts = to_vec3_list(grid);
+          const BiotSavartOptions opt = read_biot_savart_options(options);
+          if (superpose) {
+            return to_numpy_n3(BiotSavart::computeVelocitySuperposed(curves, pts, circulations, opt));
+          }
+          py::list fields;
+          for (const auto& f : BiotSavart::computeVelocityBatch(curves, pts, circulations, opt)) fields.append(to_numpy_n3(f));
+          return fields;
+        },
+        py::arg("polylines"), py::arg("grid"), py::arg("circulations") = std::vector<double>{},
+        py::arg("options") = py::dict(), py::arg("superpose") = false,
+        "Biot–Savart velocity of K closed polylines at one set of grid points.\n"
+        "circulations: empty (all 1.0) or one per polyline; options as biot_savart_velocity_field.\n"
+        "Returns a list of K (G,3) arrays, or one (G,3) array when superpose=True.");
+
+  m.def("biot_savart_invariants_batch",
+        [](const std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>>& polylines,
+           const Vec3& origin,
+           double spacing,
+           const std::array<int, 3>& shape,
+           int margin,
+           const std::vector<double>& circulations,
+           std::size_t num_threads)
+        {
+          std::vector<std::vector<Vec3>> curves;
+          curves.reserve(polylines.size());
+          for (const auto& p : polylines) curves.push_back(to_vec3_list(p));
+          RegularGrid3D g;
+          g.origin = origin;
+          g.spacing = spacing;
+          g.shape = shape;
+          return BiotSavart::computeInvariantsBatch(curves, g, margin, circulations, num_threads);
+        },
+        py::arg("polylines"), py::arg("origin"), py::arg("spacing"), py::arg("shape"), py::arg("margin"),
+        py::arg("circulations") = std::vector<double>{}, py::arg("num_threads") = 1,
+        "Per-polyline (H_charge, H_mass, a_mu) over the grid interior (central-difference vorticity,\n"
+        "r_sq = |node|^2) without materialising any field. num_threads: default 1; 0 = all cores.");
+
+  // Particle-mesh (P3M) velocity on a regular grid; options dict mirrors ParticleMeshOptions.
+  m.def("biot_savart_velocity_particle_mesh",
+        [](py::array_t<double, py::array::c_style | py::array::forcecast> polyline,
+           const Vec3& origin,
+           double spacing,
+           const std::array<int, 3>& shape,
+           double circulation,
+           py::dict options)
+        {
+          ParticleMeshOptions opt;
+          if (options.contains("periodic")) opt.periodic = py::cast<bool>(options["periodic"]);
+          if (options.contains("p3m")) opt.p3m = py::cast<bool>(options["p3m"]);
+          if (options.contains("sigma")) opt.sigma = py::cast<double>(options["sigma"]);
+          if (options.contains("cutoff")) opt.cutoff = py::cast<double>(options["cutoff"]);
+          if (options.contains("num_threads")) opt.num_threads = py::cast<std::size_t>(options["num_threads"]);
+
+          RegularGrid3D grid;
+          grid.origin = origin;
+          grid.spacing = spacing;
+          grid.shape = shape;
+          ParticleMeshResult r = BiotSavart::computeVelocityParticleMesh(to_vec3_list(polyline), grid, circulation, opt);
+
+          py::array_t<double> vel({(py::ssize_t)shape[0], (py::ssize_t)shape[1], (py::ssize_t)shape[2], (py::ssize_t)3});
+          double* o = vel.mutable_data();
+          for (std::size_t i = 0; i < r.velocity.size(); ++i) {
+            o[3 * i] = r.velocity[i][0];
+            o[3 * i + 1] = r.velocity[i][1];
+            o[3 * i + 2] = r.velocity[i][2];
+          }
+          py::dict out;
+          out["velocity"] = vel;
+          out["mesh_shape"] = py::make_tuple(r.mesh_shape[0], r.mesh_shape[1], r.mesh_shape[2]);
+          out["near_interactions"] = r.near_interactions;
+          return out;
+        },
+        py::arg("polyline"), py::arg("origin"), py::arg("spacing"), py::arg("shape"),
+        py::arg("circulation") = 1.0, py::arg("options") = py::dict(),
+        "Biot–Savart velocity on the regular grid origin + spacing * (i, j, k) by particle-mesh FFT\n"
+        "with a short-range direct correction (P3M).\n"
+        "options: periodic (False), p3m (True), sigma (0 -> 1.5 spacing), cutoff (0 -> 5.5 sigma),\n"
+        "num_threads (default 1; 0 = all cores).\n"
+        "Returns dict(velocity (nx,ny,nz,3), mesh_shape, near_interactions).");
+
+  // Fused interior velocity + vorticity (no full-grid temporaries); options mirror InteriorFieldOptions.
+  m.def("biot_savart_interior_velocity_vorticity",
+        [](py::array_t<double, py::array::c_style | py::array::forcecast> polyline,
+           const Vec3& origin,
+           double spacing,
+           const std::array<int, 3>& shape,
+           int margin,
+           double circulation,
+           py::dict options)
+        {
+          InteriorFieldOptions opt;
+          if (options.contains("vorticity")) opt.vorticity = vorticity_scheme_from_name(py::cast<std::string>(options["vorticity"]));
+          if (options.contains("particle_mesh")) opt.particle_mesh = py::cast<bool>(options["particle_mesh"]);
+          if (options.contains("num_threads")) opt.num_threads = py::cast<std::size_t>(options["num_threads"]);
+
+          RegularGrid3D grid;
+          grid.origin = origin;
+          grid.spacing = spacing;
+          grid.shape = shape;
+          InteriorFieldResult r = BiotSavart::computeInteriorVelocityVorticity(
+              to_vec3_list(polyline), grid, margin, circulation, opt);
+
+          auto pack = [&](const std::vector<Vec3>& f) {
+            py::array_t<double> a({(py::ssize_t)r.shape[0], (py::ssize_t)r.shape[1], (py::ssize_t)r.shape[2], (py::ssize_t)3});
+            double* o = a.mutable_data();
+            for (std::size_t i = 0; i < f.size(); ++i) {
+              o[3 * i] = f[i][0];
+              o[3 * i + 1] = f[i][1];
+              o[3 * i + 2] = f[i][2];
+            }
+            return a;
+          };
+          py::dict out;
+          out["velocity"] = pack(r.velocity);
+          out["vorticity"] = pack(r.vorticity);
+          out["vorticity_scheme"] = vorticity_scheme_name(opt.vorticity);
+          return out;
+        },
+        py::arg("polyline"), py::arg("origin"), py::arg("spacing"), py::arg("shape"), py::arg("margin"),
+        py::arg("circulation") = 1.0, py::arg("options") = py::dict(),
+        "Velocity and vorticity at the interior nodes (margin from every face) of the regular grid\n"
+        "origin + spacing * (i, j, k), without full-grid temporaries.\n"
+        "options: vorticity ('central' | 'analytic'), particle_mesh (False, central only),\n"
+        "num_threads (default 1; 0 = all cores).\n"
+        "Returns dict(velocity, vorticity (each (nx-2m, ny-2m, nz-2m, 3)), vorticity_scheme).");
+
   // Drop-in aliases matching trefoil_closure/sst_core.pybind module (same names and semantics).
   m.def(
       "calculate_neumann_self_energy",
@@ -140,7 +338,8 @@ void bind_biot_savart(py::module_& m) {
       [](py::array_t<double, py::array::c_style | py::array::forcecast> points,
          py::array_t<double, py::array::c_style | py::array::forcecast> tangents,
          py::array_t<double, py::array::c_style | py::array::forcecast> ds_arr,
-         py::array_t<double, py::array::c_style | py::array::forcecast> a_values) {
+         py::array_t<double, py::array::c_style | py::array::forcecast> a_values,
+         std::size_t num_threads) {
         auto pp = points.unchecked<2>();
         auto tt = tangents.unchecked<2>();
         auto ds = ds_arr.unchecked<1>();
@@ -154,7 +353,8 @@ void bind_biot_savart(py::module_& m) {
           throw std::runtime_error("calculate_bs_cutoff_energy_scan: points/tangents must have shape (N, 3)");
         }
         std::vector<double> out = sst::bs_cutoff_energy_scan(
-            &pp(0, 0), &tt(0, 0), &ds(0), static_cast<std::size_t>(n), &aa(0), static_cast<std::size_t>(m));
+            &pp(0, 0), &tt(0, 0), &ds(0), static_cast<std::size_t>(n), &aa(0), static_cast<std::size_t>(m),
+            num_threads);
         py::array_t<double> numpy_out(m);
         auto e = numpy_out.mutable_unchecked<1>();
         for (py::ssize_t k = 0; k < m; ++k) {
@@ -166,14 +366,17 @@ void bind_biot_savart(py::module_& m) {
       py::arg("tangents"),
       py::arg("ds_arr"),
       py::arg("a_values"),
-      "Accumulate a whole cutoff scan in one C++ pass (same kernel as trefoil_closure/sst_core.cpp).");
+      py::arg("num_threads") = 1,
+      "Accumulate a whole cutoff scan in one C++ pass (same kernel as trefoil_closure/sst_core.cpp).\n"
+      "num_threads: workers over the pair sweep (default 1; 0 = all cores); the result does not depend on it.");
 
   m.def(
       "calculate_bs_cutoff_energy",
       [](py::array_t<double, py::array::c_style | py::array::forcecast> points,
          py::array_t<double, py::array::c_style | py::array::forcecast> tangents,
          py::array_t<double, py::array::c_style | py::array::forcecast> ds_arr,
-         double a_cutoff) {
+         double a_cutoff,
+         std::size_t num_threads) {
         auto pp = points.unchecked<2>();
         auto tt = tangents.unchecked<2>();
         auto ds = ds_arr.unchecked<1>();
@@ -186,12 +389,13 @@ void bind_biot_savart(py::module_& m) {
         }
         double aone = a_cutoff;
         std::vector<double> out = sst::bs_cutoff_energy_scan(
-            &pp(0, 0), &tt(0, 0), &ds(0), static_cast<std::size_t>(n), &aone, 1);
+            &pp(0, 0), &tt(0, 0), &ds(0), static_cast<std::size_t>(n), &aone, 1, num_threads);
         return out[0];
       },
       py::arg("points"),
       py::arg("tangents"),
       py::arg("ds_arr"),
       py::arg("a_cutoff"),
-      "Single-cutoff Biot–Savart energy for closure scans.");
+      py::arg("num_threads") = 1,
+      "Single-cutoff Biot–Savart energy for closure scans (num_threads as calculate_bs_cutoff_energy_scan).");
 }
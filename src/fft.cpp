@@ -0,0 +1,141 @@
+// fft.cpp — recursive decimation-in-time mixed-radix FFT (radix-4/2 butterflies, generic
+// butterflies for odd factors), plus a line-parallel 3-D driver.
+#include "fft.h"
+
+#include "parallel_for.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sst {
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+constexpr std::size_t kLineTasks = 64;
+
+}  // namespace
+
+FFTPlan::FFTPlan(std::size_t n) : n_(n) {
+    if (n_ == 0) return;
+    std::size_t rest = n_;
+    while (rest % 4 == 0) { factors_.push_back(4); rest /= 4; }
+    while (rest % 2 == 0) { factors_.push_back(2); rest /= 2; }
+    for (std::size_t p = 3; rest > 1; p += 2) {
+        if (p * p > rest) p = rest;
+        while (rest % p == 0) { factors_.push_back(p); rest /= p; }
+    }
+    twiddles_.resize(n_);
+    for (std::size_t k = 0; k < n_; ++k) {
+        const double phase = -kTwoPi * static_cast<double>(k) / static_cast<double>(n_);
+        twiddles_[k] = Complex(std::cos(phase), std::sin(phase));
+    }
+}
+
+void FFTPlan::work(Complex* out, const Complex* in, std::size_t fstride, std::size_t in_stride,
+                   std::size_t stage, Complex* scratch) const {
+    const std::size_t p = factors_[stage];
+    const std::size_t m = n_ / (fstride * p);
+    if (m == 1) {
+        for (std::size_t j = 0; j < p; ++j) out[j] = in[j * fstride * in_stride];
+    } else {
+        for (std::size_t q = 0; q < p; ++q) {
+            work(out + q * m, in + q * fstride * in_stride, fstride * p, in_stride, stage + 1, scratch);
+        }
+    }
+
+    const Complex* tw = twiddles_.data();
+    if (p == 2) {
+        for (std::size_t u = 0; u < m; ++u) {
+            const Complex t = out[u + m] * tw[u * fstride];
+            out[u + m] = out[u] - t;
+            out[u] += t;
+        }
+    } else if (p == 4) {
+        for (std::size_t k = 0; k < m; ++k) {
+            const Complex s0 = out[k + m] * tw[k * fstride];
+            const Complex s1 = out[k + 2 * m] * tw[2 * k * fstride];
+            const Complex s2 = out[k + 3 * m] * tw[3 * k * fstride];
+            const Complex s5 = out[k] - s1;
+            const Complex a = out[k] + s1;
+            const Complex s3 = s0 + s2;
+            const Complex s4 = s0 - s2;
+            out[k + 2 * m] = a - s3;
+            out[k] = a + s3;
+            out[k + m] = Complex(s5.real() + s4.imag(), s5.imag() - s4.real());
+            out[k + 3 * m] = Complex(s5.real() - s4.imag(), s5.imag() + s4.real());
+        }
+    } else {
+        for (std::size_t u = 0; u < m; ++u) {
+            for (std::size_t q = 0; q < p; ++q) scratch[q] = out[u + q * m];
+            for (std::size_t q1 = 0; q1 < p; ++q1) {
+                const std::size_t k = u + q1 * m;
+                std::size_t twidx = 0;
+                Complex acc = scratch[0];
+                for (std::size_t q = 1; q < p; ++q) {
+                    twidx += fstride * k;
+                    if (twidx >= n_) twidx -= n_;
+                    acc += scratch[q] * tw[twidx];
+                }
+                out[k] = acc;
+            }
+        }
+    }
+}
+
+void FFTPlan::forward(Complex* data) const {
+    if (n_ <= 1) return;
+    const std::vector<Complex> in(data, data + n_);
+    std::vector<Complex> scratch(*std::max_element(factors_.begin(), factors_.end()));
+    work(data, in.data(), 1, 1, 0, scratch.data());
+}
+
+void FFTPlan::inverse(Complex* data) const {
+    for (std::size_t k = 0; k < n_; ++k) data[k] = std::conj(data[k]);
+    forward(data);
+    for (std::size_t k = 0; k < n_; ++k) data[k] = std::conj(data[k]);
+}
+
+std::size_t fft_good_size(std::size_t n) {
+    if (n <= 1) return 1;
+    std::size_t best = 1;
+    while (best < n) best *= 2;
+    for (std::size_t p5 = 1; p5 < best; p5 *= 5) {
+        for (std::size_t p35 = p5; p35 < best; p35 *= 3) {
+            std::size_t v = p35;
+            while (v < n) v *= 2;
+            best = std::min(best, v);
+        }
+    }
+    return best;
+}
+
+void fft3d(std::vector<Complex>& data, const std::array<std::size_t, 3>& shape, bool inverse,
+           std::size_t num_threads) {
+    for (int axis = 2; axis >= 0; --axis) {
+        const std::size_t n = shape[static_cast<std::size_t>(axis)];
+        if (n <= 1) continue;
+        const FFTPlan plan(n);
+        std::size_t inner = 1;
+        for (int a = axis + 1; a < 3; ++a) inner *= shape[static_cast<std::size_t>(a)];
+        const std::size_t lines = data.size() / n;
+        const std::size_t tasks = std::min(kLineTasks, lines);
+
+        parallel_for(tasks, num_threads, [&](std::size_t task) {
+            std::vector<Complex> line(n);
+            const std::size_t l0 = lines * task / tasks;
+            const std::size_t l1 = lines * (task + 1) / tasks;
+            for (std::size_t l = l0; l < l1; ++l) {
+                const std::size_t base = (l / inner) * n * inner + (l % inner);
+                if (inner == 1) {
+                    inverse ? plan.inverse(&data[base]) : plan.forward(&data[base]);
+                    continue;
+                }
+                for (std::size_t j = 0; j < n; ++j) line[j] = data[base + j * inner];
+                inverse ? plan.inverse(line.data()) : plan.forward(line.data());
+                for (std::size_t j = 0; j < n; ++j) data[base + j * inner] = line[j];
+            }
+        });
+    }
+}
+
+}  // namespace sst
@@ -0,0 +1,45 @@
+#ifndef SSTCORE_FFT_H
+#define SSTCORE_FFT_H
+
+// fft.h — small in-tree complex FFT (mixed radix: 4, 2, 3, 5 and generic odd factors).
+// Forward uses e^{-2πi jk/n}; neither direction normalises (inverse(forward(x)) = n x).
+#pragma once
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace sst {
+
+using Complex = std::complex<double>;
+
+class FFTPlan {
+public:
+    explicit FFTPlan(std::size_t n);
+
+    std::size_t size() const { return n_; }
+    // In-place transforms of n contiguous values.
+    void forward(Complex* data) const;
+    void inverse(Complex* data) const;
+
+private:
+    void work(Complex* out, const Complex* in, std::size_t fstride, std::size_t in_stride,
+              std::size_t stage, Complex* scratch) const;
+
+    std::size_t n_ = 0;
+    std::vector<std::size_t> factors_;  // radix per stage, outermost first
+    std::vector<Complex> twiddles_;     // e^{-2πi k/n}, k = 0..n-1
+};
+
+// Smallest 2^a 3^b 5^c >= n (fast sizes for padded meshes).
+std::size_t fft_good_size(std::size_t n);
+
+// In-place 3-D transform of a row-major (shape[0], shape[1], shape[2]) array; lines of each axis
+// are distributed over num_threads workers (0 = hardware concurrency).
+void fft3d(std::vector<Complex>& data, const std::array<std::size_t, 3>& shape, bool inverse,
+           std::size_t num_threads = 0);
+
+}  // namespace sst
+
+#endif  // SSTCORE_FFT_H
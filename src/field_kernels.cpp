@@ -1,6 +1,391 @@
 //
 // Created by omar.iskandarani on 8/12/2025.
 //
-// field_kernels.cpp — implementations are header-inlined for performance.
-// This TU keeps the project structure consistent.
+// field_kernels.cpp — runtime ISA dispatch for the FieldKernels grid loops.
+// Scalar reference loops stay header-inlined in field_kernels.h; the SIMD bodies live in
+// field_kernels_simd.h and are instantiated here once per instruction set with function-level
+// target attributes, so the default (deterministic, no -march) build carries all variants.
 #include "field_kernels.h"
+#include "parallel_for.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SST_FK_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+namespace sst {
+namespace {
+
+constexpr double kPi = 3.1415926535897932384626433832795;
+
+// Structure-of-arrays sources shared by all ISA variants.
+struct WireSegments {
+    std::vector<double> mx, my, mz, dx, dy, dz;  // dx.. pre-scaled by factor in the fast variant
+    double factor = 0.0;
+    double eps = 1e-12;
+};
+
+struct DipoleSources {
+    std::vector<double> px, py, pz, mx, my, mz;
+    double K = 1.0 / (4.0 * kPi);
+    double eps = 1e-12;
+};
+
+// Below this many source-point pairs all tiles run on the calling thread.
+constexpr std::size_t kMinParallelPairs = std::size_t{1} << 16;
+
+// Runs block(g0, g1, s0, s1) over grid tiles x source blocks. Grid tiles are distributed over
+// the workers; inside a tile the source blocks are visited in ascending order, so every grid
+// point sees the same accumulation sequence as the untiled loop.
+template <typename Block>
+void run_tiled(std::size_t n_grid, std::size_t n_src, const FieldKernelOptions& options, Block&& block) {
+    if (n_grid == 0 || n_src == 0) return;
+    const std::size_t grid_tile = (std::max<std::size_t>(1, options.grid_tile) + 7) / 8 * 8;
+    const std::size_t source_tile = std::max<std::size_t>(1, options.source_tile);
+    const std::size_t n_tiles = (n_grid + grid_tile - 1) / grid_tile;
+    const std::size_t threads = n_grid * n_src < kMinParallelPairs ? 1 : options.num_threads;
+    parallel_for(n_tiles, threads, [&](std::size_t t) {
+        const std::size_t g0 = t * grid_tile;
+        const std::size_t g1 = std::min(n_grid, g0 + grid_tile);
+        for (std::size_t s0 = 0; s0 < n_src; s0 += source_tile) {
+            block(g0, g1, s0, std::min(n_src, s0 + source_tile));
+        }
+    });
+}
+
+#if SST_FK_X86
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SST_FK_ATTR(isa) __attribute__((target(isa)))
+#define SST_FK_INLINE __attribute__((always_inline)) inline
+// Keeps a product out of FMA contraction in the reproducible variant.
+#define SST_FK_OPAQUE(v) __asm__("" : "+x"(v))
+#else
+#define SST_FK_ATTR(isa)
+#define SST_FK_INLINE __forceinline
+#define SST_FK_OPAQUE(v) ((void)0)  // MSVC never contracts intrinsics
+#endif
+
+namespace sse2 {
+
+struct Ops {
+    using V = __m128d;
+    static constexpr std::size_t W = 2;
+    static SST_FK_INLINE V set1(double a) { return _mm_set1_pd(a); }
+    static SST_FK_INLINE V load(const double* p, std::size_t lanes) {
+        if (lanes == W) return _mm_loadu_pd(p);
+        alignas(16) double tmp[W] = {};
+        std::memcpy(tmp, p, lanes * sizeof(double));
+        return _mm_load_pd(tmp);
+    }
+    static SST_FK_INLINE void store(double* p, V v, std::size_t lanes) {
+        if (lanes == W) {
+            _mm_storeu_pd(p, v);
+        } else {
+            alignas(16) double tmp[W];
+            _mm_store_pd(tmp, v);
+            std::memcpy(p, tmp, lanes * sizeof(double));
+        }
+    }
+    static SST_FK_INLINE V add(V a, V b) { return _mm_add_pd(a, b); }
+    static SST_FK_INLINE V sub(V a, V b) { return _mm_sub_pd(a, b); }
+    static SST_FK_INLINE V mul(V a, V b) { return _mm_mul_pd(a, b); }
+    static SST_FK_INLINE V div(V a, V b) { return _mm_div_pd(a, b); }
+    static SST_FK_INLINE V sqrt(V a) { return _mm_sqrt_pd(a); }
+    static SST_FK_INLINE V product(V a, V b) {
+        V p = _mm_mul_pd(a, b);
+        SST_FK_OPAQUE(p);
+        return p;
+    }
+    static SST_FK_INLINE V fmadd(V a, V b, V c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    static SST_FK_INLINE V fmsub(V a, V b, V c) { return _mm_sub_pd(_mm_mul_pd(a, b), c); }
+    static SST_FK_INLINE V lt(V a, V b) { return _mm_cmplt_pd(a, b); }
+    // mask ? if_true : if_false
+    static SST_FK_INLINE V select(V mask, V if_true, V if_false) {
+        return _mm_or_pd(_mm_and_pd(mask, if_true), _mm_andnot_pd(mask, if_false));
+    }
+};
+
+}  // namespace sse2
+
+#define SST_FK_NS sse2
+#define SST_FK_TARGET
+#include "field_kernels_simd.h"
+#undef SST_FK_NS
+#undef SST_FK_TARGET
+
+namespace avx2 {
+
+#define SST_FK_AVX2 SST_FK_ATTR("avx2,fma")
+
+struct Ops {
+    using V = __m256d;
+    static constexpr std::size_t W = 4;
+    static SST_FK_AVX2 SST_FK_INLINE V set1(double a) { return _mm256_set1_pd(a); }
+    static SST_FK_AVX2 SST_FK_INLINE V load(const double* p, std::size_t lanes) {
+        if (lanes == W) return _mm256_loadu_pd(p);
+        alignas(32) double tmp[W] = {};
+        std::memcpy(tmp, p, lanes * sizeof(double));
+        return _mm256_load_pd(tmp);
+    }
+    static SST_FK_AVX2 SST_FK_INLINE void store(double* p, V v, std::size_t lanes) {
+        if (lanes == W) {
+            _mm256_storeu_pd(p, v);
+        } else {
+            alignas(32) double tmp[W];
+            _mm256_store_pd(tmp, v);
+            std::memcpy(p, tmp, lanes * sizeof(double));
+        }
+    }
+    static SST_FK_AVX2 SST_FK_INLINE V add(V a, V b) { return _mm256_add_pd(a, b); }
+    static SST_FK_AVX2 SST_FK_INLINE V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+    static SST_FK_AVX2 SST_FK_INLINE V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+    static SST_FK_AVX2 SST_FK_INLINE V div(V a, V b) { return _mm256_div_pd(a, b); }
+    static SST_FK_AVX2 SST_FK_INLINE V sqrt(V a) { return _mm256_sqrt_pd(a); }
+    static SST_FK_AVX2 SST_FK_INLINE V product(V a, V b) {
+        V p = _mm256_mul_pd(a, b);
+        SST_FK_OPAQUE(p);
+        return p;
+    }
+    static SST_FK_AVX2 SST_FK_INLINE V fmadd(V a, V b, V c) { return _mm256_fmadd_pd(a, b, c); }
+    static SST_FK_AVX2 SST_FK_INLINE V fmsub(V a, V b, V c) { return _mm256_fmsub_pd(a, b, c); }
+    static SST_FK_AVX2 SST_FK_INLINE V lt(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static SST_FK_AVX2 SST_FK_INLINE V select(V mask, V if_true, V if_false) {
+        return _mm256_blendv_pd(if_false, if_true, mask);
+    }
+};
+
+}  // namespace avx2
+
+#define SST_FK_NS avx2
+#define SST_FK_TARGET SST_FK_AVX2
+#include "field_kernels_simd.h"
+#undef SST_FK_NS
+#undef SST_FK_TARGET
+
+namespace avx512 {
+
+#define SST_FK_AVX512 SST_FK_ATTR("avx512f")
+
+struct Ops {
+    using V = __m512d;
+    static constexpr std::size_t W = 8;
+    static SST_FK_AVX512 SST_FK_INLINE V set1(double a) { return _mm512_set1_pd(a); }
+    static SST_FK_AVX512 SST_FK_INLINE V load(const double* p, std::size_t lanes) {
+        if (lanes == W) return _mm512_loadu_pd(p);
+        return _mm512_maskz_loadu_pd(static_cast<__mmask8>((1u << lanes) - 1u), p);
+    }
+    static SST_FK_AVX512 SST_FK_INLINE void store(double* p, V v, std::size_t lanes) {
+        if (lanes == W) {
+            _mm512_storeu_pd(p, v);
+        } else {
+            _mm512_mask_storeu_pd(p, static_cast<__mmask8>((1u << lanes) - 1u), v);
+        }
+    }
+    static SST_FK_AVX512 SST_FK_INLINE V add(V a, V b) { return _mm512_add_pd(a, b); }
+    static SST_FK_AVX512 SST_FK_INLINE V sub(V a, V b) { return _mm512_sub_pd(a, b); }
+    static SST_FK_AVX512 SST_FK_INLINE V mul(V a, V b) { return _mm512_mul_pd(a, b); }
+    static SST_FK_AVX512 SST_FK_INLINE V div(V a, V b) { return _mm512_div_pd(a, b); }
+    // Full-mask form with a defined pass-through: GCC's _mm512_sqrt_pd hands the builtin an
+    // _mm512_undefined_pd() operand, which trips -Wmaybe-uninitialized at -O2.
+    static SST_FK_AVX512 SST_FK_INLINE V sqrt(V a) { return _mm512_mask_sqrt_pd(a, static_cast<__mmask8>(0xFF), a); }
+    static SST_FK_AVX512 SST_FK_INLINE V product(V a, V b) {
+        V p = _mm512_mul_pd(a, b);
+        SST_FK_OPAQUE(p);
+        return p;
+    }
+    static SST_FK_AVX512 SST_FK_INLINE V fmadd(V a, V b, V c) { return _mm512_fmadd_pd(a, b, c); }
+    static SST_FK_AVX512 SST_FK_INLINE V fmsub(V a, V b, V c) { return _mm512_fmsub_pd(a, b, c); }
+    static SST_FK_AVX512 SST_FK_INLINE __mmask8 lt(V a, V b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static SST_FK_AVX512 SST_FK_INLINE V select(__mmask8 mask, V if_true, V if_false) {
+        return _mm512_mask_blend_pd(mask, if_false, if_true);
+    }
+};
+
+}  // namespace avx512
+
+#define SST_FK_NS avx512
+#define SST_FK_TARGET SST_FK_AVX512
+#include "field_kernels_simd.h"
+#undef SST_FK_NS
+#undef SST_FK_TARGET
+
+FieldKernelIsa detect_cpu_isa() {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return FieldKernelIsa::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return FieldKernelIsa::AVX2;
+    return FieldKernelIsa::SSE2;
+#else
+    int r1[4] = {}, r7[4] = {};
+    __cpuid(r1, 1);
+    const bool osxsave = (r1[2] & (1 << 27)) != 0;
+    const bool avx = (r1[2] & (1 << 28)) != 0;
+    const bool fma = (r1[2] & (1 << 12)) != 0;
+    if (!osxsave || !avx) return FieldKernelIsa::SSE2;
+    const unsigned long long xcr0 = _xgetbv(0);
+    if ((xcr0 & 0x6) != 0x6) return FieldKernelIsa::SSE2;
+    __cpuidex(r7, 7, 0);
+    if ((r7[1] & (1 << 16)) != 0 && (xcr0 & 0xE6) == 0xE6) return FieldKernelIsa::AVX512;
+    if ((r7[1] & (1 << 5)) != 0 && fma) return FieldKernelIsa::AVX2;
+    return FieldKernelIsa::SSE2;
+#endif
+}
+
+#else
+
+FieldKernelIsa detect_cpu_isa() { return FieldKernelIsa::Scalar; }
+
+#endif  // SST_FK_X86
+
+int isa_rank(FieldKernelIsa isa) {
+    switch (isa) {
+        case FieldKernelIsa::SSE2: return 1;
+        case FieldKernelIsa::AVX2: return 2;
+        case FieldKernelIsa::AVX512: return 3;
+        default: return 0;
+    }
+}
+
+}  // namespace
+
+FieldKernelIsa FieldKernels::detected_isa() {
+    static const FieldKernelIsa isa = detect_cpu_isa();
+    return isa;
+}
+
+FieldKernelIsa FieldKernels::resolve_isa(FieldKernelIsa requested) {
+    const FieldKernelIsa best = detected_isa();
+    if (requested == FieldKernelIsa::Auto) return best;
+    return isa_rank(requested) <= isa_rank(best) ? requested : best;
+}
+
+const char* FieldKernels::isa_name(FieldKernelIsa isa) {
+    switch (isa) {
+        case FieldKernelIsa::Auto: return "auto";
+        case FieldKernelIsa::SSE2: return "sse2";
+        case FieldKernelIsa::AVX2: return "avx2";
+        case FieldKernelIsa::AVX512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+FieldKernelIsa FieldKernels::isa_from_name(const std::string& name) {
+    if (name == "auto") return FieldKernelIsa::Auto;
+    if (name == "scalar") return FieldKernelIsa::Scalar;
+    if (name == "sse2") return FieldKernelIsa::SSE2;
+    if (name == "avx2") return FieldKernelIsa::AVX2;
+    if (name == "avx512" || name == "avx512f") return FieldKernelIsa::AVX512;
+    throw std::invalid_argument("unknown field kernel ISA: " + name);
+}
+
+void FieldKernels::biot_savart_wire_grid(const double* X,
+                                         const double* Y,
+                                         const double* Z,
+                                         std::size_t n_grid,
+                                         const std::vector<Vec3>& wire_points,
+                                         double current,
+                                         double* Bx,
+                                         double* By,
+                                         double* Bz,
+                                         const FieldKernelOptions& options)
+{
+    if (wire_points.size() < 2) return;
+    const std::size_t S = wire_points.size() - 1;
+    const FieldKernelIsa isa = resolve_isa(options.isa);
+    if (isa == FieldKernelIsa::Scalar) {
+        // The reference loop is segment-outer; tiling the grid keeps its B block cache-resident.
+        FieldKernelOptions whole = options;
+        whole.source_tile = S;
+        run_tiled(n_grid, S, whole, [&](std::size_t g0, std::size_t g1, std::size_t, std::size_t) {
+            biot_savart_wire_grid_reference(X + g0, Y + g0, Z + g0, g1 - g0, wire_points, current,
+                                            Bx + g0, By + g0, Bz + g0);
+        });
+        return;
+    }
+#if SST_FK_X86
+    WireSegments seg;
+    seg.factor = (1.0 / (4.0 * kPi)) * current;
+    const double scale = options.reproducible ? 1.0 : seg.factor;
+    for (auto* v : {&seg.mx, &seg.my, &seg.mz, &seg.dx, &seg.dy, &seg.dz}) v->resize(S);
+    for (std::size_t i = 0; i < S; ++i) {
+        const Vec3& p0 = wire_points[i];
+        const Vec3& p1 = wire_points[i+1];
+        seg.mx[i] = 0.5*(p0[0]+p1[0]);
+        seg.my[i] = 0.5*(p0[1]+p1[1]);
+        seg.mz[i] = 0.5*(p0[2]+p1[2]);
+        seg.dx[i] = (p1[0]-p0[0]) * scale;
+        seg.dy[i] = (p1[1]-p0[1]) * scale;
+        seg.dz[i] = (p1[2]-p0[2]) * scale;
+    }
+    using Kernel = void (*)(const double*, const double*, const double*, std::size_t, const WireSegments&,
+                            std::size_t, std::size_t, double*, double*, double*);
+    const bool fast = !options.reproducible;
+    Kernel kernel = nullptr;
+    switch (isa) {
+        case FieldKernelIsa::AVX512: kernel = fast ? avx512::wire_grid<true> : avx512::wire_grid<false>; break;
+        case FieldKernelIsa::AVX2:   kernel = fast ? avx2::wire_grid<true> : avx2::wire_grid<false>; break;
+        default:                     kernel = fast ? sse2::wire_grid<true> : sse2::wire_grid<false>; break;
+    }
+    run_tiled(n_grid, S, options, [&](std::size_t g0, std::size_t g1, std::size_t s0, std::size_t s1) {
+        kernel(X + g0, Y + g0, Z + g0, g1 - g0, seg, s0, s1, Bx + g0, By + g0, Bz + g0);
+    });
+#endif
+}
+
+void FieldKernels::dipole_ring_field_grid(const double* X,
+                                          const double* Y,
+                                          const double* Z,
+                                          std::size_t n_grid,
+                                          const std::vector<Vec3>& positions,
+                                          const std::vector<Vec3>& moments,
+                                          double* Bx,
+                                          double* By,
+                                          double* Bz,
+                                          const FieldKernelOptions& options)
+{
+    const std::size_t M = std::min(positions.size(), moments.size());
+    const FieldKernelIsa isa = resolve_isa(options.isa);
+    if (isa == FieldKernelIsa::Scalar) {
+        FieldKernelOptions whole = options;
+        whole.source_tile = M;
+        run_tiled(n_grid, M, whole, [&](std::size_t g0, std::size_t g1, std::size_t, std::size_t) {
+            dipole_ring_field_grid_reference(X + g0, Y + g0, Z + g0, g1 - g0, positions, moments,
+                                             Bx + g0, By + g0, Bz + g0);
+        });
+        return;
+    }
+#if SST_FK_X86
+    DipoleSources src;
+    for (auto* v : {&src.px, &src.py, &src.pz, &src.mx, &src.my, &src.mz}) v->resize(M);
+    for (std::size_t d = 0; d < M; ++d) {
+        src.px[d] = positions[d][0];
+        src.py[d] = positions[d][1];
+        src.pz[d] = positions[d][2];
+        src.mx[d] = moments[d][0];
+        src.my[d] = moments[d][1];
+        src.mz[d] = moments[d][2];
+    }
+    using Kernel = void (*)(const double*, const double*, const double*, std::size_t, const DipoleSources&,
+                            std::size_t, std::size_t, double*, double*, double*);
+    const bool fast = !options.reproducible;
+    Kernel kernel = nullptr;
+    switch (isa) {
+        case FieldKernelIsa::AVX512: kernel = fast ? avx512::dipole_grid<true> : avx512::dipole_grid<false>; break;
+        case FieldKernelIsa::AVX2:   kernel = fast ? avx2::dipole_grid<true> : avx2::dipole_grid<false>; break;
+        default:                     kernel = fast ? sse2::dipole_grid<true> : sse2::dipole_grid<false>; break;
+    }
+    run_tiled(n_grid, M, options, [&](std::size_t g0, std::size_t g1, std::size_t s0, std::size_t s1) {
+        kernel(X + g0, Y + g0, Z + g0, g1 - g0, src, s0, s1, Bx + g0, By + g0, Bz + g0);
+    });
+#endif
+}
+
+} // namespace sst
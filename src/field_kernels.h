@@ -9,15 +9,102 @@
 // Units: mu0 = 1, so factor = 1/(4π).
 #pragma once
 #include "sst/types.h"
+#include "sstcore_version.h"
 #include <vector>
 #include <cstddef>
 #include <cmath>
 #include <algorithm>
+#include <string>
+#include <string_view>
 
 namespace sst {
 
+// Instruction set used by the grid kernels. Auto picks the widest one the CPU reports at runtime.
+enum class FieldKernelIsa { Auto, Scalar, SSE2, AVX2, AVX512 };
+
+// Reproducible: every SIMD lane performs exactly the scalar reference sequence (no FMA, no
+// reciprocal estimates), so results are bitwise identical for any ISA. Default on in the
+// deterministic numeric profile; the fast profile uses FMA and one sqrt + one divide per pair.
+inline constexpr bool kFieldKernelsReproducibleDefault =
+    std::string_view(SSTCORE_NUMERIC_PROFILE) != std::string_view("fast");
+
+// Grid kernels run over grid tiles x source blocks; tiles are spread over num_threads workers
+// (0 = hardware concurrency; the default stays serial so callers that parallelise outside are
+// not oversubscribed). Every grid point still sums its sources in reference order, so the
+// output does not depend on the thread count or tile sizes.
+struct FieldKernelOptions {
+    FieldKernelIsa isa = FieldKernelIsa::Auto;
+    bool reproducible = kFieldKernelsReproducibleDefault;
+    std::size_t num_threads = 1;
+    std::size_t grid_tile = 1024;   // grid points per tile (rounded up to 8 lanes)
+    std::size_t source_tile = 256;  // segments / dipoles per inner block
+};
+
+// Far-field acceleration of dipole_ring_field_grid: Barnes–Hut octree over the dipole positions
+// with quadrupole-order Cartesian moments of m; leaves use dipole_field_at_point. Same accuracy
+// knobs as the Biot–Savart treecode (BiotSavartOptions).
+struct DipoleTreecodeOptions {
+    // Opening angle: a cluster of radius rho at distance d is expanded when rho < theta * d.
+    double theta = 0.5;
+    // Absolute per-component field tolerance (> 0 adds the per-cluster error-bound test).
+    double tolerance = 0.0;
+    std::size_t leaf_size = 16;     // maximum dipoles per octree leaf
+    std::size_t num_threads = 1;    // workers over grid tiles (0 = hardware concurrency)
+    std::size_t grid_tile = 1024;
+};
+
+struct DipoleTreecodeStats {
+    // Upper estimate of max_g |B_tree(g) - B_direct(g)| per component.
+    double error_estimate = 0.0;
+    std::size_t direct_interactions = 0;
+    std::size_t cluster_interactions = 0;
+};
+
 class FieldKernels {
 public:
+    // Widest ISA supported by both this build and the running CPU.
+    static FieldKernelIsa detected_isa();
+    // Auto -> detected_isa(); requests above detected_isa() are clamped down to it.
+    static FieldKernelIsa resolve_isa(FieldKernelIsa requested);
+    static const char* isa_name(FieldKernelIsa isa);
+    static FieldKernelIsa isa_from_name(const std::string& name);  // throws std::invalid_argument
+
+    // Runtime-dispatched grid kernels (same contract as the *_reference loops below).
+    static void biot_savart_wire_grid(const double* X,
+                                      const double* Y,
+                                      const double* Z,
+                                      std::size_t n_grid,
+                                      const std::vector<Vec3>& wire_points,
+                                      double current,
+                                      double* Bx,
+                                      double* By,
+                                      double* Bz,
+                                      const FieldKernelOptions& options = {});
+
+    static void dipole_ring_field_grid(const double* X,
+                                       const double* Y,
+                                       const double* Z,
+                                       std::size_t n_grid,
+                                       const std::vector<Vec3>& positions,
+                                       const std::vector<Vec3>& moments,
+                                       double* Bx,
+                                       double* By,
+                                       double* Bz,
+                                       const FieldKernelOptions& options = {});
+
+    // Treecode counterpart of dipole_ring_field_grid (accumulates into Bx, By, Bz likewise);
+    // dipole_ring_field_grid remains the exact reference. theta = 0 sums every dipole directly.
+    static DipoleTreecodeStats dipole_ring_field_grid_treecode(const double* X,
+                                                               const double* Y,
+                                                               const double* Z,
+                                                               std::size_t n_grid,
+                                                               const std::vector<Vec3>& positions,
+                                                               const std::vector<Vec3>& moments,
+                                                               double* Bx,
+                                                               double* By,
+                                                               double* Bz,
+                                                               const DipoleTreecodeOptions& options = {});
+
     // Analytical point dipole field:
     // B(r) = (1/(4π r^3)) [3 (m·r̂) r̂ - m], with mu0=1.
     static Vec3 dipole_field_at_point(const Vec3& r, const Vec3& m) {
@@ -31,29 +118,28 @@ public:
 
         // c = 3 (m·r̂) = 3 (m·r)/|r|
         const double mdotr = (m[0]*r[0] + m[1]*r[1] + m[2]*r[2]) / R;
-        const double c_over_R = 3.0 * mdotr / R;               // 3 (m·r̂)/|r|
-        // 3 (m·r̂) r̂ - m  == (c_over_R) * (r/|r|) - m == (c_over_R/R) * r - m
-        const double c_over_R2 = c_over_R / R;                 // 3 (m·r)/R^2
-        const Vec3 term { c_over_R2 * r[0] - m[0],
-                          c_over_R2 * r[1] - m[1],
-                          c_over_R2 * r[2] - m[2] };
+        const double c_over_R = 3.0 * mdotr / R;               // 3 (m·r̂)/|r| = 3 (m·r)/R^2
+        // 3 (m·r̂) r̂ - m  == (c_over_R) * r - m
+        const Vec3 term { c_over_R * r[0] - m[0],
+                          c_over_R * r[1] - m[1],
+                          c_over_R * r[2] - m[2] };
 
         const double invR3 = 1.0 / (R2 * R);
         return { K * term[0] * invR3, K * term[1] * invR3, K * term[2] * invR3 };
     }
 
-    // Biot–Savart over a polyline defined by wire_points[N,3] (midpoint rule).
+    // Scalar reference: Biot–Savart over a polyline defined by wire_points[N,3] (midpoint rule).
     // Inputs: flattened grid arrays X,Y,Z (length n_grid).
     // Output: accumulates into Bx,By,Bz (length n_grid).
-    static void biot_savart_wire_grid(const double* X,
-                                      const double* Y,
-                                      const double* Z,
-                                      std::size_t n_grid,
-                                      const std::vector<Vec3>& wire_points,
-                                      double current,
-                                      double* Bx,
-                                      double* By,
-                                      double* Bz)
+    static void biot_savart_wire_grid_reference(const double* X,
+                                                const double* Y,
+                                                const double* Z,
+                                                std::size_t n_grid,
+                                                const std::vector<Vec3>& wire_points,
+                                                double current,
+                                                double* Bx,
+                                                double* By,
+                                                double* Bz)
     {
         constexpr double PI = 3.1415926535897932384626433832795;
         constexpr double K  = 1.0 / (4.0 * PI);
@@ -92,15 +178,15 @@ public:
     }
 
     // Superposition of M point dipoles on grid.
-    static void dipole_ring_field_grid(const double* X,
-                                       const double* Y,
-                                       const double* Z,
-                                       std::size_t n_grid,
-                                       const std::vector<Vec3>& positions,
-                                       const std::vector<Vec3>& moments,
-                                       double* Bx,
-                                       double* By,
-                                       double* Bz)
+    static void dipole_ring_field_grid_reference(const double* X,
+                                                 const double* Y,
+                                                 const double* Z,
+                                                 std::size_t n_grid,
+                                                 const std::vector<Vec3>& positions,
+                                                 const std::vector<Vec3>& moments,
+                                                 double* Bx,
+                                                 double* By,
+                                                 double* Bz)
     {
         const std::size_t M = std::min(positions.size(), moments.size());
         for (std::size_t d = 0; d < M; ++d) {
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <stdexcept>
 #include <vector>
 #include <napi.h>
 #include "node_utils.h"
@@ -63,6 +64,26 @@ Napi::Object three_arrays(Napi::Env env, size_t n, double* bx, double* by, doubl
     return o;
 }
 
+// Optional trailing options object:
+// { isa?: 'auto'|'scalar'|'sse2'|'avx2'|'avx512', reproducible?: boolean, numThreads?: number }
+// (numThreads defaults to 1; 0 = all cores).
+sst::FieldKernelOptions read_kernel_options(const Napi::CallbackInfo& info, std::size_t index) {
+    sst::FieldKernelOptions opt;
+    if (info.Length() <= index || !info[index].IsObject()) return opt;
+    Napi::Object o = info[index].As<Napi::Object>();
+    if (o.Has("isa")) {
+        try {
+            opt.isa = FieldKernels::isa_from_name(o.Get("isa").As<Napi::String>().Utf8Value());
+        } catch (const std::invalid_argument& err) {
+            throw Napi::TypeError::New(info.Env(), err.what());
+        }
+    }
+    if (o.Has("reproducible")) opt.reproducible = o.Get("reproducible").As<Napi::Boolean>().Value();
+    if (o.Has("numThreads")) opt.num_threads = o.Get("numThreads").As<Napi::Number>().Uint32Value();
+    if (o.Has("num_threads")) opt.num_threads = o.Get("num_threads").As<Napi::Number>().Uint32Value();
+    return opt;
+}
+
 void read_xyz(const Napi::TypedArray& X, const Napi::TypedArray& Y, const Napi::TypedArray& Z,
               std::vector<double>& xv, std::vector<double>& yv, std::vector<double>& zv) {
     if (X.TypedArrayType() != napi_float64_array || Y.TypedArrayType() != napi_float64_array ||
@@ -108,7 +129,7 @@ void bind_field_kernels(Napi::Env env, Napi::Object exports) {
     exports.Set("biotSavartWireGrid", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
         Napi::Env e = info.Env();
         if (info.Length() < 4) {
-            throw Napi::TypeError::New(e, "Expected (X, Y, Z, wirePoints[, current])");
+            throw Napi::TypeError::New(e, "Expected (X, Y, Z, wirePoints[, current[, options]])");
         }
         std::vector<double> Xv, Yv, Zv;
         read_xyz(info[0].As<Napi::TypedArray>(), info[1].As<Napi::TypedArray>(), info[2].As<Napi::TypedArray>(),
@@ -119,18 +140,19 @@ void bind_field_kernels(Napi::Env env, Napi::Object exports) {
         } else {
             wire = js_typedarray_to_vec3_list(info[3].As<Napi::TypedArray>());
         }
-        double current = (info.Length() > 4) ? info[4].As<Napi::Number>().DoubleValue() : 1.0;
+        double current = (info.Length() > 4 && info[4].IsNumber()) ? info[4].As<Napi::Number>().DoubleValue() : 1.0;
+        const sst::FieldKernelOptions opt = read_kernel_options(info, 5);
         const size_t n_grid = Xv.size();
         std::vector<double> Bx(n_grid, 0.0), By(n_grid, 0.0), Bz(n_grid, 0.0);
         FieldKernels::biot_savart_wire_grid(Xv.data(), Yv.data(), Zv.data(), n_grid, wire, current, Bx.data(),
-                                           By.data(), Bz.data());
+                                           By.data(), Bz.data(), opt);
         return three_arrays(e, n_grid, Bx.data(), By.data(), Bz.data());
     }));
 
     exports.Set("dipoleRingFieldGrid", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
         Napi::Env e = info.Env();
         if (info.Length() < 5) {
-            throw Napi::TypeError::New(e, "Expected (X, Y, Z, positions, moments)");
+            throw Napi::TypeError::New(e, "Expected (X, Y, Z, positions, moments[, options])");
         }
         std::vector<double> Xv, Yv, Zv;
         read_xyz(info[0].As<Napi::TypedArray>(), info[1].As<Napi::TypedArray>(), info[2].As<Napi::TypedArray>(),
@@ -140,13 +162,49 @@ void bind_field_kernels(Napi::Env env, Napi::Object exports) {
         if (pos.size() != mom.size()) {
             throw Napi::TypeError::New(e, "positions and moments same length");
         }
+        const sst::FieldKernelOptions opt = read_kernel_options(info, 5);
         const size_t n_grid = Xv.size();
         std::vector<double> Bx(n_grid, 0.0), By(n_grid, 0.0), Bz(n_grid, 0.0);
         FieldKernels::dipole_ring_field_grid(Xv.data(), Yv.data(), Zv.data(), n_grid, pos, mom, Bx.data(), By.data(),
-                                             Bz.data());
+                                             Bz.data(), opt);
         return three_arrays(e, n_grid, Bx.data(), By.data(), Bz.data());
     }));
 
+    exports.Set("dipoleRingFieldGridTreecode", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
+        Napi::Env e = info.Env();
+        if (info.Length() < 5) {
+            throw Napi::TypeError::New(e, "Expected (X, Y, Z, positions, moments[, options])");
+        }
+        std::vector<double> Xv, Yv, Zv;
+        read_xyz(info[0].As<Napi::TypedArray>(), info[1].As<Napi::TypedArray>(), info[2].As<Napi::TypedArray>(),
+                 Xv, Yv, Zv);
+        std::vector<Vec3> pos = js_array_to_vec3_list(info[3].As<Napi::Array>());
+        std::vector<Vec3> mom = js_array_to_vec3_list(info[4].As<Napi::Array>());
+        if (pos.size() != mom.size()) {
+            throw Napi::TypeError::New(e, "positions and moments same length");
+        }
+        // Optional { theta?, tolerance?, leafSize?, numThreads? } (snake_case accepted).
+        sst::DipoleTreecodeOptions opt;
+        if (info.Length() > 5 && info[5].IsObject()) {
+            Napi::Object o = info[5].As<Napi::Object>();
+            if (o.Has("theta")) opt.theta = o.Get("theta").As<Napi::Number>().DoubleValue();
+            if (o.Has("tolerance")) opt.tolerance = o.Get("tolerance").As<Napi::Number>().DoubleValue();
+            if (o.Has("leafSize")) opt.leaf_size = o.Get("leafSize").As<Napi::Number>().Uint32Value();
+            if (o.Has("leaf_size")) opt.leaf_size = o.Get("leaf_size").As<Napi::Number>().Uint32Value();
+            if (o.Has("numThreads")) opt.num_threads = o.Get("numThreads").As<Napi::Number>().Uint32Value();
+            if (o.Has("num_threads")) opt.num_threads = o.Get("num_threads").As<Napi::Number>().Uint32Value();
+        }
+        const size_t n_grid = Xv.size();
+        std::vector<double> Bx(n_grid, 0.0), By(n_grid, 0.0), Bz(n_grid, 0.0);
+        const sst::DipoleTreecodeStats stats = FieldKernels::dipole_ring_field_grid_treecode(
+            Xv.data(), Yv.data(), Zv.data(), n_grid, pos, mom, Bx.data(), By.data(), Bz.data(), opt);
+        Napi::Object out = three_arrays(e, n_grid, Bx.data(), By.data(), Bz.data());
+        out.Set("errorEstimate", Napi::Number::New(e, stats.error_estimate));
+        out.Set("directInteractions", Napi::Number::New(e, static_cast<double>(stats.direct_interactions)));
+        out.Set("clusterInteractions", Napi::Number::New(e, static_cast<double>(stats.cluster_interactions)));
+        return out;
+    }));
+
     exports.Set("biotSavartVectorPotentialGrid", Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
         Napi::Env e = info.Env();
         if (info.Length() < 2) {
@@ -179,4 +237,5 @@ void bind_field_kernels(Napi::Env env, Napi::Object exports) {
     }));
 
     exports.Set("fieldKernelsAvailable", Napi::Boolean::New(env, true));
+    exports.Set("fieldKernelsIsa", Napi::String::New(env, FieldKernels::isa_name(FieldKernels::detected_isa())));
 }
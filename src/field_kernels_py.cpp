@@ -5,6 +5,7 @@
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 #include <algorithm>
+#include <string>
 
 #include "field_kernels.h"
 
@@ -45,11 +46,21 @@ static std::vector<Vec3> to_vec3_list(const py::array_t<double>& arr) {
     return out;
 }
 
+static sst::FieldKernelOptions kernel_options(const std::string& isa, const py::object& reproducible,
+                                              std::size_t num_threads) {
+    sst::FieldKernelOptions opt;
+    opt.isa = FieldKernels::isa_from_name(isa);
+    if (!reproducible.is_none()) opt.reproducible = py::cast<bool>(reproducible);
+    opt.num_threads = num_threads;
+    return opt;
+}
+
 static py::tuple biot_savart_wire_grid_np(py::array X,
                                           py::array Y,
                                           py::array Z,
                                           py::array wire_points,
-                                          double current)
+                                          double current,
+                                          const sst::FieldKernelOptions& opt)
 {
     require_same_shape(X, Y, Z);
     require_Nx3(wire_points, "wire_points");
@@ -83,15 +94,19 @@ static py::tuple biot_savart_wire_grid_np(py::array X,
     for (py::ssize_t i = 0; i < wp.shape(0); ++i)
         W.push_back(Vec3{wp(i,0), wp(i,1), wp(i,2)});
 
-    FieldKernels::biot_savart_wire_grid(Xp, Yp, Zp, n_grid, W, current, Bxp, Byp, Bzp);
+    FieldKernels::biot_savart_wire_grid(Xp, Yp, Zp, n_grid, W, current, Bxp, Byp, Bzp, opt);
     return py::make_tuple(bx, by, bz);
 }
 
-static py::tuple dipole_ring_field_grid_np(py::array X,
-                                           py::array Y,
-                                           py::array Z,
-                                           py::array positions,
-                                           py::array moments)
+// Shared marshalling for the dipole grid entry points; eval(X, Y, Z, n, pos, mom, Bx, By, Bz)
+// accumulates into the zeroed outputs.
+template <class Eval>
+static py::tuple dipole_grid_np(py::array X,
+                                py::array Y,
+                                py::array Z,
+                                py::array positions,
+                                py::array moments,
+                                Eval&& eval)
 {
     require_same_shape(X, Y, Z);
     require_Nx3(positions, "positions");
@@ -135,10 +150,25 @@ static py::tuple dipole_ring_field_grid_np(py::array X,
         mom.emplace_back(Vec3{Mu(i,0), Mu(i,1), Mu(i,2)});
     }
 
-    FieldKernels::dipole_ring_field_grid(Xp, Yp, Zp, n_grid, pos, mom, Bxp, Byp, Bzp);
+    eval(Xp, Yp, Zp, n_grid, pos, mom, Bxp, Byp, Bzp);
     return py::make_tuple(bx, by, bz);
 }
 
+static py::tuple dipole_ring_field_grid_np(py::array X,
+                                           py::array Y,
+                                           py::array Z,
+                                           py::array positions,
+                                           py::array moments,
+                                           const sst::FieldKernelOptions& opt)
+{
+    return dipole_grid_np(X, Y, Z, positions, moments,
+                          [&](const double* Xp, const double* Yp, const double* Zp, size_t n,
+                              const std::vector<Vec3>& pos, const std::vector<Vec3>& mom,
+                              double* Bxp, double* Byp, double* Bzp) {
+                              FieldKernels::dipole_ring_field_grid(Xp, Yp, Zp, n, pos, mom, Bxp, Byp, Bzp, opt);
+                          });
+}
+
 static void biot_savart_vector_potential(const double* X,
                                          const double* Y,
                                          const double* Z,
@@ -198,18 +228,62 @@ void bind_field_kernels(py::module_ &m) {
           R"pbdoc(Analytical point dipole field (mu0=1).)pbdoc");
 
     m.def("biot_savart_wire_grid",
-          [](py::array X, py::array Y, py::array Z, py::array wire_points, double current){
-              return biot_savart_wire_grid_np(X,Y,Z,wire_points,current);
+          [](py::array X, py::array Y, py::array Z, py::array wire_points, double current,
+             const std::string& isa, py::object reproducible, std::size_t num_threads){
+              return biot_savart_wire_grid_np(X,Y,Z,wire_points,current,kernel_options(isa, reproducible, num_threads));
           },
           py::arg("X"), py::arg("Y"), py::arg("Z"),
           py::arg("wire_points"), py::arg("current") = 1.0,
-          R"pbdoc(Biot–Savart of polyline on a 3D grid (midpoint per segment).)pbdoc");
+          py::arg("isa") = "auto", py::arg("reproducible") = py::none(), py::arg("num_threads") = 1,
+          R"pbdoc(Biot–Savart of polyline on a 3D grid (midpoint per segment).
+isa: 'auto' | 'scalar' | 'sse2' | 'avx2' | 'avx512' (clamped to the CPU).
+reproducible: bitwise-identical to the scalar loop (default: on in the deterministic profile).
+num_threads: workers over grid tiles (default 1, 0 = all cores); the result does not depend on it.)pbdoc");
 
     m.def("dipole_ring_field_grid",
-          &dipole_ring_field_grid_np,
+          [](py::array X, py::array Y, py::array Z, py::array positions, py::array moments,
+             const std::string& isa, py::object reproducible, std::size_t num_threads){
+              return dipole_ring_field_grid_np(X,Y,Z,positions,moments,kernel_options(isa, reproducible, num_threads));
+          },
+          py::arg("X"), py::arg("Y"), py::arg("Z"),
+          py::arg("positions"), py::arg("moments"),
+          py::arg("isa") = "auto", py::arg("reproducible") = py::none(), py::arg("num_threads") = 1,
+          R"pbdoc(Superposition of point dipoles on a 3D grid (isa / reproducible / num_threads as biot_savart_wire_grid).)pbdoc");
+
+    m.def("dipole_ring_field_grid_treecode",
+          [](py::array X, py::array Y, py::array Z, py::array positions, py::array moments,
+             double theta, double tolerance, std::size_t leaf_size, std::size_t num_threads){
+              sst::DipoleTreecodeOptions opt;
+              opt.theta = theta;
+              opt.tolerance = tolerance;
+              opt.leaf_size = leaf_size;
+              opt.num_threads = num_threads;
+              sst::DipoleTreecodeStats stats;
+              py::tuple b = dipole_grid_np(X, Y, Z, positions, moments,
+                                           [&](const double* Xp, const double* Yp, const double* Zp, size_t n,
+                                               const std::vector<Vec3>& pos, const std::vector<Vec3>& mom,
+                                               double* Bxp, double* Byp, double* Bzp) {
+                                               stats = FieldKernels::dipole_ring_field_grid_treecode(
+                                                   Xp, Yp, Zp, n, pos, mom, Bxp, Byp, Bzp, opt);
+                                           });
+              py::dict info;
+              info["error_estimate"] = stats.error_estimate;
+              info["direct_interactions"] = stats.direct_interactions;
+              info["cluster_interactions"] = stats.cluster_interactions;
+              return py::make_tuple(b[0], b[1], b[2], info);
+          },
           py::arg("X"), py::arg("Y"), py::arg("Z"),
           py::arg("positions"), py::arg("moments"),
-          R"pbdoc(Superposition of point dipoles on a 3D grid.)pbdoc");
+          py::arg("theta") = 0.5, py::arg("tolerance") = 0.0, py::arg("leaf_size") = 16, py::arg("num_threads") = 1,
+          R"pbdoc(Treecode (quadrupole far field) version of dipole_ring_field_grid.
+theta: opening angle (0 = exact direct sum); tolerance: absolute per-component bound (> 0 adds
+the per-cluster error test); num_threads: workers over grid tiles (default 1, 0 = all cores).
+Returns (bx, by, bz, stats) with stats = {error_estimate, direct_interactions,
+cluster_interactions}.)pbdoc");
+
+    m.def("field_kernels_isa",
+          []() { return std::string(FieldKernels::isa_name(FieldKernels::detected_isa())); },
+          R"pbdoc(Widest SIMD instruction set used by the grid kernels on this CPU.)pbdoc");
 
     m.def("biot_savart_vector_potential_grid",
           [](py::array_t<double> polyline, py::array_t<double> grid, double current) {
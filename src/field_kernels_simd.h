@@ -0,0 +1,136 @@
+// field_kernels_simd.h — SIMD bodies of the FieldKernels grid loops.
+// Not a standalone header: field_kernels.cpp includes it once per instruction set, with
+// SST_FK_NS (namespace), SST_FK_TARGET (function target attribute) and SST_FK_NS::Ops in scope.
+//
+// Vectorised across grid points; each lane accumulates its sources in the scalar reference
+// order, so the reproducible variant (Fast = false) matches the *_reference loops bit for bit.
+// Each call adds sources [s_begin, s_end) into B, so consecutive source blocks compose exactly.
+
+namespace SST_FK_NS {
+
+template <bool Fast>
+SST_FK_TARGET void wire_grid(const double* X, const double* Y, const double* Z, std::size_t n_grid,
+                             const WireSegments& seg, std::size_t s_begin, std::size_t s_end,
+                             double* Bx, double* By, double* Bz) {
+    using V = Ops::V;
+    constexpr std::size_t W = Ops::W;
+    const V one = Ops::set1(1.0);
+    const V eps = Ops::set1(Fast ? seg.eps * seg.eps : seg.eps);
+    const V factor = Ops::set1(seg.factor);
+
+    for (std::size_t i = 0; i < n_grid; i += W) {
+        const std::size_t lanes = std::min(W, n_grid - i);
+        const V x = Ops::load(X + i, lanes);
+        const V y = Ops::load(Y + i, lanes);
+        const V z = Ops::load(Z + i, lanes);
+        V bx = Ops::load(Bx + i, lanes);
+        V by = Ops::load(By + i, lanes);
+        V bz = Ops::load(Bz + i, lanes);
+
+        for (std::size_t s = s_begin; s < s_end; ++s) {
+            const V rx = Ops::sub(x, Ops::set1(seg.mx[s]));
+            const V ry = Ops::sub(y, Ops::set1(seg.my[s]));
+            const V rz = Ops::sub(z, Ops::set1(seg.mz[s]));
+            const V dx = Ops::set1(seg.dx[s]);
+            const V dy = Ops::set1(seg.dy[s]);
+            const V dz = Ops::set1(seg.dz[s]);
+            if constexpr (Fast) {
+                // dl is pre-scaled by the current factor; one sqrt and one divide per pair.
+                const V R2 = Ops::fmadd(rz, rz, Ops::fmadd(ry, ry, Ops::mul(rx, rx)));
+                const auto skip = Ops::lt(R2, eps);
+                const V invR = Ops::div(one, Ops::sqrt(R2));
+                const V invR3 = Ops::mul(Ops::mul(invR, invR), invR);
+                const V cx = Ops::fmsub(dy, rz, Ops::mul(dz, ry));
+                const V cy = Ops::fmsub(dz, rx, Ops::mul(dx, rz));
+                const V cz = Ops::fmsub(dx, ry, Ops::mul(dy, rx));
+                bx = Ops::select(skip, bx, Ops::fmadd(cx, invR3, bx));
+                by = Ops::select(skip, by, Ops::fmadd(cy, invR3, by));
+                bz = Ops::select(skip, bz, Ops::fmadd(cz, invR3, bz));
+            } else {
+                // Scalar order: R2 = (rx² + ry²) + rz², invR3 = 1 / (R2 R), B += (factor c) invR3.
+                const V R2 = Ops::add(Ops::add(Ops::product(rx, rx), Ops::product(ry, ry)),
+                                      Ops::product(rz, rz));
+                const V R = Ops::sqrt(R2);
+                const auto skip = Ops::lt(R, eps);
+                const V invR3 = Ops::div(one, Ops::mul(R2, R));
+                const V cx = Ops::sub(Ops::product(dy, rz), Ops::product(dz, ry));
+                const V cy = Ops::sub(Ops::product(dz, rx), Ops::product(dx, rz));
+                const V cz = Ops::sub(Ops::product(dx, ry), Ops::product(dy, rx));
+                bx = Ops::select(skip, bx, Ops::add(bx, Ops::product(Ops::mul(factor, cx), invR3)));
+                by = Ops::select(skip, by, Ops::add(by, Ops::product(Ops::mul(factor, cy), invR3)));
+                bz = Ops::select(skip, bz, Ops::add(bz, Ops::product(Ops::mul(factor, cz), invR3)));
+            }
+        }
+
+        Ops::store(Bx + i, bx, lanes);
+        Ops::store(By + i, by, lanes);
+        Ops::store(Bz + i, bz, lanes);
+    }
+}
+
+template <bool Fast>
+SST_FK_TARGET void dipole_grid(const double* X, const double* Y, const double* Z, std::size_t n_grid,
+                               const DipoleSources& src, std::size_t s_begin, std::size_t s_end,
+                               double* Bx, double* By, double* Bz) {
+    using V = Ops::V;
+    constexpr std::size_t W = Ops::W;
+    const V zero = Ops::set1(0.0);
+    const V one = Ops::set1(1.0);
+    const V three = Ops::set1(3.0);
+    const V K = Ops::set1(src.K);
+    const V eps = Ops::set1(Fast ? src.eps * src.eps : src.eps);
+
+    for (std::size_t i = 0; i < n_grid; i += W) {
+        const std::size_t lanes = std::min(W, n_grid - i);
+        const V x = Ops::load(X + i, lanes);
+        const V y = Ops::load(Y + i, lanes);
+        const V z = Ops::load(Z + i, lanes);
+        V bx = Ops::load(Bx + i, lanes);
+        V by = Ops::load(By + i, lanes);
+        V bz = Ops::load(Bz + i, lanes);
+
+        for (std::size_t d = s_begin; d < s_end; ++d) {
+            const V rx = Ops::sub(x, Ops::set1(src.px[d]));
+            const V ry = Ops::sub(y, Ops::set1(src.py[d]));
+            const V rz = Ops::sub(z, Ops::set1(src.pz[d]));
+            const V mx = Ops::set1(src.mx[d]);
+            const V my = Ops::set1(src.my[d]);
+            const V mz = Ops::set1(src.mz[d]);
+            if constexpr (Fast) {
+                // B = K / R³ [3 (m·r) r / R² - m] with a single divide and sqrt.
+                const V R2 = Ops::fmadd(rz, rz, Ops::fmadd(ry, ry, Ops::mul(rx, rx)));
+                const auto skip = Ops::lt(R2, eps);
+                const V invR2 = Ops::div(one, R2);
+                const V kinvR3 = Ops::mul(K, Ops::mul(invR2, Ops::sqrt(invR2)));
+                const V mdotr = Ops::fmadd(mz, rz, Ops::fmadd(my, ry, Ops::mul(mx, rx)));
+                const V c = Ops::mul(Ops::mul(three, mdotr), invR2);
+                bx = Ops::select(skip, bx, Ops::fmadd(kinvR3, Ops::fmsub(c, rx, mx), bx));
+                by = Ops::select(skip, by, Ops::fmadd(kinvR3, Ops::fmsub(c, ry, my), by));
+                bz = Ops::select(skip, bz, Ops::fmadd(kinvR3, Ops::fmsub(c, rz, mz), bz));
+            } else {
+                // Same sequence as dipole_field_at_point; near-coincident lanes add +0.
+                const V R2 = Ops::add(Ops::add(Ops::product(rx, rx), Ops::product(ry, ry)),
+                                      Ops::product(rz, rz));
+                const V R = Ops::sqrt(R2);
+                const auto skip = Ops::lt(R, eps);
+                const V mdotr = Ops::div(Ops::add(Ops::add(Ops::product(mx, rx), Ops::product(my, ry)),
+                                                  Ops::product(mz, rz)),
+                                         R);
+                const V c_over_R = Ops::div(Ops::mul(three, mdotr), R);
+                const V invR3 = Ops::div(one, Ops::mul(R2, R));
+                const V tx = Ops::sub(Ops::product(c_over_R, rx), mx);
+                const V ty = Ops::sub(Ops::product(c_over_R, ry), my);
+                const V tz = Ops::sub(Ops::product(c_over_R, rz), mz);
+                bx = Ops::add(bx, Ops::select(skip, zero, Ops::product(Ops::mul(K, tx), invR3)));
+                by = Ops::add(by, Ops::select(skip, zero, Ops::product(Ops::mul(K, ty), invR3)));
+                bz = Ops::add(bz, Ops::select(skip, zero, Ops::product(Ops::mul(K, tz), invR3)));
+            }
+        }
+
+        Ops::store(Bx + i, bx, lanes);
+        Ops::store(By + i, by, lanes);
+        Ops::store(Bz + i, bz, lanes);
+    }
+}
+
+}  // namespace SST_FK_NS
@@ -0,0 +1,379 @@
+#include "filament/ensemble.h"
+
+#include "filament/integrator.h"
+#include "parallel_for.h"
+#include "sst/types.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace sst {
+namespace filament {
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr std::size_t kMaxLanes = 16;
+
+bool advected(const FilamentComponent& fil) {
+    return !fil.ghost && fil.dynamic;
+}
+
+// The lane kernel covers the plain direct midpoint sum (or a treecode request that falls back
+// to it below treecode_min_segments); cutoff members keep their own neighbour list.
+bool batchable(const FilamentSystemState& state, const VelocityOptions& options) {
+    if (options.segment_kernel != geometry::SegmentKernel::Midpoint) return false;
+    if (options.lia_only || options.mutual_backend == MutualInductionBackend::Direct) return true;
+    if (options.mutual_backend == MutualInductionBackend::Cutoff) return false;
+    std::size_t source_segments = 0;
+    for (const auto& fil : state.filaments) {
+        if (!fil.ghost && fil.source) source_segments += fil.points.size();
+    }
+    return source_segments < options.treecode_min_segments;
+}
+
+bool same_layout(const FilamentSystemState& a, const VelocityOptions& oa,
+                 const FilamentSystemState& b, const VelocityOptions& ob) {
+    if (oa.lia_only != ob.lia_only || oa.include_lia != ob.include_lia || a.filaments.size() != b.filaments.size()) return false;
+    for (std::size_t f = 0; f < a.filaments.size(); ++f) {
+        const auto& fa = a.filaments[f];
+        const auto& fb = b.filaments[f];
+        if (fa.points.size() != fb.points.size() || fa.ghost != fb.ghost || fa.source != fb.source
+            || fa.dynamic != fb.dynamic) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Midpoint contributions of segments [0, M) of one source filament (except skip_a / skip_b) to
+// one target point in P lanes; P is a compile-time width so the lane loop vectorises.
+template <std::size_t P>
+void add_segments(const double* px, const double* py, const double* pz,
+                  const double* const* mid, const double* const* dl, std::size_t M,
+                  std::size_t skip_a, std::size_t skip_b, const double* ps, const double* reg,
+                  double* ux, double* uy, double* uz) {
+    double sx[P], sy[P], sz[P];
+    for (std::size_t m = 0; m < P; ++m) {
+        sx[m] = ux[m];
+        sy[m] = uy[m];
+        sz[m] = uz[m];
+    }
+    for (std::size_t j = 0; j < M; ++j) {
+        if (j == skip_a || j == skip_b) continue;
+        const double* mx = mid[0] + j * P;
+        const double* my = mid[1] + j * P;
+        const double* mz = mid[2] + j * P;
+        const double* lx = dl[0] + j * P;
+        const double* ly = dl[1] + j * P;
+        const double* lz = dl[2] + j * P;
+        for (std::size_t m = 0; m < P; ++m) {
+            const double rx = px[m] - mx[m];
+            const double ry = py[m] - my[m];
+            const double rz = pz[m] - mz[m];
+            const double r2 = rx * rx + ry * ry + rz * rz + reg[m];
+            const double inv = ps[m] / (r2 * std::sqrt(r2));
+            sx[m] += (ly[m] * rz - lz[m] * ry) * inv;
+            sy[m] += (lz[m] * rx - lx[m] * rz) * inv;
+            sz[m] += (lx[m] * ry - ly[m] * rx) * inv;
+        }
+    }
+    for (std::size_t m = 0; m < P; ++m) {
+        ux[m] = sx[m];
+        uy[m] = sy[m];
+        uz[m] = sz[m];
+    }
+}
+
+/**
+ * RK4 over 2..kMaxLanes members of one layout. Coordinates are stored [point][lane] per
+ * component, so every loop over the O(N²) point pairs runs over lanes innermost; each lane
+ * repeats FilamentVelocitySolver::evaluate_into and FilamentRK4Stepper::step operation for
+ * operation, which keeps it bitwise equal to stepping its member alone.
+ */
+class LaneBatch {
+public:
+    LaneBatch(std::vector<FilamentSystemState*> members, std::vector<const VelocityOptions*> options)
+        : members_(std::move(members)), options_(std::move(options)), count_(members_.size()) {
+        // Pad to a kernel width; padding lanes repeat lane 0 and are never written back.
+        W_ = 2;
+        while (W_ < count_) W_ *= 2;
+        const FilamentSystemState& lead = *members_[0];
+        nf_ = lead.filaments.size();
+        off_.assign(nf_ + 1, 0);
+        for (std::size_t f = 0; f < nf_; ++f) off_[f + 1] = off_[f] + lead.filaments[f].points.size();
+        total_ = off_[nf_];
+        lia_only_ = options_[0]->lia_only;
+        include_lia_ = options_[0]->include_lia;
+        for (auto* buffers : {&y0_, &y_, &k_, &acc_, &mid_, &dl_}) {
+            for (auto& c : *buffers) c.assign(total_ * W_, 0.0);
+        }
+        pref_.assign(nf_ * W_, 0.0);
+        for (std::size_t m = 0; m < W_; ++m) {
+            const std::size_t src = m < count_ ? m : 0;
+            const VelocityOptions& o = *options_[src];
+            a_[m] = std::max(o.core_radius, 1e-30);
+            eD_[m] = std::exp(o.core_delta);
+            C_[m] = o.lia_constant;
+            a_sim2_[m] = o.a_sim * o.a_sim;
+            const auto& fils = members_[src]->filaments;
+            for (std::size_t f = 0; f < nf_; ++f) {
+                pref_[f * W_ + m] = fils[f].circulation / (4.0 * kPi);
+                for (std::size_t i = 0; i < fils[f].points.size(); ++i) {
+                    for (int c = 0; c < 3; ++c) y0_[c][(off_[f] + i) * W_ + m] = fils[f].points[i][c];
+                }
+            }
+        }
+    }
+
+    void run(double dt, std::size_t steps, double* speed) {
+        for (std::size_t s = 0; s < steps; ++s) step(dt);
+        for (std::size_t m = 0; m < count_; ++m) {
+            speed[m] = speed_[m];
+            auto& fils = members_[m]->filaments;
+            for (std::size_t f = 0; f < nf_; ++f) {
+                for (std::size_t i = 0; i < fils[f].points.size(); ++i) {
+                    for (int c = 0; c < 3; ++c) fils[f].points[i][c] = y0_[c][(off_[f] + i) * W_ + m];
+                }
+            }
+        }
+    }
+
+private:
+    using Buffer = std::array<std::vector<double>, 3>;
+
+    std::vector<FilamentSystemState*> members_;
+    std::vector<const VelocityOptions*> options_;
+    std::size_t count_ = 0;
+    std::size_t W_ = 0;  // lane stride: count_ rounded up to 2, 4, 8 or 16
+    std::size_t nf_ = 0;
+    std::size_t total_ = 0;
+    bool lia_only_ = false;
+    bool include_lia_ = true;
+    std::vector<std::size_t> off_;
+    Buffer y0_, y_, k_, acc_, mid_, dl_;
+    std::vector<double> pref_;  // [filament][lane] circulation / 4π
+    double a_[kMaxLanes] = {}, eD_[kMaxLanes] = {}, C_[kMaxLanes] = {}, a_sim2_[kMaxLanes] = {};
+    double speed_[kMaxLanes] = {};
+
+    const FilamentComponent& filament(std::size_t f) const { return members_[0]->filaments[f]; }
+
+    void step(double dt) {
+        const std::size_t n = total_ * W_;
+        double stage_speed[kMaxLanes];
+
+        evaluate(y0_, stage_speed);
+        for (std::size_t m = 0; m < W_; ++m) speed_[m] = std::max(speed_[m], stage_speed[m]);
+        for (int c = 0; c < 3; ++c) std::copy(k_[c].begin(), k_[c].end(), acc_[c].begin());
+
+        const double scales[3] = {0.5 * dt, 0.5 * dt, dt};
+        const double weights[3] = {2.0, 2.0, 1.0};
+        for (int st = 0; st < 3; ++st) {
+            stage_positions(scales[st]);
+            evaluate(y_, stage_speed);
+            for (std::size_t m = 0; m < W_; ++m) speed_[m] = std::max(speed_[m], stage_speed[m]);
+            for (int c = 0; c < 3; ++c) {
+                double* acc = acc_[c].data();
+                const double* k = k_[c].data();
+                for (std::size_t i = 0; i < n; ++i) acc[i] += weights[st] * k[i];
+            }
+        }
+
+        for (std::size_t f = 0; f < nf_; ++f) {
+            if (!advected(filament(f))) continue;
+            for (int c = 0; c < 3; ++c) {
+                double* y0 = y0_[c].data();
+                const double* acc = acc_[c].data();
+                for (std::size_t i = off_[f] * W_; i < off_[f + 1] * W_; ++i) y0[i] += (dt / 6.0) * acc[i];
+            }
+        }
+    }
+
+    // y = y0 + scale * k on advected filaments, y = y0 elsewhere.
+    void stage_positions(double scale) {
+        for (std::size_t f = 0; f < nf_; ++f) {
+            const bool move = advected(filament(f));
+            for (int c = 0; c < 3; ++c) {
+                const double* y0 = y0_[c].data();
+                const double* k = k_[c].data();
+                double* y = y_[c].data();
+                for (std::size_t i = off_[f] * W_; i < off_[f + 1] * W_; ++i) y[i] = move ? y0[i] + scale * k[i] : y0[i];
+            }
+        }
+    }
+
+    void evaluate(const Buffer& pos, double* stage_speed) {
+        for (std::size_t f = 0; f < nf_; ++f) {
+            const std::size_t o = off_[f];
+            const std::size_t N = off_[f + 1] - o;
+            for (std::size_t k = 0; k < N; ++k) {
+                const std::size_t a = (o + k) * W_;
+                const std::size_t b = (o + (k + 1) % N) * W_;
+                for (int c = 0; c < 3; ++c) {
+                    const double* p = pos[c].data();
+                    for (std::size_t m = 0; m < W_; ++m) {
+                        dl_[c][a + m] = p[b + m] - p[a + m];
+                        mid_[c][a + m] = (p[a + m] + p[b + m]) * 0.5;
+                    }
+                }
+            }
+        }
+
+        double umax2[kMaxLanes] = {};
+        const double zero[kMaxLanes] = {};
+        const double* dlx = dl_[0].data();
+        const double* dly = dl_[1].data();
+        const double* dlz = dl_[2].data();
+        for (std::size_t ft = 0; ft < nf_; ++ft) {
+            const std::size_t ot = off_[ft];
+            const std::size_t N = off_[ft + 1] - ot;
+            if (filament(ft).ghost) {
+                for (int c = 0; c < 3; ++c) std::fill(k_[c].begin() + ot * W_, k_[c].begin() + (ot + N) * W_, 0.0);
+                continue;
+            }
+            for (std::size_t i = 0; i < N; ++i) {
+                const std::size_t im = (i + N - 1) % N;
+                const std::size_t ip = i;
+                const std::size_t g = (ot + i) * W_;
+                double ux[kMaxLanes], uy[kMaxLanes], uz[kMaxLanes];
+                for (std::size_t m = 0; m < W_; ++m) {
+                    const std::size_t sm = (ot + im) * W_ + m;
+                    const std::size_t sp = (ot + ip) * W_ + m;
+                    const Vec3 dm{{dlx[sm], dly[sm], dlz[sm]}};
+                    const Vec3 dp{{dlx[sp], dly[sp], dlz[sp]}};
+                    const double lm = std::max(norm(dm), 1e-30);
+                    const double lp = std::max(norm(dp), 1e-30);
+                    const Vec3 cxv = cross(dm, dp);
+                    const double lf = pref_[ft * W_ + m]
+                        * (std::log(2.0 * std::sqrt(lm * lp) / (eD_[m] * a_[m])) + C_[m])
+                        * 2.0 / (lm * lp * (lm + lp));
+                    ux[m] = include_lia_ ? cxv[0] * lf : 0.0;
+                    uy[m] = include_lia_ ? cxv[1] * lf : 0.0;
+                    uz[m] = include_lia_ ? cxv[2] * lf : 0.0;
+                }
+
+                if (!lia_only_) {
+                    const double* px = pos[0].data() + g;
+                    const double* py = pos[1].data() + g;
+                    const double* pz = pos[2].data() + g;
+                    for (std::size_t fs = 0; fs < nf_; ++fs) {
+                        const auto& source = filament(fs);
+                        if (source.ghost || !source.source) continue;
+                        const std::size_t os = off_[fs];
+                        const std::size_t M = off_[fs + 1] - os;
+                        const double* ps = pref_.data() + fs * W_;
+                        const double* reg = (fs == ft) ? zero : a_sim2_;
+                        const std::size_t skip_a = (fs == ft) ? im : M;
+                        const std::size_t skip_b = (fs == ft) ? ip : M;
+                        const double* mids[3] = {mid_[0].data() + os * W_, mid_[1].data() + os * W_,
+                                                 mid_[2].data() + os * W_};
+                        const double* dls[3] = {dlx + os * W_, dly + os * W_, dlz + os * W_};
+                        switch (W_) {
+                        case 2: add_segments<2>(px, py, pz, mids, dls, M, skip_a, skip_b, ps, reg, ux, uy, uz); break;
+                        case 4: add_segments<4>(px, py, pz, mids, dls, M, skip_a, skip_b, ps, reg, ux, uy, uz); break;
+                        case 8: add_segments<8>(px, py, pz, mids, dls, M, skip_a, skip_b, ps, reg, ux, uy, uz); break;
+                        default: add_segments<16>(px, py, pz, mids, dls, M, skip_a, skip_b, ps, reg, ux, uy, uz); break;
+                        }
+                    }
+                }
+
+                for (std::size_t m = 0; m < W_; ++m) {
+                    k_[0][g + m] = ux[m];
+                    k_[1][g + m] = uy[m];
+                    k_[2][g + m] = uz[m];
+                    const double um = ux[m] * ux[m] + uy[m] * uy[m] + uz[m] * uz[m];
+                    if (um > umax2[m]) umax2[m] = um;
+                }
+            }
+        }
+        for (std::size_t m = 0; m < W_; ++m) stage_speed[m] = std::sqrt(umax2[m]);
+    }
+};
+
+}  // namespace
+
+FilamentEnsembleIntegrator::FilamentEnsembleIntegrator(const EnsembleOptions& options) : options_(options) {}
+
+EnsembleStepResult FilamentEnsembleIntegrator::rk4_steps(
+    std::vector<FilamentSystemState>& members,
+    const std::vector<VelocityOptions>& options,
+    double dt,
+    std::size_t steps) const {
+    const std::size_t count = members.size();
+    if (options.size() != count && options.size() != 1) {
+        throw std::invalid_argument("ensemble: options must hold one entry per member or a single shared entry");
+    }
+    // Members are the parallel unit, so each member's own solver stays serial.
+    std::vector<VelocityOptions> serial(count);
+    for (std::size_t m = 0; m < count; ++m) {
+        serial[m] = options.size() == 1 ? options[0] : options[m];
+        serial[m].num_threads = 1;
+    }
+
+    // Tasks: lane batches of matching layout (filled in member order) and single members.
+    const std::size_t lanes = std::min(std::max<std::size_t>(options_.lanes, 1), kMaxLanes);
+    std::vector<std::vector<std::size_t>> tasks;
+    std::vector<std::size_t> open;  // tasks still accepting lanes
+    for (std::size_t m = 0; m < count; ++m) {
+        bool placed = false;
+        if (lanes > 1 && batchable(members[m], serial[m])) {
+            for (const std::size_t t : open) {
+                const std::size_t lead = tasks[t][0];
+                if (tasks[t].size() < lanes && same_layout(members[lead], serial[lead], members[m], serial[m])) {
+                    tasks[t].push_back(m);
+                    placed = true;
+                    break;
+                }
+            }
+            if (!placed) open.push_back(tasks.size());
+        }
+        if (!placed) tasks.push_back({m});
+    }
+
+    EnsembleStepResult result;
+    result.maximum_stage_speed.assign(count, 0.0);
+    parallel_for(tasks.size(), options_.num_threads, [&](std::size_t t) {
+        const std::vector<std::size_t>& ids = tasks[t];
+        if (ids.size() == 1) {
+            FilamentRK4Stepper stepper(serial[ids[0]]);
+            double speed = 0.0;
+            for (std::size_t s = 0; s < steps; ++s) speed = std::max(speed, stepper.step(members[ids[0]], dt));
+            result.maximum_stage_speed[ids[0]] = speed;
+            return;
+        }
+        std::vector<FilamentSystemState*> states;
+        std::vector<const VelocityOptions*> opts;
+        for (const std::size_t m : ids) {
+            states.push_back(&members[m]);
+            opts.push_back(&serial[m]);
+        }
+        double speed[kMaxLanes] = {};
+        LaneBatch(std::move(states), std::move(opts)).run(dt, steps, speed);
+        for (std::size_t l = 0; l < ids.size(); ++l) result.maximum_stage_speed[ids[l]] = speed[l];
+    });
+    for (const auto& ids : tasks) {
+        if (ids.size() > 1) result.batched_members += ids.size();
+    }
+
+    // Pack the final points.
+    result.member_filaments.assign(1, 0);
+    result.filament_offsets.assign(1, 0);
+    for (const auto& state : members) {
+        for (const auto& fil : state.filaments) {
+            result.filament_offsets.push_back(result.filament_offsets.back() + fil.points.size());
+        }
+        result.member_filaments.push_back(result.filament_offsets.size() - 1);
+    }
+    result.positions.reserve(3 * result.filament_offsets.back());
+    for (const auto& state : members) {
+        for (const auto& fil : state.filaments) {
+            for (const auto& p : fil.points) result.positions.insert(result.positions.end(), p.begin(), p.end());
+        }
+    }
+    return result;
+}
+
+}  // namespace filament
+}  // namespace sst
@@ -0,0 +1,66 @@
+#ifndef SSTCORE_FILAMENT_ENSEMBLE_H
+#define SSTCORE_FILAMENT_ENSEMBLE_H
+
+#pragma once
+
+#include "vortexlab/types.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace sst {
+namespace filament {
+
+struct EnsembleOptions {
+    // Workers over ensemble tasks (opt-in; 0 = hardware concurrency). Members are independent,
+    // so the result does not depend on the thread count; each member's solver runs serially.
+    std::size_t num_threads = 1;
+    // Members of one lane batch (same layout, direct midpoint mutual sum) stepped together with
+    // the member index as the innermost, vectorised loop (at most 16; 1 disables batching).
+    std::size_t lanes = 8;
+};
+
+/**
+ * Packed result of an ensemble run: the final points of every member, member after member and
+ * filament after filament, in one (points x 3) buffer.
+ */
+struct EnsembleStepResult {
+    std::vector<double> positions;             // 3 * total points
+    std::vector<std::size_t> filament_offsets; // all filaments of all members + 1, in points
+    std::vector<std::size_t> member_filaments; // members + 1, prefix into filament_offsets
+    std::vector<double> maximum_stage_speed;   // per member, over all steps
+    std::size_t batched_members = 0;           // stepped by the lane-batched kernel
+};
+
+/**
+ * Classical RK4 over a batch of independent filament systems in one call. Members whose
+ * filament layout (counts and flags) and solver settings allow it are grouped into lane
+ * batches and share one pass over the point pairs, with per-member circulation, core_radius,
+ * core_delta, lia_constant and a_sim; the remaining members (treecode, cutoff, straight-segment
+ * kernel) each use a FilamentRK4Stepper. Either way every member ends bitwise equal to
+ * stepping it alone with FilamentRK4Stepper (in the deterministic numeric profile; fast-math
+ * builds may contract the two code paths differently).
+ */
+class FilamentEnsembleIntegrator {
+public:
+    explicit FilamentEnsembleIntegrator(const EnsembleOptions& options = {});
+
+    /**
+     * steps RK4 steps of size dt on every member, in place. options holds one VelocityOptions
+     * per member, or a single entry shared by all (else std::invalid_argument).
+     */
+    EnsembleStepResult rk4_steps(std::vector<FilamentSystemState>& members,
+                                 const std::vector<VelocityOptions>& options,
+                                 double dt,
+                                 std::size_t steps = 1) const;
+
+    const EnsembleOptions& options() const { return options_; }
+
+private:
+    EnsembleOptions options_;
+};
+
+}  // namespace filament
+}  // namespace sst
+
+#endif
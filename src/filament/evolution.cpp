@@ -4,6 +4,7 @@
 #include "frenet_helicity.h"
 #include "sst/knot.h"
 
+#include <algorithm>
 #include <cmath>
 #include <map>
 #include <stdexcept>
@@ -101,13 +102,13 @@ void FilamentEvolution::init_from_fseries(std::vector<Vec3>& out, const std::str
     (void)curv;
 }
 
-void FilamentEvolution::compute_tangents() {
-    tangents_.resize(positions_.size());
-    const std::size_t n = positions_.size();
+void FilamentEvolution::central_tangents(const std::vector<Vec3>& x, std::vector<Vec3>& out) {
+    const std::size_t n = x.size();
+    out.resize(n);
     for (std::size_t i = 0; i < n; ++i) {
-        const Vec3& prev = positions_[(i + n - 1) % n];
-        const Vec3& next = positions_[(i + 1) % n];
-        tangents_[i] = Vec3{
+        const Vec3& prev = x[(i + n - 1) % n];
+        const Vec3& next = x[(i + 1) % n];
+        out[i] = Vec3{
             (next[0] - prev[0]) * 0.5,
             (next[1] - prev[1]) * 0.5,
             (next[2] - prev[2]) * 0.5,
@@ -115,17 +116,161 @@ void FilamentEvolution::compute_tangents() {
     }
 }
 
+void FilamentEvolution::compute_tangents() {
+    central_tangents(positions_, tangents_);
+}
+
+void FilamentEvolution::set_options(const FilamentEvolutionOptions& options) {
+    if (!(options.core_radius > 0.0)) {
+        throw std::invalid_argument("FilamentEvolution: core_radius must be > 0");
+    }
+    if (!(options.cutoff_arclength >= 0.0)) {
+        throw std::invalid_argument("FilamentEvolution: cutoff_arclength must be >= 0");
+    }
+    options_ = options;
+}
+
+std::vector<Vec3> FilamentEvolution::velocity() {
+    std::vector<Vec3> out;
+    velocity_into(positions_, tangents_, out);
+    return out;
+}
+
+void FilamentEvolution::velocity_into(const std::vector<Vec3>& x, const std::vector<Vec3>& t, std::vector<Vec3>& out) {
+    const std::size_t n = x.size();
+    out.resize(n);
+    if (options_.model == FilamentVelocityModel::BiotSavart) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = biot_savart_velocity(x[i], x, t, circulation_);
+        }
+        return;
+    }
+    if (n < 3) {
+        for (auto& u : out) u = Vec3{0.0, 0.0, 0.0};
+        return;
+    }
+
+    // Segment j runs from x[j] to x[j + 1]; point i sits between segments i - 1 and i.
+    dl_.resize(n);
+    mid_.resize(n);
+    len_.resize(n);
+    for (std::size_t j = 0; j < n; ++j) {
+        const Vec3& a = x[j];
+        const Vec3& b = x[(j + 1) % n];
+        dl_[j] = Vec3{b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        mid_[j] = Vec3{0.5 * (a[0] + b[0]), 0.5 * (a[1] + b[1]), 0.5 * (a[2] + b[2])};
+        len_[j] = std::max(norm(dl_[j]), 1e-30);
+    }
+    const double pref = circulation_ / (4.0 * M_PI);
+    const bool cutoff = options_.model == FilamentVelocityModel::CutoffBiotSavart;
+    const double reach = options_.cutoff_arclength;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t im = (i + n - 1) % n;
+        const std::size_t ip = i;
+        const double lm = len_[im];
+        const double lp = len_[ip];
+        const Vec3 c = cross(dl_[im], dl_[ip]);
+        const double lf = pref
+            * (std::log(2.0 * std::sqrt(lm * lp) / options_.core_radius) + options_.lia_constant)
+            * 2.0 / (lm * lp * (lm + lp));
+        Vec3 u{c[0] * lf, c[1] * lf, c[2] * lf};
+
+        if (cutoff) {
+            const Vec3& p = x[i];
+            const auto add_segment = [&](std::size_t j) {
+                const Vec3 r = diff(p, mid_[j]);
+                const double r2 = r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+                const double inv = pref / (r2 * std::sqrt(r2));
+                const Vec3& dl = dl_[j];
+                u[0] += (dl[1] * r[2] - dl[2] * r[1]) * inv;
+                u[1] += (dl[2] * r[0] - dl[0] * r[2]) * inv;
+                u[2] += (dl[0] * r[1] - dl[1] * r[0]) * inv;
+            };
+            // Walk outwards from the two adjacent segments (covered by the LIA term) while the
+            // next segment's midpoint is within reach; each segment is visited at most once.
+            std::size_t budget = n - 2;
+            double ahead = lp;   // arc length from x[i] to the start of the next forward segment
+            double behind = lm;  // ... to the end of the next backward segment
+            std::size_t fwd = (ip + 1) % n;
+            std::size_t bwd = (im + n - 1) % n;
+            bool go_fwd = true, go_bwd = true;
+            while (budget > 0 && (go_fwd || go_bwd)) {
+                if (go_fwd) {
+                    if (ahead + 0.5 * len_[fwd] <= reach) {
+                        add_segment(fwd);
+                        ahead += len_[fwd];
+                        fwd = (fwd + 1) % n;
+                        --budget;
+                    } else {
+                        go_fwd = false;
+                    }
+                }
+                if (go_bwd && budget > 0) {
+                    if (behind + 0.5 * len_[bwd] <= reach) {
+                        add_segment(bwd);
+                        behind += len_[bwd];
+                        bwd = (bwd + n - 1) % n;
+                        --budget;
+                    } else {
+                        go_bwd = false;
+                    }
+                }
+            }
+        }
+        out[i] = u;
+    }
+}
+
 void FilamentEvolution::evolve(double dt, std::size_t steps) {
+    const std::size_t n = positions_.size();
     for (std::size_t step = 0; step < steps; ++step) {
-        std::vector<Vec3> velocity;
-        velocity.reserve(positions_.size());
-        for (const auto& p : positions_) {
-            velocity.push_back(biot_savart_velocity(p, positions_, tangents_, circulation_));
+        switch (options_.scheme) {
+        case FilamentTimeScheme::Euler:
+            velocity_into(positions_, tangents_, k_);
+            for (std::size_t i = 0; i < n; ++i) {
+                positions_[i][0] += dt * k_[i][0];
+                positions_[i][1] += dt * k_[i][1];
+                positions_[i][2] += dt * k_[i][2];
+            }
+            break;
+        case FilamentTimeScheme::RK2: {
+            // Explicit midpoint rule.
+            velocity_into(positions_, tangents_, k_);
+            y_.resize(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                for (std::size_t d = 0; d < 3; ++d) y_[i][d] = positions_[i][d] + 0.5 * dt * k_[i][d];
+            }
+            central_tangents(y_, stage_tangents_);
+            velocity_into(y_, stage_tangents_, k_);
+            for (std::size_t i = 0; i < n; ++i) {
+                for (std::size_t d = 0; d < 3; ++d) positions_[i][d] += dt * k_[i][d];
+            }
+            break;
+        }
+        case FilamentTimeScheme::RK4: {
+            y0_ = positions_;
+            y_.resize(n);
+            acc_.resize(n);
+            velocity_into(y0_, tangents_, k_);
+            acc_ = k_;
+            const double scale[3] = {0.5 * dt, 0.5 * dt, dt};
+            const double weight[3] = {2.0, 2.0, 1.0};
+            for (std::size_t s = 0; s < 3; ++s) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    for (std::size_t d = 0; d < 3; ++d) y_[i][d] = y0_[i][d] + scale[s] * k_[i][d];
+                }
+                central_tangents(y_, stage_tangents_);
+                velocity_into(y_, stage_tangents_, k_);
+                for (std::size_t i = 0; i < n; ++i) {
+                    for (std::size_t d = 0; d < 3; ++d) acc_[i][d] += weight[s] * k_[i][d];
+                }
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                for (std::size_t d = 0; d < 3; ++d) positions_[i][d] = y0_[i][d] + (dt / 6.0) * acc_[i][d];
+            }
+            break;
         }
-        for (std::size_t i = 0; i < positions_.size(); ++i) {
-            positions_[i][0] += dt * velocity[i][0];
-            positions_[i][1] += dt * velocity[i][1];
-            positions_[i][2] += dt * velocity[i][2];
         }
         compute_tangents();
     }
@@ -1,9 +1,11 @@
 #include "filament/integrator.h"
 
 #include "filament/velocity_solver.h"
+#include "parallel_for.h"
 #include "sst/types.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <limits>
 #include <vector>
@@ -12,45 +14,14 @@ namespace sst {
 namespace filament {
 namespace {
 
+constexpr double kPi = 3.14159265358979323846;
+
 Vec3 add_scaled(const Vec3& a, const Vec3& b, double s) {
     return {a[0] + s * b[0], a[1] + s * b[1], a[2] + s * b[2]};
 }
 
-void apply_velocity(
-    FilamentSystemState& state,
-    const VelocityFieldResult& vel,
-    double scale) {
-    for (std::size_t f = 0; f < state.filaments.size(); ++f) {
-        auto& fil = state.filaments[f];
-        if (fil.ghost || !fil.dynamic) continue;
-        for (std::size_t i = 0; i < fil.points.size(); ++i) {
-            fil.points[i] = add_scaled(fil.points[i], vel.velocity[f][i], scale);
-        }
-    }
-}
-
-FilamentSystemState blend_stages(
-    const FilamentSystemState& y0,
-    const VelocityFieldResult& k1,
-    const VelocityFieldResult& k2,
-    const VelocityFieldResult& k3,
-    const VelocityFieldResult& k4,
-    double dt) {
-    FilamentSystemState out = y0;
-    for (std::size_t f = 0; f < out.filaments.size(); ++f) {
-        auto& fil = out.filaments[f];
-        if (fil.ghost || !fil.dynamic) continue;
-        for (std::size_t i = 0; i < fil.points.size(); ++i) {
-            const Vec3& a = k1.velocity[f][i];
-            const Vec3& b = k2.velocity[f][i];
-            const Vec3& c = k3.velocity[f][i];
-            const Vec3& d = k4.velocity[f][i];
-            fil.points[i][0] += (dt / 6.0) * (a[0] + 2.0 * b[0] + 2.0 * c[0] + d[0]);
-            fil.points[i][1] += (dt / 6.0) * (a[1] + 2.0 * b[1] + 2.0 * c[1] + d[1]);
-            fil.points[i][2] += (dt / 6.0) * (a[2] + 2.0 * b[2] + 2.0 * c[2] + d[2]);
-        }
-    }
-    return out;
+bool advected(const FilamentComponent& fil) {
+    return !fil.ghost && fil.dynamic;
 }
 
 double min_segment_length(const FilamentSystemState& state) {
@@ -65,37 +36,627 @@ double min_segment_length(const FilamentSystemState& state) {
     return m;
 }
 
+/** Step size of one filament from its own resolution and speed (MultirateOptions). */
+double filament_dt(const FilamentComponent& fil, const Vec3* x, const Vec3* v, std::size_t N,
+                   const VelocityOptions& options, const MultirateOptions& multirate) {
+    if (!advected(fil) || N < 2) return std::numeric_limits<double>::infinity();
+    double lmin = std::numeric_limits<double>::infinity();
+    double umax = 0.0;
+    for (std::size_t k = 0; k < N; ++k) {
+        lmin = std::min(lmin, norm(diff(x[(k + 1) % N], x[k])));
+        umax = std::max(umax, norm(v[k]));
+    }
+    if (!std::isfinite(lmin) || lmin <= 0.0) return std::numeric_limits<double>::infinity();
+    double dt = multirate.cfl * lmin / std::max(umax, 1e-12);
+    const double gamma = std::abs(fil.circulation);
+    if (gamma > 0.0) {
+        const double a = std::max(options.core_radius, 1e-30);
+        const double lambda = std::max(
+            1.0, std::log(2.0 * lmin / (std::exp(options.core_delta) * a)) + options.lia_constant);
+        dt = std::min(dt, multirate.lia_stability * 4.0 * kPi * lmin * lmin / (gamma * lambda));
+    }
+    return dt;
+}
+
+/** Butcher tableau of an FSAL embedded pair: row stages-1 of a holds the propagated weights b. */
+struct EmbeddedTableau {
+    std::size_t stages;
+    double a[7][7];
+    double e[7];           // b - b_hat (error weights)
+    double error_order;    // q + 1 for the lower-order estimate
+};
+
+const EmbeddedTableau& tableau(EmbeddedScheme scheme) {
+    static const EmbeddedTableau dp54 = {
+        7,
+        {{0, 0, 0, 0, 0, 0, 0},
+         {1.0 / 5.0, 0, 0, 0, 0, 0, 0},
+         {3.0 / 40.0, 9.0 / 40.0, 0, 0, 0, 0, 0},
+         {44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0, 0, 0, 0, 0},
+         {19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0, 0, 0, 0},
+         {9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0, 0, 0},
+         {35.0 / 384.0, 0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0, 0}},
+        {71.0 / 57600.0, 0, -71.0 / 16695.0, 71.0 / 1920.0, -17253.0 / 339200.0, 22.0 / 525.0, -1.0 / 40.0},
+        5.0};
+    static const EmbeddedTableau bs32 = {
+        4,
+        {{0, 0, 0, 0, 0, 0, 0},
+         {1.0 / 2.0, 0, 0, 0, 0, 0, 0},
+         {0, 3.0 / 4.0, 0, 0, 0, 0, 0},
+         {2.0 / 9.0, 1.0 / 3.0, 4.0 / 9.0, 0, 0, 0, 0}},
+        {-5.0 / 72.0, 1.0 / 12.0, 1.0 / 9.0, -1.0 / 8.0, 0, 0, 0},
+        3.0};
+    return scheme == EmbeddedScheme::BogackiShampine32 ? bs32 : dp54;
+}
+
+// 3x3 blocks of the implicit LIA solve, row-major.
+using Mat3 = std::array<double, 9>;
+
+Mat3 mat_mul(const Mat3& a, const Mat3& b) {
+    Mat3 c{};
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            c[3 * i + j] = a[3 * i] * b[j] + a[3 * i + 1] * b[3 + j] + a[3 * i + 2] * b[6 + j];
+    return c;
+}
+
+Vec3 mat_vec(const Mat3& a, const Vec3& v) {
+    return {a[0] * v[0] + a[1] * v[1] + a[2] * v[2],
+            a[3] * v[0] + a[4] * v[1] + a[5] * v[2],
+            a[6] * v[0] + a[7] * v[1] + a[8] * v[2]};
+}
+
+Mat3 mat_sub(const Mat3& a, const Mat3& b) {
+    Mat3 c;
+    for (int i = 0; i < 9; ++i) c[i] = a[i] - b[i];
+    return c;
+}
+
+Mat3 mat_inverse(const Mat3& m) {
+    const Mat3 adj = {m[4] * m[8] - m[5] * m[7], m[2] * m[7] - m[1] * m[8], m[1] * m[5] - m[2] * m[4],
+                      m[5] * m[6] - m[3] * m[8], m[0] * m[8] - m[2] * m[6], m[2] * m[3] - m[0] * m[5],
+                      m[3] * m[7] - m[4] * m[6], m[1] * m[6] - m[0] * m[7], m[0] * m[4] - m[1] * m[3]};
+    const double inv_det = 1.0 / (m[0] * adj[0] + m[1] * adj[3] + m[2] * adj[6]);
+    Mat3 r;
+    for (int i = 0; i < 9; ++i) r[i] = adj[i] * inv_det;
+    return r;
+}
+
+// [k]x, so that cross_matrix(k) * v = k x v.
+Mat3 cross_matrix(const Vec3& k) {
+    return {0.0, -k[2], k[1], k[2], 0.0, -k[0], -k[1], k[0], 0.0};
+}
+
+/**
+ * Local LIA coupling of one filament at positions x: c_i = lf_i (d_{i-1} + d_i) / 2 with the
+ * solver's lf_i, so its LIA velocity is c_i x (x_{i+1} - 2 x_i + x_{i-1}).
+ */
+void lia_coupling(const FilamentComponent& fil, const Vec3* x, std::size_t N,
+                  const VelocityOptions& options, Vec3* c) {
+    const double a = std::max(options.core_radius, 1e-30);
+    const double eD = std::exp(options.core_delta);
+    const double pref = fil.circulation / (4.0 * kPi);
+    for (std::size_t i = 0; i < N; ++i) {
+        const Vec3 dm = diff(x[i], x[(i + N - 1) % N]);
+        const Vec3 dp = diff(x[(i + 1) % N], x[i]);
+        const double lm = std::max(norm(dm), 1e-30);
+        const double lp = std::max(norm(dp), 1e-30);
+        const double lf = pref * (std::log(2.0 * std::sqrt(lm * lp) / (eD * a)) + options.lia_constant)
+                          * 2.0 / (lm * lp * (lm + lp));
+        c[i] = {0.5 * lf * (dm[0] + dp[0]), 0.5 * lf * (dm[1] + dp[1]), 0.5 * lf * (dm[2] + dp[2])};
+    }
+}
+
+/**
+ * Solve y_i - k_i x (y_{i+1} - 2 y_i + y_{i-1}) = r_i on a closed filament (N >= 3): block
+ * Thomas over rows 1..N-1 with y_0 carried as a parameter (y_i = p_i + Q_i y_0), then row 0
+ * for y_0. gain / shift hold G_i and Q_i; y doubles as p.
+ */
+void solve_cyclic_lia(const Vec3* k, const Vec3* r, std::size_t N, Vec3* y, Mat3* gain, Mat3* shift) {
+    const Mat3 identity = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+    const auto diagonal = [&](const Mat3& kx) {
+        Mat3 b = identity;
+        for (int i = 0; i < 9; ++i) b[i] += 2.0 * kx[i];
+        return b;
+    };
+    for (std::size_t i = 1; i < N; ++i) {
+        const Mat3 kx = cross_matrix(k[i]);  // off-diagonal blocks are -kx
+        Mat3 d = diagonal(kx);
+        Vec3 rv = r[i];
+        Mat3 s{};
+        if (i == 1) {
+            s = kx;
+        } else {
+            const Mat3 kg = mat_mul(kx, gain[i - 1]);
+            for (int c = 0; c < 9; ++c) d[c] += kg[c];
+            const Vec3 kp = mat_vec(kx, y[i - 1]);
+            rv = {rv[0] + kp[0], rv[1] + kp[1], rv[2] + kp[2]};
+            s = mat_mul(kx, shift[i - 1]);
+        }
+        if (i == N - 1) {
+            for (int c = 0; c < 9; ++c) s[c] += kx[c];
+        }
+        const Mat3 dinv = mat_inverse(d);
+        y[i] = mat_vec(dinv, rv);
+        shift[i] = mat_mul(dinv, s);
+        if (i + 1 < N) {
+            gain[i] = mat_mul(dinv, kx);
+            for (double& g : gain[i]) g = -g;
+        }
+    }
+    for (std::size_t i = N - 2; i >= 1; --i) {
+        const Vec3 gp = mat_vec(gain[i], y[i + 1]);
+        y[i] = diff(y[i], gp);
+        shift[i] = mat_sub(shift[i], mat_mul(gain[i], shift[i + 1]));
+    }
+    const Mat3 kx = cross_matrix(k[0]);
+    Mat3 m = diagonal(kx);
+    m = mat_sub(m, mat_mul(kx, shift[N - 1]));
+    m = mat_sub(m, mat_mul(kx, shift[1]));
+    const Vec3 a = mat_vec(kx, y[N - 1]);
+    const Vec3 b = mat_vec(kx, y[1]);
+    const Vec3 y0 = mat_vec(mat_inverse(m), {r[0][0] + a[0] + b[0], r[0][1] + a[1] + b[1], r[0][2] + a[2] + b[2]});
+    y[0] = y0;
+    for (std::size_t i = 1; i < N; ++i) {
+        const Vec3 q = mat_vec(shift[i], y0);
+        y[i] = {y[i][0] + q[0], y[i][1] + q[1], y[i][2] + q[2]};
+    }
+}
+
 }  // namespace
 
+FilamentRK4Stepper::FilamentRK4Stepper(const VelocityOptions& options) : options_(options) {}
+
+double FilamentRK4Stepper::step(FilamentSystemState& state, double dt) {
+    const std::size_t total = workspace_.bind(state);
+    const std::vector<std::size_t>& off = workspace_.offsets;
+    const std::size_t nf = state.filaments.size();
+    y0_.resize(total);
+    y_.resize(total);
+    k_.resize(total);
+    acc_.resize(total);
+    for (std::size_t f = 0; f < nf; ++f) {
+        const auto& pts = state.filaments[f].points;
+        std::copy(pts.begin(), pts.end(), y0_.begin() + static_cast<std::ptrdiff_t>(off[f]));
+    }
+
+    // y = y0 + scale * k on advected filaments, y = y0 elsewhere.
+    const auto stage_positions = [&](double scale) {
+        for (std::size_t f = 0; f < nf; ++f) {
+            const bool move = advected(state.filaments[f]);
+            for (std::size_t i = off[f]; i < off[f + 1]; ++i) {
+                y_[i] = move ? add_scaled(y0_[i], k_[i], scale) : y0_[i];
+            }
+        }
+    };
+    const auto accumulate = [&](double weight) {
+        for (std::size_t i = 0; i < total; ++i) {
+            acc_[i][0] += weight * k_[i][0];
+            acc_[i][1] += weight * k_[i][1];
+            acc_[i][2] += weight * k_[i][2];
+        }
+    };
+
+    double speed = FilamentVelocitySolver::evaluate_into(state, y0_.data(), options_, workspace_, k_.data());
+    std::copy(k_.begin(), k_.end(), acc_.begin());
+
+    stage_positions(0.5 * dt);
+    speed = std::max(speed, FilamentVelocitySolver::evaluate_into(state, y_.data(), options_, workspace_, k_.data()));
+    accumulate(2.0);
+
+    stage_positions(0.5 * dt);
+    speed = std::max(speed, FilamentVelocitySolver::evaluate_into(state, y_.data(), options_, workspace_, k_.data()));
+    accumulate(2.0);
+
+    stage_positions(dt);
+    speed = std::max(speed, FilamentVelocitySolver::evaluate_into(state, y_.data(), options_, workspace_, k_.data()));
+    accumulate(1.0);
+
+    for (std::size_t f = 0; f < nf; ++f) {
+        auto& fil = state.filaments[f];
+        if (!advected(fil)) continue;
+        for (std::size_t i = 0; i < fil.points.size(); ++i) {
+            const Vec3& a = acc_[off[f] + i];
+            fil.points[i][0] += (dt / 6.0) * a[0];
+            fil.points[i][1] += (dt / 6.0) * a[1];
+            fil.points[i][2] += (dt / 6.0) * a[2];
+        }
+    }
+    return speed;
+}
+
 IntegratorStepResult FilamentIntegrator::rk4_step(
     const FilamentSystemState& state,
     double dt,
     const VelocityOptions& options) {
     IntegratorStepResult result;
-    const VelocityFieldResult k1 = FilamentVelocitySolver::evaluate(state, options);
-
-    FilamentSystemState y2 = state;
-    apply_velocity(y2, k1, 0.5 * dt);
-    const VelocityFieldResult k2 = FilamentVelocitySolver::evaluate(y2, options);
-
-    FilamentSystemState y3 = state;
-    apply_velocity(y3, k2, 0.5 * dt);
-    const VelocityFieldResult k3 = FilamentVelocitySolver::evaluate(y3, options);
-
-    FilamentSystemState y4 = state;
-    apply_velocity(y4, k3, dt);
-    const VelocityFieldResult k4 = FilamentVelocitySolver::evaluate(y4, options);
-
-    result.state = blend_stages(state, k1, k2, k3, k4, dt);
-    result.maximum_stage_speed = std::max({
-        k1.maximum_speed,
-        k2.maximum_speed,
-        k3.maximum_speed,
-        k4.maximum_speed
+    result.state = state;
+    FilamentRK4Stepper stepper(options);
+    result.maximum_stage_speed = stepper.step(result.state, dt);
+    return result;
+}
+
+FilamentAdaptiveIntegrator::FilamentAdaptiveIntegrator(
+    const VelocityOptions& options,
+    const AdaptiveStepOptions& step_options)
+    : options_(options), step_options_(step_options) {
+    const AdaptiveStepOptions& o = step_options_;
+    if (!(o.rtol >= 0.0) || !(o.atol >= 0.0) || o.rtol + o.atol <= 0.0) {
+        throw std::invalid_argument("adaptive integrator: tolerances must be >= 0 and not both zero");
+    }
+    if (!(o.dt_min > 0.0) || !(o.dt_max >= o.dt_min) || o.dt_initial < 0.0 || !(o.cfl > 0.0)) {
+        throw std::invalid_argument("adaptive integrator: require 0 < dt_min <= dt_max, dt_initial >= 0, cfl > 0");
+    }
+    if (!(o.safety > 0.0) || !(o.min_shrink > 0.0) || o.min_shrink > 1.0 || o.max_growth < 1.0) {
+        throw std::invalid_argument("adaptive integrator: require safety > 0, 0 < min_shrink <= 1 <= max_growth");
+    }
+}
+
+AdaptiveIntegrationResult FilamentAdaptiveIntegrator::advance(
+    FilamentSystemState& state,
+    double t0,
+    double t_end) {
+    if (!(t_end >= t0)) throw std::invalid_argument("adaptive integrator: t_end must be >= t0");
+    const AdaptiveStepOptions& o = step_options_;
+    const EmbeddedTableau& tab = tableau(o.scheme);
+    const std::size_t S = tab.stages;
+
+    const std::size_t total = workspace_.bind(state);
+    const std::vector<std::size_t>& off = workspace_.offsets;
+    const std::size_t nf = state.filaments.size();
+    y0_.resize(total);
+    y_.resize(total);
+    k_.resize(S);
+    for (auto& k : k_) k.resize(total);
+    for (std::size_t f = 0; f < nf; ++f) {
+        const auto& pts = state.filaments[f].points;
+        std::copy(pts.begin(), pts.end(), y0_.begin() + static_cast<std::ptrdiff_t>(off[f]));
+    }
+
+    AdaptiveIntegrationResult result;
+    result.time = t0;
+    const auto evaluate = [&](const std::vector<Vec3>& y, std::vector<Vec3>& k) {
+        const double speed = FilamentVelocitySolver::evaluate_into(state, y.data(), options_, workspace_, k.data());
+        result.maximum_stage_speed = std::max(result.maximum_stage_speed, speed);
+        ++result.velocity_evaluations;
+        return speed;
+    };
+    if (t_end == t0) {
+        result.completed = true;
+        result.next_dt = next_dt_;
+        return result;
+    }
+
+    const double speed0 = evaluate(y0_, k_[0]);
+    double dt = next_dt_;
+    if (!(dt > 0.0)) dt = o.dt_initial;
+    if (!(dt > 0.0)) {
+        const double lm = min_segment_length(state);
+        dt = std::isfinite(lm) && lm > 0.0 ? o.cfl * lm / std::max(speed0, 1e-12) : t_end - t0;
+    }
+    dt = std::min(std::max(dt, o.dt_min), o.dt_max);
+
+    double t = t0;
+    bool rejected_last = false;
+    std::size_t attempts = 0;
+    while (t < t_end && attempts < o.max_steps) {
+        ++attempts;
+        const bool clipped = t + dt >= t_end;
+        const double h = clipped ? t_end - t : dt;
+
+        for (std::size_t s = 1; s < S; ++s) {
+            for (std::size_t f = 0; f < nf; ++f) {
+                const bool move = advected(state.filaments[f]);
+                for (std::size_t i = off[f]; i < off[f + 1]; ++i) {
+                    Vec3 y = y0_[i];
+                    if (move) {
+                        for (std::size_t j = 0; j < s; ++j) {
+                            const double w = h * tab.a[s][j];
+                            if (w == 0.0) continue;
+                            y[0] += w * k_[j][i][0];
+                            y[1] += w * k_[j][i][1];
+                            y[2] += w * k_[j][i][2];
+                        }
+                    }
+                    y_[i] = y;
+                }
+            }
+            evaluate(y_, k_[s]);
+        }
+
+        // Error norm over advected coordinates; y_ holds the propagated solution.
+        double sum = 0.0;
+        std::size_t count = 0;
+        for (std::size_t f = 0; f < nf; ++f) {
+            if (!advected(state.filaments[f])) continue;
+            for (std::size_t i = off[f]; i < off[f + 1]; ++i) {
+                for (int c = 0; c < 3; ++c) {
+                    double err = 0.0;
+                    for (std::size_t j = 0; j < S; ++j) err += tab.e[j] * k_[j][i][c];
+                    const double sc = o.atol + o.rtol * std::max(std::abs(y0_[i][c]), std::abs(y_[i][c]));
+                    const double r = h * err / sc;
+                    sum += r * r;
+                    ++count;
+                }
+            }
+        }
+        const double err_norm = count > 0 ? std::sqrt(sum / static_cast<double>(count)) : 0.0;
+        double fac = err_norm > 0.0 ? o.safety * std::pow(err_norm, -1.0 / tab.error_order) : o.max_growth;
+        fac = std::min(std::max(fac, o.min_shrink), o.max_growth);
+
+        if (err_norm <= 1.0) {
+            t = clipped ? t_end : t + h;
+            y0_.swap(y_);
+            k_[0].swap(k_[S - 1]);
+            ++result.accepted_steps;
+            result.last_error_norm = err_norm;
+            result.max_error_norm = std::max(result.max_error_norm, err_norm);
+            if (rejected_last) fac = std::min(fac, 1.0);
+            rejected_last = false;
+            // A step shortened to land on t_end does not shrink the proposal.
+            dt = clipped ? std::max(dt, h * fac) : h * fac;
+        } else {
+            ++result.rejected_steps;
+            rejected_last = true;
+            dt = h * fac;
+        }
+        dt = std::min(dt, o.dt_max);
+        if (dt < o.dt_min) break;
+    }
+
+    for (std::size_t f = 0; f < nf; ++f) {
+        auto& fil = state.filaments[f];
+        if (!advected(fil)) continue;
+        std::copy(y0_.begin() + static_cast<std::ptrdiff_t>(off[f]),
+                  y0_.begin() + static_cast<std::ptrdiff_t>(off[f + 1]), fil.points.begin());
+    }
+    result.time = t;
+    result.completed = t >= t_end;
+    result.next_dt = next_dt_ = dt;
+    return result;
+}
+
+FilamentMultirateIntegrator::FilamentMultirateIntegrator(
+    const VelocityOptions& options,
+    const MultirateOptions& multirate)
+    : options_(options), multirate_(multirate) {
+    if (!(multirate_.cfl > 0.0) || !(multirate_.lia_stability > 0.0) || multirate_.max_level > 30) {
+        throw std::invalid_argument("multirate integrator: require cfl > 0, lia_stability > 0, max_level <= 30");
+    }
+}
+
+MultirateStepResult FilamentMultirateIntegrator::step(FilamentSystemState& state, double dt) {
+    if (!(dt > 0.0)) throw std::invalid_argument("multirate integrator: dt must be > 0");
+    const std::size_t total = workspace_.bind(state);
+    const std::vector<std::size_t>& off = workspace_.offsets;
+    const std::size_t nf = state.filaments.size();
+    for (auto* buf : {&x0_, &v0_, &x1_, &y_, &k_, &acc_, &stage_}) buf->resize(total);
+    group_.resize(nf);
+    level_.resize(nf);
+    for (std::size_t f = 0; f < nf; ++f) {
+        const auto& pts = state.filaments[f].points;
+        std::copy(pts.begin(), pts.end(), x0_.begin() + static_cast<std::ptrdiff_t>(off[f]));
+    }
+
+    MultirateStepResult result;
+    result.substeps.assign(nf, 1);
+    result.maximum_stage_speed =
+        FilamentVelocitySolver::evaluate_into(state, x0_.data(), options_, workspace_, v0_.data());
+    result.velocity_evaluations = 1;
+    result.target_evaluations = total;
+
+    std::size_t finest = 0;
+    for (std::size_t f = 0; f < nf; ++f) {
+        level_[f] = 0;
+        if (!advected(state.filaments[f])) continue;
+        const double local = filament_dt(state.filaments[f], &x0_[off[f]], &v0_[off[f]], off[f + 1] - off[f],
+                                         options_, multirate_);
+        while (level_[f] < multirate_.max_level && dt / static_cast<double>(std::size_t(1) << level_[f]) > local) {
+            ++level_[f];
+        }
+        result.substeps[f] = std::size_t(1) << level_[f];
+        finest = std::max(finest, level_[f]);
+    }
+    x1_ = x0_;
+
+    for (std::size_t level = 0; level <= finest; ++level) {
+        std::size_t group_points = 0;
+        for (std::size_t f = 0; f < nf; ++f) {
+            group_[f] = advected(state.filaments[f]) && level_[f] == level;
+            if (group_[f]) group_points += off[f + 1] - off[f];
+        }
+        if (group_points == 0) continue;
+        const std::size_t n_sub = std::size_t(1) << level;
+        const double h = dt / static_cast<double>(n_sub);
+
+        // Source positions at time tau after the macro start; the group sits at y_ + scale * k_.
+        const auto stage_positions = [&](double tau, double scale) {
+            const double s2 = (tau / dt) * (tau / dt);
+            for (std::size_t f = 0; f < nf; ++f) {
+                const bool move = advected(state.filaments[f]);
+                for (std::size_t i = off[f]; i < off[f + 1]; ++i) {
+                    if (group_[f]) {
+                        stage_[i] = add_scaled(y_[i], k_[i], scale);
+                    } else if (!move) {
+                        stage_[i] = x0_[i];
+                    } else if (level_[f] < level) {
+                        const Vec3 drift = add_scaled(diff(x1_[i], x0_[i]), v0_[i], -dt);
+                        stage_[i] = add_scaled(add_scaled(x0_[i], v0_[i], tau), drift, s2);
+                    } else {
+                        stage_[i] = add_scaled(x0_[i], v0_[i], tau);
+                    }
+                }
+            }
+        };
+        const auto evaluate = [&]() {
+            const double speed = FilamentVelocitySolver::evaluate_into(
+                state, stage_.data(), options_, workspace_, k_.data(), &group_);
+            result.maximum_stage_speed = std::max(result.maximum_stage_speed, speed);
+            ++result.velocity_evaluations;
+            result.target_evaluations += group_points;
+        };
+        const auto for_group = [&](auto&& body) {
+            for (std::size_t f = 0; f < nf; ++f) {
+                if (!group_[f]) continue;
+                for (std::size_t i = off[f]; i < off[f + 1]; ++i) body(i);
+            }
+        };
+        const auto accumulate = [&](double weight) {
+            for_group([&](std::size_t i) {
+                acc_[i][0] += weight * k_[i][0];
+                acc_[i][1] += weight * k_[i][1];
+                acc_[i][2] += weight * k_[i][2];
+            });
+        };
+
+        for_group([&](std::size_t i) { y_[i] = x0_[i]; });
+        for (std::size_t n = 0; n < n_sub; ++n) {
+            const double t = static_cast<double>(n) * h;
+            if (n == 0) {
+                for_group([&](std::size_t i) { k_[i] = v0_[i]; });
+            } else {
+                stage_positions(t, 0.0);
+                evaluate();
+            }
+            for_group([&](std::size_t i) { acc_[i] = k_[i]; });
+
+            stage_positions(t + 0.5 * h, 0.5 * h);
+            evaluate();
+            accumulate(2.0);
+
+            stage_positions(t + 0.5 * h, 0.5 * h);
+            evaluate();
+            accumulate(2.0);
+
+            stage_positions(t + h, h);
+            evaluate();
+            accumulate(1.0);
+
+            for_group([&](std::size_t i) {
+                y_[i][0] += (h / 6.0) * acc_[i][0];
+                y_[i][1] += (h / 6.0) * acc_[i][1];
+                y_[i][2] += (h / 6.0) * acc_[i][2];
+            });
+        }
+        for_group([&](std::size_t i) { x1_[i] = y_[i]; });
+    }
+
+    for (std::size_t f = 0; f < nf; ++f) {
+        auto& fil = state.filaments[f];
+        if (!advected(fil)) continue;
+        std::copy(x1_.begin() + static_cast<std::ptrdiff_t>(off[f]),
+                  x1_.begin() + static_cast<std::ptrdiff_t>(off[f + 1]), fil.points.begin());
+    }
+    return result;
+}
+
+FilamentImexIntegrator::FilamentImexIntegrator(const VelocityOptions& options, const ImexOptions& imex)
+    : options_(options), mutual_(options), imex_(imex) {
+    if (!(imex.theta >= 0.5 && imex.theta <= 1.0))
+        throw std::invalid_argument("imex: theta must lie in [0.5, 1]");
+    mutual_.include_lia = false;
+}
+
+double FilamentImexIntegrator::implicit_stage(const FilamentSystemState& state, const Vec3* z,
+                                              double mutual_weight, double local_weight, double h, Vec3* y) {
+    const std::vector<std::size_t>& off = workspace_.offsets;
+    const std::size_t nf = state.filaments.size();
+    std::vector<double> speed(nf, 0.0);
+    // Filaments are independent here; each task writes only its own point range.
+    parallel_for(nf, options_.num_threads, [&](std::size_t f) {
+        const auto& fil = state.filaments[f];
+        const std::size_t o = off[f];
+        const std::size_t N = off[f + 1] - o;
+        if (fil.ghost) return;
+        Vec3* c = coupling_.data() + o;
+        if (options_.include_lia) {
+            lia_coupling(fil, z + o, N, options_, c);
+        } else {
+            std::fill(c, c + N, Vec3{{0, 0, 0}});
+        }
+        const Vec3* x = x0_.data() + o;
+        double um = 0.0;
+        for (std::size_t i = 0; i < N; ++i) {
+            const std::size_t im = (i + N - 1) % N;
+            const std::size_t ip = (i + 1) % N;
+            const Vec3& u = u_[o + i];
+            const Vec3 lz = cross(c[i], {z[o + ip][0] - 2.0 * z[o + i][0] + z[o + im][0],
+                                         z[o + ip][1] - 2.0 * z[o + i][1] + z[o + im][1],
+                                         z[o + ip][2] - 2.0 * z[o + i][2] + z[o + im][2]});
+            const Vec3 v = {u[0] + lz[0], u[1] + lz[1], u[2] + lz[2]};
+            um = std::max(um, dot(v, v));
+            const Vec3 lx = cross(c[i], {x[ip][0] - 2.0 * x[i][0] + x[im][0],
+                                         x[ip][1] - 2.0 * x[i][1] + x[im][1],
+                                         x[ip][2] - 2.0 * x[i][2] + x[im][2]});
+            rhs_[o + i] = add_scaled(add_scaled(x[i], u, mutual_weight), lx, local_weight);
+        }
+        speed[f] = um;
+        if (!advected(fil)) {
+            std::copy(x, x + N, y + o);
+        } else if (N < 3) {
+            std::copy(rhs_.begin() + static_cast<std::ptrdiff_t>(o),
+                      rhs_.begin() + static_cast<std::ptrdiff_t>(o + N), y + o);
+        } else {
+            for (std::size_t i = 0; i < N; ++i) c[i] = {h * c[i][0], h * c[i][1], h * c[i][2]};
+            solve_cyclic_lia(c, rhs_.data() + o, N, y + o, gain_.data() + o, shift_.data() + o);
+        }
     });
+    double um = 0.0;
+    for (const double s : speed) um = std::max(um, s);
+    return std::sqrt(um);
+}
+
+ImexStepResult FilamentImexIntegrator::step(FilamentSystemState& state, double dt) {
+    const std::size_t total = workspace_.bind(state);
+    const std::vector<std::size_t>& off = workspace_.offsets;
+    const std::size_t nf = state.filaments.size();
+    for (auto* v : {&x0_, &x1_, &y_, &u_, &rhs_, &coupling_}) v->resize(total);
+    gain_.resize(total);
+    shift_.resize(total);
+    for (std::size_t f = 0; f < nf; ++f) {
+        const auto& pts = state.filaments[f].points;
+        std::copy(pts.begin(), pts.end(), x0_.begin() + static_cast<std::ptrdiff_t>(off[f]));
+    }
+
+    ImexStepResult result;
+    result.maximum_mutual_speed = FilamentVelocitySolver::evaluate_into(state, x0_.data(), mutual_, workspace_, u_.data());
+    if (imex_.scheme == ImexScheme::Euler) {
+        // (I - theta dt L0) x1 = x0 + dt N(x0) + (1 - theta) dt L0 x0
+        result.maximum_stage_speed = implicit_stage(state, x0_.data(), dt, (1.0 - imex_.theta) * dt,
+                                                    imex_.theta * dt, x1_.data());
+    } else {
+        // Predictor (I - dt/2 L0) y = x0 + dt/2 N(x0); corrector, with L frozen at the midpoint,
+        // (I - dt/2 Ly) x1 = x0 + dt N(y) + dt/2 Ly x0.
+        result.maximum_stage_speed = implicit_stage(state, x0_.data(), 0.5 * dt, 0.0, 0.5 * dt, y_.data());
+        result.maximum_mutual_speed = std::max(
+            result.maximum_mutual_speed,
+            FilamentVelocitySolver::evaluate_into(state, y_.data(), mutual_, workspace_, u_.data()));
+        result.maximum_stage_speed = std::max(
+            result.maximum_stage_speed, implicit_stage(state, y_.data(), dt, 0.5 * dt, 0.5 * dt, x1_.data()));
+    }
+
+    for (std::size_t f = 0; f < nf; ++f) {
+        auto& fil = state.filaments[f];
+        if (!advected(fil)) continue;
+        std::copy(x1_.begin() + static_cast<std::ptrdiff_t>(off[f]),
+                  x1_.begin() + static_cast<std::ptrdiff_t>(off[f + 1]), fil.points.begin());
+    }
     return result;
 }
 
+std::vector<double> FilamentIntegrator::estimate_filament_dt(
+    const FilamentSystemState& state,
+    const VelocityOptions& options,
+    const MultirateOptions& multirate) {
+    const VelocityFieldResult vel = FilamentVelocitySolver::evaluate(state, options);
+    std::vector<double> out(state.filaments.size());
+    for (std::size_t f = 0; f < out.size(); ++f) {
+        const auto& fil = state.filaments[f];
+        out[f] = filament_dt(fil, fil.points.data(), vel.velocity[f].data(), fil.points.size(), options, multirate);
+    }
+    return out;
+}
+
 double FilamentIntegrator::estimate_cfl_dt(
     const FilamentSystemState& state,
     const VelocityOptions& options,
@@ -3,8 +3,16 @@
 
 #pragma once
 
+#include "filament/velocity_solver.h"
 #include "vortexlab/types.h"
 
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 namespace sst {
 namespace filament {
 
@@ -13,6 +21,208 @@ struct IntegratorStepResult {
     double maximum_stage_speed = 0.0;
 };
 
+/**
+ * Reusable classical RK4 stepper for long runs: owns flat stage buffers and the velocity
+ * workspace, and advances a state in place. After the first step on a given filament layout
+ * (and with the direct mutual backend) a step performs no heap allocation. Results are bitwise
+ * equal to FilamentIntegrator::rk4_step.
+ */
+class FilamentRK4Stepper {
+public:
+    explicit FilamentRK4Stepper(const VelocityOptions& options = {});
+
+    /** One RK4 step of size dt on state.points; returns the maximum stage speed. */
+    double step(FilamentSystemState& state, double dt);
+
+    const VelocityOptions& options() const { return options_; }
+    void set_options(const VelocityOptions& options) { options_ = options; }
+    /** Stage buffers; neighbours.stats() reports the cutoff backend's list rebuilds and size. */
+    const VelocityWorkspace& workspace() const { return workspace_; }
+
+private:
+    VelocityOptions options_;
+    VelocityWorkspace workspace_;
+    std::vector<Vec3> y0_;    // positions at the start of the step
+    std::vector<Vec3> y_;     // stage positions
+    std::vector<Vec3> k_;     // stage velocity
+    std::vector<Vec3> acc_;   // k1 + 2 k2 + 2 k3 + k4
+};
+
+/** Embedded Runge–Kutta pair of FilamentAdaptiveIntegrator (both first-same-as-last). */
+enum class EmbeddedScheme {
+    BogackiShampine32,  // 3rd order, 2nd-order error estimate, 3 new evaluations per step
+    DormandPrince54     // 5th order, 4th-order error estimate, 6 new evaluations per step
+};
+
+struct AdaptiveStepOptions {
+    EmbeddedScheme scheme = EmbeddedScheme::DormandPrince54;
+    // Mixed error norm: RMS over advected coordinates of err / (atol + rtol * max(|y0|, |y1|)).
+    double rtol = 1e-6;
+    double atol = 1e-9;
+    // First step (0 = cfl * min segment length / speed from the first stage, no extra evaluation).
+    double dt_initial = 0.0;
+    double cfl = 0.5;
+    double dt_min = 1e-12;
+    double dt_max = std::numeric_limits<double>::infinity();
+    // Step-size controller: dt *= clamp(safety * norm^(-1/(q+1)), min_shrink, max_growth).
+    double safety = 0.9;
+    double min_shrink = 0.2;
+    double max_growth = 5.0;
+    std::size_t max_steps = 1000000;  // accepted + rejected attempts per advance call
+};
+
+struct AdaptiveIntegrationResult {
+    double time = 0.0;                // time reached (t_end unless completed is false)
+    bool completed = false;           // false: max_steps hit or dt fell below dt_min
+    std::size_t accepted_steps = 0;
+    std::size_t rejected_steps = 0;
+    std::size_t velocity_evaluations = 0;
+    double last_error_norm = 0.0;     // of the last accepted step
+    double max_error_norm = 0.0;      // over accepted steps (each <= 1)
+    double next_dt = 0.0;             // proposed size of the following step
+    double maximum_stage_speed = 0.0;
+};
+
+/**
+ * Error-controlled embedded Runge–Kutta driver. advance() moves a state to a target time with
+ * automatic step growth and shrink; the last stage of an accepted step is the first stage of
+ * the next (FSAL), so a DP5(4) step costs six velocity evaluations and BS3(2) three. The
+ * proposed step size carries over between advance calls. Buffers follow FilamentRK4Stepper.
+ */
+class FilamentAdaptiveIntegrator {
+public:
+    /** Throws std::invalid_argument on non-positive tolerances or an inconsistent dt range. */
+    explicit FilamentAdaptiveIntegrator(const VelocityOptions& options = {},
+                                        const AdaptiveStepOptions& step_options = {});
+
+    /** Advance state from t0 to t_end (>= t0, else std::invalid_argument) in place. */
+    AdaptiveIntegrationResult advance(FilamentSystemState& state, double t0, double t_end);
+
+    const AdaptiveStepOptions& step_options() const { return step_options_; }
+
+private:
+    VelocityOptions options_;
+    AdaptiveStepOptions step_options_;
+    double next_dt_ = 0.0;
+    VelocityWorkspace workspace_;
+    std::vector<Vec3> y0_;                // accepted positions
+    std::vector<Vec3> y_;                 // stage positions (the last stage is the proposal)
+    std::vector<std::vector<Vec3>> k_;    // stage velocities
+};
+
+struct MultirateOptions {
+    // Per-filament step: cfl * own min segment length / own max speed, capped by the explicit
+    // LIA stability bound lia_stability * 4π ds² / (|Γ| Λ) (tight for finely sampled or curled
+    // filaments; Λ is the solver's log factor at the shortest segment).
+    double cfl = 0.5;
+    double lia_stability = 0.5;
+    // Finest level: a filament takes at most 2^max_level substeps per macro step.
+    std::size_t max_level = 6;
+};
+
+struct MultirateStepResult {
+    std::vector<std::size_t> substeps;    // per filament (1 for non-advected filaments)
+    std::size_t velocity_evaluations = 0; // solver calls (each on one level's filaments)
+    std::size_t target_evaluations = 0;   // target points summed over those calls
+    double maximum_stage_speed = 0.0;
+};
+
+/**
+ * Multirate RK4: each advected filament is stepped with dt / 2^level, its level chosen from
+ * its own speed and resolution at the start of the macro step, so a few tightly curled
+ * filaments no longer force small steps on slow large rings. Levels advance slowest first; a
+ * filament's RK4 stages see coarser filaments (already at t + dt) through quadratic Hermite
+ * interpolation of x(t), x(t + dt), v(t), and finer ones linearly extrapolated from x(t), v(t).
+ * Filaments of the same level are coupled exactly. With every filament on one level the step
+ * equals FilamentRK4Stepper bit for bit.
+ */
+class FilamentMultirateIntegrator {
+public:
+    explicit FilamentMultirateIntegrator(const VelocityOptions& options = {},
+                                         const MultirateOptions& multirate = {});
+
+    /** One macro step of size dt, in place. */
+    MultirateStepResult step(FilamentSystemState& state, double dt);
+
+private:
+    VelocityOptions options_;
+    MultirateOptions multirate_;
+    VelocityWorkspace workspace_;
+    std::vector<Vec3> x0_, v0_, x1_;      // macro start, start velocity, advanced positions
+    std::vector<Vec3> y_, k_, acc_, stage_;
+    std::vector<char> group_;
+    std::vector<std::size_t> level_;
+};
+
+/** Time discretisation of FilamentImexIntegrator. */
+enum class ImexScheme {
+    Euler,     // theta-method on the local term, forward Euler on the mutual sum (1st order)
+    Midpoint   // implicit half step to the midpoint, then Crank–Nicolson on the local term frozen
+               // there with the mutual sum at the midpoint (2nd order)
+};
+
+struct ImexOptions {
+    ImexScheme scheme = ImexScheme::Midpoint;
+    // Implicit weight of the local term for ImexScheme::Euler, in [0.5, 1]: 0.5 is
+    // Crank–Nicolson (no damping of the dispersive LIA modes), 1 backward Euler (damps them).
+    double theta = 0.5;
+};
+
+struct ImexStepResult {
+    double maximum_mutual_speed = 0.0;  // explicit (non-local) velocity, max over its evaluations
+                                        // (step start; also the midpoint for Midpoint)
+    double maximum_stage_speed = 0.0;   // full velocity of the evaluated stages
+};
+
+/**
+ * Semi-implicit (IMEX) stepper for stiff, finely sampled filaments. The solver's discrete LIA
+ * term lf_i (X_i - X_{i-1}) x (X_{i+1} - X_i) equals lf_i t_i x (X_{i+1} - 2 X_i + X_{i-1})
+ * with t_i the mean of the two segments; freezing lf_i and t_i at the step start makes it
+ * linear, and it is solved implicitly as one cyclic block-tridiagonal (3x3) system per
+ * filament in O(N). The mutual Biot–Savart sum (VelocityOptions::include_lia = false) stays
+ * explicit, so dt is bounded by the large-scale speed instead of the ~ds² LIA limit.
+ */
+class FilamentImexIntegrator {
+public:
+    /** Throws std::invalid_argument on theta outside [0.5, 1]. */
+    explicit FilamentImexIntegrator(const VelocityOptions& options = {}, const ImexOptions& imex = {});
+
+    /** One step of size dt on state.points, in place. */
+    ImexStepResult step(FilamentSystemState& state, double dt);
+
+    const ImexOptions& imex_options() const { return imex_; }
+
+private:
+    VelocityOptions options_;
+    VelocityOptions mutual_;  // options_ without the local term
+    ImexOptions imex_;
+    VelocityWorkspace workspace_;
+    std::vector<Vec3> x0_, x1_, y_;       // step start, step end, midpoint predictor
+    std::vector<Vec3> u_, rhs_, coupling_;
+    std::vector<std::array<double, 9>> gain_, shift_;  // block-Thomas factors
+
+    // Solve (I - h Lz) y = x0 + mutual_weight * u_ + local_weight * Lz x0 per advected filament,
+    // Lz frozen at positions z (u_ holds the mutual velocity at z); returns the full speed at z.
+    double implicit_stage(const FilamentSystemState& state, const Vec3* z,
+                          double mutual_weight, double local_weight, double h, Vec3* y);
+};
+
+inline ImexScheme imex_scheme_from_name(const std::string& name) {
+    if (name == "midpoint" || name == "imex_midpoint") return ImexScheme::Midpoint;
+    if (name == "euler" || name == "theta" || name == "imex_euler") return ImexScheme::Euler;
+    throw std::invalid_argument("unknown IMEX scheme: " + name);
+}
+
+inline EmbeddedScheme embedded_scheme_from_name(const std::string& name) {
+    if (name == "dopri5" || name == "dp54" || name == "dormand_prince") return EmbeddedScheme::DormandPrince54;
+    if (name == "bs32" || name == "bogacki_shampine") return EmbeddedScheme::BogackiShampine32;
+    throw std::invalid_argument("unknown embedded scheme: " + name);
+}
+
+inline const char* embedded_scheme_name(EmbeddedScheme scheme) {
+    return scheme == EmbeddedScheme::BogackiShampine32 ? "bs32" : "dopri5";
+}
+
 class FilamentIntegrator {
 public:
     static IntegratorStepResult rk4_step(
@@ -20,6 +230,12 @@ public:
         double dt,
         const VelocityOptions& options);
 
+    /** Per-filament step sizes used by FilamentMultirateIntegrator (inf for non-advected). */
+    static std::vector<double> estimate_filament_dt(
+        const FilamentSystemState& state,
+        const VelocityOptions& options,
+        const MultirateOptions& multirate = {});
+
     /** CFL estimate: cfl * min_segment_length / max_speed (default cfl = 0.5). */
     static double estimate_cfl_dt(
         const FilamentSystemState& state,
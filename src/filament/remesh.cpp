@@ -0,0 +1,157 @@
+#include "filament/remesh.h"
+
+#include "geometry/periodic_spline.h"
+#include "sst/types.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace sst {
+namespace filament {
+namespace {
+
+double spline_curvature(const geometry::SplineEval& ev) {
+    const double speed = norm(ev.d1);
+    if (!(speed > 1e-30)) return 0.0;
+    const double k = norm(cross(ev.d1, ev.d2)) / (speed * speed * speed);
+    return std::isfinite(k) ? k : 0.0;
+}
+
+}  // namespace
+
+void FilamentRemesher::validate(const RemeshOptions& options) {
+    if (!(options.max_turning_angle > 0.0))
+        throw std::invalid_argument("remesh: max_turning_angle must be > 0");
+    if (!(options.min_turning_angle >= 0.0) || options.min_turning_angle >= options.max_turning_angle)
+        throw std::invalid_argument("remesh: min_turning_angle must lie in [0, max_turning_angle)");
+    if (!(options.max_segment_length > 0.0))
+        throw std::invalid_argument("remesh: max_segment_length must be > 0");
+    if (!(options.min_segment_length >= 0.0) || options.min_segment_length >= options.max_segment_length)
+        throw std::invalid_argument("remesh: min_segment_length must lie in [0, max_segment_length)");
+    if (options.min_points < 4) throw std::invalid_argument("remesh: min_points must be >= 4");
+    if (options.max_points < options.min_points)
+        throw std::invalid_argument("remesh: max_points must be >= min_points");
+}
+
+std::vector<Vec3> FilamentRemesher::remesh_points(const std::vector<Vec3>& points,
+                                                  const RemeshOptions& options,
+                                                  RemeshStats* stats) {
+    validate(options);
+    const std::size_t n = points.size();
+    if (n < 4) {
+        if (stats) stats->points += n;
+        return points;
+    }
+    const geometry::PeriodicCubicSpline3D spline(points);
+    const double L = spline.length();
+    std::vector<double> kappa(n);
+    for (std::size_t i = 0; i < n; ++i) kappa[i] = spline_curvature(spline.eval(spline.parameter_at(i)));
+
+    // Coarsen: drop point i (never two neighbours, never point 0) when the merged segment
+    // i-1 -> i+1 is flat, or when i is crowded and the merged segment is still acceptable.
+    std::vector<char> keep(n, 1);
+    std::size_t kept = n;
+    for (std::size_t i = 1; i < n && kept > options.min_points; ++i) {
+        if (!keep[i - 1]) continue;
+        const std::size_t ip = (i + 1) % n;
+        const double h_prev = spline.parameter_at(i) - spline.parameter_at(i - 1);
+        const double h_next = spline.parameter_at(i + 1) - spline.parameter_at(i);
+        const double merged = h_prev + h_next;
+        if (merged > options.max_segment_length) continue;
+        const double turn = std::max({kappa[i - 1], kappa[i], kappa[ip]}) * merged;
+        const bool flat = turn < options.min_turning_angle;
+        const bool crowded = std::min(h_prev, h_next) < options.min_segment_length
+                             && turn <= options.max_turning_angle;
+        if (flat || crowded) {
+            keep[i] = 0;
+            --kept;
+        }
+    }
+
+    // Refine: split each kept span [a, b] into enough pieces for both bounds.
+    std::vector<std::size_t> anchors;
+    anchors.reserve(kept);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (keep[i]) anchors.push_back(i);
+    }
+    if (anchors.size() > options.max_points) {
+        // More kept points than the budget: keep an evenly spaced subset (always point 0).
+        std::vector<std::size_t> thinned(options.max_points);
+        for (std::size_t j = 0; j < options.max_points; ++j) {
+            thinned[j] = anchors[j * anchors.size() / options.max_points];
+        }
+        anchors.swap(thinned);
+    }
+    const std::size_t m = anchors.size();
+    std::vector<std::size_t> pieces(m, 1);
+    std::vector<double> span(m);
+    std::size_t extra = 0;
+    for (std::size_t j = 0; j < m; ++j) {
+        const std::size_t a = anchors[j];
+        const std::size_t b = (j + 1 < m) ? anchors[j + 1] : n;
+        const double len = spline.parameter_at(b) - spline.parameter_at(a);
+        span[j] = len;
+        double kmax = 0.0;
+        for (std::size_t i = a; i <= b; ++i) kmax = std::max(kmax, kappa[i % n]);
+        const double by_length = std::ceil(len / options.max_segment_length);
+        const double by_turn = std::ceil(kmax * len / options.max_turning_angle);
+        const double want = std::max({1.0, by_length, by_turn});
+        pieces[j] = want < 1e9 ? static_cast<std::size_t>(want) : std::size_t(1000000000);
+        extra += pieces[j] - 1;
+    }
+    if (m + extra > options.max_points) {
+        // Over budget: scale every span's insertions down by the same factor.
+        const double scale = options.max_points > m
+                                 ? static_cast<double>(options.max_points - m) / static_cast<double>(extra)
+                                 : 0.0;
+        extra = 0;
+        for (auto& p : pieces) {
+            p = 1 + static_cast<std::size_t>(std::floor(static_cast<double>(p - 1) * scale));
+            extra += p - 1;
+        }
+    }
+    while (m + extra < options.min_points) {
+        // Under the floor: split the span with the longest pieces once more.
+        std::size_t best = 0;
+        for (std::size_t j = 1; j < m; ++j) {
+            if (span[j] * static_cast<double>(pieces[best]) > span[best] * static_cast<double>(pieces[j])) best = j;
+        }
+        ++pieces[best];
+        ++extra;
+    }
+
+    std::vector<Vec3> out;
+    out.reserve(m + extra);
+    for (std::size_t j = 0; j < m; ++j) {
+        const std::size_t a = anchors[j];
+        const std::size_t b = (j + 1 < m) ? anchors[j + 1] : n;
+        out.push_back(points[a]);
+        const double sa = spline.parameter_at(a);
+        const double du = (spline.parameter_at(b) - sa) / static_cast<double>(pieces[j]);
+        for (std::size_t k = 1; k < pieces[j]; ++k) {
+            out.push_back(spline.eval(std::min(sa + du * static_cast<double>(k), L)).p);
+        }
+    }
+    if (stats) {
+        stats->removed += n - m;
+        stats->inserted += extra;
+        stats->points += out.size();
+        if (n != m || extra != 0) ++stats->filaments_changed;
+    }
+    return out;
+}
+
+RemeshStats FilamentRemesher::remesh(FilamentSystemState& state, const RemeshOptions& options) {
+    validate(options);
+    RemeshStats stats;
+    for (auto& fil : state.filaments) {
+        if (fil.ghost || !fil.dynamic) continue;
+        fil.points = remesh_points(fil.points, options, &stats);
+    }
+    return stats;
+}
+
+}  // namespace filament
+}  // namespace sst
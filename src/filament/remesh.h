@@ -0,0 +1,64 @@
+#ifndef SSTCORE_FILAMENT_REMESH_H
+#define SSTCORE_FILAMENT_REMESH_H
+
+#pragma once
+
+#include "vortexlab/types.h"
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace sst {
+namespace filament {
+
+struct RemeshOptions {
+    // Turning angle of a segment is estimated as kappa * ds with kappa from the periodic spline.
+    // A segment is split until each piece turns by at most max_turning_angle; a point is dropped
+    // when the merged segment would turn by less than min_turning_angle (flat regions).
+    double max_turning_angle = 0.25;
+    double min_turning_angle = 0.05;
+    // Stretch bounds: longer segments are split, points closer than min_segment_length merged
+    // (when the merged segment still satisfies max_turning_angle and max_segment_length).
+    double max_segment_length = std::numeric_limits<double>::infinity();
+    double min_segment_length = 0.0;
+    // Per-filament point count bounds (min_points >= 4, the spline minimum).
+    std::size_t min_points = 8;
+    std::size_t max_points = 100000;
+};
+
+struct RemeshStats {
+    std::size_t inserted = 0;
+    std::size_t removed = 0;
+    std::size_t points = 0;               // advected points after remeshing
+    std::size_t filaments_changed = 0;
+};
+
+/**
+ * Curvature-adaptive remeshing of closed filaments, meant to run between integrator steps so
+ * the point count (and the O(N²) velocity cost) follows the geometry instead of the initial
+ * sampling. Kept points are unchanged; new points are sampled from a PeriodicCubicSpline3D
+ * through the old ones, evenly in its chord-length parameter within each split segment. One
+ * call removes at most every other point, so flattening regions coarsen over several calls.
+ * The result always has between min_points and max_points points: a curve whose kept points
+ * exceed max_points is thinned to an evenly spaced subset of them, and a curve below
+ * min_points gets extra samples in its longest spans.
+ */
+class FilamentRemesher {
+public:
+    /** Remesh every advected filament in place (ghost and static filaments are left as is). */
+    static RemeshStats remesh(FilamentSystemState& state, const RemeshOptions& options);
+
+    /** Remesh one closed polyline; curves with fewer than 4 points are returned unchanged. */
+    static std::vector<Vec3> remesh_points(const std::vector<Vec3>& points,
+                                           const RemeshOptions& options,
+                                           RemeshStats* stats = nullptr);
+
+    /** Throws std::invalid_argument on inconsistent thresholds or point bounds. */
+    static void validate(const RemeshOptions& options);
+};
+
+}  // namespace filament
+}  // namespace sst
+
+#endif
@@ -0,0 +1,496 @@
+#include "filament/trajectory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sst {
+namespace filament {
+namespace {
+
+constexpr char kFileMagic[8] = {'S', 'S', 'T', 'T', 'R', 'A', 'J', '1'};
+constexpr std::uint32_t kByteOrderMark = 0x01020304u;
+constexpr std::uint32_t kFrameMagic = 0x4D415246u;             // "FRAM"
+constexpr std::uint64_t kFrameEnd = 0x444E454D41524653ull;     // "SFRAMEND"
+
+constexpr std::uint32_t kFlagDynamic = 1u;
+constexpr std::uint32_t kFlagSource = 2u;
+constexpr std::uint32_t kFlagGhost = 4u;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t header_bytes;       // including the diagnostic names
+    std::uint32_t diagnostic_count;
+    std::uint64_t reserved[3];
+};
+static_assert(sizeof(FileHeader) == 48, "FileHeader layout");
+
+struct FrameHeader {
+    std::uint32_t magic;
+    std::uint32_t channels;
+    std::uint64_t frame_bytes;        // header through end mark
+    std::uint64_t step;
+    double time;
+    std::uint64_t point_count;
+    std::uint32_t filament_count;
+    std::uint32_t diagnostic_count;
+    std::uint64_t meta_bytes;         // filament records + strings, padded to 8
+    std::uint64_t reserved;
+};
+static_assert(sizeof(FrameHeader) == 64, "FrameHeader layout");
+
+struct FilamentRecord {
+    double circulation;
+    std::uint32_t flags;
+    std::uint32_t id_bytes;
+    std::uint32_t carrier_bytes;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(FilamentRecord) == 24, "FilamentRecord layout");
+static_assert(sizeof(Vec3) == 3 * sizeof(double), "Vec3 must be three packed doubles");
+
+std::size_t pad8(std::size_t n) {
+    return (n + 7u) & ~std::size_t(7u);
+}
+
+std::size_t frame_bytes(std::size_t filaments, std::size_t meta, std::size_t points, bool velocity,
+                        std::size_t diagnostics) {
+    return sizeof(FrameHeader) + (filaments + 1) * sizeof(std::uint64_t) + meta
+           + points * sizeof(Vec3) * (velocity ? 2u : 1u) + diagnostics * sizeof(double)
+           + sizeof(std::uint64_t);
+}
+
+void write_all(std::FILE* f, const void* data, std::size_t bytes, const std::string& path) {
+    if (bytes == 0) return;
+    if (std::fwrite(data, 1, bytes, f) != bytes) {
+        throw std::runtime_error("trajectory write failed: " + path);
+    }
+}
+
+void write_padding(std::FILE* f, std::size_t bytes, const std::string& path) {
+    static const unsigned char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    write_all(f, zeros, pad8(bytes) - bytes, path);
+}
+
+// fsync a closed file, or a directory so that a rename inside it is durable (directories
+// cannot be flushed on Windows; that case is a no-op).
+void sync_to_disk(const std::string& path, bool directory) {
+#if defined(_WIN32)
+    if (directory) return;
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("could not open for sync: " + path);
+    const bool ok = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    if (!ok) throw std::runtime_error("could not sync: " + path);
+#else
+    const int fd = ::open(path.c_str(), directory ? (O_RDONLY | O_DIRECTORY) : O_RDONLY);
+    if (fd < 0) throw std::runtime_error("could not open for sync: " + path);
+    const int rc = ::fsync(fd);
+    ::close(fd);
+    if (rc != 0) throw std::runtime_error("could not sync: " + path);
+#endif
+}
+
+template <class T>
+T load(const unsigned char* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------------------------
+// Writer
+
+TrajectoryWriter::TrajectoryWriter(const std::string& path,
+                                   const std::vector<std::string>& diagnostic_names,
+                                   const TrajectoryWriterOptions& options)
+    : path_(path), names_(diagnostic_names), options_(options) {
+    std::error_code ec;
+    const bool resume = options.append && std::filesystem::exists(path, ec)
+                        && std::filesystem::file_size(path, ec) > 0;
+    if (resume) {
+        std::size_t valid = 0;
+        {
+            TrajectoryReader existing(path);
+            if (existing.diagnostic_names() != names_) {
+                throw std::invalid_argument("trajectory append: diagnostic names differ from " + path);
+            }
+            frames_ = existing.frame_count();
+            valid = existing.valid_bytes();
+        }
+        // Drop a frame torn by an interrupted run before appending after it.
+        std::filesystem::resize_file(path, valid, ec);
+        if (ec) throw std::runtime_error("could not truncate trajectory: " + path);
+        file_ = std::fopen(path.c_str(), "ab");
+        if (!file_) throw std::runtime_error("could not open trajectory for append: " + path);
+        return;
+    }
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) throw std::runtime_error("could not open trajectory output path: " + path);
+    std::size_t names_bytes = 0;
+    for (const auto& n : names_) names_bytes += sizeof(std::uint32_t) + n.size();
+    FileHeader h{};
+    std::memcpy(h.magic, kFileMagic, sizeof(kFileMagic));
+    h.version = kTrajectoryVersion;
+    h.byte_order = kByteOrderMark;
+    h.header_bytes = static_cast<std::uint32_t>(sizeof(FileHeader) + pad8(names_bytes));
+    h.diagnostic_count = static_cast<std::uint32_t>(names_.size());
+    write_all(file_, &h, sizeof(h), path_);
+    for (const auto& n : names_) {
+        const auto len = static_cast<std::uint32_t>(n.size());
+        write_all(file_, &len, sizeof(len), path_);
+        write_all(file_, n.data(), n.size(), path_);
+    }
+    write_padding(file_, names_bytes, path_);
+    flush();
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+    if (file_) std::fclose(file_);
+}
+
+void TrajectoryWriter::append(const FilamentSystemState& state,
+                              double time,
+                              std::uint64_t step,
+                              const std::vector<std::vector<Vec3>>* velocity,
+                              const std::vector<double>& diagnostics) {
+    if (!file_) throw std::runtime_error("trajectory writer is closed: " + path_);
+    if (diagnostics.size() != names_.size()) {
+        throw std::invalid_argument("trajectory append: expected " + std::to_string(names_.size())
+                                    + " diagnostics, got " + std::to_string(diagnostics.size()));
+    }
+    const std::size_t nf = state.filaments.size();
+    if (velocity) {
+        if (velocity->size() != nf) throw std::invalid_argument("trajectory append: velocity filament count");
+        for (std::size_t f = 0; f < nf; ++f) {
+            if ((*velocity)[f].size() != state.filaments[f].points.size()) {
+                throw std::invalid_argument("trajectory append: velocity point count");
+            }
+        }
+    }
+
+    std::size_t points = 0, strings = 0;
+    for (const auto& fil : state.filaments) {
+        points += fil.points.size();
+        strings += fil.id.size() + fil.carrier.size();
+    }
+    const std::size_t meta = pad8(nf * sizeof(FilamentRecord) + strings);
+
+    FrameHeader h{};
+    h.magic = kFrameMagic;
+    h.channels = velocity ? kTrajectoryChannelVelocity : 0u;
+    h.frame_bytes = frame_bytes(nf, meta, points, velocity != nullptr, names_.size());
+    h.step = step;
+    h.time = time;
+    h.point_count = points;
+    h.filament_count = static_cast<std::uint32_t>(nf);
+    h.diagnostic_count = static_cast<std::uint32_t>(names_.size());
+    h.meta_bytes = meta;
+    write_all(file_, &h, sizeof(h), path_);
+
+    std::uint64_t offset = 0;
+    write_all(file_, &offset, sizeof(offset), path_);
+    for (const auto& fil : state.filaments) {
+        offset += fil.points.size();
+        write_all(file_, &offset, sizeof(offset), path_);
+    }
+    for (const auto& fil : state.filaments) {
+        FilamentRecord r{};
+        r.circulation = fil.circulation;
+        r.flags = (fil.dynamic ? kFlagDynamic : 0u) | (fil.source ? kFlagSource : 0u)
+                  | (fil.ghost ? kFlagGhost : 0u);
+        r.id_bytes = static_cast<std::uint32_t>(fil.id.size());
+        r.carrier_bytes = static_cast<std::uint32_t>(fil.carrier.size());
+        write_all(file_, &r, sizeof(r), path_);
+    }
+    for (const auto& fil : state.filaments) {
+        write_all(file_, fil.id.data(), fil.id.size(), path_);
+        write_all(file_, fil.carrier.data(), fil.carrier.size(), path_);
+    }
+    write_padding(file_, nf * sizeof(FilamentRecord) + strings, path_);
+    for (const auto& fil : state.filaments) {
+        write_all(file_, fil.points.data(), fil.points.size() * sizeof(Vec3), path_);
+    }
+    if (velocity) {
+        for (const auto& v : *velocity) write_all(file_, v.data(), v.size() * sizeof(Vec3), path_);
+    }
+    write_all(file_, diagnostics.data(), diagnostics.size() * sizeof(double), path_);
+    write_all(file_, &kFrameEnd, sizeof(kFrameEnd), path_);
+
+    ++frames_;
+    if (options_.flush_every > 0 && ++unflushed_ >= options_.flush_every) flush();
+}
+
+void TrajectoryWriter::flush() {
+    if (!file_) return;
+    if (std::fflush(file_) != 0) throw std::runtime_error("trajectory flush failed: " + path_);
+    unflushed_ = 0;
+}
+
+void TrajectoryWriter::close() {
+    if (!file_) return;
+    const int rc = std::fclose(file_);
+    file_ = nullptr;
+    if (rc != 0) throw std::runtime_error("trajectory close failed: " + path_);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Reader
+
+TrajectoryReader::TrajectoryReader(const std::string& path) : path_(path) {
+    map();
+    if (size_ < sizeof(FileHeader)) {
+        unmap();
+        throw std::runtime_error("not a trajectory file (too short): " + path);
+    }
+    const FileHeader h = load<FileHeader>(data_);
+    if (std::memcmp(h.magic, kFileMagic, sizeof(kFileMagic)) != 0) {
+        unmap();
+        throw std::runtime_error("not a trajectory file: " + path);
+    }
+    if (h.byte_order != kByteOrderMark || h.version != kTrajectoryVersion
+        || h.header_bytes < sizeof(FileHeader) || h.header_bytes > size_) {
+        unmap();
+        throw std::runtime_error("unsupported trajectory version or byte order: " + path);
+    }
+    header_bytes_ = h.header_bytes;
+    std::size_t at = sizeof(FileHeader);
+    for (std::uint32_t i = 0; i < h.diagnostic_count; ++i) {
+        if (at + sizeof(std::uint32_t) > header_bytes_) {
+            unmap();
+            throw std::runtime_error("corrupt trajectory header: " + path);
+        }
+        const auto len = load<std::uint32_t>(data_ + at);
+        at += sizeof(std::uint32_t);
+        if (at + len > header_bytes_) {
+            unmap();
+            throw std::runtime_error("corrupt trajectory header: " + path);
+        }
+        names_.emplace_back(reinterpret_cast<const char*>(data_ + at), len);
+        at += len;
+    }
+    index_frames();
+}
+
+TrajectoryReader::~TrajectoryReader() {
+    unmap();
+}
+
+void TrajectoryReader::map() {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path_.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("could not open trajectory: " + path_);
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("could not stat trajectory: " + path_);
+    }
+    size_ = static_cast<std::size_t>(size.QuadPart);
+    if (size_ > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            CloseHandle(file);
+            throw std::runtime_error("could not map trajectory: " + path_);
+        }
+        data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        handle_ = mapping;
+    }
+    CloseHandle(file);
+    if (size_ > 0 && !data_) {
+        unmap();
+        throw std::runtime_error("could not map trajectory: " + path_);
+    }
+#else
+    const int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("could not open trajectory: " + path_);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("could not stat trajectory: " + path_);
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ > 0) {
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            size_ = 0;
+            throw std::runtime_error("could not map trajectory: " + path_);
+        }
+        data_ = static_cast<const unsigned char*>(p);
+    }
+    ::close(fd);
+#endif
+}
+
+void TrajectoryReader::unmap() {
+#if defined(_WIN32)
+    if (data_) UnmapViewOfFile(data_);
+    if (handle_) CloseHandle(static_cast<HANDLE>(handle_));
+    handle_ = nullptr;
+#else
+    if (data_) ::munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+void TrajectoryReader::index_frames() {
+    if (valid_bytes_ > size_) frames_.clear();  // the file was truncated since the last index
+    std::size_t at = frames_.empty() ? header_bytes_ : valid_bytes_;
+    valid_bytes_ = at;
+    while (at + sizeof(FrameHeader) <= size_) {
+        const FrameHeader h = load<FrameHeader>(data_ + at);
+        if (h.magic != kFrameMagic || h.diagnostic_count != names_.size() || h.meta_bytes % 8 != 0) break;
+        if (h.point_count > size_ / sizeof(Vec3) || h.meta_bytes > size_ || h.filament_count > size_) break;
+        const bool velocity = (h.channels & kTrajectoryChannelVelocity) != 0;
+        const std::size_t expected = frame_bytes(h.filament_count, h.meta_bytes, h.point_count, velocity,
+                                                 h.diagnostic_count);
+        if (h.frame_bytes != expected || h.frame_bytes > size_ - at) break;
+        if (load<std::uint64_t>(data_ + at + h.frame_bytes - sizeof(std::uint64_t)) != kFrameEnd) break;
+        // Offsets must run from 0 to point_count without decreasing.
+        const unsigned char* offsets = data_ + at + sizeof(FrameHeader);
+        bool monotone = load<std::uint64_t>(offsets) == 0;
+        for (std::size_t f = 0; monotone && f < h.filament_count; ++f) {
+            monotone = load<std::uint64_t>(offsets + f * 8) <= load<std::uint64_t>(offsets + (f + 1) * 8);
+        }
+        if (!monotone || load<std::uint64_t>(offsets + h.filament_count * 8) != h.point_count) break;
+        // The filament records and their id/carrier strings must fit in meta_bytes.
+        const unsigned char* records = offsets + (h.filament_count + 1) * 8;
+        std::size_t meta = h.filament_count * sizeof(FilamentRecord);
+        for (std::size_t f = 0; meta <= h.meta_bytes && f < h.filament_count; ++f) {
+            const FilamentRecord r = load<FilamentRecord>(records + f * sizeof(FilamentRecord));
+            meta += static_cast<std::size_t>(r.id_bytes) + r.carrier_bytes;
+        }
+        if (meta > h.meta_bytes) break;
+        frames_.push_back(at);
+        at += h.frame_bytes;
+        valid_bytes_ = at;
+    }
+}
+
+std::size_t TrajectoryReader::refresh() {
+    unmap();
+    try {
+        map();
+    } catch (...) {
+        // The old mapping is gone: forget its frames rather than leave them dangling.
+        frames_.clear();
+        valid_bytes_ = 0;
+        throw;
+    }
+    index_frames();
+    return frames_.size();
+}
+
+TrajectoryFrameView TrajectoryReader::frame(std::size_t index) const {
+    if (index >= frames_.size()) throw std::out_of_range("trajectory frame index out of range");
+    const unsigned char* base = data_ + frames_[index];
+    const FrameHeader h = load<FrameHeader>(base);
+    TrajectoryFrameView v;
+    v.step = h.step;
+    v.time = h.time;
+    v.filament_count = h.filament_count;
+    v.point_count = h.point_count;
+    const unsigned char* p = base + sizeof(FrameHeader);
+    v.offsets = reinterpret_cast<const std::uint64_t*>(p);
+    p += (v.filament_count + 1) * sizeof(std::uint64_t) + h.meta_bytes;
+    v.positions = reinterpret_cast<const Vec3*>(p);
+    p += v.point_count * sizeof(Vec3);
+    if (h.channels & kTrajectoryChannelVelocity) {
+        v.velocities = reinterpret_cast<const Vec3*>(p);
+        p += v.point_count * sizeof(Vec3);
+    }
+    v.diagnostics = names_.empty() ? nullptr : reinterpret_cast<const double*>(p);
+    return v;
+}
+
+FilamentSystemState TrajectoryReader::state(std::size_t index) const {
+    const TrajectoryFrameView v = frame(index);
+    const unsigned char* records = reinterpret_cast<const unsigned char*>(v.offsets + v.filament_count + 1);
+    const char* strings = reinterpret_cast<const char*>(records + v.filament_count * sizeof(FilamentRecord));
+    FilamentSystemState state;
+    state.filaments.resize(v.filament_count);
+    for (std::size_t f = 0; f < v.filament_count; ++f) {
+        const FilamentRecord r = load<FilamentRecord>(records + f * sizeof(FilamentRecord));
+        auto& fil = state.filaments[f];
+        fil.circulation = r.circulation;
+        fil.dynamic = (r.flags & kFlagDynamic) != 0;
+        fil.source = (r.flags & kFlagSource) != 0;
+        fil.ghost = (r.flags & kFlagGhost) != 0;
+        fil.id.assign(strings, r.id_bytes);
+        strings += r.id_bytes;
+        fil.carrier.assign(strings, r.carrier_bytes);
+        strings += r.carrier_bytes;
+        fil.points.assign(v.positions + v.offsets[f], v.positions + v.offsets[f + 1]);
+    }
+    return state;
+}
+
+std::vector<std::vector<Vec3>> TrajectoryReader::velocity(std::size_t index) const {
+    const TrajectoryFrameView v = frame(index);
+    std::vector<std::vector<Vec3>> out;
+    if (!v.velocities) return out;
+    out.resize(v.filament_count);
+    for (std::size_t f = 0; f < v.filament_count; ++f) {
+        out[f].assign(v.velocities + v.offsets[f], v.velocities + v.offsets[f + 1]);
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Checkpoints
+
+void save_filament_checkpoint(const std::string& path, const FilamentCheckpoint& checkpoint) {
+    const std::string tmp = path + ".tmp";
+    {
+        TrajectoryWriter writer(tmp, checkpoint.names, TrajectoryWriterOptions{false, 0});
+        writer.append(checkpoint.state, checkpoint.time, checkpoint.step, nullptr, checkpoint.values);
+        writer.close();
+    }
+    sync_to_disk(tmp, false);
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) throw std::runtime_error("could not replace checkpoint " + path + ": " + ec.message());
+    const std::filesystem::path dir = std::filesystem::path(path).parent_path();
+    sync_to_disk(dir.empty() ? std::string(".") : dir.string(), true);
+}
+
+FilamentCheckpoint load_filament_checkpoint(const std::string& path) {
+    const TrajectoryReader reader(path);
+    if (reader.frame_count() == 0) throw std::runtime_error("checkpoint has no complete frame: " + path);
+    const std::size_t last = reader.frame_count() - 1;
+    const TrajectoryFrameView v = reader.frame(last);
+    FilamentCheckpoint c;
+    c.state = reader.state(last);
+    c.time = v.time;
+    c.step = v.step;
+    c.names = reader.diagnostic_names();
+    c.values.assign(v.diagnostics, v.diagnostics + c.names.size());
+    return c;
+}
+
+}  // namespace filament
+}  // namespace sst
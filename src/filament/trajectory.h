@@ -0,0 +1,153 @@
+#ifndef SSTCORE_FILAMENT_TRAJECTORY_H
+#define SSTCORE_FILAMENT_TRAJECTORY_H
+
+#pragma once
+
+#include "vortexlab/types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace sst {
+namespace filament {
+
+/**
+ * Binary trajectory format (".ssttraj", host byte order, every section 8-byte aligned):
+ *
+ *   file header   magic "SSTTRAJ1", version, byte-order mark, header size, diagnostic names
+ *   frame*        FrameHeader (64 B) | offsets (filaments + 1, u64) | per-filament records
+ *                 (circulation, flags, id / carrier lengths) + strings | positions (points x 3
+ *                 f64) | velocities (optional channel) | diagnostics (f64 per name) | end mark
+ *
+ * Frames are self-delimiting (FrameHeader::frame_bytes), so a reader indexes them in one pass
+ * and a frame cut short by a crash is simply ignored; appending to such a file truncates it
+ * back to the last complete frame first.
+ */
+inline constexpr std::uint32_t kTrajectoryVersion = 1;
+inline constexpr std::uint32_t kTrajectoryChannelVelocity = 1u;
+
+struct TrajectoryWriterOptions {
+    // Continue an existing file (its diagnostic names must match) instead of replacing it.
+    bool append = false;
+    // fflush after this many frames (0 = only on flush() / close()).
+    std::size_t flush_every = 1;
+};
+
+/** Zero-copy view of one frame inside a TrajectoryReader mapping (valid while it lives). */
+struct TrajectoryFrameView {
+    std::uint64_t step = 0;
+    double time = 0.0;
+    std::size_t filament_count = 0;
+    std::size_t point_count = 0;
+    const std::uint64_t* offsets = nullptr;  // filament_count + 1 prefix sums into positions
+    const Vec3* positions = nullptr;
+    const Vec3* velocities = nullptr;        // nullptr without the velocity channel
+    const double* diagnostics = nullptr;     // one per TrajectoryReader::diagnostic_names()
+};
+
+/**
+ * Append-only trajectory writer: each append() streams one frame straight to the file, so a
+ * long run never holds more than the current state in memory. Throws std::runtime_error on
+ * I/O failure and std::invalid_argument on mismatched velocity / diagnostic sizes.
+ */
+class TrajectoryWriter {
+public:
+    explicit TrajectoryWriter(const std::string& path,
+                              const std::vector<std::string>& diagnostic_names = {},
+                              const TrajectoryWriterOptions& options = {});
+    ~TrajectoryWriter();
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    /** velocity, when given, is per filament like VelocityFieldResult::velocity. */
+    void append(const FilamentSystemState& state,
+                double time,
+                std::uint64_t step,
+                const std::vector<std::vector<Vec3>>* velocity = nullptr,
+                const std::vector<double>& diagnostics = {});
+
+    void flush();
+    void close();
+
+    /** Frames in the file, including those present before an append-mode open. */
+    std::size_t frame_count() const { return frames_; }
+    const std::vector<std::string>& diagnostic_names() const { return names_; }
+
+private:
+    std::FILE* file_ = nullptr;
+    std::string path_;
+    std::vector<std::string> names_;
+    TrajectoryWriterOptions options_;
+    std::size_t frames_ = 0;
+    std::size_t unflushed_ = 0;
+};
+
+/**
+ * Memory-mapped random-access reader. Frames are indexed once at open (and again by
+ * refresh(), which picks up frames appended since); frame(i) costs no copy.
+ */
+class TrajectoryReader {
+public:
+    explicit TrajectoryReader(const std::string& path);
+    ~TrajectoryReader();
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+    std::size_t frame_count() const { return frames_.size(); }
+    const std::vector<std::string>& diagnostic_names() const { return names_; }
+    /** Bytes covered by the header and complete frames (a torn tail is excluded). */
+    std::size_t valid_bytes() const { return valid_bytes_; }
+
+    TrajectoryFrameView frame(std::size_t index) const;  // throws std::out_of_range
+    /** Materialise frame index as a state (ids, carriers, circulation and flags restored). */
+    FilamentSystemState state(std::size_t index) const;
+    /** Velocities of frame index per filament (empty without the velocity channel). */
+    std::vector<std::vector<Vec3>> velocity(std::size_t index) const;
+
+    /**
+     * Remap the file and index newly completed frames; returns the new frame count. If the
+     * file cannot be mapped again this throws and leaves the reader with no frames.
+     */
+    std::size_t refresh();
+
+private:
+    std::string path_;
+    const unsigned char* data_ = nullptr;
+    std::size_t size_ = 0;
+    void* handle_ = nullptr;   // platform mapping handle (Windows)
+    std::vector<std::string> names_;
+    std::size_t header_bytes_ = 0;
+    std::size_t valid_bytes_ = 0;
+    std::vector<std::size_t> frames_;  // byte offset of each complete frame
+
+    void map();
+    void unmap();
+    void index_frames();
+};
+
+/** Restart point of a filament run: state, clock and named scalars (e.g. a proposed dt). */
+struct FilamentCheckpoint {
+    FilamentSystemState state;
+    double time = 0.0;
+    std::uint64_t step = 0;
+    std::vector<std::string> names;
+    std::vector<double> values;
+};
+
+/**
+ * Write checkpoint as a one-frame trajectory to path + ".tmp", fsync it, rename it over path
+ * and fsync the directory, so a preempted job or a power loss always leaves either the
+ * previous or the new checkpoint intact.
+ */
+void save_filament_checkpoint(const std::string& path, const FilamentCheckpoint& checkpoint);
+
+/** Read a checkpoint (the last complete frame of any trajectory file also works). */
+FilamentCheckpoint load_filament_checkpoint(const std::string& path);
+
+}  // namespace filament
+}  // namespace sst
+
+#endif
@@ -1,8 +1,13 @@
 #include "filament/velocity_solver.h"
 
+#include "geometry/segment_octree.h"
+#include "parallel_for.h"
 #include "sst/types.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace sst {
@@ -17,28 +22,208 @@ Vec3 scale3(const Vec3& a, double s) {
     return {a[0] * s, a[1] * s, a[2] * s};
 }
 
+constexpr double kPi = 3.14159265358979323846;
+// Target points per parallel task (fixed, so the decomposition does not depend on threads).
+constexpr std::size_t kTargetChunk = 256;
+
+/**
+ * Treecode over all source segments of the system. Moments are built from Γ_s/4π · dl so one
+ * expansion covers filaments of different circulation; leaves keep the raw dl, endpoints and
+ * prefactor so the near field is summed exactly as in the direct loop (either segment kernel).
+ * With the straight-segment kernel the far-field moments are those of the straight segments too.
+ * For the Cutoff backend the tree only sums segments whose midpoint lies beyond mutual_cutoff:
+ * the closer ones come from the neighbour list.
+ */
+class MutualTreecode {
+public:
+    MutualTreecode(const FilamentSystemState& filaments,
+                   const Vec3* points,
+                   const VelocityWorkspace& ws,
+                   const VelocityOptions& options)
+        : theta_(std::max(0.0, options.treecode_theta)),
+          a_sim2_(options.a_sim * options.a_sim),
+          exact_(options.segment_kernel == geometry::SegmentKernel::StraightSegment),
+          exclude_(options.mutual_backend == MutualInductionBackend::Cutoff ? options.mutual_cutoff : -1.0) {
+        const std::size_t nf = filaments.filaments.size();
+        first_.assign(nf, kNotSource);
+        for (std::size_t f = 0; f < nf; ++f) {
+            const auto& fil = filaments.filaments[f];
+            if (fil.ghost || !fil.source) continue;
+            first_[f] = mids_.size();
+            const double pref = fil.circulation / (4.0 * kPi);
+            const std::size_t o = ws.offsets[f];
+            const std::size_t M = ws.offsets[f + 1] - o;
+            for (std::size_t j = 0; j < M; ++j) {
+                starts_.push_back(points[o + j]);
+                ends_.push_back(points[o + (j + 1) % M]);
+                mids_.push_back(ws.mids[o + j]);
+                dls_.push_back(ws.dls[o + j]);
+                weighted_.push_back(scale3(ws.dls[o + j], pref));
+                pref_.push_back(pref);
+                tag_.push_back(static_cast<std::uint32_t>(f));
+            }
+        }
+        tree_ = geometry::SegmentOctree(mids_, weighted_, options.treecode_leaf_size, &tag_,
+                                        exact_ ? &dls_ : nullptr);
+    }
+
+    std::size_t size() const { return mids_.size(); }
+
+    /**
+     * Mutual velocity at point i of filament ft (segments im = i-1 and ip = i of ft excluded).
+     * stack is caller-owned walk scratch so concurrent targets can share the tree.
+     */
+    Vec3 velocity(std::size_t ft, std::size_t im, std::size_t ip, const Vec3& p,
+                  std::vector<std::size_t>& stack) const {
+        Vec3 u{{0, 0, 0}};
+        if (tree_.empty()) return u;
+        const bool self_source = first_[ft] != kNotSource;
+        const std::size_t gm = self_source ? first_[ft] + im : 0;
+        const std::size_t gp = self_source ? first_[ft] + ip : 0;
+        const auto& nodes = tree_.nodes();
+        const auto& order = tree_.order();
+        const std::uint32_t self_tag = static_cast<std::uint32_t>(ft);
+
+        stack.clear();
+        stack.push_back(0);
+        while (!stack.empty()) {
+            const geometry::SegmentOctreeNode& node = nodes[stack.back()];
+            stack.pop_back();
+
+            const Vec3 R = diff(p, node.center);
+            const double d = norm(R);
+            // Nodes wholly inside the excluded ball are skipped; a cluster is only expanded when
+            // it lies wholly outside (the margins keep rounding on the listed side of the leaves).
+            if (exclude_ >= 0.0 && d + node.radius < exclude_ * (1.0 - 1e-9)) continue;
+            const bool outside = exclude_ < 0.0 || d - node.radius > exclude_ * (1.0 + 1e-9);
+            if (outside && d > node.radius && node.radius < theta_ * d) {
+                // Self segments use the singular kernel and must not contain the two segments
+                // adjacent to p; other filaments use reg = a_sim². A node mixing both is
+                // expanded as all(a_sim²) - self(a_sim²) + self(0).
+                const std::size_t self_idx = self_source ? node.find_tag(self_tag) : node.tags.size();
+                if (self_idx == node.tags.size()) {
+                    add_cluster(u, node.moments, R, a_sim2_);
+                    continue;
+                }
+                if (!tree_.contains(node, gm) && !tree_.contains(node, gp)) {
+                    if (node.tags.size() == 1 || a_sim2_ == 0.0) {
+                        add_cluster(u, node.moments, R, 0.0);
+                    } else {
+                        const geometry::SegmentMoments& self = node.tag_moments[self_idx];
+                        add_cluster(u, node.moments, R, a_sim2_);
+                        add_cluster(u, self, R, 0.0);
+                        const Vec3 v = geometry::segment_multipole_velocity(self, R, a_sim2_);
+                        u[0] -= v[0];
+                        u[1] -= v[1];
+                        u[2] -= v[2];
+                    }
+                    continue;
+                }
+            }
+
+            if (node.leaf) {
+                for (std::size_t k = node.begin; k < node.end; ++k) {
+                    const std::size_t seg = order[k];
+                    const bool self = tag_[seg] == self_tag;
+                    if (self && (seg == gm || seg == gp)) continue;
+                    const Vec3 r = diff(p, mids_[seg]);
+                    const double d2 = r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+                    if (exclude_ >= 0.0 && d2 <= exclude_ * exclude_) continue;
+                    const double reg = self ? 0.0 : a_sim2_;
+                    if (exact_) {
+                        const Vec3 v = geometry::straight_segment_velocity(p, starts_[seg], ends_[seg], reg);
+                        u[0] += v[0] * pref_[seg];
+                        u[1] += v[1] * pref_[seg];
+                        u[2] += v[2] * pref_[seg];
+                        continue;
+                    }
+                    const double r2 = d2 + reg;
+                    const double inv = pref_[seg] / (r2 * std::sqrt(r2));
+                    const Vec3& dl = dls_[seg];
+                    u[0] += (dl[1] * r[2] - dl[2] * r[1]) * inv;
+                    u[1] += (dl[2] * r[0] - dl[0] * r[2]) * inv;
+                    u[2] += (dl[0] * r[1] - dl[1] * r[0]) * inv;
+                }
+                continue;
+            }
+            for (int o = 7; o >= 0; --o) {
+                if (node.child[o] != geometry::SegmentOctreeNode::kNoChild) stack.push_back(node.child[o]);
+            }
+        }
+        return u;
+    }
+
+private:
+    static void add_cluster(Vec3& u, const geometry::SegmentMoments& m, const Vec3& R, double reg2) {
+        const Vec3 v = geometry::segment_multipole_velocity(m, R, reg2);
+        u[0] += v[0];
+        u[1] += v[1];
+        u[2] += v[2];
+    }
+
+    static constexpr std::size_t kNotSource = static_cast<std::size_t>(-1);
+
+    double theta_;
+    double a_sim2_;
+    bool exact_;
+    double exclude_;  // mutual_cutoff for the Cutoff backend's far field, else < 0
+    std::vector<Vec3> starts_, ends_, mids_, dls_, weighted_;
+    std::vector<double> pref_;
+    std::vector<std::uint32_t> tag_;
+    std::vector<std::size_t> first_;
+    geometry::SegmentOctree tree_;
+};
+
 }  // namespace
 
+std::size_t VelocityWorkspace::bind(const FilamentSystemState& state) {
+    const std::size_t nf = state.filaments.size();
+    offsets.resize(nf + 1);
+    offsets[0] = 0;
+    for (std::size_t f = 0; f < nf; ++f) offsets[f + 1] = offsets[f] + state.filaments[f].points.size();
+    mids.resize(offsets[nf]);
+    dls.resize(offsets[nf]);
+    return offsets[nf];
+}
+
 VelocityFieldResult FilamentVelocitySolver::evaluate(
     const FilamentSystemState& filaments,
     const VelocityOptions& options) {
+    VelocityWorkspace ws;
+    const std::size_t total = ws.bind(filaments);
+    std::vector<Vec3> points, velocity(total);
+    points.reserve(total);
+    for (const auto& fil : filaments.filaments) points.insert(points.end(), fil.points.begin(), fil.points.end());
+
     VelocityFieldResult out;
+    out.maximum_speed = evaluate_into(filaments, points.data(), options, ws, velocity.data());
     const std::size_t nf = filaments.filaments.size();
     out.velocity.resize(nf);
-    out.maximum_speed = 0.0;
+    for (std::size_t f = 0; f < nf; ++f) {
+        out.velocity[f].assign(velocity.begin() + static_cast<std::ptrdiff_t>(ws.offsets[f]),
+                               velocity.begin() + static_cast<std::ptrdiff_t>(ws.offsets[f + 1]));
+    }
+    return out;
+}
+
+double FilamentVelocitySolver::evaluate_into(
+    const FilamentSystemState& filaments,
+    const Vec3* points,
+    const VelocityOptions& options,
+    VelocityWorkspace& ws,
+    Vec3* velocity,
+    const std::vector<char>* targets) {
+    const std::size_t nf = filaments.filaments.size();
+    const std::vector<std::size_t>& off = ws.offsets;
 
     // Midpoint / dl caches
-    std::vector<std::vector<Vec3>> mids(nf), dls(nf);
     for (std::size_t f = 0; f < nf; ++f) {
-        const auto& fil = filaments.filaments[f];
-        const std::size_t N = fil.points.size();
-        mids[f].resize(N);
-        dls[f].resize(N);
-        out.velocity[f].assign(N, Vec3{{0, 0, 0}});
+        const std::size_t o = off[f];
+        const std::size_t N = off[f + 1] - o;
         for (std::size_t k = 0; k < N; ++k) {
             const std::size_t k2 = (k + 1) % N;
-            dls[f][k] = diff(fil.points[k2], fil.points[k]);
-            mids[f][k] = scale3(add3(fil.points[k], fil.points[k2]), 0.5);
+            ws.dls[o + k] = diff(points[o + k2], points[o + k]);
+            ws.mids[o + k] = scale3(add3(points[o + k], points[o + k2]), 0.5);
         }
     }
 
@@ -46,23 +231,55 @@ VelocityFieldResult FilamentVelocitySolver::evaluate(
     const double eD = std::exp(options.core_delta);
     const double a_sim2 = options.a_sim * options.a_sim;
     const bool lia_only = options.lia_only;
+    const bool exact = options.segment_kernel == geometry::SegmentKernel::StraightSegment;
     // include_external / include_mutual_friction ignored in v1
 
-    double umax2 = 0.0;
-    for (std::size_t ft = 0; ft < nf; ++ft) {
-        const auto& target = filaments.filaments[ft];
-        const std::size_t N = target.points.size();
-        if (target.ghost) {
-            // zero velocity already assigned
-            continue;
-        }
-        const double pref = target.circulation / (4.0 * 3.14159265358979323846);
-        for (std::size_t i = 0; i < N; ++i) {
+    std::size_t source_segments = 0;
+    for (const auto& fil : filaments.filaments) {
+        if (!fil.ghost && fil.source) source_segments += fil.points.size();
+    }
+    std::unique_ptr<MutualTreecode> treecode;
+    if (!lia_only && options.mutual_backend != MutualInductionBackend::Direct
+        && source_segments >= options.treecode_min_segments) {
+        treecode = std::make_unique<MutualTreecode>(filaments, points, ws, options);
+    }
+
+    const std::size_t total = off[nf];
+    const bool cutoff = !lia_only && options.mutual_backend == MutualInductionBackend::Cutoff;
+    const double cutoff2 = options.mutual_cutoff * options.mutual_cutoff;
+    if (cutoff) {
+        ws.neighbours.set_radius(options.mutual_cutoff, options.neighbour_skin);
+        ws.neighbours.update(points, total, ws.mids.data(), total);
+    }
+
+    // Fixed chunks of the flat target range spread over num_threads workers. Every point sums its
+    // sources in a fixed order and the per-chunk maxima are reduced in chunk order, so the
+    // result is bitwise independent of the thread count.
+    const std::size_t tasks = (total + kTargetChunk - 1) / kTargetChunk;
+    ws.task_speed.assign(tasks, 0.0);
+    parallel_for(tasks, options.num_threads, [&](std::size_t task) {
+        const std::size_t g0 = task * kTargetChunk;
+        const std::size_t g1 = std::min(total, g0 + kTargetChunk);
+        std::vector<std::size_t> stack;
+        std::size_t ft = static_cast<std::size_t>(std::upper_bound(off.begin(), off.end(), g0) - off.begin()) - 1;
+        double umax2 = 0.0;
+        for (std::size_t g = g0; g < g1; ++g) {
+            while (g >= off[ft + 1]) ++ft;
+            const auto& target = filaments.filaments[ft];
+            if (targets && !(*targets)[ft]) continue;
+            if (target.ghost) {
+                velocity[g] = Vec3{{0, 0, 0}};
+                continue;
+            }
+            const std::size_t ot = off[ft];
+            const std::size_t N = off[ft + 1] - ot;
+            const std::size_t i = g - ot;
+            const double pref = target.circulation / (4.0 * kPi);
             const std::size_t im = (i + N - 1) % N;
             const std::size_t ip = i;
-            const Vec3& p = target.points[i];
-            const Vec3& dm = dls[ft][im];
-            const Vec3& dp = dls[ft][ip];
+            const Vec3& p = points[ot + i];
+            const Vec3& dm = ws.dls[ot + im];
+            const Vec3& dp = ws.dls[ot + ip];
             const double lm = std::max(norm(dm), 1e-30);
             const double lp = std::max(norm(dp), 1e-30);
             const Vec3 cxv = cross(dm, dp);
@@ -70,21 +287,73 @@ VelocityFieldResult FilamentVelocitySolver::evaluate(
             const double lf = pref
                 * (std::log(2.0 * std::sqrt(lm * lp) / (eD * a)) + options.lia_constant)
                 * 2.0 / (lm * lp * (lm + lp));
-            Vec3 u = scale3(cxv, lf);
+            Vec3 u = options.include_lia ? scale3(cxv, lf) : Vec3{{0, 0, 0}};
 
-            if (!lia_only) {
+            if (cutoff) {
+                // Near field: listed midpoints are ascending, i.e. in the direct loop's (fs, j)
+                // order; the far field below adds the midpoints beyond the cutoff.
+                std::size_t fs = 0;
+                for (const std::size_t* it = ws.neighbours.begin(g); it != ws.neighbours.end(g); ++it) {
+                    const std::size_t s = *it;
+                    while (s >= off[fs + 1]) ++fs;
+                    const auto& source = filaments.filaments[fs];
+                    if (source.ghost || !source.source) continue;
+                    const std::size_t os = off[fs];
+                    const std::size_t j = s - os;
+                    if (fs == ft && (j == im || j == ip)) continue;
+                    const Vec3 r = diff(p, ws.mids[s]);
+                    const double d2 = r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+                    if (d2 > cutoff2) continue;
+                    const double pref_source = source.circulation / (4.0 * kPi);
+                    const double reg = (fs == ft) ? 0.0 : a_sim2;
+                    if (exact) {
+                        const std::size_t M = off[fs + 1] - os;
+                        const Vec3 v = geometry::straight_segment_velocity(
+                            p, points[s], points[os + (j + 1) % M], reg);
+                        u[0] += v[0] * pref_source;
+                        u[1] += v[1] * pref_source;
+                        u[2] += v[2] * pref_source;
+                        continue;
+                    }
+                    const double r2 = d2 + reg;
+                    const double inv = pref_source / (r2 * std::sqrt(r2));
+                    const Vec3& dl = ws.dls[s];
+                    u[0] += (dl[1] * r[2] - dl[2] * r[1]) * inv;
+                    u[1] += (dl[2] * r[0] - dl[0] * r[2]) * inv;
+                    u[2] += (dl[0] * r[1] - dl[1] * r[0]) * inv;
+                }
+            }
+            if (treecode) {
+                const Vec3 m = treecode->velocity(ft, im, ip, p, stack);
+                u[0] += m[0];
+                u[1] += m[1];
+                u[2] += m[2];
+            } else if (!lia_only) {
                 for (std::size_t fs = 0; fs < nf; ++fs) {
                     const auto& source = filaments.filaments[fs];
                     if (source.ghost || !source.source) continue;
-                    const std::size_t M = source.points.size();
-                    const double pref_source = source.circulation / (4.0 * 3.14159265358979323846);
+                    const std::size_t os = off[fs];
+                    const std::size_t M = off[fs + 1] - os;
+                    const double pref_source = source.circulation / (4.0 * kPi);
                     const double reg = (fs == ft) ? 0.0 : a_sim2;
                     for (std::size_t j = 0; j < M; ++j) {
                         if (fs == ft && (j == im || j == ip)) continue;
-                        const Vec3 r = diff(p, mids[fs][j]);
+                        if (cutoff) {
+                            const Vec3 r = diff(p, ws.mids[os + j]);
+                            if (r[0] * r[0] + r[1] * r[1] + r[2] * r[2] <= cutoff2) continue;
+                        }
+                        if (exact) {
+                            const Vec3 v = geometry::straight_segment_velocity(
+                                p, points[os + j], points[os + (j + 1) % M], reg);
+                            u[0] += v[0] * pref_source;
+                            u[1] += v[1] * pref_source;
+                            u[2] += v[2] * pref_source;
+                            continue;
+                        }
+                        const Vec3 r = diff(p, ws.mids[os + j]);
                         const double r2 = r[0] * r[0] + r[1] * r[1] + r[2] * r[2] + reg;
                         const double inv = pref_source / (r2 * std::sqrt(r2));
-                        const Vec3& dl = dls[fs][j];
+                        const Vec3& dl = ws.dls[os + j];
                         u[0] += (dl[1] * r[2] - dl[2] * r[1]) * inv;
                         u[1] += (dl[2] * r[0] - dl[0] * r[2]) * inv;
                         u[2] += (dl[0] * r[1] - dl[1] * r[0]) * inv;
@@ -92,13 +361,17 @@ VelocityFieldResult FilamentVelocitySolver::evaluate(
                 }
             }
 
-            out.velocity[ft][i] = u;
+            velocity[g] = u;
             const double um = u[0] * u[0] + u[1] * u[1] + u[2] * u[2];
             if (um > umax2) umax2 = um;
         }
+        ws.task_speed[task] = umax2;
+    });
+    double umax2 = 0.0;
+    for (const double um : ws.task_speed) {
+        if (um > umax2) umax2 = um;
     }
-    out.maximum_speed = std::sqrt(umax2);
-    return out;
+    return std::sqrt(umax2);
 }
 
 }  // namespace filament
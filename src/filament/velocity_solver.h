@@ -3,21 +3,73 @@
 
 #pragma once
 
+#include "geometry/neighbour_list.h"
 #include "vortexlab/types.h"
 
+#include <cstddef>
+#include <vector>
+
 namespace sst {
 namespace filament {
 
+/**
+ * Flat per-point buffers reused by FilamentVelocitySolver::evaluate_into. Point i of filament f
+ * lives at offsets[f] + i; bind() only reallocates when the point count grows.
+ */
+struct VelocityWorkspace {
+    std::vector<std::size_t> offsets;  // filament count + 1 prefix sums
+    std::vector<Vec3> mids;
+    std::vector<Vec3> dls;
+    std::vector<double> task_speed;    // per-task max |u|² scratch
+    // Cutoff backend: points -> segment midpoints, kept across calls and only rebuilt once
+    // something has moved more than half the skin.
+    geometry::VerletNeighbourList neighbours;
+
+    /** Size the buffers for state's filament layout; returns the total point count. */
+    std::size_t bind(const FilamentSystemState& state);
+};
+
 class FilamentVelocitySolver {
 public:
     /**
      * VortexLab v7.6.25b velocityCore parity (LIA + midpoint Biot–Savart).
      * Ghost filaments: zero velocity as targets; never sources.
      * External / mutual-friction flags are ignored in this first version.
+     * mutual_backend = Treecode replaces the O(N²) mutual sum by a Barnes–Hut treecode over all
+     * source segments (quadrupole order, same a_sim / self-exclusion rules) once the system has
+     * at least treecode_min_segments source segments; smaller systems use the direct sum.
+     * mutual_backend = Cutoff splits the mutual sum at mutual_cutoff: source segments whose
+     * midpoint lies within it are summed exactly from the workspace's neighbour list (in the
+     * direct sum's order, so a cutoff beyond the system size reproduces it bitwise), the rest by
+     * the treecode far field (same size threshold and opening angle). The skin never changes
+     * the result, only how often the list is rebuilt.
+     * segment_kernel = StraightSegment sums each non-adjacent source edge with the exact
+     * straight-segment field (a_sim enters as a cut-off core) instead of the midpoint rule.
+     * num_threads > 1 spreads fixed chunks of target points over workers; the output, including
+     * maximum_speed, is bitwise identical for every thread count.
      */
     static VelocityFieldResult evaluate(
         const FilamentSystemState& filaments,
         const VelocityOptions& options);
+
+    /**
+     * Allocation-free core of evaluate. Filament metadata (circulation, flags, point counts) is
+     * read from filaments, positions from the flat array points (workspace.bind(filaments)
+     * order, which may differ from filaments' own points), and velocities are written to the
+     * flat array velocity. Returns the maximum speed. Bitwise equal to evaluate on the same
+     * positions; the direct backend performs no heap allocation once workspace is bound, the
+     * treecode and cutoff backends still build their octree per call (above the size threshold).
+     * With targets (one flag per filament) only flagged filaments are evaluated (every source
+     * still contributes); the velocity entries of the others are left untouched and excluded
+     * from the returned maximum.
+     */
+    static double evaluate_into(
+        const FilamentSystemState& filaments,
+        const Vec3* points,
+        const VelocityOptions& options,
+        VelocityWorkspace& workspace,
+        Vec3* velocity,
+        const std::vector<char>* targets = nullptr);
 };
 
 }  // namespace filament
@@ -20,6 +20,10 @@ void VortexKnotSystem::evolve(double dt, std::size_t steps) {
     core_.evolve(dt, steps);
 }
 
+void VortexKnotSystem::set_evolution_options(const FilamentEvolutionOptions& options) {
+    core_.set_options(options);
+}
+
 const std::vector<Vec3>& VortexKnotSystem::get_positions() const {
     return core_.positions();
 }
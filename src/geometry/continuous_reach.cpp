@@ -1,5 +1,7 @@
 #include "geometry/continuous_reach.h"
 
+#include "parallel_for.h"
+
 #include <algorithm>
 #include <cmath>
 #include <cstring>
@@ -252,45 +254,128 @@ RefineResult refine_pair(const PeriodicCubicSpline3D& sa, const PeriodicCubicSpl
     return r;
 }
 
+/** Spline samples at u_i = length * i / M, the seed grid of continuous_pair_distance. */
+struct SampleTable {
+    int M = 0;
+    std::vector<double> u;
+    std::vector<Vec3> p, d1;
+    std::vector<double> speed;
+};
+
+SampleTable sample_spline(const PeriodicCubicSpline3D& sp, int M) {
+    SampleTable table;
+    table.M = M;
+    table.u.resize(static_cast<std::size_t>(M));
+    table.p.resize(static_cast<std::size_t>(M));
+    table.d1.resize(static_cast<std::size_t>(M));
+    table.speed.resize(static_cast<std::size_t>(M));
+    for (int i = 0; i < M; ++i) {
+        const std::size_t k = static_cast<std::size_t>(i);
+        table.u[k] = sp.length() * i / static_cast<double>(M);
+        const SplineEval ev = sp.eval(table.u[k]);
+        table.p[k] = ev.p;
+        table.d1[k] = ev.d1;
+        table.speed[k] = norm(ev.d1);
+    }
+    return table;
+}
+
+/** Tables of one spline, one per grid size it has been paired at (usually a single one). */
+const SampleTable& cached_samples(std::vector<SampleTable>& cache, const PeriodicCubicSpline3D& sp, int M) {
+    for (const SampleTable& table : cache) {
+        if (table.M == M) return table;
+    }
+    cache.push_back(sample_spline(sp, M));
+    return cache.back();
+}
+
+int seed_grid_size(const PeriodicCubicSpline3D& sa, const PeriodicCubicSpline3D& sb) {
+    return std::min(192, std::max(64, static_cast<int>(std::round(
+        10.0 * std::sqrt(static_cast<double>(std::max(sa.n(), sb.n())))))));
+}
+
 struct Seed {
     double s, t, score, orth, d;
+    std::size_t index;  // position on the seed grid scan, breaks key ties
 };
 
-bool continuous_pair_distance(const PeriodicCubicSpline3D& sa, const PeriodicCubicSpline3D& sb,
-                              bool self_pair, RefineResult& out) {
-    const int M = std::min(192, std::max(64, static_cast<int>(std::round(
-        10.0 * std::sqrt(static_cast<double>(std::max(sa.n(), sb.n())))))));
+/** The count smallest seeds by one key (ties to the earlier seed), kept in a bounded max-heap. */
+class SeedHeap {
+public:
+    SeedHeap(std::size_t count, double Seed::*key) : count_(count), key_(key) { heap_.reserve(count); }
+
+    void offer(const Seed& seed) {
+        if (count_ == 0) return;
+        if (heap_.size() < count_) {
+            heap_.push_back(seed);
+            std::push_heap(heap_.begin(), heap_.end(), Less{key_});
+        } else if (Less{key_}(seed, heap_.front())) {
+            std::pop_heap(heap_.begin(), heap_.end(), Less{key_});
+            heap_.back() = seed;
+            std::push_heap(heap_.begin(), heap_.end(), Less{key_});
+        }
+    }
+
+    /** Kept seeds in ascending key order. */
+    std::vector<Seed> sorted() const {
+        std::vector<Seed> out = heap_;
+        std::sort_heap(out.begin(), out.end(), Less{key_});
+        return out;
+    }
+
+private:
+    struct Less {
+        double Seed::*key;
+        bool operator()(const Seed& a, const Seed& b) const {
+            return a.*key < b.*key || (a.*key == b.*key && a.index < b.index);
+        }
+    };
+
+    std::size_t count_;
+    double Seed::*key_;
+    std::vector<Seed> heap_;
+};
+
+bool continuous_pair_distance(const PeriodicCubicSpline3D& sa, const SampleTable& ta,
+                              const PeriodicCubicSpline3D& sb, const SampleTable& tb,
+                              bool self_pair, std::size_t num_threads, RefineResult& out) {
+    const int M = ta.M;
     const double min_arc = self_pair
         ? std::max(4.0 * sa.length() / static_cast<double>(sa.n()), 0.015 * sa.length())
         : 0.0;
-    std::vector<Seed> seeds;
+    SeedHeap by_score(64, &Seed::score);
+    SeedHeap by_orth(48, &Seed::orth);
+    SeedHeap by_distance(32, &Seed::d);
+    std::size_t index = 0;
     for (int i = 0; i < M; ++i) {
-        const double s = sa.length() * i / static_cast<double>(M);
-        const SplineEval A = sa.eval(s);
+        const std::size_t ki = static_cast<std::size_t>(i);
+        const double s = ta.u[ki];
+        const Vec3& Ap = ta.p[ki];
+        const Vec3& Ad1 = ta.d1[ki];
         for (int j = self_pair ? i + 1 : 0; j < M; ++j) {
-            const double t = sb.length() * j / static_cast<double>(M);
+            const std::size_t kj = static_cast<std::size_t>(j);
+            const double t = tb.u[kj];
             if (self_pair) {
                 const double arc = std::min(std::abs(s - t), sa.length() - std::abs(s - t));
                 if (arc < min_arc) continue;
             }
-            const SplineEval B = sb.eval(t);
-            const double dx = A.p[0] - B.p[0], dy = A.p[1] - B.p[1], dz = A.p[2] - B.p[2];
+            const Vec3& Bp = tb.p[kj];
+            const Vec3& Bd1 = tb.d1[kj];
+            const double dx = Ap[0] - Bp[0], dy = Ap[1] - Bp[1], dz = Ap[2] - Bp[2];
             const double d = std::sqrt(dx * dx + dy * dy + dz * dz);
             if (!(d > 1e-12)) continue;
-            const double ci = std::abs((dx * A.d1[0] + dy * A.d1[1] + dz * A.d1[2])
-                                       / (d * norm(A.d1) + 1e-30));
-            const double cj = std::abs((dx * B.d1[0] + dy * B.d1[1] + dz * B.d1[2])
-                                       / (d * norm(B.d1) + 1e-30));
-            if (ci > 0.92 || cj > 0.92) continue;
-            seeds.push_back({s, t, d * (0.02 + ci * ci + cj * cj), ci + cj, d});
+            const double ci = std::abs((dx * Ad1[0] + dy * Ad1[1] + dz * Ad1[2])
+                                       / (d * ta.speed[ki] + 1e-30));
+            const double cj = std::abs((dx * Bd1[0] + dy * Bd1[1] + dz * Bd1[2])
+                                       / (d * tb.speed[kj] + 1e-30));
+            if (!(ci <= 0.92) || !(cj <= 0.92)) continue;
+            const Seed seed{s, t, d * (0.02 + ci * ci + cj * cj), ci + cj, d, index++};
+            by_score.offer(seed);
+            by_orth.offer(seed);
+            by_distance.offer(seed);
         }
     }
 
-    auto take_unique = [&](std::vector<Seed> arr, std::size_t count, auto cmp) {
-        std::sort(arr.begin(), arr.end(), cmp);
-        if (arr.size() > count) arr.resize(count);
-        return arr;
-    };
     std::vector<Seed> chosen;
     auto push_unique = [&](const std::vector<Seed>& arr) {
         for (const Seed& q : arr) {
@@ -304,13 +389,18 @@ bool continuous_pair_distance(const PeriodicCubicSpline3D& sa, const PeriodicCub
             if (!found) chosen.push_back(q);
         }
     };
-    push_unique(take_unique(seeds, 64, [](const Seed& a, const Seed& b) { return a.score < b.score; }));
-    push_unique(take_unique(seeds, 48, [](const Seed& a, const Seed& b) { return a.orth < b.orth; }));
-    push_unique(take_unique(seeds, 32, [](const Seed& a, const Seed& b) { return a.d < b.d; }));
+    push_unique(by_score.sorted());
+    push_unique(by_orth.sorted());
+    push_unique(by_distance.sorted());
+
+    // Seeds refine independently; filtering and de-duplication stay in seed order.
+    std::vector<RefineResult> attempts(chosen.size());
+    parallel_for(chosen.size(), num_threads, [&](std::size_t k) {
+        attempts[k] = refine_pair(sa, sb, chosen[k].s, chosen[k].t, self_pair);
+    });
 
     std::vector<RefineResult> refined;
-    for (const Seed& seed : chosen) {
-        RefineResult r = refine_pair(sa, sb, seed.s, seed.t, self_pair);
+    for (const RefineResult& r : attempts) {
         if (!std::isfinite(r.distance) || r.orth_residual >= 5e-9) continue;
         if (self_pair) {
             const double arc = std::min(std::abs(r.s - r.t), sa.length() - std::abs(r.s - r.t));
@@ -328,12 +418,75 @@ bool continuous_pair_distance(const PeriodicCubicSpline3D& sa, const PeriodicCub
         if (!dup) refined.push_back(r);
     }
     if (refined.empty()) return false;
-    std::sort(refined.begin(), refined.end(),
-              [](const RefineResult& a, const RefineResult& b) { return a.distance < b.distance; });
-    out = refined[0];
+    std::size_t best = 0;
+    for (std::size_t k = 1; k < refined.size(); ++k) {
+        if (refined[k].distance < refined[best].distance) best = k;
+    }
+    out = refined[best];
     return true;
 }
 
+struct SpanBox {
+    Vec3 lo, hi;
+};
+
+constexpr std::size_t kBoxIntervals = 16;
+
+/**
+ * Boxes that contain the continuous spline, one per run of kBoxIntervals knot intervals. On an
+ * interval of width h the spline leaves its chord by at most (|M_i| + |M_j|) h^2 / (9 sqrt 3) per
+ * axis (M = second derivative at the knots), since |A^3 - A| <= 2 / (3 sqrt 3) on [0, 1].
+ */
+std::vector<SpanBox> spline_boxes(const PeriodicCubicSpline3D& sp) {
+    const std::size_t n = sp.n();
+    std::vector<SplineEval> knots(n);
+    for (std::size_t i = 0; i < n; ++i) knots[i] = sp.eval(sp.parameter_at(i));
+    const double bulge = 1.0 / (9.0 * std::sqrt(3.0));
+
+    std::vector<SpanBox> boxes;
+    for (std::size_t first = 0; first < n; first += kBoxIntervals) {
+        SpanBox box;
+        box.lo = {{std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(),
+                   std::numeric_limits<double>::infinity()}};
+        box.hi = {{-std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+                   -std::numeric_limits<double>::infinity()}};
+        for (std::size_t i = first; i < std::min(n, first + kBoxIntervals); ++i) {
+            const SplineEval& a = knots[i];
+            const SplineEval& b = knots[(i + 1) % n];
+            const double h = sp.parameter_at(i + 1) - sp.parameter_at(i);
+            for (std::size_t d = 0; d < 3; ++d) {
+                const double grow = (std::abs(a.d2[d]) + std::abs(b.d2[d])) * h * h * bulge;
+                box.lo[d] = std::min(box.lo[d], std::min(a.p[d], b.p[d]) - grow);
+                box.hi[d] = std::max(box.hi[d], std::max(a.p[d], b.p[d]) + grow);
+            }
+        }
+        for (std::size_t d = 0; d < 3; ++d) {
+            const double slack = 1e-9 * (1.0 + box.hi[d] - box.lo[d]);
+            box.lo[d] -= slack;
+            box.hi[d] += slack;
+        }
+        boxes.push_back(box);
+    }
+    return boxes;
+}
+
+/** Lower bound on the distance between two splines from their boxes (0 when unknown). */
+double box_lower_bound(const std::vector<SpanBox>& a, const std::vector<SpanBox>& b) {
+    double best2 = std::numeric_limits<double>::infinity();
+    for (const SpanBox& x : a) {
+        for (const SpanBox& y : b) {
+            double d2 = 0.0;
+            for (std::size_t d = 0; d < 3; ++d) {
+                const double gap = std::max({0.0, x.lo[d] - y.hi[d], y.lo[d] - x.hi[d]});
+                d2 += gap * gap;
+            }
+            best2 = std::min(best2, d2);
+        }
+    }
+    const double bound = std::sqrt(best2);
+    return bound >= 0.0 ? bound : 0.0;
+}
+
 PairWitness to_witness(const RefineResult& r, std::size_t ca, std::size_t cb) {
     PairWitness w;
     w.component_a = ca;
@@ -356,7 +509,8 @@ PairWitness to_witness(const RefineResult& r, std::size_t ca, std::size_t cb) {
 }  // namespace
 
 ContinuousReachResult ContinuousReachSolver::compute(
-    const std::vector<PeriodicCubicSpline3D>& splines) {
+    const std::vector<PeriodicCubicSpline3D>& splines,
+    std::size_t num_threads) {
     ContinuousReachResult out;
     out.component_count = splines.size();
     if (splines.empty()) {
@@ -368,25 +522,54 @@ ContinuousReachResult ContinuousReachSolver::compute(
     curv.reserve(splines.size());
     for (const auto& sp : splines) curv.push_back(continuous_curvature_limit(sp));
 
+    std::vector<std::vector<SampleTable>> samples(splines.size());
     std::vector<RefineResult> self_res(splines.size());
     std::vector<bool> self_ok(splines.size(), false);
     for (std::size_t i = 0; i < splines.size(); ++i) {
-        self_ok[i] = continuous_pair_distance(splines[i], splines[i], true, self_res[i]);
+        const SampleTable& table =
+            cached_samples(samples[i], splines[i], seed_grid_size(splines[i], splines[i]));
+        self_ok[i] = continuous_pair_distance(
+            splines[i], table, splines[i], table, true, num_threads, self_res[i]);
     }
 
+    // Component pairs nearest-box first; a pair whose boxes are farther apart than the best
+    // inter distance so far cannot supply the minimum and is skipped.
+    struct PairBound {
+        double bound;
+        std::size_t i, j;
+    };
+    std::vector<std::vector<SpanBox>> boxes;
+    boxes.reserve(splines.size());
+    for (const auto& sp : splines) boxes.push_back(spline_boxes(sp));
+    std::vector<PairBound> pairs;
+    for (std::size_t i = 0; i < splines.size(); ++i) {
+        for (std::size_t j = i + 1; j < splines.size(); ++j) {
+            pairs.push_back({box_lower_bound(boxes[i], boxes[j]), i, j});
+        }
+    }
+    std::stable_sort(pairs.begin(), pairs.end(),
+                     [](const PairBound& a, const PairBound& b) { return a.bound < b.bound; });
+
     struct InterHit {
         RefineResult r;
         std::size_t i, j;
     };
     std::vector<InterHit> inter;
-    for (std::size_t i = 0; i < splines.size(); ++i) {
-        for (std::size_t j = i + 1; j < splines.size(); ++j) {
-            RefineResult r;
-            if (continuous_pair_distance(splines[i], splines[j], false, r)) {
-                inter.push_back({r, i, j});
-            }
+    double inter_best = std::numeric_limits<double>::infinity();
+    for (const PairBound& pair : pairs) {
+        if (pair.bound > inter_best) break;
+        const int M = seed_grid_size(splines[pair.i], splines[pair.j]);
+        const SampleTable& ta = cached_samples(samples[pair.i], splines[pair.i], M);
+        const SampleTable& tb = cached_samples(samples[pair.j], splines[pair.j], M);
+        RefineResult r;
+        if (continuous_pair_distance(splines[pair.i], ta, splines[pair.j], tb, false, num_threads, r)) {
+            inter.push_back({r, pair.i, pair.j});
+            inter_best = std::min(inter_best, r.distance);
         }
     }
+    std::sort(inter.begin(), inter.end(), [](const InterHit& a, const InterHit& b) {
+        return a.i != b.i ? a.i < b.i : a.j < b.j;
+    });
 
     std::size_t c_best_i = 0;
     for (std::size_t i = 1; i < curv.size(); ++i) {
@@ -461,13 +644,14 @@ ContinuousReachResult ContinuousReachSolver::compute(
 }
 
 ContinuousReachResult ContinuousReachSolver::compute(
-    const std::vector<std::vector<Vec3>>& components) {
+    const std::vector<std::vector<Vec3>>& components,
+    std::size_t num_threads) {
     std::vector<PeriodicCubicSpline3D> splines;
     splines.reserve(components.size());
     for (const auto& c : components) {
         splines.emplace_back(c);
     }
-    return compute(splines);
+    return compute(splines, num_threads);
 }
 
 }  // namespace geometry
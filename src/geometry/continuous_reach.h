@@ -7,18 +7,29 @@
 #include "sst/types.h"
 #include "vortexlab/types.h"
 
+#include <cstddef>
 #include <vector>
 
 namespace sst {
 namespace geometry {
 
+/**
+ * Continuous reach of a closed multi-component curve: min of the curvature radius, half the
+ * self distance of closest approach and half the inter-component distance. Seeds come from a
+ * per-spline sample table; component pairs whose spline boxes lie farther apart than the best
+ * inter distance so far are skipped (orth_residual covers the pairs that were refined). Seeds
+ * refine on num_threads workers (0 = hardware concurrency); the result does not depend on it,
+ * and the default stays serial for callers that already parallelise outside.
+ */
 class ContinuousReachSolver {
 public:
     static ContinuousReachResult compute(
-        const std::vector<std::vector<Vec3>>& components);
+        const std::vector<std::vector<Vec3>>& components,
+        std::size_t num_threads = 1);
 
     static ContinuousReachResult compute(
-        const std::vector<PeriodicCubicSpline3D>& splines);
+        const std::vector<PeriodicCubicSpline3D>& splines,
+        std::size_t num_threads = 1);
 };
 
 }  // namespace geometry
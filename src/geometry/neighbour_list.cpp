@@ -0,0 +1,132 @@
+#include "geometry/neighbour_list.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace sst {
+namespace geometry {
+namespace {
+
+constexpr std::int64_t kCellBits = 21;
+constexpr std::int64_t kMaxCells = (std::int64_t(1) << kCellBits) - 1;
+
+std::uint64_t cell_key(std::int64_t x, std::int64_t y, std::int64_t z) {
+    return (static_cast<std::uint64_t>(x) << (2 * kCellBits)) | (static_cast<std::uint64_t>(y) << kCellBits)
+           | static_cast<std::uint64_t>(z);
+}
+
+double max_displacement2(const Vec3* now, const std::vector<Vec3>& ref) {
+    double m = 0.0;
+    for (std::size_t i = 0; i < ref.size(); ++i) {
+        const double dx = now[i][0] - ref[i][0];
+        const double dy = now[i][1] - ref[i][1];
+        const double dz = now[i][2] - ref[i][2];
+        const double d2 = dx * dx + dy * dy + dz * dz;
+        if (!(d2 <= m)) m = d2;  // NaN forces a rebuild
+    }
+    return m;
+}
+
+}  // namespace
+
+VerletNeighbourList::VerletNeighbourList(double cutoff, double skin) {
+    set_radius(cutoff, skin);
+}
+
+void VerletNeighbourList::set_radius(double cutoff, double skin) {
+    if (!(cutoff > 0.0) || !(skin >= 0.0))
+        throw std::invalid_argument("neighbour list: cutoff must be > 0 and skin >= 0");
+    if (cutoff != cutoff_ || skin != skin_) valid_ = false;
+    cutoff_ = cutoff;
+    skin_ = skin;
+}
+
+bool VerletNeighbourList::update(const Vec3* targets, std::size_t target_count,
+                                 const Vec3* sources, std::size_t source_count) {
+    ++stats_.updates;
+    const bool self = targets == sources && target_count == source_count;
+    bool rebuild = !valid_ || self != self_ || target_count != target_ref_.size()
+                   || source_count != (self ? target_ref_.size() : source_ref_.size());
+    if (!rebuild) {
+        double d2 = max_displacement2(targets, target_ref_);
+        if (!self) d2 = std::max(d2, max_displacement2(sources, source_ref_));
+        stats_.max_displacement = std::sqrt(d2);
+        rebuild = !(d2 <= 0.25 * skin_ * skin_);
+    }
+    if (!rebuild) return false;
+    self_ = self;
+    build(targets, target_count, sources, source_count);
+    return true;
+}
+
+void VerletNeighbourList::build(const Vec3* targets, std::size_t target_count,
+                                const Vec3* sources, std::size_t source_count) {
+    target_ref_.assign(targets, targets + target_count);
+    if (self_) source_ref_.clear();
+    else source_ref_.assign(sources, sources + source_count);
+    valid_ = true;
+    ++stats_.builds;
+    stats_.max_displacement = 0.0;
+    offsets_.assign(target_count + 1, 0);
+    indices_.clear();
+
+    const double r = cutoff_ + skin_;
+    const double r2 = r * r;
+    Vec3 lo{{0, 0, 0}}, hi{{0, 0, 0}};
+    for (std::size_t s = 0; s < source_count; ++s) {
+        for (int c = 0; c < 3; ++c) {
+            lo[c] = s == 0 ? sources[s][c] : std::min(lo[c], sources[s][c]);
+            hi[c] = s == 0 ? sources[s][c] : std::max(hi[c], sources[s][c]);
+        }
+    }
+    // Cells at least r wide (wider if the box would need more than 2^21 per axis).
+    double cell = r;
+    for (int c = 0; c < 3; ++c) cell = std::max(cell, (hi[c] - lo[c]) / static_cast<double>(kMaxCells - 1));
+    if (!std::isfinite(cell) || !(cell > 0.0)) cell = 1.0;
+    const auto coord = [&](double x, int c) {
+        const double q = std::floor((x - lo[c]) / cell);
+        return q < -1.0 ? std::int64_t(-2) : (q > static_cast<double>(kMaxCells) ? kMaxCells + 1 : static_cast<std::int64_t>(q));
+    };
+
+    keys_.resize(source_count);
+    order_.resize(source_count);
+    for (std::size_t s = 0; s < source_count; ++s) {
+        keys_[s] = cell_key(coord(sources[s][0], 0), coord(sources[s][1], 1), coord(sources[s][2], 2));
+        order_[s] = s;
+    }
+    std::sort(order_.begin(), order_.end(), [&](std::size_t a, std::size_t b) {
+        return keys_[a] != keys_[b] ? keys_[a] < keys_[b] : a < b;
+    });
+    std::vector<std::uint64_t> sorted(source_count);
+    for (std::size_t k = 0; k < source_count; ++k) sorted[k] = keys_[order_[k]];
+
+    std::size_t longest = 0;
+    for (std::size_t t = 0; t < target_count; ++t) {
+        const Vec3& p = targets[t];
+        const std::size_t first = indices_.size();
+        const std::int64_t cx = coord(p[0], 0), cy = coord(p[1], 1), cz = coord(p[2], 2);
+        for (std::int64_t x = std::max<std::int64_t>(cx - 1, 0); x <= std::min(cx + 1, kMaxCells); ++x) {
+            for (std::int64_t y = std::max<std::int64_t>(cy - 1, 0); y <= std::min(cy + 1, kMaxCells); ++y) {
+                for (std::int64_t z = std::max<std::int64_t>(cz - 1, 0); z <= std::min(cz + 1, kMaxCells); ++z) {
+                    const auto range = std::equal_range(sorted.begin(), sorted.end(), cell_key(x, y, z));
+                    for (auto it = range.first; it != range.second; ++it) {
+                        const std::size_t s = order_[static_cast<std::size_t>(it - sorted.begin())];
+                        const double dx = p[0] - sources[s][0];
+                        const double dy = p[1] - sources[s][1];
+                        const double dz = p[2] - sources[s][2];
+                        if (dx * dx + dy * dy + dz * dz <= r2) indices_.push_back(s);
+                    }
+                }
+            }
+        }
+        std::sort(indices_.begin() + static_cast<std::ptrdiff_t>(first), indices_.end());
+        offsets_[t + 1] = indices_.size();
+        longest = std::max(longest, indices_.size() - first);
+    }
+    stats_.pairs = indices_.size();
+    stats_.max_neighbours = longest;
+}
+
+}  // namespace geometry
+}  // namespace sst
@@ -0,0 +1,73 @@
+#ifndef SSTCORE_GEOMETRY_NEIGHBOUR_LIST_H
+#define SSTCORE_GEOMETRY_NEIGHBOUR_LIST_H
+
+#pragma once
+
+#include "sst/types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sst {
+namespace geometry {
+
+struct NeighbourListStats {
+    std::size_t updates = 0;          // update() calls
+    std::size_t builds = 0;           // list (re)builds, the first one included
+    std::size_t pairs = 0;            // stored target–source pairs of the current list
+    std::size_t max_neighbours = 0;   // longest per-target list
+    double max_displacement = 0.0;    // largest move since the last build, at the last update
+};
+
+/**
+ * Verlet neighbour list: for every target point, the source points that were within
+ * cutoff + skin at the last build, in ascending source order (found through a uniform cell
+ * grid). update() rebuilds only when a target or source has moved more than skin / 2 since
+ * then, so between builds every pair closer than cutoff is listed and consumers filter the
+ * candidates by their exact distance test. Passing the same array as targets and sources
+ * lists each point against all points, itself included.
+ */
+class VerletNeighbourList {
+public:
+    VerletNeighbourList() = default;
+    VerletNeighbourList(double cutoff, double skin);
+
+    /** Throws std::invalid_argument unless cutoff > 0 and skin >= 0; a change drops the list. */
+    void set_radius(double cutoff, double skin);
+
+    /** Bring the list up to date with the current positions; returns true when it rebuilt. */
+    bool update(const Vec3* targets, std::size_t target_count,
+                const Vec3* sources, std::size_t source_count);
+
+    /** Force a rebuild on the next update (e.g. after remeshing changed the points). */
+    void invalidate() { valid_ = false; }
+
+    /** Sources listed for target, ascending, as [begin, end). */
+    const std::size_t* begin(std::size_t target) const { return indices_.data() + offsets_[target]; }
+    const std::size_t* end(std::size_t target) const { return indices_.data() + offsets_[target + 1]; }
+
+    double cutoff() const { return cutoff_; }
+    double skin() const { return skin_; }
+    const NeighbourListStats& stats() const { return stats_; }
+
+private:
+    double cutoff_ = 1.0;
+    double skin_ = 0.0;
+    bool valid_ = false;
+    bool self_ = false;
+    std::vector<Vec3> target_ref_;    // positions at the last build
+    std::vector<Vec3> source_ref_;
+    std::vector<std::size_t> offsets_ = {0};
+    std::vector<std::size_t> indices_;
+    std::vector<std::size_t> order_;  // sources sorted by cell
+    std::vector<std::uint64_t> keys_;
+    NeighbourListStats stats_;
+
+    void build(const Vec3* targets, std::size_t target_count, const Vec3* sources, std::size_t source_count);
+};
+
+}  // namespace geometry
+}  // namespace sst
+
+#endif
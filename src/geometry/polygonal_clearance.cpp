@@ -1,11 +1,33 @@
 #include "geometry/polygonal_clearance.h"
 
+#include "geometry/segment_bvh.h"
+
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <stdexcept>
 
 namespace sst {
 namespace geometry {
+namespace {
+
+// Curves with at least this many segments are searched through a SegmentBvh; below it the
+// pair loops are cheaper than building the tree.
+constexpr std::size_t kBvhMinSegments = 64;
+
+}  // namespace
+
+int self_skip_neighbors(const std::vector<Vec3>& curve, double core_radius, int default_skip_neighbors) {
+    if (core_radius <= 0.0 || curve.size() < 2) return default_skip_neighbors;
+    double L = 0.0;
+    const std::size_t n = curve.size();
+    for (std::size_t k = 0; k < n; ++k) {
+        L += norm(diff(curve[(k + 1) % n], curve[k]));
+    }
+    const double lmean = L / static_cast<double>(std::max<std::size_t>(1, n));
+    return std::max(2, static_cast<int>(std::ceil(6.0 * core_radius / std::max(lmean, 1e-12))));
+}
+
 double segment_segment_distance2(
     const Vec3& a,
     const Vec3& b,
@@ -73,9 +95,13 @@ double segment_segment_distance(
     return std::sqrt(segment_segment_distance2(a, b, c, d));
 }
 
-double self_clearance(const std::vector<Vec3>& curve, int skip_neighbors) {
+double self_clearance(const std::vector<Vec3>& curve, int skip_neighbors, SegmentBvhAccelerator* accelerator) {
     const std::size_t n = curve.size();
     if (n < 4) return std::numeric_limits<double>::infinity();
+    if (n >= kBvhMinSegments) {
+        if (accelerator) return std::sqrt(accelerator->tree(curve).self_min_distance2(curve, skip_neighbors));
+        return std::sqrt(SegmentBvh(curve).self_min_distance2(curve, skip_neighbors));
+    }
     const int skip = std::max(2, skip_neighbors);
     double m2 = std::numeric_limits<double>::infinity();
     for (std::size_t i = 0; i < n; ++i) {
@@ -107,6 +133,8 @@ double self_clearance(const std::vector<Vec3>& curve, int skip_neighbors) {
 
 double inter_clearance(const std::vector<Vec3>& a, const std::vector<Vec3>& b) {
     if (a.size() < 2 || b.size() < 2) return std::numeric_limits<double>::infinity();
+    if (a.size() * b.size() >= kBvhMinSegments * kBvhMinSegments)
+        return std::sqrt(SegmentBvh::min_distance2(SegmentBvh(a), a, SegmentBvh(b), b));
     double m2 = std::numeric_limits<double>::infinity();
     const std::size_t na = a.size(), nb = b.size();
     for (std::size_t i = 0; i < na; ++i) {
@@ -137,32 +165,104 @@ double inter_clearance(const std::vector<Vec3>& a, const std::vector<Vec3>& b) {
 TopologyClearanceResult multi_component_clearance(
     const std::vector<std::vector<Vec3>>& curves,
     double core_radius,
-    int default_skip_neighbors) {
+    int default_skip_neighbors,
+    SegmentBvhAccelerator* accelerator) {
     TopologyClearanceResult out;
     out.self_min = std::numeric_limits<double>::infinity();
     out.inter_min = std::numeric_limits<double>::infinity();
     out.clearance = std::numeric_limits<double>::infinity();
 
-    for (const auto& curve : curves) {
-        int skip = default_skip_neighbors;
-        if (core_radius > 0.0 && curve.size() >= 2) {
-            double L = 0.0;
-            const std::size_t n = curve.size();
-            for (std::size_t k = 0; k < n; ++k) {
-                L += norm(diff(curve[(k + 1) % n], curve[k]));
-            }
-            const double lmean = L / static_cast<double>(std::max<std::size_t>(1, n));
-            skip = std::max(2, static_cast<int>(std::ceil(6.0 * core_radius / std::max(lmean, 1e-12))));
+    // One tree per large curve, shared by its self query and every inter-component query.
+    std::vector<SegmentBvh> owned(accelerator ? 0 : curves.size());
+    std::vector<const SegmentBvh*> trees(curves.size(), nullptr);
+    for (std::size_t i = 0; i < curves.size(); ++i) {
+        const auto& curve = curves[i];
+        const int skip = self_skip_neighbors(curve, core_radius, default_skip_neighbors);
+        if (curve.size() >= kBvhMinSegments) {
+            trees[i] = accelerator ? &accelerator->tree(curve, i) : &(owned[i] = SegmentBvh(curve));
+            out.self_min = std::min(out.self_min, std::sqrt(trees[i]->self_min_distance2(curve, skip)));
+        } else {
+            out.self_min = std::min(out.self_min, self_clearance(curve, skip));
         }
-        out.self_min = std::min(out.self_min, self_clearance(curve, skip));
     }
 
     for (std::size_t i = 0; i < curves.size(); ++i) {
         for (std::size_t j = i + 1; j < curves.size(); ++j) {
-            out.inter_min = std::min(out.inter_min, inter_clearance(curves[i], curves[j]));
+            const double d = trees[i] && trees[j]
+                ? std::sqrt(SegmentBvh::min_distance2(*trees[i], curves[i], *trees[j], curves[j]))
+                : inter_clearance(curves[i], curves[j]);
+            out.inter_min = std::min(out.inter_min, d);
+        }
+    }
+
+    out.clearance = std::min(out.self_min, out.inter_min);
+    return out;
+}
+
+TopologyClearanceResult near_field_clearance(
+    const std::vector<std::vector<Vec3>>& curves,
+    double threshold,
+    VerletNeighbourList& list,
+    double core_radius,
+    int default_skip_neighbors) {
+    const std::size_t nc = curves.size();
+    std::vector<std::size_t> offsets(nc + 1, 0);
+    std::vector<int> skip(nc);
+    for (std::size_t c = 0; c < nc; ++c) {
+        offsets[c + 1] = offsets[c] + curves[c].size();
+        skip[c] = std::max(2, self_skip_neighbors(curves[c], core_radius, default_skip_neighbors));
+    }
+    std::vector<Vec3> mids(offsets[nc]);
+    double lmax = 0.0;
+    for (std::size_t c = 0; c < nc; ++c) {
+        const auto& curve = curves[c];
+        const std::size_t n = curve.size();
+        for (std::size_t k = 0; k < n; ++k) {
+            const Vec3& A = curve[k];
+            const Vec3& B = curve[(k + 1) % n];
+            mids[offsets[c] + k] = Vec3{{0.5 * (A[0] + B[0]), 0.5 * (A[1] + B[1]), 0.5 * (A[2] + B[2])}};
+            lmax = std::max(lmax, norm(diff(B, A)));
         }
     }
+    if (!(list.cutoff() >= threshold + lmax))
+        throw std::invalid_argument("near_field_clearance: neighbour list cutoff below threshold + longest edge");
+    list.update(mids.data(), mids.size(), mids.data(), mids.size());
 
+    // Each unordered pair once, lower flat index first: the argument order of self_clearance
+    // and inter_clearance, so the distances are bitwise the same.
+    double self2 = std::numeric_limits<double>::infinity();
+    double inter2 = std::numeric_limits<double>::infinity();
+    for (std::size_t ca = 0; ca < nc; ++ca) {
+        const auto& a = curves[ca];
+        const std::size_t na = a.size();
+        if (na < 2) continue;
+        for (std::size_t i = 0; i < na; ++i) {
+            const Vec3& A = a[i];
+            const Vec3& B = a[(i + 1) % na];
+            std::size_t cb = ca;
+            for (const std::size_t* it = list.begin(offsets[ca] + i); it != list.end(offsets[ca] + i); ++it) {
+                if (*it <= offsets[ca] + i) continue;
+                while (*it >= offsets[cb + 1]) ++cb;
+                const auto& b = curves[cb];
+                const std::size_t nb = b.size();
+                const std::size_t j = *it - offsets[cb];
+                if (cb == ca) {
+                    if (na < 4) continue;
+                    const int dd = static_cast<int>(std::min(j - i, na - (j - i)));
+                    if (dd < skip[ca]) continue;
+                } else if (nb < 2) {
+                    continue;
+                }
+                const double d2 = segment_segment_distance2(A, B, b[j], b[(j + 1) % nb]);
+                double& m2 = cb == ca ? self2 : inter2;
+                if (d2 < m2) m2 = d2;
+            }
+        }
+    }
+
+    TopologyClearanceResult out;
+    out.self_min = std::sqrt(self2);
+    out.inter_min = std::sqrt(inter2);
     out.clearance = std::min(out.self_min, out.inter_min);
     return out;
 }
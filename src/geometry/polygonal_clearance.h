@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include "geometry/neighbour_list.h"
+#include "geometry/segment_bvh.h"
 #include "sst/types.h"
 #include "vortexlab/types.h"
 
@@ -25,12 +27,23 @@ double segment_segment_distance2(
     const Vec3& c,
     const Vec3& d);
 
-/** Self-clearance of a closed polygonal curve (skip adjacent index window). */
+/** Self skip window: max(2, ceil(6 * core_radius / mean edge)) when core_radius > 0, else the default. */
+int self_skip_neighbors(
+    const std::vector<Vec3>& curve,
+    double core_radius,
+    int default_skip_neighbors = 2);
+
+/**
+ * Self-clearance of a closed polygonal curve (skip adjacent index window). Curves of 64 or
+ * more segments are searched with a SegmentBvh dual-tree traversal (same result bitwise),
+ * taken from slot 0 of accelerator when one is given.
+ */
 double self_clearance(
     const std::vector<Vec3>& curve,
-    int skip_neighbors = 2);
+    int skip_neighbors = 2,
+    SegmentBvhAccelerator* accelerator = nullptr);
 
-/** Minimum inter-component segment clearance between two closed curves. */
+/** Minimum inter-component segment clearance between two closed curves (BVH when large). */
 double inter_clearance(
     const std::vector<Vec3>& a,
     const std::vector<Vec3>& b);
@@ -38,10 +51,28 @@ double inter_clearance(
 /**
  * Multi-component polygonal clearance (min of self and inter).
  * If core_radius > 0, self skip = max(2, ceil(6*core_radius / mean_edge)).
+ * Each large curve's SegmentBvh is built once and shared by its self and inter queries; with
+ * an accelerator, component k's tree is kept in slot k and refit across calls.
  */
 TopologyClearanceResult multi_component_clearance(
     const std::vector<std::vector<Vec3>>& curves,
     double core_radius = 0.0,
+    int default_skip_neighbors = 2,
+    SegmentBvhAccelerator* accelerator = nullptr);
+
+/**
+ * multi_component_clearance over the segment pairs listed by list, which is refreshed here
+ * with the segment midpoints (component after component) and must have a cutoff of at least
+ * threshold plus the longest edge (else std::invalid_argument), so every pair closer than
+ * threshold is a candidate. The result equals the full one whenever that is below threshold;
+ * otherwise it is only known to be >= threshold (infinity without candidates). Keeping the
+ * list across calls on nearby configurations reuses it until something moves skin / 2.
+ */
+TopologyClearanceResult near_field_clearance(
+    const std::vector<std::vector<Vec3>>& curves,
+    double threshold,
+    VerletNeighbourList& list,
+    double core_radius = 0.0,
     int default_skip_neighbors = 2);
 
 }  // namespace geometry
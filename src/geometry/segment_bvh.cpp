@@ -0,0 +1,317 @@
+#include "geometry/segment_bvh.h"
+
+#include "geometry/polygonal_clearance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace sst {
+namespace geometry {
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+// Node pairs are pruned only when their box distance clearly exceeds the best pair, so a
+// rounding difference between box and segment distance can never drop the true minimum.
+constexpr double kPruneSlack = 1.0 + 1e-9;
+
+double box_distance2(const SegmentBvhNode& a, const SegmentBvhNode& b) {
+    double d2 = 0.0;
+    for (int c = 0; c < 3; ++c) {
+        const double gap = std::max({0.0, b.lo[c] - a.hi[c], a.lo[c] - b.hi[c]});
+        d2 += gap * gap;
+    }
+    return d2;
+}
+
+double extent(const SegmentBvhNode& n) {
+    return std::max({n.hi[0] - n.lo[0], n.hi[1] - n.lo[1], n.hi[2] - n.lo[2]});
+}
+
+double extent_sum(const SegmentBvhNode& n) {
+    return (n.hi[0] - n.lo[0]) + (n.hi[1] - n.lo[1]) + (n.hi[2] - n.lo[2]);
+}
+
+/**
+ * Dual-tree minimum over leaf pairs. With same_tree, (a, b) and (b, a) are one pair and a node
+ * is paired with itself; leaf(a, b, best) scans one leaf pair and lowers best.
+ */
+template <class LeafPair>
+double dual_tree_min(const std::vector<SegmentBvhNode>& ta, const std::vector<SegmentBvhNode>& tb,
+                     bool same_tree, std::size_t skip, LeafPair&& leaf) {
+    // Within one curve, every pair of two index ranges closer than skip is excluded.
+    const auto inside_window = [&](const SegmentBvhNode& a, const SegmentBvhNode& b) {
+        return same_tree && std::max(a.last, b.last) - std::min(a.first, b.first) < skip;
+    };
+    double best = kInf;
+    if (ta.empty() || tb.empty()) return best;
+    struct Item {
+        std::size_t a, b;
+        double d2;
+    };
+    std::vector<Item> stack;
+    stack.push_back({0, 0, box_distance2(ta[0], tb[0])});
+    Item near[4];
+    while (!stack.empty()) {
+        const Item it = stack.back();
+        stack.pop_back();
+        if (it.d2 > best * kPruneSlack) continue;
+        const SegmentBvhNode& na = ta[it.a];
+        const SegmentBvhNode& nb = tb[it.b];
+        if (inside_window(na, nb)) continue;
+        if (na.leaf() && nb.leaf()) {
+            leaf(na, nb, best);
+            continue;
+        }
+        int count = 0;
+        if (same_tree && it.a == it.b) {
+            near[count++] = {na.left, na.left, 0.0};
+            near[count++] = {na.left, na.right, 0.0};
+            near[count++] = {na.right, na.right, 0.0};
+        } else if (nb.leaf() || (!na.leaf() && extent(na) >= extent(nb))) {
+            near[count++] = {na.left, it.b, 0.0};
+            near[count++] = {na.right, it.b, 0.0};
+        } else {
+            near[count++] = {it.a, nb.left, 0.0};
+            near[count++] = {it.a, nb.right, 0.0};
+        }
+        for (int k = 0; k < count; ++k) near[k].d2 = box_distance2(ta[near[k].a], tb[near[k].b]);
+        // Farthest pushed first so the nearest pair is refined next.
+        std::sort(near, near + count, [](const Item& x, const Item& y) { return x.d2 > y.d2; });
+        for (int k = 0; k < count; ++k) {
+            if (near[k].d2 <= best * kPruneSlack) stack.push_back(near[k]);
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
+SegmentBvh::SegmentBvh(const std::vector<Vec3>& curve, std::size_t leaf_size)
+    : leaf_size_(std::max<std::size_t>(1, leaf_size)) {
+    const std::size_t n = curve.size();
+    if (n == 0) return;
+    order_.resize(n);
+    std::vector<Vec3> centres(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        order_[k] = k;
+        const Vec3& A = curve[k];
+        const Vec3& B = curve[(k + 1) % n];
+        centres[k] = Vec3{{0.5 * (A[0] + B[0]), 0.5 * (A[1] + B[1]), 0.5 * (A[2] + B[2])}};
+    }
+    nodes_.reserve(2 * (n / leaf_size_ + 1));
+    build(curve, centres, 0, n);
+    cost_ = build_cost_ = measure_cost();
+}
+
+double SegmentBvh::measure_cost() const {
+    if (nodes_.empty()) return 0.0;
+    const double root = extent_sum(nodes_[0]);
+    if (!(root > 0.0)) return 0.0;
+    double sum = 0.0;
+    for (const SegmentBvhNode& node : nodes_) {
+        if (!node.leaf()) sum += extent_sum(node);
+    }
+    return sum / root;
+}
+
+bool SegmentBvh::refit(const std::vector<Vec3>& curve) {
+    const std::size_t n = curve.size();
+    if (n != order_.size()) return false;
+    // Children are stored after their parent, so a reverse sweep sees them first.
+    for (std::size_t id = nodes_.size(); id-- > 0;) {
+        SegmentBvhNode& node = nodes_[id];
+        if (node.leaf()) {
+            node.lo = node.hi = curve[order_[node.begin]];
+            for (std::size_t p = node.begin; p < node.end; ++p) {
+                const Vec3& A = curve[order_[p]];
+                const Vec3& B = curve[(order_[p] + 1) % n];
+                for (int c = 0; c < 3; ++c) {
+                    node.lo[c] = std::min({node.lo[c], A[c], B[c]});
+                    node.hi[c] = std::max({node.hi[c], A[c], B[c]});
+                }
+            }
+        } else {
+            const SegmentBvhNode& l = nodes_[node.left];
+            const SegmentBvhNode& r = nodes_[node.right];
+            for (int c = 0; c < 3; ++c) {
+                node.lo[c] = std::min(l.lo[c], r.lo[c]);
+                node.hi[c] = std::max(l.hi[c], r.hi[c]);
+            }
+        }
+    }
+    cost_ = measure_cost();
+    return true;
+}
+
+std::size_t SegmentBvh::build(const std::vector<Vec3>& curve, std::vector<Vec3>& centres,
+                              std::size_t begin, std::size_t end) {
+    const std::size_t n = curve.size();
+    const std::size_t id = nodes_.size();
+    nodes_.emplace_back();
+    SegmentBvhNode node;
+    node.begin = begin;
+    node.end = end;
+    node.first = node.last = order_[begin];
+    if (end - begin <= leaf_size_) {
+        node.lo = node.hi = curve[order_[begin]];
+        for (std::size_t p = begin; p < end; ++p) {
+            const std::size_t k = order_[p];
+            node.first = std::min(node.first, k);
+            node.last = std::max(node.last, k);
+            const Vec3& A = curve[k];
+            const Vec3& B = curve[(k + 1) % n];
+            for (int c = 0; c < 3; ++c) {
+                node.lo[c] = std::min({node.lo[c], A[c], B[c]});
+                node.hi[c] = std::max({node.hi[c], A[c], B[c]});
+            }
+        }
+        nodes_[id] = node;
+        return id;
+    }
+
+    // Split at the median segment centre along the longest axis of the centres' box; the node
+    // box is the union of the children's.
+    Vec3 clo = centres[order_[begin]], chi = clo;
+    for (std::size_t p = begin + 1; p < end; ++p) {
+        const Vec3& m = centres[order_[p]];
+        for (int c = 0; c < 3; ++c) {
+            clo[c] = std::min(clo[c], m[c]);
+            chi[c] = std::max(chi[c], m[c]);
+        }
+    }
+    int axis = 0;
+    for (int c = 1; c < 3; ++c) {
+        if (chi[c] - clo[c] > chi[axis] - clo[axis]) axis = c;
+    }
+    const std::size_t mid = begin + (end - begin) / 2;
+    std::nth_element(order_.begin() + static_cast<std::ptrdiff_t>(begin),
+                     order_.begin() + static_cast<std::ptrdiff_t>(mid),
+                     order_.begin() + static_cast<std::ptrdiff_t>(end),
+                     [&](std::size_t x, std::size_t y) {
+                         return centres[x][axis] != centres[y][axis] ? centres[x][axis] < centres[y][axis] : x < y;
+                     });
+    node.left = build(curve, centres, begin, mid);
+    node.right = build(curve, centres, mid, end);
+    const SegmentBvhNode& l = nodes_[node.left];
+    const SegmentBvhNode& r = nodes_[node.right];
+    for (int c = 0; c < 3; ++c) {
+        node.lo[c] = std::min(l.lo[c], r.lo[c]);
+        node.hi[c] = std::max(l.hi[c], r.hi[c]);
+    }
+    node.first = std::min(l.first, r.first);
+    node.last = std::max(l.last, r.last);
+    nodes_[id] = node;
+    return id;
+}
+
+double SegmentBvh::self_min_distance2(const std::vector<Vec3>& curve, int skip_neighbors) const {
+    const std::size_t n = curve.size();
+    if (n < 4 || n != order_.size()) return kInf;
+    const std::size_t skip = static_cast<std::size_t>(std::max(2, skip_neighbors));
+    return dual_tree_min(nodes_, nodes_, true, skip, [&](const SegmentBvhNode& a, const SegmentBvhNode& b, double& best) {
+        for (std::size_t p = a.begin; p < a.end; ++p) {
+            for (std::size_t q = (&a == &b ? p + 1 : b.begin); q < b.end; ++q) {
+                const std::size_t i = std::min(order_[p], order_[q]);
+                const std::size_t j = std::max(order_[p], order_[q]);
+                if (std::min(j - i, n - (j - i)) < skip) continue;
+                const double d2 = segment_segment_distance2(curve[i], curve[(i + 1) % n], curve[j], curve[(j + 1) % n]);
+                if (d2 < best) best = d2;
+            }
+        }
+    });
+}
+
+double SegmentBvh::min_distance2(const SegmentBvh& ta, const std::vector<Vec3>& a,
+                                 const SegmentBvh& tb, const std::vector<Vec3>& b) {
+    const std::size_t na = a.size(), nb = b.size();
+    if (na < 2 || nb < 2 || na != ta.size() || nb != tb.size()) return kInf;
+    return dual_tree_min(ta.nodes_, tb.nodes_, false, 0, [&](const SegmentBvhNode& x, const SegmentBvhNode& y, double& best) {
+        for (std::size_t p = x.begin; p < x.end; ++p) {
+            const std::size_t i = ta.order_[p];
+            const Vec3& A = a[i];
+            const Vec3& B = a[(i + 1) % na];
+            for (std::size_t q = y.begin; q < y.end; ++q) {
+                const std::size_t j = tb.order_[q];
+                const double d2 = segment_segment_distance2(A, B, b[j], b[(j + 1) % nb]);
+                if (d2 < best) best = d2;
+            }
+        }
+    });
+}
+
+void SegmentBvh::self_pairs_within(const std::vector<Vec3>& curve, double r, std::size_t skip,
+                                   std::vector<std::pair<std::size_t, std::size_t>>& out) const {
+    const std::size_t n = curve.size();
+    if (n < 2 || n != order_.size() || !(r >= 0.0)) return;
+    const double r2 = r * r;
+    const auto box_gap2 = [](const Vec3& alo, const Vec3& ahi, const Vec3& blo, const Vec3& bhi) {
+        double d2 = 0.0;
+        for (int c = 0; c < 3; ++c) {
+            const double gap = std::max({0.0, blo[c] - ahi[c], alo[c] - bhi[c]});
+            d2 += gap * gap;
+        }
+        return d2;
+    };
+    const auto segment_box = [&](std::size_t k, Vec3& lo, Vec3& hi) {
+        const Vec3& A = curve[k];
+        const Vec3& B = curve[(k + 1) % n];
+        for (int c = 0; c < 3; ++c) {
+            lo[c] = std::min(A[c], B[c]);
+            hi[c] = std::max(A[c], B[c]);
+        }
+    };
+    std::vector<std::pair<std::size_t, std::size_t>> stack;
+    stack.emplace_back(0, 0);
+    while (!stack.empty()) {
+        const auto [ia, ib] = stack.back();
+        stack.pop_back();
+        const SegmentBvhNode& a = nodes_[ia];
+        const SegmentBvhNode& b = nodes_[ib];
+        if (box_distance2(a, b) > r2) continue;
+        if (std::max(a.last, b.last) - std::min(a.first, b.first) < skip) continue;
+        if (a.leaf() && b.leaf()) {
+            for (std::size_t p = a.begin; p < a.end; ++p) {
+                Vec3 plo, phi;
+                segment_box(order_[p], plo, phi);
+                for (std::size_t q = (ia == ib ? p + 1 : b.begin); q < b.end; ++q) {
+                    const std::size_t i = std::min(order_[p], order_[q]);
+                    const std::size_t j = std::max(order_[p], order_[q]);
+                    if (std::min(j - i, n - (j - i)) < skip) continue;
+                    Vec3 qlo, qhi;
+                    segment_box(order_[q], qlo, qhi);
+                    if (box_gap2(plo, phi, qlo, qhi) <= r2) out.emplace_back(i, j);
+                }
+            }
+        } else if (ia == ib) {
+            stack.emplace_back(a.left, a.left);
+            stack.emplace_back(a.left, a.right);
+            stack.emplace_back(a.right, a.right);
+        } else if (b.leaf() || (!a.leaf() && extent(a) >= extent(b))) {
+            stack.emplace_back(a.left, ib);
+            stack.emplace_back(a.right, ib);
+        } else {
+            stack.emplace_back(ia, b.left);
+            stack.emplace_back(ia, b.right);
+        }
+    }
+}
+
+SegmentBvhAccelerator::SegmentBvhAccelerator(double rebuild_ratio)
+    : rebuild_ratio_(std::max(1.0, rebuild_ratio)) {}
+
+const SegmentBvh& SegmentBvhAccelerator::tree(const std::vector<Vec3>& curve, std::size_t slot) {
+    ++stats_.updates;
+    if (slot >= trees_.size()) trees_.resize(slot + 1);
+    SegmentBvh& t = trees_[slot];
+    if (!t.empty() && t.refit(curve) && !(t.cost() > rebuild_ratio_ * t.build_cost())) {
+        ++stats_.refits;
+        return t;
+    }
+    t = SegmentBvh(curve);
+    ++stats_.builds;
+    return t;
+}
+
+}  // namespace geometry
+}  // namespace sst
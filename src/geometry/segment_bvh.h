@@ -0,0 +1,127 @@
+#ifndef SSTCORE_GEOMETRY_SEGMENT_BVH_H
+#define SSTCORE_GEOMETRY_SEGMENT_BVH_H
+
+#pragma once
+
+#include "sst/types.h"
+
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace sst {
+namespace geometry {
+
+struct SegmentBvhNode {
+    static constexpr std::size_t kNoChild = std::numeric_limits<std::size_t>::max();
+
+    Vec3 lo{{0, 0, 0}};  // axis-aligned box of the node's segment endpoints
+    Vec3 hi{{0, 0, 0}};
+    std::size_t begin = 0;  // range into SegmentBvh::order()
+    std::size_t end = 0;
+    std::size_t first = 0;  // smallest and largest segment index in the node
+    std::size_t last = 0;
+    std::size_t left = kNoChild;
+    std::size_t right = kNoChild;
+
+    bool leaf() const { return left == kNoChild; }
+};
+
+/**
+ * Bounding-volume hierarchy over the segments curve[k] -> curve[(k + 1) % n] of a closed
+ * polyline (median split of the segment centres along the longest box axis). The tree keeps
+ * only indices and boxes; queries take the curve it was built on. Node 0 is the root.
+ */
+class SegmentBvh {
+public:
+    SegmentBvh() = default;
+    explicit SegmentBvh(const std::vector<Vec3>& curve, std::size_t leaf_size = 8);
+
+    const std::vector<SegmentBvhNode>& nodes() const { return nodes_; }
+    const std::vector<std::size_t>& order() const { return order_; }
+    std::size_t size() const { return order_.size(); }
+    bool empty() const { return nodes_.empty(); }
+
+    /**
+     * Minimum squared segment–segment distance over pairs i < j whose cyclic index distance is
+     * at least skip (dual-tree traversal, nearest node pairs first; node pairs whose index
+     * ranges lie entirely inside the skip window are dropped unvisited). The pair distances are
+     * those of segment_segment_distance2(seg i, seg j), so the result is bitwise the brute-force
+     * minimum; infinity when no pair qualifies.
+     */
+    double self_min_distance2(const std::vector<Vec3>& curve, int skip) const;
+
+    /** Minimum squared distance between the segments of two curves, each with its own tree. */
+    static double min_distance2(const SegmentBvh& ta, const std::vector<Vec3>& a,
+                                const SegmentBvh& tb, const std::vector<Vec3>& b);
+
+    /**
+     * Appends every pair (i, j), i < j, with cyclic index distance at least skip (no floor)
+     * whose segment boxes are within r: a superset of the pairs closer than r, each once, in
+     * traversal order.
+     */
+    void self_pairs_within(const std::vector<Vec3>& curve, double r, std::size_t skip,
+                           std::vector<std::pair<std::size_t, std::size_t>>& out) const;
+
+    /**
+     * Recompute every box for the curve's current points, keeping the tree (children before
+     * parents, O(n)); false when the point count differs from the one the tree was built on.
+     */
+    bool refit(const std::vector<Vec3>& curve);
+
+    /**
+     * Traversal cost estimate: the summed box extents (dx + dy + dz) of the internal nodes
+     * relative to the root's. Refits that scatter a node's segments raise it; build_cost() is
+     * its value when the tree was built.
+     */
+    double cost() const { return cost_; }
+    double build_cost() const { return build_cost_; }
+
+private:
+    std::size_t leaf_size_ = 8;
+    std::vector<std::size_t> order_;
+    std::vector<SegmentBvhNode> nodes_;
+    double cost_ = 0.0;
+    double build_cost_ = 0.0;
+
+    double measure_cost() const;
+
+    std::size_t build(const std::vector<Vec3>& curve, std::vector<Vec3>& centres,
+                      std::size_t begin, std::size_t end);
+};
+
+struct SegmentBvhAcceleratorStats {
+    std::size_t updates = 0;  // tree() calls
+    std::size_t builds = 0;   // full builds, the first one of every slot included
+    std::size_t refits = 0;   // O(n) refits that kept the tree
+};
+
+/**
+ * Segment BVHs kept across queries on slowly changing curves, one per slot (component).
+ * tree() refits the slot's tree to the current points and rebuilds it only when the point
+ * count changed or the refit cost exceeds rebuild_ratio times its cost at build. Trees only
+ * prune, so queries through them return the same results however often they were refit.
+ * References returned by tree() stay valid while the accelerator lives.
+ */
+class SegmentBvhAccelerator {
+public:
+    explicit SegmentBvhAccelerator(double rebuild_ratio = 1.5);
+
+    const SegmentBvh& tree(const std::vector<Vec3>& curve, std::size_t slot = 0);
+    void clear() { trees_.clear(); }
+
+    double rebuild_ratio() const { return rebuild_ratio_; }
+    const SegmentBvhAcceleratorStats& stats() const { return stats_; }
+
+private:
+    double rebuild_ratio_ = 1.5;
+    std::deque<SegmentBvh> trees_;
+    SegmentBvhAcceleratorStats stats_;
+};
+
+}  // namespace geometry
+}  // namespace sst
+
+#endif
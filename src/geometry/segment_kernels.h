@@ -0,0 +1,59 @@
+#ifndef SSTCORE_SEGMENT_KERNELS_H
+#define SSTCORE_SEGMENT_KERNELS_H
+
+#pragma once
+
+#include "sst/types.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace sst {
+namespace geometry {
+
+/** Per-segment Biot–Savart quadrature used by the polyline velocity evaluators. */
+enum class SegmentKernel {
+    Midpoint,        // dl × (x - y_mid) / |x - y_mid|³ (historical)
+    StraightSegment  // exact field of the straight segment between the two vertices
+};
+
+inline const char* segment_kernel_name(SegmentKernel k) {
+    return k == SegmentKernel::StraightSegment ? "straight_segment" : "midpoint";
+}
+
+inline SegmentKernel segment_kernel_from_name(const std::string& name) {
+    if (name == "midpoint") return SegmentKernel::Midpoint;
+    if (name == "straight_segment" || name == "segment" || name == "exact") return SegmentKernel::StraightSegment;
+    throw std::invalid_argument("unknown segment kernel: " + name);
+}
+
+/**
+ * Velocity induced at p by the straight segment a → b with unit circulation, without the 1/4π:
+ *   v = (|r1| + |r2|) (r1 × r2) / (|r1||r2| (|r1||r2| + r1·r2) + reg2 |b - a|²),  r1 = p - a, r2 = p - b.
+ * This is the exact line integral of dl × r / |r|³ along the segment, written in endpoint distances
+ * (no cancelling arccos/difference terms). reg2 > 0 adds a cut-off core of radius ~√reg2; with
+ * reg2 = 0 points on the segment's own line inside it (or on a vertex) get zero.
+ */
+inline Vec3 straight_segment_velocity(const Vec3& p, const Vec3& a, const Vec3& b, double reg2 = 0.0) {
+    const Vec3 r1 = diff(p, a);
+    const Vec3 r2 = diff(p, b);
+    const double l1 = norm(r1);
+    const double l2 = norm(r2);
+    const double l1l2 = l1 * l2;
+    const double s = l1l2 + dot(r1, r2);
+    if (reg2 <= 0.0 && !(s > 1e-12 * l1l2)) return {0.0, 0.0, 0.0};
+    double den = l1l2 * s;
+    if (reg2 > 0.0) {
+        const Vec3 d = diff(b, a);
+        den += reg2 * dot(d, d);
+    }
+    if (!(den > 0.0)) return {0.0, 0.0, 0.0};
+    const double f = (l1 + l2) / den;
+    const Vec3 c = cross(r1, r2);
+    return {c[0] * f, c[1] * f, c[2] * f};
+}
+
+}  // namespace geometry
+}  // namespace sst
+
+#endif
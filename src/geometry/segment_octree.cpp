@@ -0,0 +1,239 @@
+#include "geometry/segment_octree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace sst {
+namespace geometry {
+namespace {
+
+constexpr int kMaxDepth = 48;
+
+void accumulate(SegmentMoments& m, const Vec3& d, const Vec3& dl, const Vec3* extent) {
+    m.strength += norm(dl);
+    for (int a = 0; a < 3; ++a) {
+        m.m0[a] += dl[a];
+        for (int i = 0; i < 3; ++i) {
+            m.m1[a][i] += dl[a] * d[i];
+            for (int j = 0; j < 3; ++j) {
+                m.m2[a][i][j] += dl[a] * d[i] * d[j];
+            }
+        }
+    }
+    if (!extent) return;
+    // ∫_{-1/2}^{1/2} (d + s e)_i (d + s e)_k ds = d_i d_k + e_i e_k / 12
+    const Vec3& e = *extent;
+    for (int a = 0; a < 3; ++a) {
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                m.m2[a][i][j] += dl[a] * e[i] * e[j] / 12.0;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+std::size_t SegmentOctreeNode::find_tag(std::uint32_t tag) const {
+    const auto it = std::lower_bound(tags.begin(), tags.end(), tag);
+    return (it != tags.end() && *it == tag) ? static_cast<std::size_t>(it - tags.begin()) : tags.size();
+}
+
+SegmentOctree::SegmentOctree(
+    const std::vector<Vec3>& mids,
+    const std::vector<Vec3>& dls,
+    std::size_t leaf_size,
+    const std::vector<std::uint32_t>* tags,
+    const std::vector<Vec3>* extents)
+    : mids_(&mids), dls_(&dls), tags_(tags), extents_(extents), leaf_size_(std::max<std::size_t>(1, leaf_size)) {
+    if (mids.empty()) return;
+    order_.resize(mids.size());
+    for (std::size_t i = 0; i < order_.size(); ++i) order_[i] = i;
+    nodes_.reserve(2 * (mids.size() / leaf_size_ + 1));
+    build(0, order_.size(), 0);
+    position_.resize(order_.size());
+    for (std::size_t k = 0; k < order_.size(); ++k) position_[order_[k]] = k;
+    mids_ = nullptr;
+    dls_ = nullptr;
+    tags_ = nullptr;
+    extents_ = nullptr;
+}
+
+std::size_t SegmentOctree::build(std::size_t begin, std::size_t end, int depth) {
+    const std::size_t id = nodes_.size();
+    nodes_.emplace_back();
+    nodes_[id].begin = begin;
+    nodes_[id].end = end;
+    compute_moments(nodes_[id]);
+
+    const std::vector<Vec3>& mids = *mids_;
+    Vec3 lo{{std::numeric_limits<double>::infinity(),
+             std::numeric_limits<double>::infinity(),
+             std::numeric_limits<double>::infinity()}};
+    Vec3 hi{{-lo[0], -lo[1], -lo[2]}};
+    for (std::size_t k = begin; k < end; ++k) {
+        const Vec3& y = mids[order_[k]];
+        for (int a = 0; a < 3; ++a) {
+            lo[a] = std::min(lo[a], y[a]);
+            hi[a] = std::max(hi[a], y[a]);
+        }
+    }
+    const double extent = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]});
+    if (end - begin <= leaf_size_ || depth >= kMaxDepth || !(extent > 0.0)) {
+        return id;
+    }
+
+    const Vec3 split{{0.5 * (lo[0] + hi[0]), 0.5 * (lo[1] + hi[1]), 0.5 * (lo[2] + hi[2])}};
+    auto octant = [&](std::size_t seg) {
+        const Vec3& y = mids[seg];
+        return (y[0] > split[0] ? 1 : 0) | (y[1] > split[1] ? 2 : 0) | (y[2] > split[2] ? 4 : 0);
+    };
+    std::size_t counts[8] = {};
+    for (std::size_t k = begin; k < end; ++k) ++counts[octant(order_[k])];
+    std::size_t offsets[9] = {};
+    for (int o = 0; o < 8; ++o) offsets[o + 1] = offsets[o] + counts[o];
+    std::vector<std::size_t> sorted(end - begin);
+    std::size_t cursor[8];
+    for (int o = 0; o < 8; ++o) cursor[o] = offsets[o];
+    for (std::size_t k = begin; k < end; ++k) {
+        const std::size_t seg = order_[k];
+        sorted[cursor[octant(seg)]++] = seg;
+    }
+    std::copy(sorted.begin(), sorted.end(), order_.begin() + static_cast<std::ptrdiff_t>(begin));
+
+    nodes_[id].leaf = false;
+    for (int o = 0; o < 8; ++o) {
+        if (counts[o] == 0) continue;
+        const std::size_t child = build(begin + offsets[o], begin + offsets[o + 1], depth + 1);
+        nodes_[id].child[o] = child;
+    }
+    return id;
+}
+
+void SegmentOctree::compute_moments(SegmentOctreeNode& node) const {
+    const std::vector<Vec3>& mids = *mids_;
+    const std::vector<Vec3>& dls = *dls_;
+    const double count = static_cast<double>(node.end - node.begin);
+    Vec3 c{{0, 0, 0}};
+    for (std::size_t k = node.begin; k < node.end; ++k) {
+        const Vec3& y = mids[order_[k]];
+        c[0] += y[0];
+        c[1] += y[1];
+        c[2] += y[2];
+    }
+    node.center = {c[0] / count, c[1] / count, c[2] / count};
+
+    for (std::size_t k = node.begin; k < node.end; ++k) {
+        const std::size_t seg = order_[k];
+        const Vec3 d = diff(mids[seg], node.center);
+        const Vec3* extent = extents_ ? &(*extents_)[seg] : nullptr;
+        node.radius = std::max(node.radius, extent ? norm(d) + 0.5 * norm(*extent) : norm(d));
+        accumulate(node.moments, d, dls[seg], extent);
+        if (tags_) node.tags.push_back((*tags_)[seg]);
+    }
+    if (!tags_) return;
+
+    std::sort(node.tags.begin(), node.tags.end());
+    node.tags.erase(std::unique(node.tags.begin(), node.tags.end()), node.tags.end());
+    if (node.tags.size() == 1) {
+        node.tag_moments.assign(1, node.moments);
+        return;
+    }
+    node.tag_moments.assign(node.tags.size(), SegmentMoments{});
+    for (std::size_t k = node.begin; k < node.end; ++k) {
+        const std::size_t seg = order_[k];
+        accumulate(node.tag_moments[node.find_tag((*tags_)[seg])], diff(mids[seg], node.center), dls[seg],
+                   extents_ ? &(*extents_)[seg] : nullptr);
+    }
+}
+
+Vec3 segment_multipole_velocity(const SegmentMoments& m, const Vec3& R, double reg2) {
+    // A = Σ dl G(x - y),  G(R) = (|R|² + reg2)^{-1/2};  v = ∇ × A with
+    // ∂_b A_c = m0_c ∂_b G - m1_{c,i} ∂_b∂_i G + ½ m2_{c,ik} ∂_b∂_i∂_k G.
+    const double g2 = 1.0 / (R[0] * R[0] + R[1] * R[1] + R[2] * R[2] + reg2);
+    const double g1 = std::sqrt(g2);
+    const double g3 = g1 * g2;
+    const double g5 = g3 * g2;
+    const double g7 = g5 * g2;
+
+    double J[3][3];
+    for (int c = 0; c < 3; ++c) {
+        const double m1R = m.m1[c][0] * R[0] + m.m1[c][1] * R[1] + m.m1[c][2] * R[2];
+        double m2R[3];
+        double Rm2R = 0.0;
+        for (int b = 0; b < 3; ++b) {
+            m2R[b] = m.m2[c][b][0] * R[0] + m.m2[c][b][1] * R[1] + m.m2[c][b][2] * R[2];
+            Rm2R += R[b] * m2R[b];
+        }
+        const double tr_m2 = m.m2[c][0][0] + m.m2[c][1][1] + m.m2[c][2][2];
+        for (int b = 0; b < 3; ++b) {
+            const double mono = -m.m0[c] * R[b] * g3;
+            const double dip = 3.0 * R[b] * m1R * g5 - m.m1[c][b] * g3;
+            const double quad = -15.0 * R[b] * Rm2R * g7 + 3.0 * (R[b] * tr_m2 + 2.0 * m2R[b]) * g5;
+            J[b][c] = mono - dip + 0.5 * quad;
+        }
+    }
+    return {J[1][2] - J[2][1], J[2][0] - J[0][2], J[0][1] - J[1][0]};
+}
+
+double segment_multipole_error_bound(double strength, double radius, double d) {
+    const double gap = d - radius;
+    const double q = radius / gap;
+    return 4.0 * strength * q * q * q / (gap * gap);
+}
+
+Vec3 dipole_multipole_field(const SegmentMoments& m, const Vec3& R) {
+    // B_i = m0_a T_ia - m1_{a,k} T_iak + ½ m2_{a,kl} T_iakl with T the derivative tensors of
+    // G = 1/|R|: T_ia = ∂_i∂_a G, T_iak = ∂_i∂_a∂_k G, T_iakl = ∂_i∂_a∂_k∂_l G (m2 symmetric in k, l).
+    const double g2 = 1.0 / (R[0] * R[0] + R[1] * R[1] + R[2] * R[2]);
+    const double g1 = std::sqrt(g2);
+    const double g3 = g1 * g2;
+    const double g5 = g3 * g2;
+    const double g7 = g5 * g2;
+    const double g9 = g7 * g2;
+
+    const double m0R = m.m0[0] * R[0] + m.m0[1] * R[1] + m.m0[2] * R[2];
+    double P[3], Q[3], A[3], B[3], tr[3], e[3];
+    double tr_m1 = 0.0, S = 0.0, c1 = 0.0, c2 = 0.0, s1 = 0.0;
+    for (int i = 0; i < 3; ++i) {
+        P[i] = m.m1[i][0] * R[0] + m.m1[i][1] * R[1] + m.m1[i][2] * R[2];   // m1_{i,k} R_k
+        Q[i] = m.m1[0][i] * R[0] + m.m1[1][i] * R[1] + m.m1[2][i] * R[2];   // R_a m1_{a,i}
+        tr_m1 += m.m1[i][i];
+        s1 += R[i] * P[i];
+        A[i] = 0.0;
+        B[i] = 0.0;
+        tr[i] = m.m2[i][0][0] + m.m2[i][1][1] + m.m2[i][2][2];              // m2_{i,kk}
+        e[i] = m.m2[0][i][0] + m.m2[1][i][1] + m.m2[2][i][2];               // m2_{a,ia}
+        for (int k = 0; k < 3; ++k) {
+            for (int l = 0; l < 3; ++l) {
+                A[i] += m.m2[i][k][l] * R[k] * R[l];
+                B[i] += m.m2[k][i][l] * R[k] * R[l];
+            }
+        }
+        S += R[i] * A[i];
+        c2 += R[i] * tr[i];
+        c1 += R[i] * e[i];
+    }
+
+    Vec3 out;
+    for (int i = 0; i < 3; ++i) {
+        const double mono = 3.0 * R[i] * m0R * g5 - m.m0[i] * g3;
+        const double dip = -15.0 * R[i] * s1 * g7 + 3.0 * (P[i] + Q[i] + R[i] * tr_m1) * g5;
+        const double quad = 105.0 * R[i] * S * g9
+                            - 15.0 * (A[i] + 2.0 * B[i] + R[i] * (2.0 * c1 + c2)) * g7
+                            + 3.0 * (tr[i] + 2.0 * e[i]) * g5;
+        out[i] = mono - dip + 0.5 * quad;
+    }
+    return out;
+}
+
+double dipole_multipole_error_bound(double strength, double radius, double d) {
+    // Third-order Taylor remainder of ∂∂G with |∂^5 (1/r)| <= 5! / r^6 along any directions.
+    const double gap = d - radius;
+    const double q = radius / gap;
+    return 20.0 * strength * q * q * q / (gap * gap * gap);
+}
+
+}  // namespace geometry
+}  // namespace sst
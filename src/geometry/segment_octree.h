@@ -0,0 +1,111 @@
+#ifndef SSTCORE_SEGMENT_OCTREE_H
+#define SSTCORE_SEGMENT_OCTREE_H
+
+#pragma once
+
+#include "sst/types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace sst {
+namespace geometry {
+
+/**
+ * Cartesian moments of a cluster of midpoint-rule line elements (y_j, dl_j) about a centre c,
+ * with δ_j = y_j - c:  m0 = Σ dl,  m1[a][i] = Σ dl_a δ_i,  m2[a][i][k] = Σ dl_a δ_i δ_k.
+ * For straight segments (dl_j spread uniformly over y_j ± e_j / 2) m2 gains Σ dl_a e_i e_k / 12.
+ */
+struct SegmentMoments {
+    Vec3 m0{{0, 0, 0}};
+    double m1[3][3] = {};
+    double m2[3][3][3] = {};
+    double strength = 0.0;  // Σ |dl|
+};
+
+struct SegmentOctreeNode {
+    static constexpr std::size_t kNoChild = std::numeric_limits<std::size_t>::max();
+
+    Vec3 center{{0, 0, 0}};
+    double radius = 0.0;  // max |y_j - center| over the node's midpoints (+ |e_j| / 2 for segments)
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    std::size_t child[8] = {kNoChild, kNoChild, kNoChild, kNoChild,
+                            kNoChild, kNoChild, kNoChild, kNoChild};
+    bool leaf = true;
+    SegmentMoments moments;
+    /** Sorted distinct tags of the node's segments (empty when the tree was built without tags). */
+    std::vector<std::uint32_t> tags;
+    /** Moments of the node's segments carrying tags[k], about the same centre (aligned with tags). */
+    std::vector<SegmentMoments> tag_moments;
+
+    /** Index of tag in tags, or tags.size() when absent. */
+    std::size_t find_tag(std::uint32_t tag) const;
+};
+
+/**
+ * Octree over segment midpoints with quadrupole moments per node (Barnes–Hut treecodes).
+ * Node 0 is the root; order() maps node ranges [begin, end) to input segment indices.
+ * With extents, element j is the straight segment y_j ± extents[j] / 2 carrying dls[j] (the
+ * exact segment kernel): moments and radii cover the whole segment, so the far field and its
+ * error bound refer to that kernel instead of the midpoint rule.
+ */
+class SegmentOctree {
+public:
+    SegmentOctree() = default;
+    SegmentOctree(const std::vector<Vec3>& mids,
+                  const std::vector<Vec3>& dls,
+                  std::size_t leaf_size,
+                  const std::vector<std::uint32_t>* tags = nullptr,
+                  const std::vector<Vec3>* extents = nullptr);
+
+    const std::vector<SegmentOctreeNode>& nodes() const { return nodes_; }
+    const std::vector<std::size_t>& order() const { return order_; }
+    /** Position of segment j inside order(); node n contains j iff begin <= position(j) < end. */
+    std::size_t position(std::size_t j) const { return position_[j]; }
+    bool contains(const SegmentOctreeNode& node, std::size_t j) const {
+        const std::size_t p = position_[j];
+        return p >= node.begin && p < node.end;
+    }
+    bool empty() const { return nodes_.empty(); }
+
+private:
+    const std::vector<Vec3>* mids_ = nullptr;
+    const std::vector<Vec3>* dls_ = nullptr;
+    const std::vector<std::uint32_t>* tags_ = nullptr;
+    const std::vector<Vec3>* extents_ = nullptr;
+    std::size_t leaf_size_ = 16;
+    std::vector<std::size_t> order_;
+    std::vector<std::size_t> position_;
+    std::vector<SegmentOctreeNode> nodes_;
+
+    std::size_t build(std::size_t begin, std::size_t end, int depth);
+    void compute_moments(SegmentOctreeNode& node) const;
+};
+
+/**
+ * Far-field velocity Σ dl_j × R_j / (|R_j|² + reg2)^{3/2} of a cluster at R = x - center,
+ * truncated after the quadrupole term (no 1/4π or circulation factor).
+ * reg2 = 0 is the singular Biot–Savart kernel; reg2 = a² the Rosenhead–Moore kernel.
+ */
+Vec3 segment_multipole_velocity(const SegmentMoments& moments, const Vec3& R, double reg2 = 0.0);
+
+/** Truncation bound of segment_multipole_velocity for a node at distance d > radius. */
+double segment_multipole_error_bound(double strength, double radius, double d);
+
+/**
+ * Far field Σ ∇∇(1/|R_j|) · m_j of a cluster of point dipoles (moments built with dl = m), i.e.
+ * Σ [3 (m_j·R_j) R_j - |R_j|² m_j] / |R_j|^5 at R = x - center, truncated after the quadrupole
+ * term (no 1/4π factor).
+ */
+Vec3 dipole_multipole_field(const SegmentMoments& moments, const Vec3& R);
+
+/** Per-component truncation bound of dipole_multipole_field for a node at distance d > radius. */
+double dipole_multipole_error_bound(double strength, double radius, double d);
+
+}  // namespace geometry
+}  // namespace sst
+
+#endif
@@ -0,0 +1,303 @@
+#include "geometry/swept_contact.h"
+
+#include "geometry/polygonal_clearance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace sst {
+namespace geometry {
+namespace {
+
+// Conservative advancement stops once its next step (in path fraction) would be shorter than
+// kFractionTol, or after kMaxAdvance steps; steps are shortened by kStepShrink relative. Past
+// kMaxAdvance the rest of the path is split and bisected, with at most kMaxRefine splits.
+constexpr double kFractionTol = 1e-9;
+constexpr int kMaxAdvance = 256;
+constexpr double kStepShrink = 1e-9;
+constexpr int kMaxRefine = 1 << 16;
+// A coplanarity root counts as a crossing when the segments are this close relative to their
+// lengths; cubics whose coefficients are all this small relative to their scale are taken as
+// coplanar throughout.
+constexpr double kCrossingTol = 1e-9;
+constexpr double kCoplanarTol = 1e-13;
+
+Vec3 lerp(const Vec3& x0, const Vec3& x1, double f) {
+    return {x0[0] + f * (x1[0] - x0[0]), x0[1] + f * (x1[1] - x0[1]), x0[2] + f * (x1[2] - x0[2])};
+}
+
+double distance_at(const SweptSegment& p, const SweptSegment& q, double f) {
+    return segment_segment_distance(lerp(p.a0, p.a1, f), lerp(p.b0, p.b1, f), lerp(q.a0, q.a1, f), lerp(q.b0, q.b1, f));
+}
+
+double cubic(const double c[4], double f) {
+    return ((c[3] * f + c[2]) * f + c[1]) * f + c[0];
+}
+
+/** Roots of c[0] + c[1] f + c[2] f^2 + c[3] f^3 in [0, f_max], ascending (bisection on monotone pieces). */
+std::size_t cubic_roots(const double c[4], double f_max, double roots[3]) {
+    // Monotone pieces split at the roots of the derivative 3 c3 f^2 + 2 c2 f + c1.
+    double cuts[4] = {0.0, 0.0, 0.0, 0.0};
+    std::size_t nc = 0;
+    cuts[nc++] = 0.0;
+    const double A = 3.0 * c[3], B = 2.0 * c[2], C = c[1];
+    double crit[2];
+    std::size_t ncrit = 0;
+    if (A == 0.0) {
+        if (B != 0.0) crit[ncrit++] = -C / B;
+    } else {
+        const double disc = B * B - 4.0 * A * C;
+        if (disc >= 0.0) {
+            const double q = -0.5 * (B + std::copysign(std::sqrt(disc), B));
+            crit[ncrit++] = q / A;
+            if (q != 0.0) crit[ncrit++] = C / q;
+        }
+    }
+    std::sort(crit, crit + ncrit);
+    for (std::size_t k = 0; k < ncrit; ++k) {
+        if (crit[k] > cuts[nc - 1] && crit[k] < f_max) cuts[nc++] = crit[k];
+    }
+    cuts[nc++] = f_max;
+
+    std::size_t count = 0;
+    const auto push = [&](double f) {
+        if (count == 0 || f > roots[count - 1]) roots[count++] = f;
+    };
+    for (std::size_t k = 0; k + 1 < nc && count < 3; ++k) {
+        double lo = cuts[k], hi = cuts[k + 1];
+        double plo = cubic(c, lo);
+        const double phi = cubic(c, hi);
+        if (plo == 0.0) {
+            push(lo);
+            continue;
+        }
+        if (phi == 0.0) {
+            push(hi);
+            continue;
+        }
+        if ((plo < 0.0) == (phi < 0.0)) continue;
+        for (int it = 0; it < 200; ++it) {
+            const double mid = 0.5 * (lo + hi);
+            if (!(mid > lo && mid < hi)) break;
+            const double pm = cubic(c, mid);
+            if ((pm < 0.0) == (plo < 0.0)) {
+                lo = mid;
+                plo = pm;
+            } else {
+                hi = mid;
+            }
+        }
+        push(hi);  // the side where the sign has changed: the segments have met
+    }
+    return count;
+}
+
+std::size_t crossing_times(const SweptSegment& p, const SweptSegment& q, double f_max, double times[3], bool& coplanar) {
+    // det[u, v, w] with u = b - a, v = c - a, w = d - a, each linear in f: e(f) = e0 + f e1.
+    const Vec3 u0 = diff(p.b0, p.a0), v0 = diff(q.a0, p.a0), w0 = diff(q.b0, p.a0);
+    const Vec3 u1 = diff(diff(p.b1, p.a1), u0), v1 = diff(diff(q.a1, p.a1), v0), w1 = diff(diff(q.b1, p.a1), w0);
+    const Vec3 v0w0 = cross(v0, w0), v1w0 = cross(v1, w0), v0w1 = cross(v0, w1), v1w1 = cross(v1, w1);
+    const double c[4] = {
+        dot(u0, v0w0),
+        dot(u1, v0w0) + dot(u0, v1w0) + dot(u0, v0w1),
+        dot(u0, v1w1) + dot(u1, v1w0) + dot(u1, v0w1),
+        dot(u1, v1w1),
+    };
+    const double scale = (norm(u0) + norm(u1)) * (norm(v0) + norm(v1)) * (norm(w0) + norm(w1));
+    coplanar = std::max({std::abs(c[0]), std::abs(c[1]), std::abs(c[2]), std::abs(c[3])}) <= kCoplanarTol * scale;
+    if (coplanar) return 0;
+
+    double roots[3];
+    const std::size_t nr = cubic_roots(c, f_max, roots);
+    std::size_t count = 0;
+    for (std::size_t k = 0; k < nr; ++k) {
+        const double f = roots[k];
+        const double lp = norm(diff(lerp(p.b0, p.b1, f), lerp(p.a0, p.a1, f)));
+        const double lq = norm(diff(lerp(q.b0, q.b1, f), lerp(q.a0, q.a1, f)));
+        if (distance_at(p, q, f) <= kCrossingTol * (lp + lq)) times[count++] = f;
+    }
+    return count;
+}
+
+}  // namespace
+
+std::size_t segment_crossing_times(const SweptSegment& p, const SweptSegment& q, double f_max, double times[3]) {
+    bool coplanar = false;
+    return crossing_times(p, q, f_max, times, coplanar);
+}
+
+double segment_time_of_impact(const SweptSegment& p, const SweptSegment& q, double threshold, double f_max) {
+    const double none = f_max + 1.0;
+    double times[3];
+    bool coplanar = false;
+    const std::size_t nr = crossing_times(p, q, f_max, times, coplanar);
+    if (threshold <= 0.0 && !coplanar) return nr > 0 ? times[0] : none;
+
+    // Segments moving in their common plane have no isolated crossing roots: advance against
+    // a contact distance at the crossing tolerance instead.
+    double contact = threshold;
+    if (contact <= 0.0) {
+        contact = kCrossingTol * (norm(diff(p.b0, p.a0)) + norm(diff(q.b0, q.a0)));
+        if (!(contact > 0.0)) return none;
+    }
+    const double end = nr > 0 ? times[0] : f_max;
+    // The closest-point separation moves at most as fast as the fastest relative endpoint
+    // velocity (its velocity is bilinear in the segment parameters).
+    const Vec3 va = diff(p.a1, p.a0), vb = diff(p.b1, p.b0), vc = diff(q.a1, q.a0), vd = diff(q.b1, q.b0);
+    const double L = std::max({norm(diff(va, vc)), norm(diff(va, vd)), norm(diff(vb, vc)), norm(diff(vb, vd))});
+
+    double f = 0.0;
+    double d = distance_at(p, q, f);
+    if (!std::isfinite(d)) return none;
+    if (d < contact) return f;
+    for (int it = 0; it < kMaxAdvance; ++it) {
+        if (!(L > 0.0)) return nr > 0 ? f : none;
+        // Slightly short of the bound, so an exact approach lands just on the safe side.
+        const double step = (d - contact) / L * (1.0 - kStepShrink);
+        if (step < kFractionTol) return f;
+        // No contact before f + step; past the first crossing it has certainly happened.
+        if (f + step >= end) return nr > 0 ? f : none;
+        const double next = distance_at(p, q, f + step);
+        if (!std::isfinite(next)) return none;
+        if (next < contact) return f;  // rounding only: the step is conservative
+        f += step;
+        d = next;
+    }
+
+    // Slow approach under a fast relative motion (L far above the approach speed): split
+    // [f, end] earliest piece first. A piece [f, b] is clear when the bound from both its ends,
+    // (d(f) + d(b) - L (b - f)) / 2, stays >= contact (pieces narrower than kFractionTol count
+    // as clear); once some b is in contact, [f, b] brackets it and is bisected down to
+    // kFractionTol. Pieces still unresolved after kMaxRefine splits stop the path at f.
+    std::vector<std::pair<double, double>> pending;  // right ends and distances, earliest on top
+    pending.emplace_back(end, distance_at(p, q, end));
+    for (int it = 0; !pending.empty(); ++it) {
+        double b = pending.back().first;
+        const double db = pending.back().second;
+        if (!std::isfinite(db)) return none;
+        if (db < contact) {
+            while (b - f >= kFractionTol) {
+                const double mid = 0.5 * (f + b);
+                const double dm = distance_at(p, q, mid);
+                if (!std::isfinite(dm)) return none;
+                if (dm < contact) {
+                    b = mid;
+                } else {
+                    f = mid;
+                }
+            }
+            return f;
+        }
+        if (b - f < kFractionTol || 0.5 * (d + db - L * (b - f)) >= contact) {
+            f = b;
+            d = db;
+            pending.pop_back();
+            continue;
+        }
+        if (it >= kMaxRefine) return f;
+        const double mid = 0.5 * (f + b);
+        pending.emplace_back(mid, distance_at(p, q, mid));
+    }
+    return nr > 0 ? f : none;
+}
+
+SweptContactResult first_swept_contact(
+    const std::vector<std::vector<Vec3>>& before,
+    const std::vector<std::vector<Vec3>>& after,
+    double threshold,
+    double core_radius,
+    int default_skip_neighbors) {
+    SweptContactResult out;
+    const std::size_t nc = std::min(before.size(), after.size());
+    std::vector<std::size_t> offsets(nc + 1, 0);
+    std::vector<std::size_t> sizes(nc);
+    std::vector<int> skip(nc);
+    for (std::size_t c = 0; c < nc; ++c) {
+        const std::size_t n = std::min(before[c].size(), after[c].size());
+        sizes[c] = n < 2 ? 0 : n;
+        offsets[c + 1] = offsets[c] + sizes[c];
+        const std::vector<Vec3> b0(before[c].begin(), before[c].begin() + static_cast<std::ptrdiff_t>(n));
+        const std::vector<Vec3> b1(after[c].begin(), after[c].begin() + static_cast<std::ptrdiff_t>(n));
+        skip[c] = std::max(2, std::min(self_skip_neighbors(b0, core_radius, default_skip_neighbors),
+                                       self_skip_neighbors(b1, core_radius, default_skip_neighbors)));
+    }
+
+    // Swept boxes: each covers the segment at both ends of the path (and so all the way along
+    // it), grown by threshold / 2 so that boxes of pairs that come within threshold overlap.
+    const std::size_t ns = offsets[nc];
+    std::vector<SweptSegment> segs(ns);
+    std::vector<std::size_t> comp(ns);
+    std::vector<Vec3> lo(ns), hi(ns);
+    const double grow = 0.5 * std::max(threshold, 0.0);
+    for (std::size_t c = 0; c < nc; ++c) {
+        const std::size_t n = sizes[c];
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::size_t s = offsets[c] + k;
+            segs[s] = {before[c][k], before[c][(k + 1) % n], after[c][k], after[c][(k + 1) % n]};
+            comp[s] = c;
+            for (int a = 0; a < 3; ++a) {
+                lo[s][a] = std::min({segs[s].a0[a], segs[s].b0[a], segs[s].a1[a], segs[s].b1[a]}) - grow;
+                hi[s][a] = std::max({segs[s].a0[a], segs[s].b0[a], segs[s].a1[a], segs[s].b1[a]}) + grow;
+            }
+        }
+    }
+
+    // Sweep and prune along the axis where the box centres spread most.
+    int axis = 0;
+    if (ns > 0) {
+        Vec3 cmin = lo[0], cmax = lo[0];
+        for (std::size_t s = 0; s < ns; ++s) {
+            for (int a = 0; a < 3; ++a) {
+                const double m = 0.5 * (lo[s][a] + hi[s][a]);
+                cmin[a] = s == 0 ? m : std::min(cmin[a], m);
+                cmax[a] = s == 0 ? m : std::max(cmax[a], m);
+            }
+        }
+        for (int a = 1; a < 3; ++a) {
+            if (cmax[a] - cmin[a] > cmax[axis] - cmin[axis]) axis = a;
+        }
+    }
+    std::vector<std::size_t> order(ns);
+    for (std::size_t s = 0; s < ns; ++s) order[s] = s;
+    std::sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) {
+        return lo[x][axis] != lo[y][axis] ? lo[x][axis] < lo[y][axis] : x < y;
+    });
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    for (std::size_t k = 0; k < ns; ++k) {
+        const std::size_t x = order[k];
+        for (std::size_t m = k + 1; m < ns && lo[order[m]][axis] <= hi[x][axis]; ++m) {
+            const std::size_t y = order[m];
+            bool overlap = true;
+            for (int a = 0; a < 3 && overlap; ++a) overlap = lo[x][a] <= hi[y][a] && lo[y][a] <= hi[x][a];
+            if (!overlap) continue;
+            const std::size_t i = std::min(x, y), j = std::max(x, y);
+            if (comp[i] == comp[j]) {
+                const std::size_t n = sizes[comp[i]];
+                const std::size_t gap = j - i;
+                if (n < 4 || static_cast<int>(std::min(gap, n - gap)) < skip[comp[i]]) continue;
+            }
+            pairs.emplace_back(i, j);
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    out.candidates = pairs.size();
+
+    // Narrow phase, each pair bounded by the earliest contact found so far.
+    for (const auto& pr : pairs) {
+        const double f_max = out.fraction;
+        const double f = segment_time_of_impact(segs[pr.first], segs[pr.second], threshold, f_max);
+        if (!(f <= f_max) || (out.hit && !(f < out.fraction))) continue;
+        out.hit = true;
+        out.fraction = f;
+        out.component_a = comp[pr.first];
+        out.segment_a = pr.first - offsets[out.component_a];
+        out.component_b = comp[pr.second];
+        out.segment_b = pr.second - offsets[out.component_b];
+    }
+    return out;
+}
+
+}  // namespace geometry
+}  // namespace sst
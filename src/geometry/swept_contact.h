@@ -0,0 +1,67 @@
+#ifndef SSTCORE_GEOMETRY_SWEPT_CONTACT_H
+#define SSTCORE_GEOMETRY_SWEPT_CONTACT_H
+
+#pragma once
+
+#include "sst/types.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace sst {
+namespace geometry {
+
+/** Moving segment a -> b whose endpoints travel linearly from (a0, b0) at f = 0 to (a1, b1) at f = 1. */
+struct SweptSegment {
+    Vec3 a0, b0;
+    Vec3 a1, b1;
+};
+
+struct SweptContactResult {
+    bool hit = false;
+    double fraction = 1.0;         // first contact, on the safe side (1 without contact)
+    std::size_t component_a = 0;   // the pair that touches first (lower flat index as a)
+    std::size_t segment_a = 0;
+    std::size_t component_b = 0;
+    std::size_t segment_b = 0;
+    std::size_t candidates = 0;    // swept-box pairs handed to the narrow phase
+};
+
+/**
+ * Times f in [0, f_max] at which the two moving segments are coplanar and intersect (the exact
+ * roots of the cubic det[b - a, c - a, d - a](f)), ascending; at most three. Segments that stay
+ * coplanar throughout have no isolated roots and report none.
+ */
+std::size_t segment_crossing_times(const SweptSegment& p, const SweptSegment& q, double f_max, double times[3]);
+
+/**
+ * Earliest f in [0, f_max] at which the moving segments come closer than threshold, on the
+ * safe side (distance >= threshold up to 1e-9 in f); f_max + 1 when they do not. The search
+ * advances conservatively by (distance - threshold) / L, where L bounds the relative endpoint
+ * speed, and stops at the first crossing time, where contact has certainly happened. When
+ * that takes too many steps (a slow approach under a fast sliding motion), the rest of the
+ * path is split into pieces cleared by the same bound until one ends in contact, which is then
+ * bisected to its safe side. Only if the pieces cannot be resolved within a fixed budget does
+ * the search stop early, at the last cleared fraction. With threshold <= 0 the result is the
+ * first crossing time itself.
+ */
+double segment_time_of_impact(const SweptSegment& p, const SweptSegment& q, double threshold, double f_max);
+
+/**
+ * First contact along the linear path before -> after (common prefix of each component's
+ * points): swept-box broad phase (sweep and prune, boxes grown by threshold / 2), then
+ * segment_time_of_impact for every candidate pair, each bounded by the earliest hit so far.
+ * Self pairs inside the skip window are excluded as in multi_component_clearance, with the
+ * smaller of the two end states' windows. Ties go to the lowest (a, b) flat index pair.
+ */
+SweptContactResult first_swept_contact(
+    const std::vector<std::vector<Vec3>>& before,
+    const std::vector<std::vector<Vec3>>& after,
+    double threshold,
+    double core_radius = 0.0,
+    int default_skip_neighbors = 2);
+
+}  // namespace geometry
+}  // namespace sst
+
+#endif
@@ -499,7 +499,8 @@ namespace sst {
                 int grid_size,
                 double spacing,
                 int interior_margin,
-                int nsamples) {
+                int nsamples,
+                bool particle_mesh) {
                 // Evaluate Fourier block to get knot points
                 std::vector<double> s(nsamples);
                 const double twoPi = 2.0 * M_PI;
@@ -509,31 +510,21 @@ namespace sst {
                 std::vector<Vec3> curve = FourierKnot::evaluate(block, s);
                 curve = FourierKnot::center_points(curve);
 
-                // Create grid (matching Python: spacing * (np.arange(grid_size) - grid_size // 2))
-                std::vector<Vec3> grid_points;
-                grid_points.reserve(grid_size * grid_size * grid_size);
+                // Grid matching Python: spacing * (np.arange(grid_size) - grid_size // 2)
                 const int half_grid = grid_size / 2;  // Integer division to match Python //
-                for (int i = 0; i < grid_size; ++i) {
-                        for (int j = 0; j < grid_size; ++j) {
-                                for (int k = 0; k < grid_size; ++k) {
-                                        double x = spacing * (i - half_grid);
-                                        double y = spacing * (j - half_grid);
-                                        double z = spacing * (k - half_grid);
-                                        grid_points.push_back({x, y, z});
-                                }
-                        }
-                }
-
-                // Compute velocity on grid
-                std::vector<Vec3> velocity = BiotSavart::computeVelocity(curve, grid_points);
-
-                // Compute vorticity
-                std::array<int, 3> shape = {grid_size, grid_size, grid_size};
-                std::vector<Vec3> vorticity = BiotSavart::computeVorticity(velocity, shape, spacing);
-
-                // Extract interior fields
-                std::vector<Vec3> v_sub = BiotSavart::extractInterior(velocity, shape, interior_margin);
-                std::vector<Vec3> w_sub = BiotSavart::extractInterior(vorticity, shape, interior_margin);
+                RegularGrid3D grid;
+                grid.origin = {-spacing * half_grid, -spacing * half_grid, -spacing * half_grid};
+                grid.spacing = spacing;
+                grid.shape = {grid_size, grid_size, grid_size};
+
+                // Velocity and central-difference vorticity at the interior only (the stencil's
+                // one-node shell is all that is evaluated outside it)
+                InteriorFieldOptions field_options;
+                field_options.particle_mesh = particle_mesh;
+                InteriorFieldResult field = BiotSavart::computeInteriorVelocityVorticity(
+                        curve, grid, interior_margin, 1.0, field_options);
+                const std::vector<Vec3>& v_sub = field.velocity;
+                const std::vector<Vec3>& w_sub = field.vorticity;
 
                 // Compute r_sq for interior points (matching Python interior_vals)
                 std::vector<double> r_sq;
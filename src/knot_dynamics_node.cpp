@@ -732,7 +732,8 @@ void bind_knot(Napi::Env env, Napi::Object exports) {
         double spacing = (info.Length() > 2 && info[2].IsNumber()) ? info[2].As<Napi::Number>().DoubleValue() : 0.1;
         int margin = (info.Length() > 3 && info[3].IsNumber()) ? info[3].As<Napi::Number>().Int32Value() : 8;
         int nsamples = (info.Length() > 4 && info[4].IsNumber()) ? info[4].As<Napi::Number>().Int32Value() : 1000;
-        auto t = KnotDynamics::compute_helicity_from_fourier_block(b, grid_size, spacing, margin, nsamples);
+        bool particle_mesh = (info.Length() > 5 && info[5].IsBoolean()) ? info[5].As<Napi::Boolean>().Value() : false;
+        auto t = KnotDynamics::compute_helicity_from_fourier_block(b, grid_size, spacing, margin, nsamples, particle_mesh);
         Napi::Object o = Napi::Object::New(e);
         o.Set("hCharge", Napi::Number::New(e, std::get<0>(t)));
         o.Set("hMass", Napi::Number::New(e, std::get<1>(t)));
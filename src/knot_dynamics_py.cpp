@@ -593,14 +593,15 @@ Compute a PD code from a closed 3D polygonal curve.
 
   m.def("compute_helicity_from_fourier_block",
         [](const FourierBlock& block,
-           int grid_size, double spacing, int interior_margin, int nsamples) {
+           int grid_size, double spacing, int interior_margin, int nsamples, bool particle_mesh) {
           auto [H_charge, H_mass, a_mu] = KnotDynamics::compute_helicity_from_fourier_block(
-              block, grid_size, spacing, interior_margin, nsamples);
+              block, grid_size, spacing, interior_margin, nsamples, particle_mesh);
           return py::make_tuple(H_charge, H_mass, a_mu);
         },
         py::arg("block"), py::arg("grid_size") = 32, py::arg("spacing") = 0.1,
-        py::arg("interior_margin") = 8, py::arg("nsamples") = 1000,
-        R"pbdoc(Compute helicity invariants from a Fourier block.)pbdoc");
+        py::arg("interior_margin") = 8, py::arg("nsamples") = 1000, py::arg("particle_mesh") = false,
+        R"pbdoc(Compute helicity invariants from a Fourier block.
+particle_mesh=True evaluates the grid velocity with the P3M solver instead of the direct sum.)pbdoc");
 
   m.def("compute_curvature",
         [](py::array_t<double, py::array::c_style | py::array::forcecast> pts, double eps) {
@@ -777,6 +778,23 @@ Compute a PD code from a closed 3D polygonal curve.
       .def("evolve", &VortexKnotSystem::evolve,
            py::arg("dt"), py::arg("steps"),
            R"pbdoc(Evolve vortex knot using Biot–Savart dynamics.)pbdoc")
+      .def("set_evolution_options",
+           [](VortexKnotSystem& self, const std::string& model, const std::string& scheme,
+              double cutoff_arclength, double core_radius, double lia_constant) {
+             sst::FilamentEvolutionOptions o;
+             o.model = sst::filament_velocity_model_from_name(model);
+             o.scheme = sst::filament_time_scheme_from_name(scheme);
+             o.cutoff_arclength = cutoff_arclength;
+             o.core_radius = core_radius;
+             o.lia_constant = lia_constant;
+             self.set_evolution_options(o);
+           },
+           py::arg("model") = "biot_savart", py::arg("scheme") = "euler",
+           py::arg("cutoff_arclength") = 1.0, py::arg("core_radius") = 0.01,
+           py::arg("lia_constant") = 0.25,
+           R"pbdoc(Select the evolve() velocity model ('biot_savart' | 'lia' | 'cutoff') and time
+scheme ('euler' | 'rk2' | 'rk4'). 'lia' is O(N); 'cutoff' sums segments within cutoff_arclength
+plus the local induction term with core_radius.)pbdoc")
       .def("get_positions", &VortexKnotSystem::get_positions,
            py::return_value_policy::reference,
            R"pbdoc(Get current 3D positions of the knot.)pbdoc")
@@ -0,0 +1,64 @@
+#ifndef SSTCORE_PARALLEL_FOR_H
+#define SSTCORE_PARALLEL_FOR_H
+
+// parallel_for.h — minimal std::thread task loop shared by the grid / filament kernels.
+// Tasks are independent and write disjoint outputs, so results never depend on the number of
+// workers or on which worker ran a task (callers keep per-task accumulation order fixed).
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sst {
+
+// num_threads = 0 selects std::thread::hardware_concurrency() (at least 1).
+inline std::size_t resolve_thread_count(std::size_t num_threads) {
+    if (num_threads > 0) return num_threads;
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? static_cast<std::size_t>(hw) : 1;
+}
+
+// Runs body(task) for task in [0, n_tasks) on up to num_threads workers (dynamic scheduling).
+// The first exception thrown by a task is rethrown on the calling thread.
+template <typename Body>
+void parallel_for(std::size_t n_tasks, std::size_t num_threads, Body&& body) {
+    const std::size_t workers = std::min(resolve_thread_count(num_threads), n_tasks);
+    if (workers <= 1) {
+        for (std::size_t t = 0; t < n_tasks; ++t) body(t);
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto run = [&]() {
+        for (;;) {
+            const std::size_t t = next.fetch_add(1, std::memory_order_relaxed);
+            if (t >= n_tasks) return;
+            try {
+                body(t);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::current_exception();
+                next.store(n_tasks, std::memory_order_relaxed);
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (std::size_t w = 1; w < workers; ++w) pool.emplace_back(run);
+    run();
+    for (auto& th : pool) th.join();
+    if (error) std::rethrow_exception(error);
+}
+
+}  // namespace sst
+
+#endif  // SSTCORE_PARALLEL_FOR_H
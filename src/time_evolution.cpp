@@ -14,6 +14,10 @@ void TimeEvolution::evolve(double dt, int steps) {
     core_.evolve(dt, static_cast<std::size_t>(steps));
 }
 
+void TimeEvolution::set_evolution_options(const FilamentEvolutionOptions& options) {
+    core_.set_options(options);
+}
+
 const std::vector<Vec3>& TimeEvolution::get_positions() const {
     return core_.positions();
 }
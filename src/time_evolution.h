@@ -16,6 +16,7 @@ public:
                   double gamma = 1.0);
 
     void evolve(double dt, int steps);
+    void set_evolution_options(const FilamentEvolutionOptions& options);
     const std::vector<Vec3>& get_positions() const;
     const std::vector<Vec3>& get_tangents() const;
 
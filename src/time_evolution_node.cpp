@@ -1,5 +1,6 @@
 // node_time_evolution.cpp
 #include <napi.h>
+#include <stdexcept>
 #include "node_utils.h"
 #include "time_evolution.h"
 
@@ -11,6 +12,7 @@ public:
         Napi::Function func = DefineClass(
             env, "TimeEvolution",
             {InstanceMethod("evolve", &TimeEvolutionWrap::Evolve),
+             InstanceMethod("setEvolutionOptions", &TimeEvolutionWrap::SetEvolutionOptions),
              InstanceMethod("getPositions", &TimeEvolutionWrap::GetPositions),
              InstanceMethod("getTangents", &TimeEvolutionWrap::GetTangents)});
         exports.Set("TimeEvolution", func);
@@ -39,6 +41,33 @@ private:
         return info.Env().Undefined();
     }
 
+    // { model?: 'biot_savart' | 'lia' | 'cutoff', scheme?: 'euler' | 'rk2' | 'rk4',
+    //   cutoffArclength?, coreRadius?, liaConstant? } (snake_case accepted).
+    Napi::Value SetEvolutionOptions(const Napi::CallbackInfo& info) {
+        Napi::Env e = info.Env();
+        sst::FilamentEvolutionOptions o;
+        if (info.Length() > 0 && info[0].IsObject()) {
+            Napi::Object d = info[0].As<Napi::Object>();
+            const auto number = [&](const char* camel, const char* snake, double& out) {
+                if (d.Has(camel)) out = d.Get(camel).As<Napi::Number>().DoubleValue();
+                if (d.Has(snake)) out = d.Get(snake).As<Napi::Number>().DoubleValue();
+            };
+            try {
+                if (d.Has("model"))
+                    o.model = sst::filament_velocity_model_from_name(d.Get("model").As<Napi::String>().Utf8Value());
+                if (d.Has("scheme"))
+                    o.scheme = sst::filament_time_scheme_from_name(d.Get("scheme").As<Napi::String>().Utf8Value());
+                number("cutoffArclength", "cutoff_arclength", o.cutoff_arclength);
+                number("coreRadius", "core_radius", o.core_radius);
+                number("liaConstant", "lia_constant", o.lia_constant);
+                te_->set_evolution_options(o);
+            } catch (const std::invalid_argument& ex) {
+                throw Napi::TypeError::New(e, ex.what());
+            }
+        }
+        return e.Undefined();
+    }
+
     Napi::Value GetPositions(const Napi::CallbackInfo& info) {
         return vec3_list_to_js_typedarray(info.Env(), te_->get_positions());
     }
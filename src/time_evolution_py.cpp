@@ -11,6 +11,20 @@ void bind_time_evolution(py::module_& m) {
 				 py::arg("initial_positions"), py::arg("initial_tangents"), py::arg("gamma") = 1.0)
 			.def("evolve", &sst::TimeEvolution::evolve,
 				 py::arg("dt"), py::arg("steps"))
+			.def("set_evolution_options",
+				 [](sst::TimeEvolution& self, const std::string& model, const std::string& scheme,
+					double cutoff_arclength, double core_radius, double lia_constant) {
+					 sst::FilamentEvolutionOptions o;
+					 o.model = sst::filament_velocity_model_from_name(model);
+					 o.scheme = sst::filament_time_scheme_from_name(scheme);
+					 o.cutoff_arclength = cutoff_arclength;
+					 o.core_radius = core_radius;
+					 o.lia_constant = lia_constant;
+					 self.set_evolution_options(o);
+				 },
+				 py::arg("model") = "biot_savart", py::arg("scheme") = "euler",
+				 py::arg("cutoff_arclength") = 1.0, py::arg("core_radius") = 0.01,
+				 py::arg("lia_constant") = 0.25)
 			.def("get_positions", &sst::TimeEvolution::get_positions,
 				 py::return_value_policy::reference)
 			.def("get_tangents", &sst::TimeEvolution::get_tangents,
@@ -1,10 +1,10 @@
 #include "topology/topology_guard.h"
 
 #include "geometry/polygonal_clearance.h"
+#include "geometry/swept_contact.h"
 
 #include <algorithm>
 #include <cmath>
-#include <limits>
 #include <string>
 #include <vector>
 
@@ -12,8 +12,6 @@ namespace sst {
 namespace topology {
 namespace {
 
-constexpr int kSweepSamples = 8;
-
 std::vector<std::vector<Vec3>> curve_set_points(const CurveSet& cs) {
     std::vector<std::vector<Vec3>> out;
     out.reserve(cs.components.size());
@@ -21,25 +19,6 @@ std::vector<std::vector<Vec3>> curve_set_points(const CurveSet& cs) {
     return out;
 }
 
-std::vector<std::vector<Vec3>> lerp_states(
-    const std::vector<std::vector<Vec3>>& a,
-    const std::vector<std::vector<Vec3>>& b,
-    double f) {
-    std::vector<std::vector<Vec3>> out = a;
-    const std::size_t nc = std::min(a.size(), b.size());
-    out.resize(nc);
-    for (std::size_t c = 0; c < nc; ++c) {
-        const std::size_t n = std::min(a[c].size(), b[c].size());
-        out[c].resize(n);
-        for (std::size_t i = 0; i < n; ++i) {
-            out[c][i][0] = a[c][i][0] + f * (b[c][i][0] - a[c][i][0]);
-            out[c][i][1] = a[c][i][1] + f * (b[c][i][1] - a[c][i][1]);
-            out[c][i][2] = a[c][i][2] + f * (b[c][i][2] - a[c][i][2]);
-        }
-    }
-    return out;
-}
-
 bool hard_contact(const TopologyClearanceResult& cl, double threshold) {
     return std::isfinite(cl.clearance) && cl.clearance < threshold;
 }
@@ -99,22 +78,12 @@ TopologyGuardResult TopologyGuard::guard_step(
         return out;
     }
 
-    double lo = 0.0;
-    double hi = std::numeric_limits<double>::quiet_NaN();
-    bool found = false;
-    for (int k = 1; k <= kSweepSamples; ++k) {
-        const double f = static_cast<double>(k) / static_cast<double>(kSweepSamples);
-        const auto mid = lerp_states(before, after, f);
-        const TopologyClearanceResult cl = compute_clearance(mid, core_radius);
-        if (hard_contact(cl, contact_threshold)) {
-            hi = f;
-            lo = static_cast<double>(k - 1) / static_cast<double>(kSweepSamples);
-            found = true;
-            break;
-        }
-    }
-
-    if (!found) {
+    // Continuous collision test: swept-box candidate pairs, then the first time each comes
+    // within the threshold (exact crossing roots bound the conservative advancement).
+    const geometry::SweptContactResult hit =
+        geometry::first_swept_contact(before, after, contact_threshold, core_radius, 2);
+    out.swept_pairs = hit.candidates;
+    if (!hit.hit) {
         if (hard_contact(cl1, contact_threshold)) {
             out.contact = true;
             out.safe_dt_fraction = 0.0;
@@ -123,17 +92,12 @@ TopologyGuardResult TopologyGuard::guard_step(
         return out;
     }
 
-    // Bisect to first-hit; land on safe side (lo).
-    for (int it = 0; it < 18 && (hi - lo) > 1e-6; ++it) {
-        const double mid_f = 0.5 * (lo + hi);
-        const auto mid = lerp_states(before, after, mid_f);
-        const TopologyClearanceResult cl = compute_clearance(mid, core_radius);
-        if (hard_contact(cl, contact_threshold)) hi = mid_f;
-        else lo = mid_f;
-    }
-
     out.contact = true;
-    out.safe_dt_fraction = lo;
+    out.safe_dt_fraction = hit.fraction;
+    out.hit_component_a = static_cast<int>(hit.component_a);
+    out.hit_segment_a = static_cast<int>(hit.segment_a);
+    out.hit_component_b = static_cast<int>(hit.component_b);
+    out.hit_segment_b = static_cast<int>(hit.segment_b);
     out.message =
         "topology guard: transient contact within step; stopped on safe side";
     return out;
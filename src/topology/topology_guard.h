@@ -28,7 +28,8 @@ public:
         double threshold);
 
     /**
-     * First-hit bisection on a linear path from before → after (8 sweep samples).
+     * First contact on the linear path from before → after by continuous collision detection
+     * (geometry::first_swept_contact): the safe-side fraction and the segment pair that hits.
      * Pure: does not mutate diagnostic globals.
      */
     static TopologyGuardResult guard_step(
@@ -1,10 +1,13 @@
 #include "sst/tube/geometry_core.h"
 #include "sst/tube/detail/common.h"
+#include "geometry/neighbour_list.h"
+#include "geometry/segment_bvh.h"
 
 #include <algorithm>
 #include <cmath>
 #include <limits>
 #include <stdexcept>
+#include <utility>
 
 using namespace sst::tube::detail;
 
@@ -173,47 +176,130 @@ double ResolvedTubeGeometry::segment_segment_distance(
     return dist(cp, cq);
 }
 
+namespace {
+
+// Curves with at least this many points search dcsd candidates through segment-centre cells.
+constexpr std::size_t kGridMinPoints = 64;
+
+}  // namespace
+
 std::vector<SegmentPair> ResolvedTubeGeometry::dcsd_candidates(
     const std::vector<Vec3>& pts,
     int skip_neighbors,
-    double distance_tol) {
+    double distance_tol,
+    geometry::SegmentBvhAccelerator* accelerator) {
     std::vector<SegmentPair> out;
     const std::size_t n = pts.size();
     if (n < 4) return out;
     if (skip_neighbors < 0) skip_neighbors = 0;
 
     const auto cum = cumulative_lengths(pts);
+    const auto make_pair = [&](std::size_t i, std::size_t j) {
+        double s = 0.0, t = 0.0;
+        const double d = segment_segment_distance(pts[i], pts[(i + 1) % n],
+                                                  pts[j], pts[(j + 1) % n],
+                                                  &s, &t);
+        SegmentPair pair;
+        pair.i = i;
+        pair.j = j;
+        pair.s = s;
+        pair.t = t;
+        pair.distance = d;
+        pair.arclength_i = cum[i] + s * dist(pts[i], pts[(i + 1) % n]);
+        pair.arclength_j = cum[j] + t * dist(pts[j], pts[(j + 1) % n]);
+        return pair;
+    };
+    const double tol = std::max(0.0, distance_tol);
+    const auto within = [tol](double d, double best) {
+        return tol <= 0.0 ? d <= best + 1e-12 : d <= best * (1.0 + tol) + tol;
+    };
+
     double best = std::numeric_limits<double>::infinity();
     std::vector<SegmentPair> all;
 
-    for (std::size_t i = 0; i < n; ++i) {
-        for (std::size_t j = i + 1; j < n; ++j) {
-            if (cyclic_edge_distance(i, j, n) <= skip_neighbors) continue;
-            double s = 0.0, t = 0.0;
-            const double d = segment_segment_distance(pts[i], pts[(i + 1) % n],
-                                                      pts[j], pts[(j + 1) % n],
-                                                      &s, &t);
-            SegmentPair pair;
-            pair.i = i;
-            pair.j = j;
-            pair.s = s;
-            pair.t = t;
-            pair.distance = d;
-            pair.arclength_i = cum[i] + s * dist(pts[i], pts[(i + 1) % n]);
-            pair.arclength_j = cum[j] + t * dist(pts[j], pts[(j + 1) % n]);
-            all.push_back(pair);
-            best = std::min(best, d);
+    // Large curves: an upper bound on the minimum, then every pair that could lie within the
+    // tolerance of that bound. The true minimum pair is among them, so best and the filtered
+    // list, kept in (i, j) order, equal the brute-force ones.
+    bool gridded = false;
+    if (accelerator && n >= kGridMinPoints) {
+        // Through the accelerator's tree: the dual-tree minimum over index distance >=
+        // max(2, skip + 1), a subset of the pairs here, is the bound (with slack for its own
+        // distance formula); the candidates are the pairs whose segment boxes are within reach.
+        const geometry::SegmentBvh& tree = accelerator->tree(pts);
+        const std::size_t window = static_cast<std::size_t>(skip_neighbors) + 1;
+        const double bound = std::sqrt(tree.self_min_distance2(pts, static_cast<int>(window))) * (1.0 + 1e-9);
+        if (std::isfinite(bound)) {
+            const double reach = tol <= 0.0 ? bound + 1e-12 : bound * (1.0 + tol) + tol;
+            std::vector<std::pair<std::size_t, std::size_t>> pairs;
+            tree.self_pairs_within(pts, reach * (1.0 + 1e-9), window, pairs);
+            std::sort(pairs.begin(), pairs.end());
+            gridded = true;
+            all.reserve(pairs.size());
+            for (const auto& pr : pairs) {
+                all.push_back(make_pair(pr.first, pr.second));
+                best = std::min(best, all.back().distance);
+            }
+        }
+    }
+    if (!gridded && n >= kGridMinPoints) {
+        // Through a cell list of segment centres: segments closer than r have centres closer
+        // than r + lmax. The bound comes from the pairs within a small cutoff, doubled until a
+        // non-adjacent pair shows up.
+        double lmax = 0.0;
+        bool finite = true;
+        std::vector<Vec3> centres(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const Vec3& A = pts[i];
+            const Vec3& B = pts[(i + 1) % n];
+            lmax = std::max(lmax, dist(A, B));
+            centres[i] = mul(add(A, B), 0.5);
+            finite = finite && std::isfinite(centres[i][0]) && std::isfinite(centres[i][1]) && std::isfinite(centres[i][2]);
+        }
+        double extent = 0.0;
+        for (const Vec3& c : centres) extent = std::max(extent, dist(c, centres[0]));
+        if (finite && std::isfinite(lmax) && lmax > 0.0) {
+            geometry::VerletNeighbourList cells;
+            // Centre cutoffs carry a relative slack so rounding in the centres cannot drop a pair.
+            const auto pairs_within = [&](double cutoff, auto&& visit) {
+                cells.set_radius(cutoff, 0.0);
+                cells.update(centres.data(), n, centres.data(), n);
+                for (std::size_t i = 0; i < n; ++i) {
+                    for (const std::size_t* q = cells.begin(i); q != cells.end(i); ++q) {
+                        if (*q > i && cyclic_edge_distance(i, *q, n) > skip_neighbors) visit(i, *q);
+                    }
+                }
+            };
+            double bound = std::numeric_limits<double>::infinity();
+            for (double cutoff = 2.0 * lmax; !std::isfinite(bound) && cutoff <= 4.0 * extent + 2.0 * lmax; cutoff *= 2.0) {
+                pairs_within(cutoff, [&](std::size_t i, std::size_t j) {
+                    bound = std::min(bound, segment_segment_distance(pts[i], pts[(i + 1) % n], pts[j], pts[(j + 1) % n],
+                                                                     nullptr, nullptr));
+                });
+            }
+            if (std::isfinite(bound)) {
+                const double reach = tol <= 0.0 ? bound + 1e-12 : bound * (1.0 + tol) + tol;
+                gridded = true;
+                pairs_within((reach + lmax) * (1.0 + 1e-9), [&](std::size_t i, std::size_t j) {
+                    all.push_back(make_pair(i, j));
+                    best = std::min(best, all.back().distance);
+                });
+            }
+        }
+    }
+
+    if (!gridded) {
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = i + 1; j < n; ++j) {
+                if (cyclic_edge_distance(i, j, n) <= skip_neighbors) continue;
+                all.push_back(make_pair(i, j));
+                best = std::min(best, all.back().distance);
+            }
         }
     }
 
     if (all.empty()) return out;
-    const double tol = std::max(0.0, distance_tol);
     for (const auto& pair : all) {
-        if (tol <= 0.0) {
-            if (pair.distance <= best + 1e-12) out.push_back(pair);
-        } else if (pair.distance <= best * (1.0 + tol) + tol) {
-            out.push_back(pair);
-        }
+        if (within(pair.distance, best)) out.push_back(pair);
     }
     return out;
 }
@@ -222,7 +308,8 @@ ResolvedTubeMetrics ResolvedTubeGeometry::analyze(
     const std::vector<Vec3>& pts,
     int skip_neighbors,
     double contact_tol,
-    double equilateral_tol) {
+    double equilateral_tol,
+    geometry::SegmentBvhAccelerator* accelerator) {
     if (pts.size() < 3) throw std::invalid_argument("analyze requires at least 3 points.");
     if (contact_tol < 0.0) throw std::invalid_argument("contact_tol must be non-negative.");
     if (equilateral_tol < 0.0) throw std::invalid_argument("equilateral_tol must be non-negative.");
@@ -234,7 +321,7 @@ ResolvedTubeMetrics ResolvedTubeGeometry::analyze(
     out.equilateral_ok = out.edge_length_rel_std <= equilateral_tol;
     out.minrad = global_minrad(pts);
 
-    const auto candidates = dcsd_candidates(pts, skip_neighbors, 0.0);
+    const auto candidates = dcsd_candidates(pts, skip_neighbors, 0.0, accelerator);
     if (!candidates.empty()) {
         out.min_dcsd = candidates.front().distance;
         for (const auto& c : candidates) out.min_dcsd = std::min(out.min_dcsd, c.distance);
@@ -254,7 +341,7 @@ ResolvedTubeMetrics ResolvedTubeGeometry::analyze(
 
     const double contact_radius = std::isfinite(out.thickness_rad) ? out.thickness_rad : 0.0;
     if (contact_radius > 0.0) {
-        const auto strut_candidates = dcsd_candidates(pts, skip_neighbors, contact_tol);
+        const auto strut_candidates = dcsd_candidates(pts, skip_neighbors, contact_tol, accelerator);
         for (const auto& c : strut_candidates) {
             if (0.5 * c.distance <= contact_radius * (1.0 + contact_tol) + contact_tol) {
                 out.struts.push_back(c);
@@ -403,6 +403,8 @@ Napi::Object tightening_result_to_js(Napi::Env env, const TighteningResult& r) {
     o.Set("steps", steps);
     o.Set("converged", Napi::Boolean::New(env, r.converged));
     o.Set("reason", Napi::String::New(env, r.reason));
+    o.Set("bvh_builds", Napi::Number::New(env, static_cast<double>(r.bvh_builds)));
+    o.Set("bvh_refits", Napi::Number::New(env, static_cast<double>(r.bvh_refits)));
     return o;
 }
 
@@ -137,7 +137,9 @@ void bind_resolved_tube_geometry(py::module_& m) {
         .def_readwrite("metrics", &sst::TighteningResult::metrics)
         .def_readwrite("steps", &sst::TighteningResult::steps)
         .def_readwrite("converged", &sst::TighteningResult::converged)
-        .def_readwrite("reason", &sst::TighteningResult::reason);
+        .def_readwrite("reason", &sst::TighteningResult::reason)
+        .def_readwrite("bvh_builds", &sst::TighteningResult::bvh_builds)
+        .def_readwrite("bvh_refits", &sst::TighteningResult::bvh_refits);
 
     py::class_<sst::ContactStressDiagnostics>(m, "ContactStressDiagnostics")
         .def(py::init<>())
@@ -178,9 +180,15 @@ void bind_resolved_tube_geometry(py::module_& m) {
                         return py::make_tuple(d, s, t);
                     },
                     py::arg("p0"), py::arg("p1"), py::arg("q0"), py::arg("q1"))
-        .def_static("dcsd_candidates", &sst::ResolvedTubeGeometry::dcsd_candidates,
+        .def_static("dcsd_candidates",
+                    [](const std::vector<sst::Vec3>& points, int skip_neighbors, double distance_tol) {
+                        return sst::ResolvedTubeGeometry::dcsd_candidates(points, skip_neighbors, distance_tol);
+                    },
                     py::arg("points"), py::arg("skip_neighbors") = 2, py::arg("distance_tol") = 0.0)
-        .def_static("analyze", &sst::ResolvedTubeGeometry::analyze,
+        .def_static("analyze",
+                    [](const std::vector<sst::Vec3>& points, int skip_neighbors, double contact_tol, double equilateral_tol) {
+                        return sst::ResolvedTubeGeometry::analyze(points, skip_neighbors, contact_tol, equilateral_tol);
+                    },
                     py::arg("points"), py::arg("skip_neighbors") = 2,
                     py::arg("contact_tol") = 1e-3, py::arg("equilateral_tol") = 1e-3)
         .def_static("length_gradient_flat", &sst::ResolvedTubeGeometry::length_gradient_flat,
@@ -201,11 +209,20 @@ void bind_resolved_tube_geometry(py::module_& m) {
                     py::arg("ropelength_diam"));
 
     py::class_<sst::ResolvedTubeTightener>(m, "ResolvedTubeTightener")
-        .def_static("rescale_to_thickness", &sst::ResolvedTubeTightener::rescale_to_thickness,
+        .def_static("rescale_to_thickness",
+                    [](const std::vector<sst::Vec3>& points, double target_thickness, int skip_neighbors,
+                       double contact_tol, double equilateral_tol) {
+                        return sst::ResolvedTubeTightener::rescale_to_thickness(
+                            points, target_thickness, skip_neighbors, contact_tol, equilateral_tol);
+                    },
                     py::arg("points"), py::arg("target_thickness"),
                     py::arg("skip_neighbors") = 2, py::arg("contact_tol") = 1e-3,
                     py::arg("equilateral_tol") = 1e-3)
-        .def_static("correct_thickness", &sst::ResolvedTubeTightener::correct_thickness,
+        .def_static("correct_thickness",
+                    [](const std::vector<sst::Vec3>& points, double target_thickness,
+                       const sst::TighteningOptions& options) {
+                        return sst::ResolvedTubeTightener::correct_thickness(points, target_thickness, options);
+                    },
                     py::arg("points"), py::arg("target_thickness"),
                     py::arg("options") = sst::TighteningOptions())
         .def_static("projected_gradient_flat",
@@ -258,7 +275,10 @@ void bind_resolved_tube_geometry(py::module_& m) {
                     py::arg("use_active_set_solver") = true);
 
     // Convenience flat functions for users who do not want to instantiate class namespaces.
-    m.def("resolved_tube_analyze", &sst::ResolvedTubeGeometry::analyze,
+    m.def("resolved_tube_analyze",
+          [](const std::vector<sst::Vec3>& points, int skip_neighbors, double contact_tol, double equilateral_tol) {
+              return sst::ResolvedTubeGeometry::analyze(points, skip_neighbors, contact_tol, equilateral_tol);
+          },
           py::arg("points"), py::arg("skip_neighbors") = 2,
           py::arg("contact_tol") = 1e-3, py::arg("equilateral_tol") = 1e-3);
     m.def("resolved_tube_length", &sst::ResolvedTubeGeometry::length, py::arg("points"));
@@ -3,6 +3,7 @@
 #include "sst/tube/rigidity_matrix.h"
 #include "sst/tube/nnls.h"
 #include "sst/tube/detail/common.h"
+#include "geometry/segment_bvh.h"
 
 #include <cmath>
 #include <limits>
@@ -17,10 +18,11 @@ std::vector<Vec3> ResolvedTubeTightener::rescale_to_thickness(
     double target_thickness,
     int skip_neighbors,
     double contact_tol,
-    double equilateral_tol) {
+    double equilateral_tol,
+    geometry::SegmentBvhAccelerator* accelerator) {
     if (pts.empty()) return pts;
     if (!(target_thickness > 0.0) || !std::isfinite(target_thickness)) return pts;
-    const auto metrics = ResolvedTubeGeometry::analyze(pts, skip_neighbors, contact_tol, equilateral_tol);
+    const auto metrics = ResolvedTubeGeometry::analyze(pts, skip_neighbors, contact_tol, equilateral_tol, accelerator);
     if (!(metrics.thickness_rad > 0.0) || !std::isfinite(metrics.thickness_rad)) return pts;
     if (metrics.thickness_rad >= target_thickness) return pts;
     const double scale = (target_thickness / metrics.thickness_rad) * (1.0 + 1e-12);
@@ -33,24 +35,25 @@ std::vector<Vec3> ResolvedTubeTightener::rescale_to_thickness(
 std::vector<Vec3> ResolvedTubeTightener::correct_thickness(
     const std::vector<Vec3>& pts,
     double target_thickness,
-    const TighteningOptions& options) {
+    const TighteningOptions& options,
+    geometry::SegmentBvhAccelerator* accelerator) {
     if (pts.empty()) return pts;
     if (!(target_thickness > 0.0) || !std::isfinite(target_thickness)) return pts;
     if (options.correction_strategy == "none") return pts;
 
     auto current = ResolvedTubeGeometry::analyze(
-        pts, options.skip_neighbors, options.contact_tol, options.equilateral_tol);
+        pts, options.skip_neighbors, options.contact_tol, options.equilateral_tol, accelerator);
     if (current.thickness_rad >= target_thickness) return pts;
 
     if (options.correction_strategy == "scale") {
         return rescale_to_thickness(pts, target_thickness, options.skip_neighbors,
-                                    options.contact_tol, options.equilateral_tol);
+                                    options.contact_tol, options.equilateral_tol, accelerator);
     }
 
     std::vector<Vec3> out = pts;
     for (int attempt = 0; attempt < 3; ++attempt) {
         current = ResolvedTubeGeometry::analyze(
-            out, options.skip_neighbors, options.contact_tol, options.equilateral_tol);
+            out, options.skip_neighbors, options.contact_tol, options.equilateral_tol, accelerator);
         if (current.thickness_rad >= target_thickness) return out;
 
         const auto A = build_sparse_rigidity_matrix(
@@ -80,10 +83,10 @@ std::vector<Vec3> ResolvedTubeTightener::correct_thickness(
     }
 
     current = ResolvedTubeGeometry::analyze(
-        out, options.skip_neighbors, options.contact_tol, options.equilateral_tol);
+        out, options.skip_neighbors, options.contact_tol, options.equilateral_tol, accelerator);
     if (current.thickness_rad < target_thickness) {
         out = rescale_to_thickness(out, target_thickness, options.skip_neighbors,
-                                   options.contact_tol, options.equilateral_tol);
+                                   options.contact_tol, options.equilateral_tol, accelerator);
     }
     return out;
 }
@@ -165,18 +168,26 @@ TighteningResult ResolvedTubeTightener::tighten(
     const std::vector<Vec3>& initial_points,
     const TighteningOptions& options) {
     if (initial_points.size() < 3) throw std::invalid_argument("tighten requires at least 3 points.");
+    geometry::SegmentBvhAccelerator bvh;
+    geometry::SegmentBvhAccelerator* accelerator = &bvh;
+    const auto finish = [&](TighteningResult& r) {
+        r.bvh_builds = bvh.stats().builds;
+        r.bvh_refits = bvh.stats().refits;
+    };
     TighteningResult result;
     result.points = initial_points;
     result.metrics = ResolvedTubeGeometry::analyze(
-        result.points, options.skip_neighbors, options.contact_tol, options.equilateral_tol);
+        result.points, options.skip_neighbors, options.contact_tol, options.equilateral_tol, accelerator);
     if (options.max_steps == 0) {
         result.reason = "max_steps_zero";
+        finish(result);
         return result;
     }
 
     const double initial_thickness = result.metrics.thickness_rad;
     if (!(initial_thickness > 0.0) || !std::isfinite(initial_thickness)) {
         result.reason = "nonpositive_initial_thickness";
+        finish(result);
         return result;
     }
 
@@ -223,13 +234,13 @@ TighteningResult ResolvedTubeTightener::tighten(
             auto candidate = apply_flat_step(result.points, direction, alpha);
             bool did_correct = false;
             auto cand_metrics = ResolvedTubeGeometry::analyze(
-                candidate, options.skip_neighbors, options.contact_tol, options.equilateral_tol);
+                candidate, options.skip_neighbors, options.contact_tol, options.equilateral_tol, accelerator);
             if (cand_metrics.thickness_rad < min_allowed_thickness ||
                 (options.preserve_initial_thickness && cand_metrics.thickness_rad < target_thickness)) {
-                candidate = correct_thickness(candidate, target_thickness, options);
+                candidate = correct_thickness(candidate, target_thickness, options, accelerator);
                 did_correct = true;
                 cand_metrics = ResolvedTubeGeometry::analyze(
-                    candidate, options.skip_neighbors, options.contact_tol, options.equilateral_tol);
+                    candidate, options.skip_neighbors, options.contact_tol, options.equilateral_tol, accelerator);
             }
             const bool thickness_ok = cand_metrics.thickness_rad + 1e-12 >= min_allowed_thickness &&
                 (!options.preserve_initial_thickness || cand_metrics.thickness_rad + 1e-12 >= target_thickness * options.thickness_floor_fraction);
@@ -267,6 +278,7 @@ TighteningResult ResolvedTubeTightener::tighten(
     if (result.reason.empty()) {
         result.reason = result.converged ? "target_kkt_residual" : "max_steps";
     }
+    finish(result);
     return result;
 }
 
@@ -4,8 +4,10 @@
 #pragma once
 
 #include "sst/types.h"
+#include "geometry/segment_kernels.h"
 
 #include <cstddef>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -35,14 +37,39 @@ struct FilamentSystemState {
     std::vector<FilamentComponent> filaments;
 };
 
+/** Mutual-induction summation in FilamentVelocitySolver::evaluate (the LIA term is always local). */
+enum class MutualInductionBackend {
+    Direct,
+    Treecode,
+    Cutoff
+};
+
 struct VelocityOptions {
     bool lia_only = false;
+    // false drops the local (LIA) term and keeps only the mutual sum (for integrators that
+    // treat the local term implicitly).
+    bool include_lia = true;
     bool include_external = false;  // parity default: pure self/mutual first
     bool include_mutual_friction = false;
     double a_sim = 0.0;
     double core_delta = 0.0;       // DELTA index proxy: use exp(core_delta)
     double lia_constant = 0.25;    // VortexLab C0 default ≈ 0.25
     double core_radius = 0.01;     // a
+    MutualInductionBackend mutual_backend = MutualInductionBackend::Direct;
+    double treecode_theta = 0.3;              // opening angle radius / distance
+    std::size_t treecode_leaf_size = 32;
+    std::size_t treecode_min_segments = 2048; // direct sum below this many source segments
+    // Cutoff backend: source segments whose midpoint lies within mutual_cutoff of the target
+    // are summed from a Verlet neighbour list rebuilt after skin / 2 of motion; the ones beyond
+    // it through the treecode (or the direct sum below treecode_min_segments).
+    double mutual_cutoff = 1.0;
+    double neighbour_skin = 0.1;
+    // Mutual-induction quadrature (direct sum and treecode leaves); the LIA term is unchanged.
+    geometry::SegmentKernel segment_kernel = geometry::SegmentKernel::Midpoint;
+    // Workers over target points (0 = hardware concurrency). Each point sums its sources in a
+    // fixed order, so results do not depend on the thread count; the default stays serial
+    // because integrators call the solver many times per step.
+    std::size_t num_threads = 1;
 };
 
 struct VelocityFieldResult {
@@ -101,6 +128,13 @@ struct TopologyGuardResult {
     double safe_dt_fraction = 1.0;
     double clearance_before = 0.0;
     double clearance_after = 0.0;
+    // Continuous collision test: swept-box candidate pairs, and the segment pair (component,
+    // segment index) whose contact ends the step; -1 when no contact is found inside it.
+    std::size_t swept_pairs = 0;
+    int hit_component_a = -1;
+    int hit_segment_a = -1;
+    int hit_component_b = -1;
+    int hit_segment_b = -1;
     std::string message;
 };
 
@@ -129,6 +163,21 @@ struct PolygonalGaussResult {
     int linking_integer_audit = 0;
 };
 
+inline const char* mutual_induction_backend_name(MutualInductionBackend b) {
+    switch (b) {
+        case MutualInductionBackend::Treecode: return "treecode";
+        case MutualInductionBackend::Cutoff: return "cutoff";
+        default: return "direct";
+    }
+}
+
+inline MutualInductionBackend mutual_induction_backend_from_name(const std::string& name) {
+    if (name == "direct") return MutualInductionBackend::Direct;
+    if (name == "treecode" || name == "tree" || name == "barnes_hut") return MutualInductionBackend::Treecode;
+    if (name == "cutoff" || name == "neighbour_list") return MutualInductionBackend::Cutoff;
+    throw std::invalid_argument("unknown mutual induction backend: " + name);
+}
+
 inline const char* reach_limiter_name(ReachLimiter lim) {
     switch (lim) {
         case ReachLimiter::Curvature: return "CURVATURE";
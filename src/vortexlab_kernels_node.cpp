@@ -1,6 +1,10 @@
 // VortexLab kernel Node bindings (thin N-API wrappers).
 #include <napi.h>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -8,7 +12,10 @@
 #include "analysis/intrinsic_frame.h"
 #include "analysis/rigid_motion.h"
 #include "curve/sampling.h"
+#include "filament/ensemble.h"
 #include "filament/integrator.h"
+#include "filament/remesh.h"
+#include "filament/trajectory.h"
 #include "filament/velocity_solver.h"
 #include "geometry/continuous_reach.h"
 #include "geometry/polygonal_clearance.h"
@@ -39,6 +46,7 @@ static FilamentSystemState read_filaments(const Napi::Array& arr) {
         if (o.Has("circulation")) f.circulation = o.Get("circulation").As<Napi::Number>().DoubleValue();
         if (o.Has("ghost")) f.ghost = o.Get("ghost").As<Napi::Boolean>().Value();
         if (o.Has("source")) f.source = o.Get("source").As<Napi::Boolean>().Value();
+        if (o.Has("dynamic")) f.dynamic = o.Get("dynamic").As<Napi::Boolean>().Value();
         state.filaments.push_back(std::move(f));
     }
     return state;
@@ -50,6 +58,8 @@ static VelocityOptions read_options(const Napi::Value& v) {
     Napi::Object d = v.As<Napi::Object>();
     if (d.Has("liaOnly")) o.lia_only = d.Get("liaOnly").As<Napi::Boolean>().Value();
     if (d.Has("lia_only")) o.lia_only = d.Get("lia_only").As<Napi::Boolean>().Value();
+    if (d.Has("includeLia")) o.include_lia = d.Get("includeLia").As<Napi::Boolean>().Value();
+    if (d.Has("include_lia")) o.include_lia = d.Get("include_lia").As<Napi::Boolean>().Value();
     if (d.Has("aSim")) o.a_sim = d.Get("aSim").As<Napi::Number>().DoubleValue();
     if (d.Has("a_sim")) o.a_sim = d.Get("a_sim").As<Napi::Number>().DoubleValue();
     if (d.Has("coreDelta")) o.core_delta = d.Get("coreDelta").As<Napi::Number>().DoubleValue();
@@ -57,6 +67,38 @@ static VelocityOptions read_options(const Napi::Value& v) {
     if (d.Has("liaConstant")) o.lia_constant = d.Get("liaConstant").As<Napi::Number>().DoubleValue();
     if (d.Has("coreRadius")) o.core_radius = d.Get("coreRadius").As<Napi::Number>().DoubleValue();
     if (d.Has("core_radius")) o.core_radius = d.Get("core_radius").As<Napi::Number>().DoubleValue();
+    for (const char* key : {"mutualBackend", "mutual_backend"}) {
+        if (!d.Has(key)) continue;
+        try {
+            o.mutual_backend = mutual_induction_backend_from_name(d.Get(key).As<Napi::String>().Utf8Value());
+        } catch (const std::invalid_argument& e) {
+            throw Napi::TypeError::New(v.Env(), e.what());
+        }
+    }
+    if (d.Has("mutualCutoff")) o.mutual_cutoff = d.Get("mutualCutoff").As<Napi::Number>().DoubleValue();
+    if (d.Has("mutual_cutoff")) o.mutual_cutoff = d.Get("mutual_cutoff").As<Napi::Number>().DoubleValue();
+    if (d.Has("neighbourSkin")) o.neighbour_skin = d.Get("neighbourSkin").As<Napi::Number>().DoubleValue();
+    if (d.Has("neighbour_skin")) o.neighbour_skin = d.Get("neighbour_skin").As<Napi::Number>().DoubleValue();
+    if (d.Has("treecodeTheta")) o.treecode_theta = d.Get("treecodeTheta").As<Napi::Number>().DoubleValue();
+    if (d.Has("treecode_theta")) o.treecode_theta = d.Get("treecode_theta").As<Napi::Number>().DoubleValue();
+    if (d.Has("treecodeLeafSize"))
+        o.treecode_leaf_size = d.Get("treecodeLeafSize").As<Napi::Number>().Uint32Value();
+    if (d.Has("treecode_leaf_size"))
+        o.treecode_leaf_size = d.Get("treecode_leaf_size").As<Napi::Number>().Uint32Value();
+    if (d.Has("treecodeMinSegments"))
+        o.treecode_min_segments = d.Get("treecodeMinSegments").As<Napi::Number>().Uint32Value();
+    if (d.Has("treecode_min_segments"))
+        o.treecode_min_segments = d.Get("treecode_min_segments").As<Napi::Number>().Uint32Value();
+    for (const char* key : {"segmentKernel", "segment_kernel"}) {
+        if (!d.Has(key)) continue;
+        try {
+            o.segment_kernel = geometry::segment_kernel_from_name(d.Get(key).As<Napi::String>().Utf8Value());
+        } catch (const std::invalid_argument& e) {
+            throw Napi::TypeError::New(v.Env(), e.what());
+        }
+    }
+    if (d.Has("numThreads")) o.num_threads = d.Get("numThreads").As<Napi::Number>().Uint32Value();
+    if (d.Has("num_threads")) o.num_threads = d.Get("num_threads").As<Napi::Number>().Uint32Value();
     return o;
 }
 
@@ -129,7 +171,9 @@ static Napi::Value ComputeTopologyClearance(const Napi::CallbackInfo& info) {
 static Napi::Value ComputeContinuousReach(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     auto curves = read_curve_list(info[0].As<Napi::Array>());
-    auto r = geometry::ContinuousReachSolver::compute(curves);
+    const std::size_t threads =
+        info.Length() > 1 ? static_cast<std::size_t>(info[1].As<Napi::Number>().Uint32Value()) : 1;
+    auto r = geometry::ContinuousReachSolver::compute(curves, threads);
     Napi::Object o = Napi::Object::New(env);
     o.Set("curvatureRadius", r.curvature_radius);
     o.Set("selfDcsd", r.self_dcsd);
@@ -161,26 +205,305 @@ static Napi::Value ComputeRegularizedMutualVelocity(const Napi::CallbackInfo& in
     return ComputeFilamentVelocity(info);
 }
 
-static Napi::Value Rk4Step(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    auto state = read_filaments(info[0].As<Napi::Array>());
-    double dt = info[1].As<Napi::Number>().DoubleValue();
-    auto opt = info.Length() > 2 ? read_options(info[2]) : VelocityOptions{};
-    auto r = filament::FilamentIntegrator::rk4_step(state, dt, opt);
-    Napi::Array fils = Napi::Array::New(env, r.state.filaments.size());
-    for (std::size_t i = 0; i < r.state.filaments.size(); ++i) {
-        const auto& f = r.state.filaments[i];
+static Napi::Array filaments_obj(Napi::Env env, const FilamentSystemState& state) {
+    Napi::Array fils = Napi::Array::New(env, state.filaments.size());
+    for (std::size_t i = 0; i < state.filaments.size(); ++i) {
+        const auto& f = state.filaments[i];
         Napi::Object o = Napi::Object::New(env);
         o.Set("id", f.id);
         o.Set("carrier", f.carrier);
         o.Set("points", points_obj(env, f.points));
         o.Set("circulation", f.circulation);
         o.Set("ghost", f.ghost);
+        o.Set("source", f.source);
+        o.Set("dynamic", f.dynamic);
         fils.Set(static_cast<uint32_t>(i), o);
     }
+    return fils;
+}
+
+// Optional remesh settings: { maxTurningAngle?, minTurningAngle?, maxSegmentLength?,
+// minSegmentLength?, minPoints?, maxPoints? } (snake_case accepted).
+static filament::RemeshOptions read_remesh_options(const Napi::Value& v) {
+    filament::RemeshOptions o;
+    if (!v.IsObject()) return o;
+    Napi::Object d = v.As<Napi::Object>();
+    const auto number = [&](const char* camel, const char* snake, double& out) {
+        if (d.Has(camel)) out = d.Get(camel).As<Napi::Number>().DoubleValue();
+        if (d.Has(snake)) out = d.Get(snake).As<Napi::Number>().DoubleValue();
+    };
+    const auto count = [&](const char* camel, const char* snake, std::size_t& out) {
+        if (d.Has(camel)) out = d.Get(camel).As<Napi::Number>().Uint32Value();
+        if (d.Has(snake)) out = d.Get(snake).As<Napi::Number>().Uint32Value();
+    };
+    number("maxTurningAngle", "max_turning_angle", o.max_turning_angle);
+    number("minTurningAngle", "min_turning_angle", o.min_turning_angle);
+    number("maxSegmentLength", "max_segment_length", o.max_segment_length);
+    number("minSegmentLength", "min_segment_length", o.min_segment_length);
+    count("minPoints", "min_points", o.min_points);
+    count("maxPoints", "max_points", o.max_points);
+    try {
+        filament::FilamentRemesher::validate(o);
+    } catch (const std::invalid_argument& e) {
+        throw Napi::TypeError::New(v.Env(), e.what());
+    }
+    return o;
+}
+
+static Napi::Value Rk4Step(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto state = read_filaments(info[0].As<Napi::Array>());
+    double dt = info[1].As<Napi::Number>().DoubleValue();
+    auto opt = info.Length() > 2 ? read_options(info[2]) : VelocityOptions{};
+    // Optional step count: repeated steps reuse one stepper workspace.
+    const uint32_t steps = info.Length() > 3 && info[3].IsNumber() ? info[3].As<Napi::Number>().Uint32Value() : 1u;
+    // Optional remesh settings: advected filaments are remeshed after every step.
+    const bool remesh = info.Length() > 4 && info[4].IsObject();
+    const auto remesh_opt = remesh ? read_remesh_options(info[4]) : filament::RemeshOptions{};
+    filament::IntegratorStepResult r;
+    r.state = std::move(state);
+    filament::FilamentRK4Stepper stepper(opt);
+    filament::RemeshStats remeshed;
+    for (uint32_t s = 0; s < steps; ++s) {
+        r.maximum_stage_speed = std::max(r.maximum_stage_speed, stepper.step(r.state, dt));
+        if (remesh) {
+            const auto st = filament::FilamentRemesher::remesh(r.state, remesh_opt);
+            remeshed.inserted += st.inserted;
+            remeshed.removed += st.removed;
+        }
+    }
     Napi::Object out = Napi::Object::New(env);
-    out.Set("filaments", fils);
+    out.Set("filaments", filaments_obj(env, r.state));
     out.Set("maximumStageSpeed", r.maximum_stage_speed);
+    if (remesh) {
+        out.Set("inserted", static_cast<double>(remeshed.inserted));
+        out.Set("removed", static_cast<double>(remeshed.removed));
+    }
+    if (opt.mutual_backend == MutualInductionBackend::Cutoff) {
+        const auto& st = stepper.workspace().neighbours.stats();
+        out.Set("neighbourBuilds", static_cast<double>(st.builds));
+        out.Set("neighbourPairs", static_cast<double>(st.pairs));
+    }
+    return out;
+}
+
+// ensembleRk4Step(members, dt, options?, steps?, ensemble?): options is one object shared by all
+// members or an array with one per member; ensemble { numThreads?, lanes? } (snake_case accepted).
+static Napi::Value EnsembleRk4Step(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 2 || !info[0].IsArray()) throw Napi::TypeError::New(env, "Expected (members, dt[, options, steps, ensemble])");
+    Napi::Array arr = info[0].As<Napi::Array>();
+    std::vector<FilamentSystemState> members;
+    for (uint32_t m = 0; m < arr.Length(); ++m) members.push_back(read_filaments(arr.Get(m).As<Napi::Array>()));
+    const double dt = info[1].As<Napi::Number>().DoubleValue();
+    std::vector<VelocityOptions> opts;
+    if (info.Length() > 2 && info[2].IsArray()) {
+        Napi::Array list = info[2].As<Napi::Array>();
+        for (uint32_t m = 0; m < list.Length(); ++m) opts.push_back(read_options(list.Get(m)));
+    } else {
+        opts.push_back(info.Length() > 2 ? read_options(info[2]) : VelocityOptions{});
+    }
+    const uint32_t steps = info.Length() > 3 && info[3].IsNumber() ? info[3].As<Napi::Number>().Uint32Value() : 1u;
+    filament::EnsembleOptions eo;
+    if (info.Length() > 4 && info[4].IsObject()) {
+        Napi::Object d = info[4].As<Napi::Object>();
+        if (d.Has("numThreads")) eo.num_threads = d.Get("numThreads").As<Napi::Number>().Uint32Value();
+        if (d.Has("num_threads")) eo.num_threads = d.Get("num_threads").As<Napi::Number>().Uint32Value();
+        if (d.Has("lanes")) eo.lanes = d.Get("lanes").As<Napi::Number>().Uint32Value();
+    }
+    filament::EnsembleStepResult r;
+    try {
+        r = filament::FilamentEnsembleIntegrator(eo).rk4_steps(members, opts, dt, steps);
+    } catch (const std::invalid_argument& e) {
+        throw Napi::TypeError::New(env, e.what());
+    }
+    Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, r.positions.size() * sizeof(double));
+    std::copy(r.positions.begin(), r.positions.end(), static_cast<double*>(buffer.Data()));
+    const auto index_array = [&](const std::vector<std::size_t>& v) {
+        Napi::Array a = Napi::Array::New(env, v.size());
+        for (uint32_t i = 0; i < v.size(); ++i) a.Set(i, static_cast<double>(v[i]));
+        return a;
+    };
+    Napi::Array speed = Napi::Array::New(env, r.maximum_stage_speed.size());
+    for (uint32_t i = 0; i < r.maximum_stage_speed.size(); ++i) speed.Set(i, r.maximum_stage_speed[i]);
+    Napi::Object out = Napi::Object::New(env);
+    out.Set("positions", Napi::Float64Array::New(env, r.positions.size(), buffer, 0));
+    out.Set("filamentOffsets", index_array(r.filament_offsets));
+    out.Set("memberFilaments", index_array(r.member_filaments));
+    out.Set("maximumStageSpeed", speed);
+    out.Set("batchedMembers", static_cast<double>(r.batched_members));
+    return out;
+}
+
+static Napi::Value RemeshFilaments(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto state = read_filaments(info[0].As<Napi::Array>());
+    const auto remesh_opt = info.Length() > 1 ? read_remesh_options(info[1]) : filament::RemeshOptions{};
+    const auto st = filament::FilamentRemesher::remesh(state, remesh_opt);
+    Napi::Object out = Napi::Object::New(env);
+    out.Set("filaments", filaments_obj(env, state));
+    out.Set("inserted", static_cast<double>(st.inserted));
+    out.Set("removed", static_cast<double>(st.removed));
+    out.Set("points", static_cast<double>(st.points));
+    out.Set("filamentsChanged", static_cast<double>(st.filaments_changed));
+    return out;
+}
+
+// Optional adaptive settings: { scheme?: 'dopri5' | 'bs32', rtol?, atol?, dtInitial?, cfl?, dtMin?,
+// dtMax?, safety?, minShrink?, maxGrowth?, maxSteps? } (snake_case accepted).
+static filament::AdaptiveStepOptions read_adaptive_options(const Napi::Value& v) {
+    filament::AdaptiveStepOptions o;
+    if (!v.IsObject()) return o;
+    Napi::Object d = v.As<Napi::Object>();
+    if (d.Has("scheme")) {
+        try {
+            o.scheme = filament::embedded_scheme_from_name(d.Get("scheme").As<Napi::String>().Utf8Value());
+        } catch (const std::invalid_argument& e) {
+            throw Napi::TypeError::New(v.Env(), e.what());
+        }
+    }
+    const auto number = [&](const char* camel, const char* snake, double& out) {
+        if (d.Has(camel)) out = d.Get(camel).As<Napi::Number>().DoubleValue();
+        if (d.Has(snake)) out = d.Get(snake).As<Napi::Number>().DoubleValue();
+    };
+    number("rtol", "rtol", o.rtol);
+    number("atol", "atol", o.atol);
+    number("dtInitial", "dt_initial", o.dt_initial);
+    number("cfl", "cfl", o.cfl);
+    number("dtMin", "dt_min", o.dt_min);
+    number("dtMax", "dt_max", o.dt_max);
+    number("safety", "safety", o.safety);
+    number("minShrink", "min_shrink", o.min_shrink);
+    number("maxGrowth", "max_growth", o.max_growth);
+    if (d.Has("maxSteps")) o.max_steps = d.Get("maxSteps").As<Napi::Number>().Uint32Value();
+    if (d.Has("max_steps")) o.max_steps = d.Get("max_steps").As<Napi::Number>().Uint32Value();
+    return o;
+}
+
+static Napi::Value IntegrateAdaptive(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto state = read_filaments(info[0].As<Napi::Array>());
+    const double t_end = info[1].As<Napi::Number>().DoubleValue();
+    auto opt = info.Length() > 2 ? read_options(info[2]) : VelocityOptions{};
+    const auto adaptive = info.Length() > 3 ? read_adaptive_options(info[3]) : filament::AdaptiveStepOptions{};
+    const double t0 = info.Length() > 4 && info[4].IsNumber() ? info[4].As<Napi::Number>().DoubleValue() : 0.0;
+    filament::AdaptiveIntegrationResult r;
+    try {
+        filament::FilamentAdaptiveIntegrator integrator(opt, adaptive);
+        r = integrator.advance(state, t0, t_end);
+    } catch (const std::invalid_argument& e) {
+        throw Napi::TypeError::New(env, e.what());
+    }
+    Napi::Object out = Napi::Object::New(env);
+    out.Set("filaments", filaments_obj(env, state));
+    out.Set("time", r.time);
+    out.Set("completed", r.completed);
+    out.Set("acceptedSteps", static_cast<double>(r.accepted_steps));
+    out.Set("rejectedSteps", static_cast<double>(r.rejected_steps));
+    out.Set("velocityEvaluations", static_cast<double>(r.velocity_evaluations));
+    out.Set("lastErrorNorm", r.last_error_norm);
+    out.Set("maxErrorNorm", r.max_error_norm);
+    out.Set("nextDt", r.next_dt);
+    out.Set("maximumStageSpeed", r.maximum_stage_speed);
+    return out;
+}
+
+// Optional multirate settings: { cfl?, liaStability?, maxLevel? } (snake_case accepted).
+static filament::MultirateOptions read_multirate_options(const Napi::Value& v) {
+    filament::MultirateOptions o;
+    if (!v.IsObject()) return o;
+    Napi::Object d = v.As<Napi::Object>();
+    if (d.Has("cfl")) o.cfl = d.Get("cfl").As<Napi::Number>().DoubleValue();
+    if (d.Has("liaStability")) o.lia_stability = d.Get("liaStability").As<Napi::Number>().DoubleValue();
+    if (d.Has("lia_stability")) o.lia_stability = d.Get("lia_stability").As<Napi::Number>().DoubleValue();
+    if (d.Has("maxLevel")) o.max_level = d.Get("maxLevel").As<Napi::Number>().Uint32Value();
+    if (d.Has("max_level")) o.max_level = d.Get("max_level").As<Napi::Number>().Uint32Value();
+    return o;
+}
+
+static Napi::Value MultirateStep(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto state = read_filaments(info[0].As<Napi::Array>());
+    const double dt = info[1].As<Napi::Number>().DoubleValue();
+    auto opt = info.Length() > 2 ? read_options(info[2]) : VelocityOptions{};
+    const auto multirate = info.Length() > 3 ? read_multirate_options(info[3]) : filament::MultirateOptions{};
+    const uint32_t steps = info.Length() > 4 && info[4].IsNumber() ? info[4].As<Napi::Number>().Uint32Value() : 1u;
+    filament::MultirateStepResult last;
+    std::size_t evaluations = 0, targets = 0;
+    double speed = 0.0;
+    try {
+        filament::FilamentMultirateIntegrator integrator(opt, multirate);
+        for (uint32_t s = 0; s < steps; ++s) {
+            last = integrator.step(state, dt);
+            evaluations += last.velocity_evaluations;
+            targets += last.target_evaluations;
+            speed = std::max(speed, last.maximum_stage_speed);
+        }
+    } catch (const std::invalid_argument& e) {
+        throw Napi::TypeError::New(env, e.what());
+    }
+    Napi::Array substeps = Napi::Array::New(env, last.substeps.size());
+    for (std::size_t i = 0; i < last.substeps.size(); ++i) {
+        substeps.Set(static_cast<uint32_t>(i), static_cast<double>(last.substeps[i]));
+    }
+    Napi::Object out = Napi::Object::New(env);
+    out.Set("filaments", filaments_obj(env, state));
+    out.Set("substeps", substeps);
+    out.Set("velocityEvaluations", static_cast<double>(evaluations));
+    out.Set("targetEvaluations", static_cast<double>(targets));
+    out.Set("maximumStageSpeed", speed);
+    return out;
+}
+
+// Optional IMEX settings: { scheme?: 'midpoint' | 'euler', theta? }.
+static filament::ImexOptions read_imex_options(const Napi::Value& v) {
+    filament::ImexOptions o;
+    if (!v.IsObject()) return o;
+    Napi::Object d = v.As<Napi::Object>();
+    if (d.Has("scheme")) {
+        try {
+            o.scheme = filament::imex_scheme_from_name(d.Get("scheme").As<Napi::String>().Utf8Value());
+        } catch (const std::invalid_argument& e) {
+            throw Napi::TypeError::New(v.Env(), e.what());
+        }
+    }
+    if (d.Has("theta")) o.theta = d.Get("theta").As<Napi::Number>().DoubleValue();
+    return o;
+}
+
+static Napi::Value ImexStep(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto state = read_filaments(info[0].As<Napi::Array>());
+    const double dt = info[1].As<Napi::Number>().DoubleValue();
+    auto opt = info.Length() > 2 ? read_options(info[2]) : VelocityOptions{};
+    const auto imex = info.Length() > 3 ? read_imex_options(info[3]) : filament::ImexOptions{};
+    const uint32_t steps = info.Length() > 4 && info[4].IsNumber() ? info[4].As<Napi::Number>().Uint32Value() : 1u;
+    filament::ImexStepResult total;
+    try {
+        filament::FilamentImexIntegrator integrator(opt, imex);
+        for (uint32_t s = 0; s < steps; ++s) {
+            const auto r = integrator.step(state, dt);
+            total.maximum_mutual_speed = std::max(total.maximum_mutual_speed, r.maximum_mutual_speed);
+            total.maximum_stage_speed = std::max(total.maximum_stage_speed, r.maximum_stage_speed);
+        }
+    } catch (const std::invalid_argument& e) {
+        throw Napi::TypeError::New(env, e.what());
+    }
+    Napi::Object out = Napi::Object::New(env);
+    out.Set("filaments", filaments_obj(env, state));
+    out.Set("maximumMutualSpeed", total.maximum_mutual_speed);
+    out.Set("maximumStageSpeed", total.maximum_stage_speed);
+    return out;
+}
+
+static Napi::Value EstimateFilamentDt(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto state = read_filaments(info[0].As<Napi::Array>());
+    auto opt = info.Length() > 1 ? read_options(info[1]) : VelocityOptions{};
+    const auto multirate = info.Length() > 2 ? read_multirate_options(info[2]) : filament::MultirateOptions{};
+    const auto dts = filament::FilamentIntegrator::estimate_filament_dt(state, opt, multirate);
+    Napi::Array out = Napi::Array::New(env, dts.size());
+    for (std::size_t i = 0; i < dts.size(); ++i) out.Set(static_cast<uint32_t>(i), dts[i]);
     return out;
 }
 
@@ -206,6 +529,13 @@ static Napi::Value GuardTopologyStep(const Napi::CallbackInfo& info) {
     o.Set("safeDtFraction", r.safe_dt_fraction);
     o.Set("clearanceBefore", r.clearance_before);
     o.Set("clearanceAfter", r.clearance_after);
+    o.Set("sweptPairs", static_cast<double>(r.swept_pairs));
+    Napi::Array hit = Napi::Array::New(env, 4);
+    hit.Set(0u, r.hit_component_a);
+    hit.Set(1u, r.hit_segment_a);
+    hit.Set(2u, r.hit_component_b);
+    hit.Set(3u, r.hit_segment_b);
+    o.Set("hitPair", hit);
     o.Set("message", r.message);
     return o;
 }
@@ -240,6 +570,222 @@ static Napi::Value ComputeRigidMotion(const Napi::CallbackInfo& info) {
     return o;
 }
 
+// Binary trajectories (.ssttraj) and checkpoints; I/O failures surface as JS Errors.
+static std::vector<std::string> read_string_list(const Napi::Value& v) {
+    std::vector<std::string> out;
+    if (!v.IsArray()) return out;
+    Napi::Array a = v.As<Napi::Array>();
+    for (uint32_t i = 0; i < a.Length(); ++i) out.push_back(a.Get(i).As<Napi::String>().Utf8Value());
+    return out;
+}
+
+static std::vector<double> read_number_list(const Napi::Value& v) {
+    std::vector<double> out;
+    if (!v.IsArray()) return out;
+    Napi::Array a = v.As<Napi::Array>();
+    for (uint32_t i = 0; i < a.Length(); ++i) out.push_back(a.Get(i).As<Napi::Number>().DoubleValue());
+    return out;
+}
+
+class FilamentTrajectoryWriterWrap : public Napi::ObjectWrap<FilamentTrajectoryWriterWrap> {
+public:
+    static void Init(Napi::Env env, Napi::Object exports) {
+        Napi::Function func = DefineClass(
+            env, "FilamentTrajectoryWriter",
+            {InstanceMethod("append", &FilamentTrajectoryWriterWrap::Append),
+             InstanceMethod("flush", &FilamentTrajectoryWriterWrap::Flush),
+             InstanceMethod("close", &FilamentTrajectoryWriterWrap::Close),
+             InstanceMethod("frameCount", &FilamentTrajectoryWriterWrap::FrameCount)});
+        exports.Set("FilamentTrajectoryWriter", func);
+    }
+
+    // (path, diagnosticNames?, { append?, flushEvery? })
+    FilamentTrajectoryWriterWrap(const Napi::CallbackInfo& info)
+        : Napi::ObjectWrap<FilamentTrajectoryWriterWrap>(info) {
+        Napi::Env env = info.Env();
+        if (info.Length() < 1 || !info[0].IsString()) throw Napi::TypeError::New(env, "Expected (path[, diagnosticNames, options])");
+        filament::TrajectoryWriterOptions o;
+        if (info.Length() > 2 && info[2].IsObject()) {
+            Napi::Object d = info[2].As<Napi::Object>();
+            if (d.Has("append")) o.append = d.Get("append").As<Napi::Boolean>().Value();
+            if (d.Has("flushEvery")) o.flush_every = d.Get("flushEvery").As<Napi::Number>().Uint32Value();
+            if (d.Has("flush_every")) o.flush_every = d.Get("flush_every").As<Napi::Number>().Uint32Value();
+        }
+        try {
+            writer_ = std::make_unique<filament::TrajectoryWriter>(
+                info[0].As<Napi::String>().Utf8Value(),
+                info.Length() > 1 ? read_string_list(info[1]) : std::vector<std::string>{}, o);
+        } catch (const std::exception& e) {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+private:
+    std::unique_ptr<filament::TrajectoryWriter> writer_;
+
+    // (filaments, time, step, { velocity?: Vec3Array[], diagnostics?: number[] })
+    Napi::Value Append(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        const auto state = read_filaments(info[0].As<Napi::Array>());
+        const double time = info[1].As<Napi::Number>().DoubleValue();
+        const auto step = static_cast<std::uint64_t>(info[2].As<Napi::Number>().Int64Value());
+        std::vector<std::vector<Vec3>> velocity;
+        std::vector<double> diagnostics;
+        bool has_velocity = false;
+        if (info.Length() > 3 && info[3].IsObject()) {
+            Napi::Object d = info[3].As<Napi::Object>();
+            if (d.Has("velocity") && d.Get("velocity").IsArray()) {
+                Napi::Array a = d.Get("velocity").As<Napi::Array>();
+                for (uint32_t i = 0; i < a.Length(); ++i) velocity.push_back(read_points(a.Get(i)));
+                has_velocity = true;
+            }
+            if (d.Has("diagnostics")) diagnostics = read_number_list(d.Get("diagnostics"));
+        }
+        try {
+            writer_->append(state, time, step, has_velocity ? &velocity : nullptr, diagnostics);
+        } catch (const std::invalid_argument& e) {
+            throw Napi::TypeError::New(env, e.what());
+        } catch (const std::exception& e) {
+            throw Napi::Error::New(env, e.what());
+        }
+        return env.Undefined();
+    }
+
+    Napi::Value Flush(const Napi::CallbackInfo& info) {
+        try {
+            writer_->flush();
+        } catch (const std::exception& e) {
+            throw Napi::Error::New(info.Env(), e.what());
+        }
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Close(const Napi::CallbackInfo& info) {
+        try {
+            writer_->close();
+        } catch (const std::exception& e) {
+            throw Napi::Error::New(info.Env(), e.what());
+        }
+        return info.Env().Undefined();
+    }
+
+    Napi::Value FrameCount(const Napi::CallbackInfo& info) {
+        return Napi::Number::New(info.Env(), static_cast<double>(writer_->frame_count()));
+    }
+};
+
+class FilamentTrajectoryReaderWrap : public Napi::ObjectWrap<FilamentTrajectoryReaderWrap> {
+public:
+    static void Init(Napi::Env env, Napi::Object exports) {
+        Napi::Function func = DefineClass(
+            env, "FilamentTrajectoryReader",
+            {InstanceMethod("frameCount", &FilamentTrajectoryReaderWrap::FrameCount),
+             InstanceMethod("diagnosticNames", &FilamentTrajectoryReaderWrap::DiagnosticNames),
+             InstanceMethod("frame", &FilamentTrajectoryReaderWrap::Frame),
+             InstanceMethod("refresh", &FilamentTrajectoryReaderWrap::Refresh)});
+        exports.Set("FilamentTrajectoryReader", func);
+    }
+
+    FilamentTrajectoryReaderWrap(const Napi::CallbackInfo& info)
+        : Napi::ObjectWrap<FilamentTrajectoryReaderWrap>(info) {
+        Napi::Env env = info.Env();
+        if (info.Length() < 1 || !info[0].IsString()) throw Napi::TypeError::New(env, "Expected (path)");
+        try {
+            reader_ = std::make_unique<filament::TrajectoryReader>(info[0].As<Napi::String>().Utf8Value());
+        } catch (const std::exception& e) {
+            throw Napi::Error::New(env, e.what());
+        }
+    }
+
+private:
+    std::unique_ptr<filament::TrajectoryReader> reader_;
+
+    Napi::Value FrameCount(const Napi::CallbackInfo& info) {
+        return Napi::Number::New(info.Env(), static_cast<double>(reader_->frame_count()));
+    }
+
+    Napi::Value DiagnosticNames(const Napi::CallbackInfo& info) {
+        const auto& names = reader_->diagnostic_names();
+        Napi::Array out = Napi::Array::New(info.Env(), names.size());
+        for (std::size_t i = 0; i < names.size(); ++i) out.Set(static_cast<uint32_t>(i), names[i]);
+        return out;
+    }
+
+    // { step, time, filaments, diagnostics: { name: value }, velocity? }
+    Napi::Value Frame(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        const std::size_t index = info[0].As<Napi::Number>().Uint32Value();
+        if (index >= reader_->frame_count()) throw Napi::RangeError::New(env, "trajectory frame index out of range");
+        const auto view = reader_->frame(index);
+        Napi::Object out = Napi::Object::New(env);
+        out.Set("step", static_cast<double>(view.step));
+        out.Set("time", view.time);
+        out.Set("filaments", filaments_obj(env, reader_->state(index)));
+        Napi::Object diagnostics = Napi::Object::New(env);
+        const auto& names = reader_->diagnostic_names();
+        for (std::size_t k = 0; k < names.size(); ++k) diagnostics.Set(names[k], view.diagnostics[k]);
+        out.Set("diagnostics", diagnostics);
+        if (view.velocities) {
+            const auto vel = reader_->velocity(index);
+            Napi::Array arr = Napi::Array::New(env, vel.size());
+            for (std::size_t f = 0; f < vel.size(); ++f) arr.Set(static_cast<uint32_t>(f), points_obj(env, vel[f]));
+            out.Set("velocity", arr);
+        }
+        return out;
+    }
+
+    Napi::Value Refresh(const Napi::CallbackInfo& info) {
+        try {
+            return Napi::Number::New(info.Env(), static_cast<double>(reader_->refresh()));
+        } catch (const std::exception& e) {
+            throw Napi::Error::New(info.Env(), e.what());
+        }
+    }
+};
+
+// (path, filaments, time, step?, values?: { name: number })
+static Napi::Value SaveFilamentCheckpoint(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    filament::FilamentCheckpoint c;
+    const std::string path = info[0].As<Napi::String>().Utf8Value();
+    c.state = read_filaments(info[1].As<Napi::Array>());
+    c.time = info[2].As<Napi::Number>().DoubleValue();
+    if (info.Length() > 3 && info[3].IsNumber()) c.step = static_cast<std::uint64_t>(info[3].As<Napi::Number>().Int64Value());
+    if (info.Length() > 4 && info[4].IsObject()) {
+        Napi::Object values = info[4].As<Napi::Object>();
+        Napi::Array keys = values.GetPropertyNames();
+        for (uint32_t i = 0; i < keys.Length(); ++i) {
+            const std::string key = keys.Get(i).As<Napi::String>().Utf8Value();
+            c.names.push_back(key);
+            c.values.push_back(values.Get(key).As<Napi::Number>().DoubleValue());
+        }
+    }
+    try {
+        filament::save_filament_checkpoint(path, c);
+    } catch (const std::exception& e) {
+        throw Napi::Error::New(env, e.what());
+    }
+    return env.Undefined();
+}
+
+static Napi::Value LoadFilamentCheckpoint(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    filament::FilamentCheckpoint c;
+    try {
+        c = filament::load_filament_checkpoint(info[0].As<Napi::String>().Utf8Value());
+    } catch (const std::exception& e) {
+        throw Napi::Error::New(env, e.what());
+    }
+    Napi::Object values = Napi::Object::New(env);
+    for (std::size_t k = 0; k < c.names.size(); ++k) values.Set(c.names[k], c.values[k]);
+    Napi::Object out = Napi::Object::New(env);
+    out.Set("filaments", filaments_obj(env, c.state));
+    out.Set("time", c.time);
+    out.Set("step", static_cast<double>(c.step));
+    out.Set("values", values);
+    return out;
+}
+
 void bind_vortexlab_kernels(Napi::Env env, Napi::Object exports) {
     exports.Set("resampleClosedCurve", Napi::Function::New(env, ResampleClosedCurve));
     exports.Set("sampleCurve", Napi::Function::New(env, SampleCurve));
@@ -250,8 +796,18 @@ void bind_vortexlab_kernels(Napi::Env env, Napi::Object exports) {
     exports.Set("computeFilamentVelocity", Napi::Function::New(env, ComputeFilamentVelocity));
     exports.Set("computeRegularizedMutualVelocity", Napi::Function::New(env, ComputeRegularizedMutualVelocity));
     exports.Set("rk4Step", Napi::Function::New(env, Rk4Step));
+    exports.Set("remeshFilaments", Napi::Function::New(env, RemeshFilaments));
+    exports.Set("ensembleRk4Step", Napi::Function::New(env, EnsembleRk4Step));
+    exports.Set("integrateAdaptive", Napi::Function::New(env, IntegrateAdaptive));
+    exports.Set("multirateStep", Napi::Function::New(env, MultirateStep));
+    exports.Set("imexStep", Napi::Function::New(env, ImexStep));
+    exports.Set("estimateFilamentDt", Napi::Function::New(env, EstimateFilamentDt));
     exports.Set("estimateCflDt", Napi::Function::New(env, EstimateCflDt));
     exports.Set("guardTopologyStep", Napi::Function::New(env, GuardTopologyStep));
     exports.Set("computeIntrinsicFrame", Napi::Function::New(env, ComputeIntrinsicFrame));
     exports.Set("computeRigidMotion", Napi::Function::New(env, ComputeRigidMotion));
+    exports.Set("saveFilamentCheckpoint", Napi::Function::New(env, SaveFilamentCheckpoint));
+    exports.Set("loadFilamentCheckpoint", Napi::Function::New(env, LoadFilamentCheckpoint));
+    FilamentTrajectoryWriterWrap::Init(env, exports);
+    FilamentTrajectoryReaderWrap::Init(env, exports);
 }
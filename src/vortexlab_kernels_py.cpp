@@ -3,11 +3,18 @@
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
 #include "analysis/intrinsic_frame.h"
 #include "analysis/rigid_motion.h"
 #include "catalog/knot_catalog.h"
 #include "curve/sampling.h"
+#include "filament/ensemble.h"
 #include "filament/integrator.h"
+#include "filament/remesh.h"
+#include "filament/trajectory.h"
 #include "filament/velocity_solver.h"
 #include "geometry/continuous_reach.h"
 #include "geometry/polygonal_clearance.h"
@@ -51,6 +58,7 @@ static FilamentSystemState parse_filaments(const py::list& fils) {
         if (d.contains("circulation")) f.circulation = py::cast<double>(d["circulation"]);
         if (d.contains("ghost")) f.ghost = py::cast<bool>(d["ghost"]);
         if (d.contains("source")) f.source = py::cast<bool>(d["source"]);
+        if (d.contains("dynamic")) f.dynamic = py::cast<bool>(d["dynamic"]);
         state.filaments.push_back(std::move(f));
     }
     return state;
@@ -59,13 +67,106 @@ static FilamentSystemState parse_filaments(const py::list& fils) {
 static VelocityOptions parse_velocity_options(const py::dict& d) {
     VelocityOptions o;
     if (d.contains("lia_only")) o.lia_only = py::cast<bool>(d["lia_only"]);
+    if (d.contains("include_lia")) o.include_lia = py::cast<bool>(d["include_lia"]);
     if (d.contains("a_sim")) o.a_sim = py::cast<double>(d["a_sim"]);
     if (d.contains("core_delta")) o.core_delta = py::cast<double>(d["core_delta"]);
     if (d.contains("lia_constant")) o.lia_constant = py::cast<double>(d["lia_constant"]);
     if (d.contains("core_radius")) o.core_radius = py::cast<double>(d["core_radius"]);
+    if (d.contains("mutual_backend"))
+        o.mutual_backend = mutual_induction_backend_from_name(py::cast<std::string>(d["mutual_backend"]));
+    if (d.contains("mutual_cutoff")) o.mutual_cutoff = py::cast<double>(d["mutual_cutoff"]);
+    if (d.contains("neighbour_skin")) o.neighbour_skin = py::cast<double>(d["neighbour_skin"]);
+    if (d.contains("treecode_theta")) o.treecode_theta = py::cast<double>(d["treecode_theta"]);
+    if (d.contains("treecode_leaf_size")) o.treecode_leaf_size = py::cast<std::size_t>(d["treecode_leaf_size"]);
+    if (d.contains("treecode_min_segments"))
+        o.treecode_min_segments = py::cast<std::size_t>(d["treecode_min_segments"]);
+    if (d.contains("segment_kernel"))
+        o.segment_kernel = geometry::segment_kernel_from_name(py::cast<std::string>(d["segment_kernel"]));
+    if (d.contains("num_threads")) o.num_threads = py::cast<std::size_t>(d["num_threads"]);
+    return o;
+}
+
+static py::list filaments_to_list(const FilamentSystemState& state) {
+    py::list out;
+    for (const auto& f : state.filaments) {
+        out.append(py::dict(
+            "id"_a = f.id,
+            "carrier"_a = f.carrier,
+            "points"_a = to_numpy(f.points),
+            "circulation"_a = f.circulation,
+            "ghost"_a = f.ghost,
+            "source"_a = f.source,
+            "dynamic"_a = f.dynamic));
+    }
+    return out;
+}
+
+static filament::AdaptiveStepOptions parse_adaptive_options(const py::dict& d) {
+    filament::AdaptiveStepOptions o;
+    if (d.contains("scheme")) o.scheme = filament::embedded_scheme_from_name(py::cast<std::string>(d["scheme"]));
+    if (d.contains("rtol")) o.rtol = py::cast<double>(d["rtol"]);
+    if (d.contains("atol")) o.atol = py::cast<double>(d["atol"]);
+    if (d.contains("dt_initial")) o.dt_initial = py::cast<double>(d["dt_initial"]);
+    if (d.contains("cfl")) o.cfl = py::cast<double>(d["cfl"]);
+    if (d.contains("dt_min")) o.dt_min = py::cast<double>(d["dt_min"]);
+    if (d.contains("dt_max")) o.dt_max = py::cast<double>(d["dt_max"]);
+    if (d.contains("safety")) o.safety = py::cast<double>(d["safety"]);
+    if (d.contains("min_shrink")) o.min_shrink = py::cast<double>(d["min_shrink"]);
+    if (d.contains("max_growth")) o.max_growth = py::cast<double>(d["max_growth"]);
+    if (d.contains("max_steps")) o.max_steps = py::cast<std::size_t>(d["max_steps"]);
     return o;
 }
 
+static filament::MultirateOptions parse_multirate_options(const py::dict& d) {
+    filament::MultirateOptions o;
+    if (d.contains("cfl")) o.cfl = py::cast<double>(d["cfl"]);
+    if (d.contains("lia_stability")) o.lia_stability = py::cast<double>(d["lia_stability"]);
+    if (d.contains("max_level")) o.max_level = py::cast<std::size_t>(d["max_level"]);
+    return o;
+}
+
+static filament::ImexOptions parse_imex_options(const py::dict& d) {
+    filament::ImexOptions o;
+    if (d.contains("scheme")) o.scheme = filament::imex_scheme_from_name(py::cast<std::string>(d["scheme"]));
+    if (d.contains("theta")) o.theta = py::cast<double>(d["theta"]);
+    return o;
+}
+
+static filament::RemeshOptions parse_remesh_options(const py::dict& d) {
+    filament::RemeshOptions o;
+    if (d.contains("max_turning_angle")) o.max_turning_angle = py::cast<double>(d["max_turning_angle"]);
+    if (d.contains("min_turning_angle")) o.min_turning_angle = py::cast<double>(d["min_turning_angle"]);
+    if (d.contains("max_segment_length")) o.max_segment_length = py::cast<double>(d["max_segment_length"]);
+    if (d.contains("min_segment_length")) o.min_segment_length = py::cast<double>(d["min_segment_length"]);
+    if (d.contains("min_points")) o.min_points = py::cast<std::size_t>(d["min_points"]);
+    if (d.contains("max_points")) o.max_points = py::cast<std::size_t>(d["max_points"]);
+    filament::FilamentRemesher::validate(o);
+    return o;
+}
+
+static std::vector<std::vector<Vec3>> parse_velocity_list(const py::list& vel) {
+    std::vector<std::vector<Vec3>> out;
+    for (auto v : vel) out.push_back(as_points(py::cast<py::array>(v)));
+    return out;
+}
+
+static py::dict trajectory_frame_dict(const filament::TrajectoryReader& reader, std::size_t index) {
+    const auto view = reader.frame(index);
+    py::dict diagnostics;
+    for (std::size_t k = 0; k < reader.diagnostic_names().size(); ++k)
+        diagnostics[py::str(reader.diagnostic_names()[k])] = view.diagnostics[k];
+    py::dict out("step"_a = view.step,
+                 "time"_a = view.time,
+                 "filaments"_a = filaments_to_list(reader.state(index)),
+                 "diagnostics"_a = diagnostics);
+    if (view.velocities) {
+        py::list vel;
+        for (const auto& v : reader.velocity(index)) vel.append(to_numpy(v));
+        out["velocity"] = vel;
+    }
+    return out;
+}
+
 void bind_vortexlab_kernels(py::module_& m) {
     m.def("resample_closed_curve",
           [](py::array_t<double> pts, std::size_t n) {
@@ -125,10 +226,10 @@ void bind_vortexlab_kernels(py::module_& m) {
           py::arg("curves"), py::arg("core_radius") = 0.0);
 
     m.def("compute_continuous_reach",
-          [](py::list curves) {
+          [](py::list curves, std::size_t num_threads) {
               std::vector<std::vector<Vec3>> comps;
               for (auto c : curves) comps.push_back(as_points(py::cast<py::array>(c)));
-              auto r = geometry::ContinuousReachSolver::compute(comps);
+              auto r = geometry::ContinuousReachSolver::compute(comps, num_threads);
               return py::dict(
                   "curvature_radius"_a = r.curvature_radius,
                   "self_dcsd"_a = r.self_dcsd,
@@ -140,7 +241,7 @@ void bind_vortexlab_kernels(py::module_& m) {
                   "orth_residual"_a = r.orth_residual,
                   "component_count"_a = r.component_count);
           },
-          py::arg("curves"));
+          py::arg("curves"), py::arg("num_threads") = 1);
 
     m.def("compute_filament_velocity",
           [](py::list filaments, py::dict options) {
@@ -166,22 +267,173 @@ void bind_vortexlab_kernels(py::module_& m) {
           py::arg("filaments"), py::arg("options") = py::dict());
 
     m.def("rk4_step",
-          [](py::list filaments, double dt, py::dict options) {
+          [](py::list filaments, double dt, py::dict options, std::size_t steps, py::object remesh) {
+              filament::IntegratorStepResult r;
+              r.state = parse_filaments(filaments);
+              const bool do_remesh = !remesh.is_none();
+              const auto remesh_opt = do_remesh ? parse_remesh_options(py::cast<py::dict>(remesh))
+                                                : filament::RemeshOptions{};
+              // Repeated steps reuse one stepper workspace.
+              const auto opt = parse_velocity_options(options);
+              filament::FilamentRK4Stepper stepper(opt);
+              filament::RemeshStats remeshed;
+              for (std::size_t s = 0; s < steps; ++s) {
+                  r.maximum_stage_speed = std::max(r.maximum_stage_speed, stepper.step(r.state, dt));
+                  if (do_remesh) {
+                      const auto st = filament::FilamentRemesher::remesh(r.state, remesh_opt);
+                      remeshed.inserted += st.inserted;
+                      remeshed.removed += st.removed;
+                  }
+              }
+              py::dict out("filaments"_a = filaments_to_list(r.state),
+                           "maximum_stage_speed"_a = r.maximum_stage_speed);
+              if (do_remesh) {
+                  out["inserted"] = remeshed.inserted;
+                  out["removed"] = remeshed.removed;
+              }
+              if (opt.mutual_backend == MutualInductionBackend::Cutoff) {
+                  const auto& st = stepper.workspace().neighbours.stats();
+                  out["neighbour_builds"] = st.builds;
+                  out["neighbour_pairs"] = st.pairs;
+              }
+              return out;
+          },
+          py::arg("filaments"), py::arg("dt"), py::arg("options") = py::dict(), py::arg("steps") = 1,
+          py::arg("remesh") = py::none(),
+          R"pbdoc(RK4 steps; with a remesh dict advected filaments are remeshed after every step
+(see remesh_filaments) and the result also reports inserted / removed point totals. With
+mutual_backend="cutoff" it reports the neighbour list's rebuild count and pair total.)pbdoc");
+
+    m.def("ensemble_rk4_step",
+          [](py::list members, double dt, py::object options, std::size_t steps, py::dict ensemble) {
+              std::vector<FilamentSystemState> states;
+              for (const auto& member : members) states.push_back(parse_filaments(py::cast<py::list>(member)));
+              std::vector<VelocityOptions> opts;
+              if (py::isinstance<py::dict>(options)) {
+                  opts.push_back(parse_velocity_options(py::cast<py::dict>(options)));
+              } else {
+                  for (const auto& d : py::cast<py::list>(options)) opts.push_back(parse_velocity_options(py::cast<py::dict>(d)));
+              }
+              filament::EnsembleOptions eo;
+              if (ensemble.contains("num_threads")) eo.num_threads = py::cast<std::size_t>(ensemble["num_threads"]);
+              if (ensemble.contains("lanes")) eo.lanes = py::cast<std::size_t>(ensemble["lanes"]);
+              const auto r = filament::FilamentEnsembleIntegrator(eo).rk4_steps(states, opts, dt, steps);
+              const std::size_t n = r.filament_offsets.back();
+              py::array_t<double> pts({static_cast<py::ssize_t>(n), py::ssize_t(3)});
+              std::copy(r.positions.begin(), r.positions.end(), pts.mutable_data());
+              return py::dict(
+                  "positions"_a = pts,
+                  "filament_offsets"_a = r.filament_offsets,
+                  "member_filaments"_a = r.member_filaments,
+                  "maximum_stage_speed"_a = r.maximum_stage_speed,
+                  "batched_members"_a = r.batched_members);
+          },
+          py::arg("members"), py::arg("dt"), py::arg("options") = py::dict(), py::arg("steps") = 1,
+          py::arg("ensemble") = py::dict(),
+          R"pbdoc(RK4 steps on many independent filament systems in one call. members is a list of
+filament lists; options one dict shared by all or a list with one per member. Members with the
+same layout are stepped together in vectorised lane batches (bitwise equal to rk4_step on each).
+Returns all final points packed in one (N,3) array: member m owns filaments
+member_filaments[m]..member_filaments[m+1], filament f owns rows
+filament_offsets[f]..filament_offsets[f+1]. ensemble: {num_threads (default 1, 0 = all cores), lanes}.)pbdoc");
+
+    m.def("remesh_filaments",
+          [](py::list filaments, py::dict remesh) {
               auto state = parse_filaments(filaments);
-              auto opt = parse_velocity_options(options);
-              auto r = filament::FilamentIntegrator::rk4_step(state, dt, opt);
-              py::list out;
-              for (const auto& f : r.state.filaments) {
-                  out.append(py::dict(
-                      "id"_a = f.id,
-                      "carrier"_a = f.carrier,
-                      "points"_a = to_numpy(f.points),
-                      "circulation"_a = f.circulation,
-                      "ghost"_a = f.ghost));
+              const auto st = filament::FilamentRemesher::remesh(state, parse_remesh_options(remesh));
+              return py::dict(
+                  "filaments"_a = filaments_to_list(state),
+                  "inserted"_a = st.inserted,
+                  "removed"_a = st.removed,
+                  "points"_a = st.points,
+                  "filaments_changed"_a = st.filaments_changed);
+          },
+          py::arg("filaments"), py::arg("remesh") = py::dict(),
+          R"pbdoc(Curvature-adaptive remeshing of advected filaments: split segments turning by more
+than max_turning_angle (kappa * ds) or longer than max_segment_length with periodic-spline points,
+drop points in flat (< min_turning_angle) or crowded (< min_segment_length) regions.
+remesh: {max_turning_angle, min_turning_angle, max_segment_length, min_segment_length,
+min_points, max_points}.)pbdoc");
+
+    m.def("integrate_adaptive",
+          [](py::list filaments, double t_end, py::dict options, py::dict adaptive, double t0) {
+              auto state = parse_filaments(filaments);
+              filament::FilamentAdaptiveIntegrator integrator(parse_velocity_options(options),
+                                                              parse_adaptive_options(adaptive));
+              const auto r = integrator.advance(state, t0, t_end);
+              return py::dict(
+                  "filaments"_a = filaments_to_list(state),
+                  "time"_a = r.time,
+                  "completed"_a = r.completed,
+                  "accepted_steps"_a = r.accepted_steps,
+                  "rejected_steps"_a = r.rejected_steps,
+                  "velocity_evaluations"_a = r.velocity_evaluations,
+                  "last_error_norm"_a = r.last_error_norm,
+                  "max_error_norm"_a = r.max_error_norm,
+                  "next_dt"_a = r.next_dt,
+                  "maximum_stage_speed"_a = r.maximum_stage_speed);
+          },
+          py::arg("filaments"), py::arg("t_end"), py::arg("options") = py::dict(),
+          py::arg("adaptive") = py::dict(), py::arg("t0") = 0.0,
+          R"pbdoc(Advance filaments from t0 to t_end with an error-controlled embedded Runge–Kutta pair.
+adaptive: {scheme: 'dopri5' | 'bs32', rtol, atol, dt_initial, cfl, dt_min, dt_max, safety,
+min_shrink, max_growth, max_steps}.)pbdoc");
+
+    m.def("multirate_step",
+          [](py::list filaments, double dt, py::dict options, py::dict multirate, std::size_t steps) {
+              auto state = parse_filaments(filaments);
+              filament::FilamentMultirateIntegrator integrator(parse_velocity_options(options),
+                                                               parse_multirate_options(multirate));
+              std::vector<std::size_t> substeps(state.filaments.size(), 1);
+              std::size_t evaluations = 0, targets = 0;
+              double speed = 0.0;
+              for (std::size_t s = 0; s < steps; ++s) {
+                  const auto r = integrator.step(state, dt);
+                  substeps = r.substeps;
+                  evaluations += r.velocity_evaluations;
+                  targets += r.target_evaluations;
+                  speed = std::max(speed, r.maximum_stage_speed);
+              }
+              return py::dict(
+                  "filaments"_a = filaments_to_list(state),
+                  "substeps"_a = substeps,
+                  "velocity_evaluations"_a = evaluations,
+                  "target_evaluations"_a = targets,
+                  "maximum_stage_speed"_a = speed);
+          },
+          py::arg("filaments"), py::arg("dt"), py::arg("options") = py::dict(),
+          py::arg("multirate") = py::dict(), py::arg("steps") = 1,
+          R"pbdoc(Multirate RK4 macro steps: each filament takes dt / 2^level substeps from its own
+speed and resolution. multirate: {cfl, lia_stability, max_level}. substeps reports the last step.)pbdoc");
+
+    m.def("imex_step",
+          [](py::list filaments, double dt, py::dict options, py::dict imex, std::size_t steps) {
+              auto state = parse_filaments(filaments);
+              filament::FilamentImexIntegrator integrator(parse_velocity_options(options), parse_imex_options(imex));
+              filament::ImexStepResult total;
+              for (std::size_t s = 0; s < steps; ++s) {
+                  const auto r = integrator.step(state, dt);
+                  total.maximum_mutual_speed = std::max(total.maximum_mutual_speed, r.maximum_mutual_speed);
+                  total.maximum_stage_speed = std::max(total.maximum_stage_speed, r.maximum_stage_speed);
               }
-              return py::dict("filaments"_a = out, "maximum_stage_speed"_a = r.maximum_stage_speed);
+              return py::dict(
+                  "filaments"_a = filaments_to_list(state),
+                  "maximum_mutual_speed"_a = total.maximum_mutual_speed,
+                  "maximum_stage_speed"_a = total.maximum_stage_speed);
+          },
+          py::arg("filaments"), py::arg("dt"), py::arg("options") = py::dict(),
+          py::arg("imex") = py::dict(), py::arg("steps") = 1,
+          R"pbdoc(Semi-implicit steps: the local LIA term is solved implicitly (one cyclic
+block-tridiagonal solve per filament), the mutual Biot–Savart sum stays explicit, so dt can
+follow cfl * ds / maximum_mutual_speed instead of the ~ds² LIA limit.
+imex: {scheme: 'midpoint' (2nd order, default) | 'euler', theta (euler only, 0.5..1)}.)pbdoc");
+
+    m.def("estimate_filament_dt",
+          [](py::list filaments, py::dict options, py::dict multirate) {
+              return filament::FilamentIntegrator::estimate_filament_dt(
+                  parse_filaments(filaments), parse_velocity_options(options), parse_multirate_options(multirate));
           },
-          py::arg("filaments"), py::arg("dt"), py::arg("options") = py::dict());
+          py::arg("filaments"), py::arg("options") = py::dict(), py::arg("multirate") = py::dict());
 
     m.def("estimate_cfl_dt",
           [](py::list filaments, py::dict options, double cfl) {
@@ -190,6 +442,87 @@ void bind_vortexlab_kernels(py::module_& m) {
           },
           py::arg("filaments"), py::arg("options") = py::dict(), py::arg("cfl") = 0.5);
 
+    py::class_<filament::TrajectoryWriter>(m, "FilamentTrajectoryWriter",
+                                           R"pbdoc(Append-only binary filament trajectory (.ssttraj).
+Each append streams one frame to disk; append=True continues an existing file after its last
+complete frame.)pbdoc")
+        .def(py::init([](const std::string& path, std::vector<std::string> diagnostic_names, bool append,
+                         std::size_t flush_every) {
+                 filament::TrajectoryWriterOptions o;
+                 o.append = append;
+                 o.flush_every = flush_every;
+                 return std::make_unique<filament::TrajectoryWriter>(path, diagnostic_names, o);
+             }),
+             py::arg("path"), py::arg("diagnostic_names") = std::vector<std::string>{},
+             py::arg("append") = false, py::arg("flush_every") = 1)
+        .def("append",
+             [](filament::TrajectoryWriter& w, py::list filaments, double time, std::uint64_t step,
+                py::object velocity, std::vector<double> diagnostics) {
+                 const auto state = parse_filaments(filaments);
+                 if (velocity.is_none()) {
+                     w.append(state, time, step, nullptr, diagnostics);
+                 } else {
+                     const auto vel = parse_velocity_list(py::cast<py::list>(velocity));
+                     w.append(state, time, step, &vel, diagnostics);
+                 }
+             },
+             py::arg("filaments"), py::arg("time"), py::arg("step"), py::arg("velocity") = py::none(),
+             py::arg("diagnostics") = std::vector<double>{})
+        .def("flush", &filament::TrajectoryWriter::flush)
+        .def("close", &filament::TrajectoryWriter::close)
+        .def_property_readonly("frame_count", &filament::TrajectoryWriter::frame_count)
+        .def_property_readonly("diagnostic_names", &filament::TrajectoryWriter::diagnostic_names)
+        .def("__enter__", [](filament::TrajectoryWriter& w) -> filament::TrajectoryWriter& { return w; },
+             py::return_value_policy::reference)
+        .def("__exit__", [](filament::TrajectoryWriter& w, py::args) { w.close(); });
+
+    py::class_<filament::TrajectoryReader>(m, "FilamentTrajectoryReader",
+                                           R"pbdoc(Memory-mapped random-access reader for .ssttraj files.)pbdoc")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def_property_readonly("frame_count", &filament::TrajectoryReader::frame_count)
+        .def_property_readonly("diagnostic_names", &filament::TrajectoryReader::diagnostic_names)
+        .def("__len__", &filament::TrajectoryReader::frame_count)
+        .def("frame", &trajectory_frame_dict, py::arg("index"),
+             R"pbdoc(Frame as {step, time, filaments, diagnostics[, velocity]}.)pbdoc")
+        .def("positions",
+             [](const filament::TrajectoryReader& r, std::size_t index) {
+                 const auto view = r.frame(index);
+                 py::array_t<double> pts({static_cast<py::ssize_t>(view.point_count), py::ssize_t(3)});
+                 std::copy_n(reinterpret_cast<const double*>(view.positions), 3 * view.point_count, pts.mutable_data());
+                 std::vector<std::uint64_t> offsets(view.offsets, view.offsets + view.filament_count + 1);
+                 return py::make_tuple(pts, offsets);
+             },
+             py::arg("index"), R"pbdoc(All points of a frame as one (N,3) array plus per-filament offsets.)pbdoc")
+        .def("refresh", &filament::TrajectoryReader::refresh);
+
+    m.def("save_filament_checkpoint",
+          [](const std::string& path, py::list filaments, double time, std::uint64_t step, py::dict values) {
+              filament::FilamentCheckpoint c;
+              c.state = parse_filaments(filaments);
+              c.time = time;
+              c.step = step;
+              for (auto kv : values) {
+                  c.names.push_back(py::cast<std::string>(kv.first));
+                  c.values.push_back(py::cast<double>(kv.second));
+              }
+              filament::save_filament_checkpoint(path, c);
+          },
+          py::arg("path"), py::arg("filaments"), py::arg("time"), py::arg("step") = 0,
+          py::arg("values") = py::dict(),
+          R"pbdoc(Atomically replace path with a one-frame checkpoint (values: named scalars).)pbdoc");
+
+    m.def("load_filament_checkpoint",
+          [](const std::string& path) {
+              const auto c = filament::load_filament_checkpoint(path);
+              py::dict values;
+              for (std::size_t k = 0; k < c.names.size(); ++k) values[py::str(c.names[k])] = c.values[k];
+              return py::dict("filaments"_a = filaments_to_list(c.state),
+                              "time"_a = c.time,
+                              "step"_a = c.step,
+                              "values"_a = values);
+          },
+          py::arg("path"));
+
     m.def("guard_topology_step",
           [](py::list before, py::list after, double threshold, double dmax, double core) {
               std::vector<std::vector<Vec3>> b, a;
@@ -202,6 +535,9 @@ void bind_vortexlab_kernels(py::module_& m) {
                   "safe_dt_fraction"_a = r.safe_dt_fraction,
                   "clearance_before"_a = r.clearance_before,
                   "clearance_after"_a = r.clearance_after,
+                  "swept_pairs"_a = r.swept_pairs,
+                  "hit_pair"_a = py::make_tuple(r.hit_component_a, r.hit_segment_a,
+                                                r.hit_component_b, r.hit_segment_b),
                   "message"_a = r.message);
           },
           py::arg("before"), py::arg("after"), py::arg("contact_threshold"),
@@ -13,3 +13,78 @@ def test_biot_savart_velocity_basic():
 
     v = sstcore.biot_savart_velocity(r, X, T)
     assert len(v) == 3
+
+
+def test_biot_savart_velocity_field_treecode_matches_direct():
+    if not hasattr(sstcore, "biot_savart_velocity_field"):
+        pytest.skip("biot_savart_velocity_field missing")
+    np = pytest.importorskip("numpy")
+    s = 2.0 * np.pi * np.arange(600) / 600
+    curve = np.column_stack([(2 + np.cos(3 * s)) * np.cos(2 * s),
+                             (2 + np.cos(3 * s)) * np.sin(2 * s),
+                             np.sin(3 * s)])
+    ax = 0.5 * (np.arange(8) - 4)
+    grid = np.stack(np.meshgrid(ax, ax, ax, indexing="ij"), axis=-1).reshape(-1, 3)
+
+    direct = sstcore.biot_savart_velocity_grid(curve, grid, 1.0)
+    r = sstcore.biot_savart_velocity_field(curve, grid, 1.0,
+                                           {"method": "treecode", "theta": 0.5, "tolerance": 1e-6})
+    assert r["method"] == "treecode"
+    assert r["error_estimate"] <= 1e-6
+    assert np.max(np.abs(r["velocity"] - direct)) <= 1e-6
+
+
+def test_biot_savart_velocity_field_straight_segment_kernel():
+    if not hasattr(sstcore, "biot_savart_velocity_field"):
+        pytest.skip("biot_savart_velocity_field missing")
+    np = pytest.importorskip("numpy")
+    # Regular N-gon of circumradius R: centre field is exactly N tan(pi/N) / (2 pi R) along z.
+    n, radius = 12, 1.5
+    s = 2.0 * np.pi * np.arange(n) / n
+    polygon = np.column_stack([radius * np.cos(s), radius * np.sin(s), np.zeros(n)])
+    r = sstcore.biot_savart_velocity_field(polygon, np.zeros((1, 3)), 1.0, {"kernel": "straight_segment"})
+    assert r["kernel"] == "straight_segment"
+    expected = n * np.tan(np.pi / n) / (2.0 * np.pi * radius)
+    assert abs(r["velocity"][0, 2] - expected) < 1e-13
+
+
+def test_biot_savart_velocity_particle_mesh_matches_direct():
+    if not hasattr(sstcore, "biot_savart_velocity_particle_mesh"):
+        pytest.skip("biot_savart_velocity_particle_mesh missing")
+    np = pytest.importorskip("numpy")
+    s = 2.0 * np.pi * np.arange(600) / 600
+    curve = 0.5 * np.column_stack([(2 + np.cos(3 * s)) * np.cos(2 * s),
+                                   (2 + np.cos(3 * s)) * np.sin(2 * s),
+                                   np.sin(3 * s)])
+    origin, h, n = (-1.15, -1.15, -1.15), 0.1, 24
+    ax = origin[0] + h * np.arange(n)
+    grid = np.stack(np.meshgrid(ax, ax, ax, indexing="ij"), axis=-1).reshape(-1, 3)
+
+    direct = sstcore.biot_savart_velocity_grid(curve, grid, 1.0)
+    r = sstcore.biot_savart_velocity_particle_mesh(curve, origin, h, (n, n, n), 1.0)
+    assert r["velocity"].shape == (n, n, n, 3)
+    assert r["near_interactions"] > 0
+    err = np.linalg.norm(r["velocity"].reshape(-1, 3) - direct) / np.linalg.norm(direct)
+    assert err < 1e-3
+
+
+def test_biot_savart_velocity_batch_matches_single_calls():
+    if not hasattr(sstcore, "biot_savart_velocity_batch"):
+        pytest.skip("biot_savart_velocity_batch missing")
+    np = pytest.importorskip("numpy")
+    s = 2.0 * np.pi * np.arange(300) / 300
+    curves = [np.column_stack([r * np.cos(s), r * np.sin(s), np.full_like(s, z)])
+              for r, z in ((1.0, 0.0), (0.6, 0.3), (1.4, -0.2))]
+    circ = [1.0, -0.5, 2.0]
+    ax = 0.5 * (np.arange(6) - 3)
+    grid = np.stack(np.meshgrid(ax, ax, ax, indexing="ij"), axis=-1).reshape(-1, 3)
+
+    fields = sstcore.biot_savart_velocity_batch(curves, grid, circ)
+    total = sstcore.biot_savart_velocity_batch(curves, grid, circ, superpose=True)
+    singles = [sstcore.biot_savart_velocity_grid(c, grid, g) for c, g in zip(curves, circ)]
+    for f, ref in zip(fields, singles):
+        assert np.array_equal(f, ref)
+    assert np.allclose(total, sum(singles), rtol=0, atol=1e-14)
+
+    inv = sstcore.biot_savart_invariants_batch(curves, (-1.5, -1.5, -1.5), 0.25, (13, 13, 13), 3, circ)
+    assert len(inv) == 3
@@ -0,0 +1,367 @@
+#include "../src/biot_savart.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+std::vector<sst::Vec3> trefoil(std::size_t n) {
+    std::vector<sst::Vec3> pts;
+    pts.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double s = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(n);
+        pts.push_back({(2.0 + std::cos(3.0 * s)) * std::cos(2.0 * s),
+                       (2.0 + std::cos(3.0 * s)) * std::sin(2.0 * s),
+                       std::sin(3.0 * s)});
+    }
+    return pts;
+}
+
+std::vector<sst::Vec3> cubic_grid(int n, double spacing) {
+    std::vector<sst::Vec3> grid;
+    grid.reserve(static_cast<std::size_t>(n * n * n));
+    const int half = n / 2;
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            for (int k = 0; k < n; ++k)
+                grid.push_back({spacing * (i - half), spacing * (j - half), spacing * (k - half)});
+    return grid;
+}
+
+double max_abs_diff(const std::vector<sst::Vec3>& a, const std::vector<sst::Vec3>& b) {
+    assert(a.size() == b.size());
+    double m = 0.0;
+    for (std::size_t i = 0; i < a.size(); ++i)
+        for (int c = 0; c < 3; ++c) m = std::max(m, std::abs(a[i][c] - b[i][c]));
+    return m;
+}
+
+// Historical segment-outer / grid-inner loop, kept verbatim as the bitwise reference.
+std::vector<sst::Vec3> segment_outer(const std::vector<sst::Vec3>& curve, const std::vector<sst::Vec3>& grid,
+                                     double gamma) {
+    std::vector<sst::Vec3> vel(grid.size(), {0.0, 0.0, 0.0});
+    const std::size_t N = curve.size();
+    for (std::size_t i = 0; i < N; ++i) {
+        const sst::Vec3& r0 = curve[i];
+        const sst::Vec3& r1 = curve[(i + 1) % N];
+        const sst::Vec3 dl = {r1[0] - r0[0], r1[1] - r0[1], r1[2] - r0[2]};
+        const sst::Vec3 mid = {0.5 * (r0[0] + r1[0]), 0.5 * (r0[1] + r1[1]), 0.5 * (r0[2] + r1[2])};
+        for (std::size_t g = 0; g < grid.size(); ++g) {
+            const sst::Vec3 R = {grid[g][0] - mid[0], grid[g][1] - mid[1], grid[g][2] - mid[2]};
+            const double normR = std::pow(R[0] * R[0] + R[1] * R[1] + R[2] * R[2], 1.5) + 1e-12;
+            vel[g][0] += (dl[1] * R[2] - dl[2] * R[1]) / normR;
+            vel[g][1] += (dl[2] * R[0] - dl[0] * R[2]) / normR;
+            vel[g][2] += (dl[0] * R[1] - dl[1] * R[0]) / normR;
+        }
+    }
+    const double factor = gamma / (4.0 * M_PI);
+    for (auto& v : vel) {
+        v[0] *= factor; v[1] *= factor; v[2] *= factor;
+    }
+    return vel;
+}
+
+// Historical all-pairs scan with one lower_bound per ordered pair.
+std::vector<double> cutoff_scan_reference(const std::vector<double>& p, const std::vector<double>& t,
+                                          const std::vector<double>& ds, const std::vector<double>& a) {
+    const std::size_t n = ds.size(), m = a.size();
+    std::vector<double> diff(m + 1, 0.0);
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = 0; j < n; ++j) {
+            if (i == j) continue;
+            const double rx = p[j * 3] - p[i * 3], ry = p[j * 3 + 1] - p[i * 3 + 1], rz = p[j * 3 + 2] - p[i * 3 + 2];
+            const double dist2 = rx * rx + ry * ry + rz * rz;
+            if (dist2 <= 0.0) continue;
+            const double dist = std::sqrt(dist2);
+            const std::size_t k = static_cast<std::size_t>(std::lower_bound(a.begin(), a.end(), dist) - a.begin());
+            if (k == 0) continue;
+            const double q = (t[i * 3] * t[j * 3] + t[i * 3 + 1] * t[j * 3 + 1] + t[i * 3 + 2] * t[j * 3 + 2]) / dist * ds[i] * ds[j];
+            diff[0] += q;
+            diff[k] -= q;
+        }
+    std::vector<double> out(m);
+    double running = 0.0;
+    for (std::size_t k = 0; k < m; ++k) {
+        running += diff[k];
+        out[k] = running / (8.0 * M_PI);
+    }
+    return out;
+}
+
+void test_cutoff_energy_scan() {
+    const std::size_t n = 1500;
+    std::vector<double> p, t, ds;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double s = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(n);
+        const double x = (2.0 + std::cos(3.0 * s)) * std::cos(2.0 * s);
+        const double y = (2.0 + std::cos(3.0 * s)) * std::sin(2.0 * s);
+        const double z = std::sin(3.0 * s);
+        const double tx = -3.0 * std::sin(3.0 * s) * std::cos(2.0 * s) - 2.0 * y;
+        const double ty = -3.0 * std::sin(3.0 * s) * std::sin(2.0 * s) + 2.0 * x;
+        const double tz = 3.0 * std::cos(3.0 * s);
+        const double l = std::sqrt(tx * tx + ty * ty + tz * tz);
+        p.insert(p.end(), {x, y, z});
+        t.insert(t.end(), {tx / l, ty / l, tz / l});
+        ds.push_back(l * 2.0 * M_PI / static_cast<double>(n));
+    }
+    p[3 * 7] = p[3 * 6]; p[3 * 7 + 1] = p[3 * 6 + 1]; p[3 * 7 + 2] = p[3 * 6 + 2];  // coincident pair
+
+    // Small cutoffs (cell-list path, with a duplicate and a zero) and cutoffs spanning the knot.
+    const std::vector<std::vector<double>> sweeps = {
+        {0.0, 1e-3, 5e-3, 5e-3, 0.01, 0.02, 0.05, 0.1, 0.2},
+        {0.01, 0.5, 1.0, 2.0, 4.0, 8.0}};
+    for (const auto& a : sweeps) {
+        const auto ref = cutoff_scan_reference(p, t, ds, a);
+        const auto fast = sst::bs_cutoff_energy_scan(p.data(), t.data(), ds.data(), n, a.data(), a.size());
+        double scale = 0.0;
+        for (double e : ref) scale = std::max(scale, std::abs(e));
+        for (std::size_t k = 0; k < a.size(); ++k) assert(std::abs(fast[k] - ref[k]) <= 1e-12 * scale);
+        for (std::size_t threads : {1u, 3u}) {
+            const auto r = sst::bs_cutoff_energy_scan(p.data(), t.data(), ds.data(), n, a.data(), a.size(), threads);
+            for (std::size_t k = 0; k < a.size(); ++k) assert(r[k] == fast[k]);
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    test_cutoff_energy_scan();
+
+    const auto curve = trefoil(1500);
+    const auto grid = cubic_grid(14, 0.45);
+    const double gamma = 1.7;
+    const auto direct = sst::BiotSavart::computeVelocity(curve, grid, gamma);
+
+    // Tiled direct sum: bitwise equal to the segment-outer loop for any thread count / tiling.
+    assert(max_abs_diff(direct, segment_outer(curve, grid, gamma)) == 0.0);
+    for (std::size_t threads : {1u, 2u, 3u, 7u}) {
+        sst::BiotSavartOptions tiled;
+        tiled.num_threads = threads;
+        tiled.grid_tile = 37;
+        tiled.segment_tile = 101;
+        const auto r = sst::BiotSavart::computeVelocity(curve, grid, gamma, tiled);
+        assert(max_abs_diff(r.velocity, direct) == 0.0);
+    }
+
+    // Treecode with theta = 0 never opens a cluster: all leaves summed directly.
+    sst::BiotSavartOptions exact;
+    exact.method = sst::BiotSavartMethod::Treecode;
+    exact.theta = 0.0;
+    const auto tree_exact = sst::BiotSavart::computeVelocity(curve, grid, gamma, exact);
+    assert(tree_exact.cluster_interactions == 0);
+    assert(tree_exact.error_estimate == 0.0);
+    assert(max_abs_diff(tree_exact.velocity, direct) < 1e-10);
+
+    // Opening angle only: error estimate bounds the deviation from the direct sum.
+    sst::BiotSavartOptions bh;
+    bh.method = sst::BiotSavartMethod::Treecode;
+    bh.theta = 0.5;
+    const auto tree = sst::BiotSavart::computeVelocity(curve, grid, gamma, bh);
+    assert(tree.cluster_interactions > 0);
+    assert(tree.direct_interactions < curve.size() * grid.size());
+    assert(max_abs_diff(tree.velocity, direct) <= tree.error_estimate);
+    assert(bh.num_threads == 1);
+    sst::BiotSavartOptions bh_parallel = bh;
+    bh_parallel.num_threads = 4;
+    const auto tree_parallel = sst::BiotSavart::computeVelocity(curve, grid, gamma, bh_parallel);
+    assert(max_abs_diff(tree_parallel.velocity, tree.velocity) == 0.0);
+    assert(tree_parallel.error_estimate == tree.error_estimate);
+    assert(tree_parallel.cluster_interactions == tree.cluster_interactions);
+
+    // User tolerance is honoured.
+    sst::BiotSavartOptions tol = bh;
+    tol.tolerance = 1e-7;
+    const auto tree_tol = sst::BiotSavart::computeVelocity(curve, grid, gamma, tol);
+    assert(tree_tol.error_estimate <= 1e-7);
+    assert(max_abs_diff(tree_tol.velocity, direct) <= 1e-7);
+
+    // Straight-segment kernel: exact for a polygon. Regular N-gon of circumradius R has the
+    // centre field N tan(π/N) Γ / (2π R) along its axis.
+    {
+        const std::size_t n = 12;
+        const double radius = 1.5;
+        std::vector<sst::Vec3> polygon;
+        for (std::size_t i = 0; i < n; ++i) {
+            const double s = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(n);
+            polygon.push_back({radius * std::cos(s), radius * std::sin(s), 0.0});
+        }
+        sst::BiotSavartOptions seg;
+        seg.kernel = sst::geometry::SegmentKernel::StraightSegment;
+        const auto centre = sst::BiotSavart::computeVelocity(polygon, {{0.0, 0.0, 0.0}}, gamma, seg);
+        const double expected = n * std::tan(M_PI / n) * gamma / (2.0 * M_PI * radius);
+        assert(std::abs(centre.velocity[0][2] - expected) < 1e-13);
+        assert(std::abs(centre.velocity[0][0]) < 1e-13 && std::abs(centre.velocity[0][1]) < 1e-13);
+
+        // Near field of a smooth curve: the exact kernel on a coarse polygon beats the midpoint
+        // rule by a wide margin against a finely resolved reference.
+        const auto fine = trefoil(24000);
+        std::vector<sst::Vec3> near;
+        for (std::size_t i = 0; i < 40; ++i) {
+            const sst::Vec3& p = fine[i * 600];
+            near.push_back({p[0] + 0.05, p[1] - 0.03, p[2] + 0.04});
+        }
+        const auto reference = sst::BiotSavart::computeVelocity(fine, near, gamma, seg).velocity;
+        const auto coarse = trefoil(300);
+        const double err_segment = max_abs_diff(sst::BiotSavart::computeVelocity(coarse, near, gamma, seg).velocity, reference);
+        const double err_midpoint = max_abs_diff(sst::BiotSavart::computeVelocity(coarse, near, gamma), reference);
+        assert(err_segment * 4.0 < err_midpoint);
+
+        // Treecode leaves use the selected kernel.
+        sst::BiotSavartOptions seg_tree = seg;
+        seg_tree.method = sst::BiotSavartMethod::Treecode;
+        seg_tree.theta = 0.0;
+        const auto seg_direct = sst::BiotSavart::computeVelocity(curve, grid, gamma, seg);
+        const auto seg_tree_r = sst::BiotSavart::computeVelocity(curve, grid, gamma, seg_tree);
+        assert(max_abs_diff(seg_tree_r.velocity, seg_direct.velocity) < 1e-10);
+
+        // Far clusters expand the straight segments, so the estimate bounds the exact direct sum.
+        for (double th : {0.3, 0.5, 0.7}) {
+            seg_tree.theta = th;
+            const auto seg_far = sst::BiotSavart::computeVelocity(curve, grid, gamma, seg_tree);
+            assert(seg_far.cluster_interactions > 0);
+            assert(max_abs_diff(seg_far.velocity, seg_direct.velocity) <= seg_far.error_estimate);
+        }
+    }
+
+    // Fused interior velocity/vorticity: central differences reproduce the full-grid pipeline bit for
+    // bit; the analytic curl matches a fine finite difference of the direct field.
+    {
+        sst::RegularGrid3D box;
+        box.origin = {{-2.6, -2.4, -1.3}};
+        box.spacing = 0.35;
+        box.shape = {{16, 15, 9}};
+        std::vector<sst::Vec3> nodes;
+        for (int i = 0; i < box.shape[0]; ++i)
+            for (int j = 0; j < box.shape[1]; ++j)
+                for (int k = 0; k < box.shape[2]; ++k)
+                    nodes.push_back({box.origin[0] + box.spacing * i, box.origin[1] + box.spacing * j,
+                                     box.origin[2] + box.spacing * k});
+        const auto full_v = sst::BiotSavart::computeVelocity(curve, nodes, gamma);
+        const auto full_w = sst::BiotSavart::computeVorticity(full_v, box.shape, box.spacing);
+        for (int margin : {0, 1, 3}) {
+            const auto v_ref = sst::BiotSavart::extractInterior(full_v, box.shape, margin);
+            const auto w_ref = sst::BiotSavart::extractInterior(full_w, box.shape, margin);
+            for (std::size_t threads : {1u, 3u}) {
+                sst::InteriorFieldOptions opt;
+                opt.num_threads = threads;
+                const auto fused = sst::BiotSavart::computeInteriorVelocityVorticity(curve, box, margin, gamma, opt);
+                assert(fused.shape[0] == box.shape[0] - 2 * margin && fused.shape[2] == box.shape[2] - 2 * margin);
+                assert(max_abs_diff(fused.velocity, v_ref) == 0.0);
+                assert(max_abs_diff(fused.vorticity, w_ref) == 0.0);
+            }
+        }
+
+        sst::InteriorFieldOptions analytic;
+        assert(analytic.num_threads == 1);  // multithreading is opt-in
+        analytic.vorticity = sst::VorticityScheme::Analytic;
+        const auto coarse = trefoil(40);
+        const auto exact = sst::BiotSavart::computeInteriorVelocityVorticity(coarse, box, 2, gamma, analytic);
+        const auto cd = sst::BiotSavart::computeInteriorVelocityVorticity(coarse, box, 2, gamma);
+        assert(max_abs_diff(exact.velocity, cd.velocity) == 0.0);
+        const int nj = exact.shape[1], nk = exact.shape[2];
+        const double delta = 1e-5;
+        double w_scale = 0.0, w_err = 0.0;
+        for (std::size_t p = 0; p < exact.vorticity.size(); p += 7) {
+            const int i = static_cast<int>(p) / (nj * nk), j = (static_cast<int>(p) / nk) % nj, k = static_cast<int>(p) % nk;
+            const sst::Vec3 x = {box.origin[0] + box.spacing * (i + 2), box.origin[1] + box.spacing * (j + 2),
+                                 box.origin[2] + box.spacing * (k + 2)};
+            std::vector<sst::Vec3> probe;
+            for (int a = 0; a < 3; ++a)
+                for (double sgn : {1.0, -1.0}) {
+                    sst::Vec3 y = x;
+                    y[a] += sgn * delta;
+                    probe.push_back(y);
+                }
+            const auto u = sst::BiotSavart::computeVelocity(coarse, probe, gamma);
+            auto d = [&](int a, int c) { return (u[2 * a][c] - u[2 * a + 1][c]) / (2.0 * delta); };
+            const sst::Vec3 w = {d(1, 2) - d(2, 1), d(2, 0) - d(0, 2), d(0, 1) - d(1, 0)};
+            for (int c = 0; c < 3; ++c) {
+                w_scale = std::max(w_scale, std::abs(w[c]));
+                w_err = std::max(w_err, std::abs(w[c] - exact.vorticity[p][c]));
+            }
+        }
+        assert(w_scale > 0.0 && w_err < 1e-6 * w_scale);
+    }
+
+    // Batched curves against one grid: each field is the single-curve call, the superposition is
+    // their in-order sum, and batch invariants equal the fused interior pipeline.
+    {
+        std::vector<std::vector<sst::Vec3>> curves;
+        for (int c = 0; c < 5; ++c) {
+            auto k = trefoil(200 + 37 * c);
+            for (auto& p : k) {
+                p[0] = 0.6 * p[0] + 0.1 * c;
+                p[1] = 0.6 * p[1] - 0.05 * c;
+                p[2] *= 0.6;
+            }
+            curves.push_back(k);
+        }
+        curves.push_back({});  // empty curves contribute nothing
+        // 0.1 does not survive a / 4π * 4π round trip; every path must receive it as given.
+        const std::vector<double> circ = {1.0, -0.5, 2.0, 0.1, 1.7, 4.0};
+        assert(circ[3] / (4.0 * M_PI) * (4.0 * M_PI) != circ[3]);
+        for (auto method : {sst::BiotSavartMethod::Direct, sst::BiotSavartMethod::Treecode})
+        for (auto kernel : {sst::geometry::SegmentKernel::Midpoint, sst::geometry::SegmentKernel::StraightSegment}) {
+            for (std::size_t threads : {1u, 4u}) {
+                sst::BiotSavartOptions opt;
+                opt.method = method;
+                opt.kernel = kernel;
+                opt.num_threads = threads;
+                opt.grid_tile = 100;
+                const auto fields = sst::BiotSavart::computeVelocityBatch(curves, grid, circ, opt);
+                const auto sum = sst::BiotSavart::computeVelocitySuperposed(curves, grid, circ, opt);
+                std::vector<sst::Vec3> expected_sum(grid.size(), {0.0, 0.0, 0.0});
+                assert(fields.size() == curves.size());
+                for (std::size_t c = 0; c < curves.size(); ++c) {
+                    const auto single = sst::BiotSavart::computeVelocity(curves[c], grid, circ[c], opt).velocity;
+                    assert(max_abs_diff(fields[c], single) == 0.0);
+                    for (std::size_t g = 0; g < grid.size(); ++g)
+                        for (int a = 0; a < 3; ++a) expected_sum[g][a] += single[g][a];
+                }
+                assert(max_abs_diff(sum, expected_sum) == 0.0);
+            }
+        }
+
+        sst::RegularGrid3D box;
+        box.origin = {{-2.0, -1.9, -1.2}};
+        box.spacing = 0.3;
+        box.shape = {{14, 13, 9}};
+        for (int margin : {0, 1, 3}) {
+            std::vector<double> r_sq;
+            for (int i = margin; i < box.shape[0] - margin; ++i)
+                for (int j = margin; j < box.shape[1] - margin; ++j)
+                    for (int k = margin; k < box.shape[2] - margin; ++k) {
+                        const double x = box.origin[0] + box.spacing * i;
+                        const double y = box.origin[1] + box.spacing * j;
+                        const double z = box.origin[2] + box.spacing * k;
+                        r_sq.push_back(x * x + y * y + z * z);
+                    }
+            for (std::size_t threads : {1u, 3u}) {
+                const auto inv = sst::BiotSavart::computeInvariantsBatch(curves, box, margin, circ, threads);
+                for (std::size_t c = 0; c + 1 < curves.size(); ++c) {
+                    const auto f = sst::BiotSavart::computeInteriorVelocityVorticity(curves[c], box, margin, circ[c]);
+                    const auto ref = sst::BiotSavart::computeInvariants(f.velocity, f.vorticity, r_sq);
+                    assert(std::get<0>(inv[c]) == std::get<0>(ref));
+                    assert(std::get<1>(inv[c]) == std::get<1>(ref));
+                    assert(std::get<2>(inv[c]) == std::get<2>(ref));
+                }
+            }
+        }
+
+        bool threw = false;
+        try {
+            sst::BiotSavart::computeVelocityBatch(curves, grid, {1.0, 2.0});
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    // Direct backend through the options overload is the historical kernel.
+    const auto via_options = sst::BiotSavart::computeVelocity(curve, grid, gamma, sst::BiotSavartOptions{});
+    assert(max_abs_diff(via_options.velocity, direct) == 0.0);
+    return 0;
+}
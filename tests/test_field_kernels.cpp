@@ -0,0 +1,193 @@
+#include "../src/field_kernels.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using sst::FieldKernelIsa;
+using sst::FieldKernelOptions;
+using sst::FieldKernels;
+using sst::Vec3;
+
+struct Grid {
+    std::vector<double> X, Y, Z;
+};
+
+// Odd point count so every ISA exercises its partial-vector tail; includes points on the wire.
+Grid make_grid(const std::vector<Vec3>& on_curve) {
+    Grid g;
+    const int n = 11;
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            for (int k = 0; k < n; ++k) {
+                g.X.push_back(-1.5 + 0.3 * i);
+                g.Y.push_back(-1.5 + 0.3 * j);
+                g.Z.push_back(-1.5 + 0.3 * k);
+            }
+    for (const Vec3& p : on_curve) {
+        g.X.push_back(p[0]);
+        g.Y.push_back(p[1]);
+        g.Z.push_back(p[2]);
+    }
+    return g;
+}
+
+bool bitwise_equal(const std::vector<double>& a, const std::vector<double>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+}
+
+double max_rel_diff(const std::vector<double>& a, const std::vector<double>& b) {
+    double scale = 0.0, m = 0.0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        scale = std::max(scale, std::abs(a[i]));
+        m = std::max(m, std::abs(a[i] - b[i]));
+    }
+    return m / scale;
+}
+
+}  // namespace
+
+int main() {
+    std::vector<Vec3> wire, positions, moments, mids;
+    for (int i = 0; i <= 96; ++i) {
+        const double s = 2.0 * M_PI * i / 96.0;
+        wire.push_back({std::cos(s), std::sin(s), 0.2 * std::sin(3.0 * s)});
+    }
+    for (int i = 0; i < 24; ++i) {
+        const double s = 2.0 * M_PI * i / 24.0;
+        positions.push_back({0.8 * std::cos(s), 0.8 * std::sin(s), 0.1});
+        moments.push_back({-std::sin(s), std::cos(s), 0.3});
+    }
+    for (std::size_t i = 0; i + 1 < wire.size(); ++i)
+        mids.push_back({0.5 * (wire[i][0] + wire[i + 1][0]), 0.5 * (wire[i][1] + wire[i + 1][1]),
+                        0.5 * (wire[i][2] + wire[i + 1][2])});
+    std::vector<Vec3> singular = mids;
+    singular.insert(singular.end(), positions.begin(), positions.end());
+    const Grid g = make_grid(singular);
+    const std::size_t n = g.X.size();
+
+    // Accumulation contract: kernels add onto the existing buffers (including -0.0 entries).
+    std::vector<double> seed(n);
+    for (std::size_t i = 0; i < n; ++i) seed[i] = (i % 7 == 0) ? -0.0 : 1e-3 * static_cast<double>(i % 5);
+
+    std::vector<double> wx = seed, wy = seed, wz = seed, dx = seed, dy = seed, dz = seed;
+    FieldKernels::biot_savart_wire_grid_reference(g.X.data(), g.Y.data(), g.Z.data(), n, wire, 1.3,
+                                                  wx.data(), wy.data(), wz.data());
+    FieldKernels::dipole_ring_field_grid_reference(g.X.data(), g.Y.data(), g.Z.data(), n, positions, moments,
+                                                   dx.data(), dy.data(), dz.data());
+
+    for (FieldKernelIsa isa : {FieldKernelIsa::Scalar, FieldKernelIsa::SSE2, FieldKernelIsa::AVX2,
+                               FieldKernelIsa::AVX512, FieldKernelIsa::Auto}) {
+        for (bool reproducible : {true, false}) {
+            FieldKernelOptions opt;
+            assert(opt.num_threads == 1);  // multithreading is opt-in
+            opt.isa = isa;
+            opt.reproducible = reproducible;
+            std::vector<double> bx = seed, by = seed, bz = seed, cx = seed, cy = seed, cz = seed;
+            FieldKernels::biot_savart_wire_grid(g.X.data(), g.Y.data(), g.Z.data(), n, wire, 1.3,
+                                                bx.data(), by.data(), bz.data(), opt);
+            FieldKernels::dipole_ring_field_grid(g.X.data(), g.Y.data(), g.Z.data(), n, positions, moments,
+                                                 cx.data(), cy.data(), cz.data(), opt);
+            if (reproducible || FieldKernels::resolve_isa(isa) == FieldKernelIsa::Scalar) {
+                assert(bitwise_equal(bx, wx) && bitwise_equal(by, wy) && bitwise_equal(bz, wz));
+                assert(bitwise_equal(cx, dx) && bitwise_equal(cy, dy) && bitwise_equal(cz, dz));
+            } else {
+                assert(max_rel_diff(bx, wx) < 1e-12 && max_rel_diff(by, wy) < 1e-12 && max_rel_diff(bz, wz) < 1e-12);
+                assert(max_rel_diff(cx, dx) < 1e-12 && max_rel_diff(cy, dy) < 1e-12 && max_rel_diff(cz, dz) < 1e-12);
+            }
+
+            // Thread count and tile shape never change the bits, in either mode.
+            for (std::size_t threads : {1u, 3u}) {
+                FieldKernelOptions tiled = opt;
+                tiled.num_threads = threads;
+                tiled.grid_tile = 50;
+                tiled.source_tile = 17;
+                std::vector<double> tx = seed, ty = seed, tz = seed, ux = seed, uy = seed, uz = seed;
+                FieldKernels::biot_savart_wire_grid(g.X.data(), g.Y.data(), g.Z.data(), n, wire, 1.3,
+                                                    tx.data(), ty.data(), tz.data(), tiled);
+                FieldKernels::dipole_ring_field_grid(g.X.data(), g.Y.data(), g.Z.data(), n, positions, moments,
+                                                     ux.data(), uy.data(), uz.data(), tiled);
+                assert(bitwise_equal(tx, bx) && bitwise_equal(ty, by) && bitwise_equal(tz, bz));
+                assert(bitwise_equal(ux, cx) && bitwise_equal(uy, cy) && bitwise_equal(uz, cz));
+            }
+        }
+    }
+
+    // Dipole treecode: theta = 0 is the direct sum; otherwise the error stays below its estimate
+    // and below the requested tolerance, independent of the thread count.
+    {
+        std::vector<Vec3> ring_pos, ring_mom;
+        for (int i = 0; i < 3000; ++i) {
+            const double s = 2.0 * M_PI * i / 3000.0;
+            ring_pos.push_back({std::cos(s), std::sin(s), 0.1 * std::sin(5.0 * s)});
+            ring_mom.push_back({0.3 * std::cos(s), 0.3 * std::sin(s), 1.0 + 0.2 * std::cos(2.0 * s)});
+        }
+        const Grid g = make_grid({ring_pos[0], ring_pos[700]});
+        const std::size_t n = g.X.size();
+        std::vector<double> rx(n, 0.0), ry(n, 0.0), rz(n, 0.0);
+        FieldKernels::dipole_ring_field_grid_reference(g.X.data(), g.Y.data(), g.Z.data(), n, ring_pos, ring_mom,
+                                                       rx.data(), ry.data(), rz.data());
+        auto max_abs = [&](const std::vector<double>& a, const std::vector<double>& b) {
+            double m = 0.0;
+            for (std::size_t i = 0; i < a.size(); ++i) m = std::max(m, std::abs(a[i] - b[i]));
+            return m;
+        };
+
+        sst::DipoleTreecodeOptions exact;
+        exact.theta = 0.0;
+        std::vector<double> ex(n, 0.0), ey(n, 0.0), ez(n, 0.0);
+        const auto s0 = FieldKernels::dipole_ring_field_grid_treecode(g.X.data(), g.Y.data(), g.Z.data(), n, ring_pos,
+                                                                      ring_mom, ex.data(), ey.data(), ez.data(), exact);
+        assert(s0.cluster_interactions == 0 && s0.direct_interactions == n * ring_pos.size());
+        assert(max_rel_diff(ex, rx) < 1e-12 && max_rel_diff(ey, ry) < 1e-12 && max_rel_diff(ez, rz) < 1e-12);
+
+        sst::DipoleTreecodeOptions tree;
+        std::vector<double> tx(n, 0.0), ty(n, 0.0), tz(n, 0.0);
+        const auto st = FieldKernels::dipole_ring_field_grid_treecode(g.X.data(), g.Y.data(), g.Z.data(), n, ring_pos,
+                                                                      ring_mom, tx.data(), ty.data(), tz.data(), tree);
+        const double err = std::max({max_abs(tx, rx), max_abs(ty, ry), max_abs(tz, rz)});
+        assert(st.cluster_interactions > 0 && st.direct_interactions < n * ring_pos.size() / 2);
+        assert(err <= st.error_estimate);
+        assert(max_rel_diff(tx, rx) < 1e-3);
+
+        sst::DipoleTreecodeOptions tol = tree;
+        tol.tolerance = 1e-7;
+        std::vector<double> ux(n, 0.0), uy(n, 0.0), uz(n, 0.0);
+        const auto su = FieldKernels::dipole_ring_field_grid_treecode(g.X.data(), g.Y.data(), g.Z.data(), n, ring_pos,
+                                                                      ring_mom, ux.data(), uy.data(), uz.data(), tol);
+        assert(su.error_estimate <= 1e-7);
+        assert(std::max({max_abs(ux, rx), max_abs(uy, ry), max_abs(uz, rz)}) <= 1e-7);
+
+        for (std::size_t threads : {1u, 3u}) {
+            sst::DipoleTreecodeOptions par = tree;
+            par.num_threads = threads;
+            par.grid_tile = 97;
+            std::vector<double> px(n, 0.0), py(n, 0.0), pz(n, 0.0);
+            FieldKernels::dipole_ring_field_grid_treecode(g.X.data(), g.Y.data(), g.Z.data(), n, ring_pos, ring_mom,
+                                                         px.data(), py.data(), pz.data(), par);
+            assert(bitwise_equal(px, tx) && bitwise_equal(py, ty) && bitwise_equal(pz, tz));
+        }
+    }
+
+    // Reference dipole: B = (3 (m·r̂) r̂ - m) / (4π |r|³); at r = (1,1,1)/2, m = ẑ: B ∝ (1, 1, 0).
+    const Vec3 B = FieldKernels::dipole_field_at_point({0.5, 0.5, 0.5}, {0.0, 0.0, 1.0});
+    const double expected = 1.0 / (4.0 * M_PI * std::pow(0.75, 1.5));
+    assert(std::abs(B[0] - expected) < 1e-14 && std::abs(B[1] - expected) < 1e-14 && std::abs(B[2]) < 1e-14);
+
+    // On axis B = 2m / (4π |r|³) and in the equatorial plane B = -m / (4π |r|³), at any distance.
+    for (double R : {0.25, 1.0, 3.0, 40.0}) {
+        const double k = 1.0 / (4.0 * M_PI * R * R * R);
+        const Vec3 axial = FieldKernels::dipole_field_at_point({0.0, 0.0, R}, {0.0, 0.0, 1.0});
+        const Vec3 equatorial = FieldKernels::dipole_field_at_point({R, 0.0, 0.0}, {0.0, 0.0, 1.0});
+        assert(std::abs(axial[2] - 2.0 * k) < 1e-14 * k && axial[0] == 0.0 && axial[1] == 0.0);
+        assert(std::abs(equatorial[2] + k) < 1e-14 * k && equatorial[0] == 0.0);
+    }
+
+    assert(FieldKernels::resolve_isa(FieldKernelIsa::Auto) == FieldKernels::detected_isa());
+    assert(FieldKernels::isa_from_name(FieldKernels::isa_name(FieldKernelIsa::AVX2)) == FieldKernelIsa::AVX2);
+    return 0;
+}
@@ -0,0 +1,1187 @@
+#include "../src/filament/ensemble.h"
+#include "../src/filament/integrator.h"
+#include "../src/filament/remesh.h"
+#include "../src/filament/trajectory.h"
+#include "../src/filament/velocity_solver.h"
+#include "../src/geometry/neighbour_list.h"
+#include "../src/geometry/polygonal_clearance.h"
+#include "../src/geometry/segment_bvh.h"
+#include "../src/geometry/swept_contact.h"
+#include "../src/topology/topology_guard.h"
+#include "../src/biot_savart.h"
+#include "sst/filament/evolution.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Counts heap allocations so the stepper's allocation-free contract can be checked.
+static std::atomic<std::size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    ++g_allocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+using sst::FilamentComponent;
+using sst::FilamentSystemState;
+using sst::Vec3;
+
+FilamentComponent trefoil(std::size_t n, double circulation, Vec3 shift) {
+    FilamentComponent f;
+    f.id = "trefoil";
+    f.circulation = circulation;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double s = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(n);
+        f.points.push_back({(2.0 + std::cos(3.0 * s)) * std::cos(2.0 * s) + shift[0],
+                            (2.0 + std::cos(3.0 * s)) * std::sin(2.0 * s) + shift[1],
+                            std::sin(3.0 * s) + shift[2]});
+    }
+    return f;
+}
+
+FilamentComponent ring(std::size_t n, double radius, double circulation, Vec3 centre) {
+    FilamentComponent f;
+    f.id = "ring";
+    f.circulation = circulation;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double s = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(n);
+        f.points.push_back({centre[0] + radius * std::cos(s), centre[1], centre[2] + radius * std::sin(s)});
+    }
+    return f;
+}
+
+FilamentSystemState tangle() {
+    FilamentSystemState state;
+    state.filaments.push_back(trefoil(900, 1.0, {0.0, 0.0, 0.0}));
+    state.filaments.push_back(ring(400, 1.2, -0.7, {2.0, 0.0, 0.0}));
+    state.filaments.push_back(ring(300, 0.8, 1.3, {-1.0, 1.5, 0.4}));
+    FilamentComponent ghost = ring(200, 0.5, 5.0, {0.0, 0.0, 3.0});
+    ghost.ghost = true;
+    state.filaments.push_back(ghost);
+    FilamentComponent passive = ring(150, 0.6, 2.0, {0.0, -3.0, 0.0});
+    passive.source = false;
+    state.filaments.push_back(passive);
+    return state;
+}
+
+double max_abs_diff(const sst::VelocityFieldResult& a, const sst::VelocityFieldResult& b) {
+    assert(a.velocity.size() == b.velocity.size());
+    double m = 0.0;
+    for (std::size_t f = 0; f < a.velocity.size(); ++f) {
+        assert(a.velocity[f].size() == b.velocity[f].size());
+        for (std::size_t i = 0; i < a.velocity[f].size(); ++i)
+            for (int c = 0; c < 3; ++c) m = std::max(m, std::abs(a.velocity[f][i][c] - b.velocity[f][i][c]));
+    }
+    return m;
+}
+
+void test_treecode_mutual_induction() {
+    const FilamentSystemState state = tangle();
+    for (double a_sim : {0.0, 0.05}) {
+        sst::VelocityOptions direct_opt;
+        direct_opt.a_sim = a_sim;
+        const auto direct = sst::filament::FilamentVelocitySolver::evaluate(state, direct_opt);
+
+        sst::VelocityOptions tree_opt = direct_opt;
+        tree_opt.mutual_backend = sst::MutualInductionBackend::Treecode;
+        tree_opt.treecode_min_segments = 0;
+
+        // theta = 0: every leaf summed directly with the historical kernel and exclusions.
+        tree_opt.treecode_theta = 0.0;
+        const auto exact = sst::filament::FilamentVelocitySolver::evaluate(state, tree_opt);
+        assert(max_abs_diff(exact, direct) < 1e-10 * direct.maximum_speed);
+
+        tree_opt.treecode_theta = 0.3;  // default opening angle
+        const auto tree = sst::filament::FilamentVelocitySolver::evaluate(state, tree_opt);
+        assert(max_abs_diff(tree, direct) < 5e-3 * direct.maximum_speed);
+        for (const Vec3& v : tree.velocity[3]) assert(v[0] == 0.0 && v[1] == 0.0 && v[2] == 0.0);
+
+        // Below the size threshold the treecode request falls back to the direct sum.
+        tree_opt.treecode_min_segments = 1u << 20;
+        const auto fallback = sst::filament::FilamentVelocitySolver::evaluate(state, tree_opt);
+        assert(max_abs_diff(fallback, direct) == 0.0);
+    }
+}
+
+void test_straight_segment_kernel() {
+    const FilamentSystemState state = tangle();
+    for (double a_sim : {0.0, 0.05}) {
+        sst::VelocityOptions opt;
+        opt.a_sim = a_sim;
+        opt.segment_kernel = sst::geometry::SegmentKernel::StraightSegment;
+        const auto direct = sst::filament::FilamentVelocitySolver::evaluate(state, opt);
+
+        sst::VelocityOptions mid = opt;
+        mid.segment_kernel = sst::geometry::SegmentKernel::Midpoint;
+        const auto midpoint = sst::filament::FilamentVelocitySolver::evaluate(state, mid);
+        const double d = max_abs_diff(direct, midpoint);
+        assert(d > 0.0 && d < 0.05 * midpoint.maximum_speed);
+
+        // Treecode leaves evaluate the same exact kernel.
+        opt.mutual_backend = sst::MutualInductionBackend::Treecode;
+        opt.treecode_min_segments = 0;
+        opt.treecode_theta = 0.0;
+        const auto tree = sst::filament::FilamentVelocitySolver::evaluate(state, opt);
+        assert(max_abs_diff(tree, direct) < 1e-10 * direct.maximum_speed);
+
+        // Far clusters expand the straight segments as well, not their midpoints.
+        opt.treecode_theta = 0.3;
+        const auto far = sst::filament::FilamentVelocitySolver::evaluate(state, opt);
+        assert(max_abs_diff(far, direct) < 1e-2 * direct.maximum_speed);
+    }
+}
+
+// Classical RK4 from whole-state evaluate calls (the historical rk4_step formulation).
+FilamentSystemState reference_rk4(const FilamentSystemState& y0, double dt, const sst::VelocityOptions& opt) {
+    const auto stage = [&](const sst::VelocityFieldResult& k, double s) {
+        FilamentSystemState y = y0;
+        for (std::size_t f = 0; f < y.filaments.size(); ++f) {
+            auto& fil = y.filaments[f];
+            if (fil.ghost || !fil.dynamic) continue;
+            for (std::size_t i = 0; i < fil.points.size(); ++i)
+                for (int c = 0; c < 3; ++c) fil.points[i][c] = fil.points[i][c] + s * k.velocity[f][i][c];
+        }
+        return y;
+    };
+    using sst::filament::FilamentVelocitySolver;
+    const auto k1 = FilamentVelocitySolver::evaluate(y0, opt);
+    const auto k2 = FilamentVelocitySolver::evaluate(stage(k1, 0.5 * dt), opt);
+    const auto k3 = FilamentVelocitySolver::evaluate(stage(k2, 0.5 * dt), opt);
+    const auto k4 = FilamentVelocitySolver::evaluate(stage(k3, dt), opt);
+    FilamentSystemState out = y0;
+    for (std::size_t f = 0; f < out.filaments.size(); ++f) {
+        auto& fil = out.filaments[f];
+        if (fil.ghost || !fil.dynamic) continue;
+        for (std::size_t i = 0; i < fil.points.size(); ++i)
+            for (int c = 0; c < 3; ++c)
+                fil.points[i][c] += (dt / 6.0) * (k1.velocity[f][i][c] + 2.0 * k2.velocity[f][i][c]
+                                                  + 2.0 * k3.velocity[f][i][c] + k4.velocity[f][i][c]);
+    }
+    return out;
+}
+
+void test_rk4_stepper() {
+    FilamentSystemState state;
+    state.filaments.push_back(ring(120, 1.0, 1.0, {0.0, 0.0, 0.0}));
+    state.filaments.push_back(ring(90, 0.7, -0.5, {0.3, 0.2, 0.1}));
+    state.filaments[1].dynamic = false;
+    FilamentComponent ghost = ring(40, 0.4, 2.0, {0.0, 1.0, 0.0});
+    ghost.ghost = true;
+    state.filaments.push_back(ghost);
+
+    sst::VelocityOptions opt;
+    opt.a_sim = 0.02;
+    const double dt = 2e-3;
+    sst::filament::FilamentRK4Stepper stepper(opt);
+    FilamentSystemState y = state;
+    stepper.step(y, dt);
+    const FilamentSystemState ref = reference_rk4(state, dt, opt);
+    for (std::size_t f = 0; f < y.filaments.size(); ++f)
+        for (std::size_t i = 0; i < y.filaments[f].points.size(); ++i)
+            assert(y.filaments[f].points[i] == ref.filaments[f].points[i]);
+    assert(y.filaments[1].points == state.filaments[1].points);
+
+    // Later steps on the same layout do not touch the heap; rk4_step is the one-shot form.
+    const auto once = sst::filament::FilamentIntegrator::rk4_step(y, dt, opt);
+    const std::size_t before = g_allocations.load();
+    const double speed = stepper.step(y, dt);
+    assert(speed == once.maximum_stage_speed);
+    assert(y.filaments[0].points == once.state.filaments[0].points);
+    for (int s = 0; s < 20; ++s) stepper.step(y, dt);
+    assert(g_allocations.load() == before);
+    for (const Vec3& p : y.filaments[0].points) assert(std::isfinite(p[0] + p[1] + p[2]));
+}
+
+void test_adaptive_integrator() {
+    FilamentSystemState state;
+    state.filaments.push_back(ring(48, 1.0, 1.0, {0.0, 0.0, 0.0}));
+    state.filaments.push_back(ring(40, 0.8, 0.6, {0.2, 1.2, 0.0}));
+    state.filaments.push_back(ring(32, 0.5, 1.0, {3.0, 0.0, 0.0}));
+    state.filaments[2].dynamic = false;
+
+    sst::VelocityOptions opt;
+    opt.a_sim = 0.02;
+    const double T = 0.5;
+    FilamentSystemState ref = state;
+    sst::filament::FilamentRK4Stepper fine(opt);
+    for (int s = 0; s < 1000; ++s) fine.step(ref, T / 1000);
+
+    using sst::filament::EmbeddedScheme;
+    for (EmbeddedScheme scheme : {EmbeddedScheme::DormandPrince54, EmbeddedScheme::BogackiShampine32}) {
+        sst::filament::AdaptiveStepOptions ao;
+        ao.scheme = scheme;
+        ao.rtol = 1e-7;
+        ao.atol = 1e-9;
+        sst::filament::FilamentAdaptiveIntegrator integrator(opt, ao);
+        FilamentSystemState y = state;
+        const auto r = integrator.advance(y, 0.0, 0.5 * T);
+        assert(r.completed && r.time == 0.5 * T);
+        assert(r.max_error_norm <= 1.0 && r.next_dt > 0.0);
+        // FSAL: one start-up evaluation, then stages - 1 per attempt.
+        const std::size_t per_step = scheme == EmbeddedScheme::DormandPrince54 ? 6 : 3;
+        assert(r.velocity_evaluations == 1 + per_step * (r.accepted_steps + r.rejected_steps));
+
+        // The second leg continues with the carried-over step size.
+        const auto r2 = integrator.advance(y, 0.5 * T, T);
+        assert(r2.completed && r2.time == T);
+        double err = 0.0;
+        for (std::size_t f = 0; f < y.filaments.size(); ++f)
+            for (std::size_t i = 0; i < y.filaments[f].points.size(); ++i)
+                for (int c = 0; c < 3; ++c)
+                    err = std::max(err, std::abs(y.filaments[f].points[i][c] - ref.filaments[f].points[i][c]));
+        assert(err < 1e-5);
+        assert(y.filaments[2].points == state.filaments[2].points);
+        assert(r.accepted_steps + r2.accepted_steps < 50);
+    }
+
+    bool threw = false;
+    try {
+        sst::filament::AdaptiveStepOptions bad;
+        bad.rtol = 0.0;
+        bad.atol = 0.0;
+        sst::filament::FilamentAdaptiveIntegrator integrator(opt, bad);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+void test_thread_invariance() {
+    const FilamentSystemState state = tangle();
+    for (int variant = 0; variant < 3; ++variant) {
+        sst::VelocityOptions opt;
+        opt.a_sim = 0.03;
+        if (variant == 1) {
+            opt.mutual_backend = sst::MutualInductionBackend::Treecode;
+            opt.treecode_min_segments = 0;
+        }
+        if (variant == 2) opt.segment_kernel = sst::geometry::SegmentKernel::StraightSegment;
+        const auto serial = sst::filament::FilamentVelocitySolver::evaluate(state, opt);
+        for (std::size_t threads : {2u, 3u, 8u, 0u}) {
+            opt.num_threads = threads;
+            const auto par = sst::filament::FilamentVelocitySolver::evaluate(state, opt);
+            assert(par.maximum_speed == serial.maximum_speed);
+            for (std::size_t f = 0; f < serial.velocity.size(); ++f) assert(par.velocity[f] == serial.velocity[f]);
+        }
+    }
+}
+
+double max_point_diff(const FilamentSystemState& a, const FilamentSystemState& b) {
+    double m = 0.0;
+    for (std::size_t f = 0; f < a.filaments.size(); ++f)
+        for (std::size_t i = 0; i < a.filaments[f].points.size(); ++i)
+            for (int c = 0; c < 3; ++c)
+                m = std::max(m, std::abs(a.filaments[f].points[i][c] - b.filaments[f].points[i][c]));
+    return m;
+}
+
+void test_multirate_integrator() {
+    // Two coarse slow rings and two small fast ones.
+    FilamentSystemState state;
+    state.filaments.push_back(ring(100, 1.5, 1.0, {0.0, 0.0, 0.0}));
+    state.filaments.push_back(ring(90, 1.3, -0.8, {0.0, 1.0, 0.0}));
+    state.filaments.push_back(ring(16, 0.05, 0.5, {0.0, 0.5, 0.3}));
+    state.filaments.push_back(ring(16, 0.05, 0.5, {0.4, 0.5, -0.3}));
+    sst::VelocityOptions opt;
+    opt.a_sim = 0.01;
+
+    // One level: the classical RK4 step.
+    {
+        sst::filament::MultirateOptions one;
+        one.max_level = 0;
+        sst::filament::FilamentMultirateIntegrator mr(opt, one);
+        sst::filament::FilamentRK4Stepper rk4(opt);
+        FilamentSystemState a = state, b = state;
+        mr.step(a, 1e-3);
+        rk4.step(b, 1e-3);
+        assert(max_point_diff(a, b) == 0.0);
+    }
+
+    const auto local = sst::filament::FilamentIntegrator::estimate_filament_dt(state, opt);
+    const double dt_fast = std::min(local[2], local[3]);
+    const double dt_slow = std::max(local[0], local[1]);
+    assert(dt_slow > 4.0 * dt_fast);
+
+    const double T = 4.0 * dt_slow;
+    FilamentSystemState ref = state;
+    sst::filament::FilamentRK4Stepper fine(opt);
+    const int n_fine = static_cast<int>(std::ceil(T / (0.25 * dt_fast)));
+    for (int s = 0; s < n_fine; ++s) fine.step(ref, T / n_fine);
+
+    FilamentSystemState global = state;
+    sst::filament::FilamentRK4Stepper rk4(opt);
+    const int n_global = static_cast<int>(std::ceil(T / dt_fast));
+    for (int s = 0; s < n_global; ++s) rk4.step(global, T / n_global);
+    const std::size_t global_targets = static_cast<std::size_t>(n_global) * 4 * (100 + 90 + 16 + 16);
+
+    FilamentSystemState y = state;
+    sst::filament::FilamentMultirateIntegrator mr(opt);
+    std::size_t targets = 0;
+    for (int s = 0; s < 4; ++s) {
+        const auto r = mr.step(y, T / 4);
+        assert(r.substeps[0] < r.substeps[2] && r.substeps[3] >= 4);
+        targets += r.target_evaluations;
+    }
+    const double err_global = max_point_diff(global, ref);
+    const double err_mr = max_point_diff(y, ref);
+    assert(err_mr < 10.0 * err_global + 1e-9);
+    assert(2 * targets < global_targets);
+}
+
+void test_remesh() {
+    using sst::filament::FilamentRemesher;
+    using sst::filament::RemeshOptions;
+    using sst::filament::RemeshStats;
+    RemeshOptions opt;
+
+    // Coarse trefoil: every segment is split until it turns by at most max_turning_angle, the
+    // original points are kept in order, and new points sit on the smooth curve.
+    const FilamentComponent coarse = trefoil(24, 1.0, {0.0, 0.0, 0.0});
+    RemeshStats stats;
+    const std::vector<Vec3> refined = FilamentRemesher::remesh_points(coarse.points, opt, &stats);
+    assert(stats.removed == 0 && stats.inserted > 0);
+    assert(refined.size() == coarse.points.size() + stats.inserted);
+    std::size_t next = 0;
+    for (const Vec3& p : refined) {
+        if (next < coarse.points.size() && p == coarse.points[next]) ++next;
+    }
+    assert(next == coarse.points.size());
+    const FilamentComponent fine = trefoil(4096, 1.0, {0.0, 0.0, 0.0});
+    for (const Vec3& p : refined) {
+        double d = 1e300;
+        for (const Vec3& q : fine.points) d = std::min(d, sst::norm(sst::diff(p, q)));
+        assert(d < 0.05);
+    }
+
+    // Over-resolved rings coarsen over repeated calls to a count set by the turning bound,
+    // independent of the radius; a ring's inserted points stay on the circle.
+    FilamentSystemState state;
+    state.filaments.push_back(ring(1200, 2.0, 1.0, {0.0, 0.0, 0.0}));
+    state.filaments.push_back(ring(1200, 0.1, 1.0, {5.0, 0.0, 0.0}));
+    FilamentComponent ghost = ring(1200, 0.5, 1.0, {0.0, 5.0, 0.0});
+    ghost.ghost = true;
+    state.filaments.push_back(ghost);
+    for (int pass = 0; pass < 8; ++pass) FilamentRemesher::remesh(state, opt);
+    const std::size_t big = state.filaments[0].points.size();
+    const std::size_t small = state.filaments[1].points.size();
+    assert(big == small);
+    assert(2.0 * 2.0 * M_PI / static_cast<double>(big) >= 0.5 * opt.min_turning_angle);
+    assert(2.0 * M_PI / static_cast<double>(big) <= opt.max_turning_angle);
+    assert(state.filaments[2].points.size() == 1200);
+
+    const std::vector<Vec3> circle = ring(12, 1.0, 1.0, {0.0, 0.0, 0.0}).points;
+    for (const Vec3& p : FilamentRemesher::remesh_points(circle, opt)) {
+        assert(std::abs(std::hypot(p[0], p[2]) - 1.0) < 1e-3);
+    }
+
+    // Stretch and point-count bounds.
+    opt.max_segment_length = 0.05;
+    const std::vector<Vec3> stretched = FilamentRemesher::remesh_points(circle, opt);
+    for (std::size_t i = 0; i < stretched.size(); ++i) {
+        assert(sst::norm(sst::diff(stretched[(i + 1) % stretched.size()], stretched[i])) <= 0.05 + 1e-9);
+    }
+    opt.max_points = 64;
+    assert(FilamentRemesher::remesh_points(circle, opt).size() <= 64);
+    opt = RemeshOptions{};
+    opt.min_points = 40;
+    assert(FilamentRemesher::remesh_points(ring(48, 1.0, 1.0, {0, 0, 0}).points, opt).size() >= 40);
+    // Both bounds hold even when coarsening alone cannot meet them: a dense, sharply turning
+    // curve is thinned to max_points, and a sparse one is filled up to min_points.
+    opt = RemeshOptions{};
+    opt.min_points = 4;
+    opt.max_points = 16;
+    const std::vector<Vec3> dense = trefoil(400, 1.0, {0.0, 0.0, 0.0}).points;
+    stats = RemeshStats{};
+    const std::vector<Vec3> thinned = FilamentRemesher::remesh_points(dense, opt, &stats);
+    assert(thinned.size() == 16 && stats.points == 16);
+    assert(thinned.front() == dense.front());
+    opt = RemeshOptions{};
+    opt.max_turning_angle = 100.0;
+    opt.min_points = 30;
+    const std::vector<Vec3> square = {{1, 0, 0}, {0, 1, 0}, {-1, 0, 0}, {0, -1, 0}, {1, 0.1, 0}};
+    const std::vector<Vec3> filled = FilamentRemesher::remesh_points(square, opt);
+    assert(filled.size() == 30);
+    next = 0;
+    for (const Vec3& p : filled) {
+        if (next < square.size() && p == square[next]) ++next;
+    }
+    assert(next == square.size());
+    opt.min_points = 3;
+    bool threw = false;
+    try {
+        FilamentRemesher::remesh_points(circle, opt);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Remeshing between steps: the stepper rebinds to the new layout.
+    FilamentSystemState evolving;
+    evolving.filaments.push_back(trefoil(64, 1.0, {0.0, 0.0, 0.0}));
+    sst::filament::FilamentRK4Stepper stepper;
+    for (int s = 0; s < 3; ++s) {
+        stepper.step(evolving, 1e-3);
+        FilamentRemesher::remesh(evolving, RemeshOptions{});
+    }
+    for (const Vec3& p : evolving.filaments[0].points) assert(std::isfinite(p[0] + p[1] + p[2]));
+}
+
+void test_filament_evolution_modes() {
+    using sst::FilamentEvolution;
+    using sst::FilamentEvolutionOptions;
+    using sst::FilamentTimeScheme;
+    using sst::FilamentVelocityModel;
+
+    // Default options reproduce the original Euler + full Biot–Savart loop bit for bit.
+    FilamentEvolution ev = FilamentEvolution::make_trefoil(120);
+    std::vector<Vec3> x = ev.positions();
+    std::vector<Vec3> t = ev.tangents();
+    const double dt = 1e-3;
+    for (int step = 0; step < 3; ++step) {
+        std::vector<Vec3> v;
+        for (const Vec3& p : x) v.push_back(sst::biot_savart_velocity(p, x, t, 1.0));
+        for (std::size_t i = 0; i < x.size(); ++i)
+            for (std::size_t d = 0; d < 3; ++d) x[i][d] += dt * v[i][d];
+        const std::size_t n = x.size();
+        for (std::size_t i = 0; i < n; ++i)
+            for (std::size_t d = 0; d < 3; ++d) t[i][d] = (x[(i + 1) % n][d] - x[(i + n - 1) % n][d]) * 0.5;
+    }
+    ev.evolve(dt, 3);
+    assert(ev.positions() == x);
+
+    // LIA and an all-covering cutoff match the filament velocity solver on one filament.
+    FilamentSystemState state;
+    state.filaments.push_back(trefoil(120, 1.0, {0.0, 0.0, 0.0}));
+    ev = FilamentEvolution::make_trefoil(120);
+    sst::VelocityOptions vopt;
+    vopt.core_radius = 0.02;
+    FilamentEvolutionOptions opt;
+    opt.core_radius = 0.02;
+    for (const bool lia : {true, false}) {
+        vopt.lia_only = lia;
+        opt.model = lia ? FilamentVelocityModel::LocalInduction : FilamentVelocityModel::CutoffBiotSavart;
+        opt.cutoff_arclength = 1e3;
+        ev.set_options(opt);
+        const auto ref = sst::filament::FilamentVelocitySolver::evaluate(state, vopt);
+        const std::vector<Vec3> v = ev.velocity();
+        for (std::size_t i = 0; i < v.size(); ++i)
+            assert(sst::norm(sst::diff(v[i], ref.velocity[0][i])) <= 1e-10 * ref.maximum_speed);
+    }
+
+    // Shrinking the window drops more of the far field.
+    opt.model = FilamentVelocityModel::CutoffBiotSavart;
+    opt.cutoff_arclength = 1e3;
+    ev.set_options(opt);
+    const std::vector<Vec3> full = ev.velocity();
+    const auto deviation = [&](double cutoff) {
+        opt.cutoff_arclength = cutoff;
+        ev.set_options(opt);
+        const std::vector<Vec3> v = ev.velocity();
+        double m = 0.0;
+        for (std::size_t i = 0; i < v.size(); ++i) m = std::max(m, sst::norm(sst::diff(full[i], v[i])));
+        return m;
+    };
+    assert(deviation(8.0) > 0.0 && deviation(8.0) < deviation(1.0));
+
+    // Higher-order schemes converge faster towards a fine RK4 reference.
+    const auto run = [&](FilamentTimeScheme scheme, double h, std::size_t steps) {
+        FilamentEvolution e = FilamentEvolution::make_trefoil(96);
+        FilamentEvolutionOptions o;
+        o.model = FilamentVelocityModel::LocalInduction;
+        o.scheme = scheme;
+        e.set_options(o);
+        e.evolve(h, steps);
+        return e.positions();
+    };
+    const auto err = [](const std::vector<Vec3>& a, const std::vector<Vec3>& b) {
+        double m = 0.0;
+        for (std::size_t i = 0; i < a.size(); ++i) m = std::max(m, sst::norm(sst::diff(a[i], b[i])));
+        return m;
+    };
+    const std::vector<Vec3> fine = run(FilamentTimeScheme::RK4, 1e-4, 200);
+    const double e_euler = err(run(FilamentTimeScheme::Euler, 1e-3, 20), fine);
+    const double e_rk2 = err(run(FilamentTimeScheme::RK2, 1e-3, 20), fine);
+    const double e_rk4 = err(run(FilamentTimeScheme::RK4, 1e-3, 20), fine);
+    assert(e_rk4 < e_rk2 && e_rk2 < e_euler);
+
+    // Repeated evolve calls reuse the member buffers.
+    opt.scheme = FilamentTimeScheme::RK4;
+    opt.cutoff_arclength = 1.0;
+    ev.set_options(opt);
+    ev.evolve(1e-4, 1);
+    const std::size_t before = g_allocations.load();
+    ev.evolve(1e-4, 5);
+    opt.model = FilamentVelocityModel::LocalInduction;
+    ev.set_options(opt);
+    ev.evolve(1e-4, 5);
+    assert(g_allocations.load() == before);
+
+    opt.core_radius = 0.0;
+    bool threw = false;
+    try {
+        ev.set_options(opt);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+void test_trajectory_io() {
+    using namespace sst::filament;
+    namespace fs = std::filesystem;
+    const std::string path = (fs::temp_directory_path() / "sst_test_trajectory.ssttraj").string();
+    const std::string ckpt = (fs::temp_directory_path() / "sst_test_checkpoint.ssttraj").string();
+
+    FilamentSystemState state;
+    state.filaments.push_back(ring(40, 1.0, 1.0, {0.0, 0.0, 0.0}));
+    state.filaments.push_back(ring(25, 0.5, -0.3, {0.1, 1.0, 0.0}));
+    state.filaments[1].id = "satellite";
+    state.filaments[1].carrier = "B";
+    state.filaments[1].dynamic = false;
+    FilamentComponent ghost = ring(7, 0.2, 2.0, {0.0, 0.0, 2.0});
+    ghost.ghost = true;
+    ghost.source = false;
+    state.filaments.push_back(ghost);
+
+    // Stream frames while stepping; frame 1 carries the velocity channel.
+    std::vector<FilamentSystemState> frames;
+    std::vector<std::vector<Vec3>> v1;
+    {
+        TrajectoryWriter writer(path, {"speed", "energy"});
+        FilamentRK4Stepper stepper;
+        for (std::uint64_t s = 0; s < 3; ++s) {
+            const double speed = stepper.step(state, 1e-3);
+            frames.push_back(state);
+            if (s == 1) {
+                v1 = FilamentVelocitySolver::evaluate(state, {}).velocity;
+                writer.append(state, 1e-3 * static_cast<double>(s + 1), s + 1, &v1, {speed, -1.0});
+            } else {
+                writer.append(state, 1e-3 * static_cast<double>(s + 1), s + 1, nullptr, {speed, -1.0});
+            }
+        }
+        bool threw = false;
+        try {
+            writer.append(state, 0.0, 0, nullptr, {1.0});
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    {
+        TrajectoryReader reader(path);
+        assert(reader.frame_count() == 3);
+        assert((reader.diagnostic_names() == std::vector<std::string>{"speed", "energy"}));
+        for (std::size_t i = 0; i < 3; ++i) {
+            const FilamentSystemState back = reader.state(i);
+            assert(back.filaments.size() == 3);
+            for (std::size_t f = 0; f < 3; ++f) {
+                const auto& a = back.filaments[f];
+                const auto& b = frames[i].filaments[f];
+                assert(a.points == b.points && a.id == b.id && a.carrier == b.carrier);
+                assert(a.circulation == b.circulation && a.dynamic == b.dynamic);
+                assert(a.source == b.source && a.ghost == b.ghost);
+            }
+            const TrajectoryFrameView view = reader.frame(i);
+            assert(view.step == i + 1 && view.point_count == 72 && view.diagnostics[1] == -1.0);
+            assert((view.velocities != nullptr) == (i == 1));
+        }
+        assert(reader.velocity(1) == v1);
+        assert(reader.velocity(0).empty());
+    }
+
+    // A torn final frame is ignored, and append mode truncates it before continuing.
+    const auto full_size = fs::file_size(path);
+    fs::resize_file(path, full_size - 100);
+    {
+        TrajectoryReader reader(path);
+        assert(reader.frame_count() == 2);
+    }
+    {
+        TrajectoryWriterOptions opt;
+        opt.append = true;
+        TrajectoryWriter writer(path, {"speed", "energy"}, opt);
+        assert(writer.frame_count() == 2);
+        TrajectoryReader live(path);
+        assert(live.frame_count() == 2);
+        writer.append(frames[2], 3e-3, 3, nullptr, {0.0, -1.0});
+        writer.flush();
+        assert(live.refresh() == 3);
+        assert(live.state(2).filaments[0].points == frames[2].filaments[0].points);
+
+        // A failed remap leaves no frames pointing into the old mapping.
+        writer.close();
+        fs::rename(path, path + ".moved");
+        bool threw = false;
+        try {
+            live.refresh();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw && live.frame_count() == 0 && live.valid_bytes() == 0);
+        threw = false;
+        try {
+            live.frame(0);
+        } catch (const std::out_of_range&) {
+            threw = true;
+        }
+        assert(threw);
+        fs::rename(path + ".moved", path);
+        assert(live.refresh() == 3);
+    }
+
+    // A frame whose id/carrier lengths overrun its metadata block is not indexed.
+    {
+        const std::string corrupt = path + ".corrupt";
+        fs::copy_file(path, corrupt, fs::copy_options::overwrite_existing);
+        std::uint32_t header_bytes = 0;
+        std::FILE* f = std::fopen(corrupt.c_str(), "r+b");
+        assert(f);
+        std::fseek(f, 16, SEEK_SET);
+        assert(std::fread(&header_bytes, sizeof(header_bytes), 1, f) == 1);
+        // Frame header (64 bytes), 3 + 1 offsets, then the first record's id_bytes at +12.
+        const std::uint32_t huge = 0xFFFFFFFFu;
+        std::fseek(f, static_cast<long>(header_bytes + 64 + 4 * 8 + 12), SEEK_SET);
+        assert(std::fwrite(&huge, sizeof(huge), 1, f) == 1);
+        std::fclose(f);
+        TrajectoryReader reader(corrupt);
+        assert(reader.frame_count() == 0);
+        fs::remove(corrupt);
+    }
+
+    // Checkpoints round-trip and replace the previous one.
+    FilamentCheckpoint c;
+    c.state = frames[0];
+    c.time = 0.5;
+    c.step = 500;
+    c.names = {"next_dt"};
+    c.values = {1.25e-3};
+    save_filament_checkpoint(ckpt, c);
+    c.state = frames[2];
+    c.step = 501;
+    save_filament_checkpoint(ckpt, c);
+    const FilamentCheckpoint r = load_filament_checkpoint(ckpt);
+    assert(r.step == 501 && r.time == 0.5 && r.values == c.values && r.names == c.names);
+    assert(r.state.filaments[1].points == frames[2].filaments[1].points);
+    assert(!fs::exists(ckpt + ".tmp"));
+
+    fs::remove(path);
+    fs::remove(ckpt);
+}
+
+void test_ensemble_stepping() {
+    using sst::filament::EnsembleOptions;
+    using sst::filament::EnsembleStepResult;
+    using sst::filament::FilamentEnsembleIntegrator;
+
+    // Five members of one layout (moving ring, static ring, ghost) with per-member physics, a
+    // differently sized member and one on the straight-segment kernel (stepped on its own).
+    std::vector<FilamentSystemState> members;
+    std::vector<sst::VelocityOptions> options;
+    for (int m = 0; m < 5; ++m) {
+        FilamentSystemState s;
+        s.filaments.push_back(ring(48, 1.0 + 0.05 * m, 1.0 - 0.1 * m, {0.0, 0.01 * m, 0.0}));
+        s.filaments.push_back(ring(30, 0.6, -0.4 + 0.2 * m, {0.2, 0.3, 0.1}));
+        s.filaments[1].dynamic = false;
+        FilamentComponent ghost = ring(20, 0.4, 2.0, {0.0, 1.0, 0.0});
+        ghost.ghost = true;
+        s.filaments.push_back(ghost);
+        members.push_back(s);
+        sst::VelocityOptions opt;
+        opt.a_sim = 0.01 * m;
+        opt.core_radius = 0.01 + 0.002 * m;
+        opt.core_delta = 0.1 * m;
+        opt.lia_constant = 0.25 + 0.05 * m;
+        options.push_back(opt);
+    }
+    FilamentSystemState other;
+    other.filaments.push_back(trefoil(60, 1.0, {0.0, 0.0, 0.0}));
+    members.push_back(other);
+    options.emplace_back();
+    members.push_back(members[0]);
+    options.push_back(options[0]);
+    options.back().segment_kernel = sst::geometry::SegmentKernel::StraightSegment;
+
+    const double dt = 2e-3;
+    const std::size_t steps = 3;
+    std::vector<FilamentSystemState> expected = members;
+    std::vector<double> expected_speed(members.size(), 0.0);
+    for (std::size_t m = 0; m < members.size(); ++m) {
+        sst::filament::FilamentRK4Stepper stepper(options[m]);
+        for (std::size_t s = 0; s < steps; ++s) expected_speed[m] = std::max(expected_speed[m], stepper.step(expected[m], dt));
+    }
+
+    const auto run = [&](const EnsembleOptions& eo) {
+        std::vector<FilamentSystemState> ys = members;
+        const EnsembleStepResult r = FilamentEnsembleIntegrator(eo).rk4_steps(ys, options, dt, steps);
+        for (std::size_t m = 0; m < ys.size(); ++m) {
+            assert(r.maximum_stage_speed[m] == expected_speed[m]);
+            for (std::size_t f = 0; f < ys[m].filaments.size(); ++f)
+                assert(ys[m].filaments[f].points == expected[m].filaments[f].points);
+        }
+        return r;
+    };
+    EnsembleOptions eo;
+    assert(eo.num_threads == 1);  // multithreading is opt-in
+    const EnsembleStepResult serial = run(eo);
+    assert(serial.batched_members == 5);
+    eo.num_threads = 3;
+    eo.lanes = 2;
+    const EnsembleStepResult threaded = run(eo);
+    assert(threaded.batched_members == 4);
+    assert(threaded.positions == serial.positions);
+    eo.lanes = 1;
+    assert(run(eo).batched_members == 0);
+
+    // Packed layout: member after member, filament after filament.
+    assert(serial.member_filaments.size() == members.size() + 1);
+    assert(serial.member_filaments[5] == 15 && serial.member_filaments[6] == 16);
+    assert(serial.filament_offsets.back() * 3 == serial.positions.size());
+    const std::size_t o = serial.filament_offsets[serial.member_filaments[5]];
+    for (int c = 0; c < 3; ++c) assert(serial.positions[3 * o + c] == expected[5].filaments[0].points[0][c]);
+
+    bool threw = false;
+    try {
+        std::vector<FilamentSystemState> ys = members;
+        FilamentEnsembleIntegrator().rk4_steps(ys, {options[0], options[1]}, dt);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+void test_imex_integrator() {
+    using sst::filament::FilamentImexIntegrator;
+    using sst::filament::ImexOptions;
+    using sst::filament::ImexScheme;
+
+    // Finely sampled, gently perturbed ring; the explicit LIA limit is a few 1e-3.
+    const auto make = [] {
+        FilamentSystemState s;
+        FilamentComponent f = ring(128, 1.0, 1.0, {0.0, 0.0, 0.0});
+        for (std::size_t i = 0; i < f.points.size(); ++i)
+            f.points[i][1] = 0.05 * std::sin(3.0 * 2.0 * M_PI * static_cast<double>(i) / 128.0);
+        s.filaments.push_back(f);
+        return s;
+    };
+    const auto error = [](const FilamentSystemState& a, const FilamentSystemState& b) {
+        double m = 0.0;
+        for (std::size_t i = 0; i < a.filaments[0].points.size(); ++i)
+            for (int c = 0; c < 3; ++c) m = std::max(m, std::abs(a.filaments[0].points[i][c] - b.filaments[0].points[i][c]));
+        return m;
+    };
+    sst::VelocityOptions opt;
+    const double T = 0.2;
+    FilamentSystemState ref = make();
+    sst::filament::FilamentRK4Stepper stepper(opt);
+    for (int k = 0; k < 400; ++k) stepper.step(ref, T / 400.0);
+    const double limit = sst::filament::FilamentIntegrator::estimate_filament_dt(make(), opt)[0];
+
+    const auto run = [&](const ImexOptions& imex, std::size_t steps) {
+        FilamentSystemState y = make();
+        FilamentImexIntegrator integrator(opt, imex);
+        for (std::size_t k = 0; k < steps; ++k) {
+            const auto r = integrator.step(y, T / static_cast<double>(steps));
+            assert(r.maximum_mutual_speed > 0.0 && r.maximum_stage_speed > r.maximum_mutual_speed);
+        }
+        return error(y, ref);
+    };
+    // A ±1e-4 zigzag seeds the fastest LIA mode: at several times the explicit limit RK4
+    // amplifies it until the ring is jagged at the segment scale, the IMEX schemes keep it smooth.
+    const double dt_big = T / 5.0;
+    assert(dt_big > 4.0 * limit);
+    const auto zigzag = [&] {
+        FilamentSystemState z = make();
+        for (std::size_t i = 0; i < z.filaments[0].points.size(); ++i) z.filaments[0].points[i][1] += (i % 2 ? 1e-4 : -1e-4);
+        return z;
+    };
+    const auto roughness = [](const FilamentSystemState& z) {  // max |second difference|
+        const auto& p = z.filaments[0].points;
+        const std::size_t n = p.size();
+        double m = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            double d2 = 0.0;
+            for (int c = 0; c < 3; ++c) {
+                const double d = p[(i + 1) % n][c] - 2.0 * p[i][c] + p[(i + n - 1) % n][c];
+                d2 += d * d;
+            }
+            m = std::isfinite(d2) ? std::max(m, std::sqrt(d2)) : std::numeric_limits<double>::infinity();
+        }
+        return m;
+    };
+    FilamentSystemState explicit_run = zigzag();
+    sst::filament::FilamentRK4Stepper coarse(opt);
+    for (int k = 0; k < 20; ++k) coarse.step(explicit_run, dt_big);
+    assert(roughness(explicit_run) > 0.05);
+    for (const ImexScheme scheme : {ImexScheme::Midpoint, ImexScheme::Euler}) {
+        ImexOptions imex;
+        imex.scheme = scheme;
+        FilamentSystemState z = zigzag();
+        FilamentImexIntegrator integrator(opt, imex);
+        for (int k = 0; k < 20; ++k) integrator.step(z, dt_big);
+        assert(roughness(z) < 5e-3);  // the smooth ring alone gives ~ds² = 2.4e-3
+    }
+
+    const double e5 = run({}, 5);
+    const double e10 = run({}, 10);
+    assert(e5 < 1e-4 && e5 / e10 > 3.5);  // second order
+    ImexOptions euler;
+    euler.scheme = ImexScheme::Euler;
+    euler.theta = 1.0;
+    const double b5 = run(euler, 5);
+    const double b10 = run(euler, 10);
+    assert(b5 < 5e-3 && b5 / b10 > 1.7 && b5 / b10 < 2.3);  // first order
+
+    // Without the local term the solver returns the mutual sum alone.
+    sst::VelocityOptions mutual = opt;
+    mutual.include_lia = false;
+    sst::VelocityOptions lia = opt;
+    lia.lia_only = true;
+    const auto full = sst::filament::FilamentVelocitySolver::evaluate(make(), opt);
+    const auto a = sst::filament::FilamentVelocitySolver::evaluate(make(), mutual);
+    const auto b = sst::filament::FilamentVelocitySolver::evaluate(make(), lia);
+    for (std::size_t i = 0; i < full.velocity[0].size(); ++i)
+        for (int c = 0; c < 3; ++c)
+            assert(std::abs(full.velocity[0][i][c] - a.velocity[0][i][c] - b.velocity[0][i][c]) < 1e-12);
+
+    bool threw = false;
+    try {
+        euler.theta = 0.3;
+        FilamentImexIntegrator bad(opt, euler);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+double distance2(const Vec3& a, const Vec3& b) {
+    const double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+void test_neighbour_list() {
+    using sst::geometry::VerletNeighbourList;
+    std::uint64_t seed = 12345;
+    const auto uniform = [&seed]() {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<double>(seed >> 11) * 0x1.0p-53;
+    };
+    std::vector<Vec3> sources(600), targets(300);
+    for (Vec3& p : sources) p = {4.0 * uniform(), 4.0 * uniform(), 4.0 * uniform()};
+    for (Vec3& p : targets) p = {5.0 * uniform() - 0.5, 5.0 * uniform() - 0.5, 5.0 * uniform() - 0.5};
+
+    const double cutoff = 0.5, skin = 0.2;
+    // Every pair within cutoff is listed, ascending; nothing beyond cutoff + skin at build time.
+    const auto check = [&](const VerletNeighbourList& list, const std::vector<Vec3>& t,
+                           const std::vector<Vec3>& s, bool at_build) {
+        for (std::size_t i = 0; i < t.size(); ++i) {
+            std::vector<std::size_t> listed(list.begin(i), list.end(i));
+            assert(std::is_sorted(listed.begin(), listed.end()));
+            for (std::size_t j = 0; j < s.size(); ++j) {
+                const double d2 = distance2(t[i], s[j]);
+                const bool in = std::binary_search(listed.begin(), listed.end(), j);
+                if (d2 <= cutoff * cutoff) assert(in);
+                if (at_build && in) assert(d2 <= (cutoff + skin) * (cutoff + skin));
+            }
+        }
+    };
+    VerletNeighbourList list(cutoff, skin);
+    assert(list.update(targets.data(), targets.size(), sources.data(), sources.size()));
+    check(list, targets, sources, true);
+    assert(list.stats().builds == 1 && list.stats().pairs > 0);
+
+    // Moves below skin / 2 keep the list; it still covers every pair within cutoff.
+    for (Vec3& p : sources) p[0] += 0.09;
+    for (Vec3& p : targets) p[1] -= 0.09;
+    assert(!list.update(targets.data(), targets.size(), sources.data(), sources.size()));
+    check(list, targets, sources, false);
+    assert(list.stats().builds == 1 && list.stats().updates == 2);
+    sources[7][2] += 0.05;  // |(0.09, 0, 0.05)| > skin / 2
+    assert(list.update(targets.data(), targets.size(), sources.data(), sources.size()));
+    check(list, targets, sources, true);
+
+    // Self mode: each point against all points, itself included.
+    VerletNeighbourList self(cutoff, 0.0);
+    self.update(sources.data(), sources.size(), sources.data(), sources.size());
+    check(self, sources, sources, true);
+    for (std::size_t i = 0; i < sources.size(); ++i) assert(std::binary_search(self.begin(i), self.end(i), i));
+    assert(!self.update(sources.data(), sources.size(), sources.data(), sources.size()));
+    sources.pop_back();
+    assert(self.update(sources.data(), sources.size(), sources.data(), sources.size()));
+
+    bool threw = false;
+    try {
+        list.set_radius(0.0, 0.1);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+void test_cutoff_backend() {
+    const FilamentSystemState state = tangle();
+    sst::VelocityOptions opt;
+    opt.a_sim = 0.05;
+    const auto direct = sst::filament::FilamentVelocitySolver::evaluate(state, opt);
+
+    // A cutoff beyond the system reproduces the direct sum bitwise (same source order).
+    sst::VelocityOptions cut = opt;
+    cut.mutual_backend = sst::MutualInductionBackend::Cutoff;
+    cut.mutual_cutoff = 100.0;
+    assert(max_abs_diff(sst::filament::FilamentVelocitySolver::evaluate(state, cut), direct) == 0.0);
+    // A shorter cutoff only moves the far segments to the direct sum's tail (small systems) or
+    // to the treecode: the field is not truncated.
+    cut.mutual_cutoff = 1.0;
+    const auto split = sst::filament::FilamentVelocitySolver::evaluate(state, cut);
+    assert(max_abs_diff(split, direct) > 0.0);
+    assert(max_abs_diff(split, direct) < 1e-12 * direct.maximum_speed);
+    for (const Vec3& v : split.velocity[3]) assert(v[0] == 0.0 && v[1] == 0.0 && v[2] == 0.0);
+    sst::VelocityOptions tree_opt = opt;
+    tree_opt.mutual_backend = sst::MutualInductionBackend::Treecode;
+    tree_opt.treecode_min_segments = 0;
+    const auto tree = sst::filament::FilamentVelocitySolver::evaluate(state, tree_opt);
+    cut.treecode_min_segments = 0;
+    for (double radius : {0.05, 0.3, 1.0}) {
+        cut.mutual_cutoff = radius;
+        const auto far = sst::filament::FilamentVelocitySolver::evaluate(state, cut);
+        assert(max_abs_diff(far, direct) <= max_abs_diff(tree, direct) + 1e-12 * direct.maximum_speed);
+    }
+    cut.treecode_min_segments = opt.treecode_min_segments;
+    cut.mutual_cutoff = 1.0;
+
+    // The skin only changes how often the list is rebuilt, never the trajectory.
+    const double dt = 5e-3;
+    std::vector<FilamentSystemState> runs;
+    std::vector<std::size_t> builds;
+    for (double skin : {0.0, 0.05, 0.3}) {
+        cut.neighbour_skin = skin;
+        sst::filament::FilamentRK4Stepper stepper(cut);
+        FilamentSystemState y = state;
+        for (int s = 0; s < 6; ++s) stepper.step(y, dt);
+        runs.push_back(y);
+        const auto& st = stepper.workspace().neighbours.stats();
+        assert(st.updates == 24 && st.pairs > 0 && st.max_neighbours > 0);
+        builds.push_back(st.builds);
+    }
+    for (std::size_t f = 0; f < state.filaments.size(); ++f) {
+        assert(runs[1].filaments[f].points == runs[0].filaments[f].points);
+        assert(runs[2].filaments[f].points == runs[0].filaments[f].points);
+    }
+    assert(builds[0] == 24 && builds[1] < builds[0] && builds[2] < builds[1]);
+}
+
+void test_near_field_clearance() {
+    using sst::geometry::VerletNeighbourList;
+    // A trefoil and two rings threading it, one of them passing through the trefoil's tube.
+    std::vector<std::vector<Vec3>> before = {trefoil(240, 1.0, {0.0, 0.0, 0.0}).points,
+                                             ring(80, 0.5, 1.0, {2.9, 0.0, 0.0}).points,
+                                             ring(60, 0.3, 1.0, {0.0, 0.0, 2.5}).points};
+    std::vector<std::vector<Vec3>> after = before;
+    for (Vec3& p : after[1]) p[0] -= 0.6;
+    for (Vec3& p : after[2]) p[2] -= 0.2;
+
+    const auto full = sst::geometry::multi_component_clearance(before, 0.02, 2);
+    for (double threshold : {0.05, 0.2, 2.0 * full.clearance, 10.0}) {
+        VerletNeighbourList list(threshold + 0.2, 0.0);
+        const auto near = sst::geometry::near_field_clearance(before, threshold, list, 0.02, 2);
+        if (full.clearance < threshold) {
+            assert(near.clearance == full.clearance);
+        } else {
+            assert(near.clearance >= threshold);
+        }
+        if (full.self_min < threshold) assert(near.self_min == full.self_min);
+        if (full.inter_min < threshold) assert(near.inter_min == full.inter_min);
+    }
+    bool threw = false;
+    try {
+        VerletNeighbourList small(0.05, 0.0);
+        sst::geometry::near_field_clearance(before, 0.05, small);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // The guard's contact test along the path agrees with the full clearance at every sample.
+    const double threshold = 0.05;  // below the trefoil's own clearance, crossed by the ring
+    VerletNeighbourList list(threshold + 0.2, 0.2);
+    for (int k = 0; k <= 64; ++k) {
+        const double f = k / 64.0;
+        std::vector<std::vector<Vec3>> mid = before;
+        for (std::size_t c = 0; c < mid.size(); ++c)
+            for (std::size_t i = 0; i < mid[c].size(); ++i)
+                for (int d = 0; d < 3; ++d) mid[c][i][d] += f * (after[c][i][d] - before[c][i][d]);
+        const double exact = sst::geometry::multi_component_clearance(mid, 0.02, 2).clearance;
+        const double near = sst::geometry::near_field_clearance(mid, threshold, list, 0.02, 2).clearance;
+        assert((exact < threshold) == (near < threshold));
+    }
+    assert(list.stats().builds < 65);
+
+    const auto guard = sst::topology::TopologyGuard::guard_step(before, after, threshold, 0.6, 0.02);
+    assert(guard.contact && guard.safe_dt_fraction > 0.0 && guard.safe_dt_fraction < 1.0);
+    assert(guard.swept_pairs > 0 && guard.hit_component_a >= 0 && guard.hit_segment_b >= 0);
+    std::vector<std::vector<Vec3>> safe = before;
+    for (std::size_t c = 0; c < safe.size(); ++c)
+        for (std::size_t i = 0; i < safe[c].size(); ++i)
+            for (int d = 0; d < 3; ++d) safe[c][i][d] += guard.safe_dt_fraction * (after[c][i][d] - before[c][i][d]);
+    assert(sst::geometry::multi_component_clearance(safe, 0.02, 2).clearance >= threshold);
+}
+
+void test_segment_bvh_clearance() {
+    // Perturbed trefoil and a ring through it; brute-force pair loops as the reference.
+    std::vector<Vec3> knot = trefoil(700, 1.0, {0.0, 0.0, 0.0}).points;
+    for (std::size_t i = 0; i < knot.size(); ++i) knot[i][2] += 0.05 * std::sin(37.0 * i);
+    const std::vector<Vec3> loop = ring(300, 0.6, 1.0, {2.9, 0.0, 0.0}).points;
+    const auto segment = [](const std::vector<Vec3>& c, std::size_t k) {
+        return std::make_pair(c[k], c[(k + 1) % c.size()]);
+    };
+    const auto brute_self = [&](const std::vector<Vec3>& c, int skip) {
+        const std::size_t n = c.size();
+        double m2 = std::numeric_limits<double>::infinity();
+        for (std::size_t i = 0; i < n; ++i)
+            for (std::size_t j = i + 1; j < n; ++j) {
+                if (static_cast<int>(std::min(j - i, n - (j - i))) < std::max(2, skip)) continue;
+                const auto a = segment(c, i), b = segment(c, j);
+                m2 = std::min(m2, sst::geometry::segment_segment_distance2(a.first, a.second, b.first, b.second));
+            }
+        return std::sqrt(m2);
+    };
+    for (int skip : {2, 7, 60}) assert(sst::geometry::self_clearance(knot, skip) == brute_self(knot, skip));
+
+    double inter2 = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i < knot.size(); ++i)
+        for (std::size_t j = 0; j < loop.size(); ++j) {
+            const auto a = segment(knot, i), b = segment(loop, j);
+            inter2 = std::min(inter2, sst::geometry::segment_segment_distance2(a.first, a.second, b.first, b.second));
+        }
+    assert(sst::geometry::inter_clearance(knot, loop) == std::sqrt(inter2));
+
+    const auto multi = sst::geometry::multi_component_clearance({knot, loop}, 0.0, 5);
+    assert(multi.self_min == std::min(brute_self(knot, 5), brute_self(loop, 5)));
+    assert(multi.inter_min == std::sqrt(inter2));
+
+    // The tree covers every segment once; leaves hold at most leaf_size of them.
+    const sst::geometry::SegmentBvh tree(knot, 4);
+    std::vector<std::size_t> seen = tree.order();
+    std::sort(seen.begin(), seen.end());
+    for (std::size_t k = 0; k < seen.size(); ++k) assert(seen[k] == k);
+    for (const auto& node : tree.nodes()) assert(!node.leaf() || node.end - node.begin <= 4);
+    assert(std::sqrt(tree.self_min_distance2(knot, 7)) == brute_self(knot, 7));
+
+    // Refitting after a small displacement keeps the tree and its answers; scrambling the
+    // points degrades the refit tree until the accelerator rebuilds it.
+    std::vector<Vec3> moved = knot;
+    for (std::size_t i = 0; i < moved.size(); ++i) moved[i][0] += 0.01 * std::cos(11.0 * i);
+    sst::geometry::SegmentBvhAccelerator accel;
+    const std::vector<std::vector<Vec3>> pair_before = {knot, loop};
+    const std::vector<std::vector<Vec3>> pair_after = {moved, loop};
+    for (const auto* curves : {&pair_before, &pair_after, &pair_before}) {
+        const auto fast = sst::geometry::multi_component_clearance(*curves, 0.0, 2, &accel);
+        const auto fresh = sst::geometry::multi_component_clearance(*curves, 0.0, 2);
+        assert(fast.self_min == fresh.self_min && fast.inter_min == fresh.inter_min);
+        assert(sst::geometry::self_clearance((*curves)[0], 3, &accel) == sst::geometry::self_clearance((*curves)[0], 3));
+    }
+    assert(accel.stats().builds == 2 && accel.stats().refits == 7);
+    sst::geometry::SegmentBvh refit(knot);
+    assert(refit.refit(moved) && refit.cost() < 1.5 * refit.build_cost());
+    assert(std::sqrt(refit.self_min_distance2(moved, 7)) == brute_self(moved, 7));
+    std::vector<Vec3> scrambled(knot.size());
+    for (std::size_t k = 0; k < knot.size(); ++k) scrambled[k] = knot[(37 * k) % knot.size()];
+    assert(refit.refit(scrambled) && refit.cost() > 1.5 * refit.build_cost());
+    assert(std::sqrt(refit.self_min_distance2(scrambled, 7)) == brute_self(scrambled, 7));
+    assert(!refit.refit(loop));
+    const std::size_t builds = accel.stats().builds;
+    (void)accel.tree(scrambled);
+    assert(accel.stats().builds == builds + 1);
+}
+
+void test_swept_contact() {
+    using sst::geometry::SweptSegment;
+    // A segment dropping onto a crossing one: crossing at f = 0.5, contact 0.1 away at f = 0.45.
+    const SweptSegment fixed{{-1.0, 0.0, 0.0}, {1.0, 0.0, 0.0}, {-1.0, 0.0, 0.0}, {1.0, 0.0, 0.0}};
+    const SweptSegment falling{{0.0, -1.0, 1.0}, {0.0, 1.0, 1.0}, {0.0, -1.0, -1.0}, {0.0, 1.0, -1.0}};
+    double times[3];
+    assert(sst::geometry::segment_crossing_times(fixed, falling, 1.0, times) == 1);
+    assert(std::abs(times[0] - 0.5) < 1e-12);
+    const double toi = sst::geometry::segment_time_of_impact(fixed, falling, 0.1, 1.0);
+    assert(toi <= 0.45 && toi > 0.45 - 1e-8);
+    assert(std::abs(sst::geometry::segment_time_of_impact(fixed, falling, 0.0, 1.0) - 0.5) < 1e-12);
+    assert(sst::geometry::segment_time_of_impact(fixed, falling, 0.1, 0.4) > 0.4);
+    // Passing beside the fixed segment: the lines cross but the segments do not.
+    const SweptSegment beside{{3.0, -1.0, 1.0}, {3.0, 1.0, 1.0}, {3.0, -1.0, -1.0}, {3.0, 1.0, -1.0}};
+    assert(sst::geometry::segment_crossing_times(fixed, beside, 1.0, times) == 0);
+    assert(sst::geometry::segment_time_of_impact(fixed, beside, 0.1, 1.0) > 1.0);
+    // Sliding fast along a long rail while closing in slowly: conservative advancement alone
+    // runs out of steps far from the contact, which must neither be reported early nor missed.
+    const SweptSegment rail{{-100.0, 0.0, 0.0}, {100.0, 0.0, 0.0}, {-100.0, 0.0, 0.0}, {100.0, 0.0, 0.0}};
+    const auto slider = [](double z0, double z1) {
+        return SweptSegment{{0.0, -1.0, z0}, {0.0, 1.0, z0}, {20.0, -1.0, z1}, {20.0, 1.0, z1}};
+    };
+    const double slow = sst::geometry::segment_time_of_impact(rail, slider(0.101, 0.099), 0.1, 1.0);
+    assert(slow <= 0.5 && slow > 0.5 - 1e-8);
+    assert(sst::geometry::segment_time_of_impact(rail, slider(0.103, 0.101), 0.1, 1.0) > 1.0);
+
+    // A small square jumps through an edge of a larger one in a single step; every one of
+    // eight evenly spaced samples along the path is clear of the threshold.
+    const double threshold = 0.1;
+    const std::vector<Vec3> big = {{-1.0, -1.0, 0.0}, {1.0, -1.0, 0.0}, {1.0, 1.0, 0.0}, {-1.0, 1.0, 0.0}};
+    const auto small = [](double z) {
+        return std::vector<Vec3>{{0.0, -1.2, z}, {0.0, -0.8, z}, {0.0, -0.8, z + 0.4}, {0.0, -1.2, z + 0.4}};
+    };
+    const std::vector<std::vector<Vec3>> before = {big, small(0.3)};
+    const std::vector<std::vector<Vec3>> after = {big, small(0.3 - 3.36)};
+    for (int k = 0; k <= 8; ++k) {
+        const auto mid = std::vector<std::vector<Vec3>>{big, small(0.3 - 3.36 * k / 8.0)};
+        assert(sst::geometry::multi_component_clearance(mid).clearance >= threshold);
+    }
+    const auto guard = sst::topology::TopologyGuard::guard_step(before, after, threshold, 3.36);
+    assert(guard.contact);
+    assert(guard.hit_component_a == 0 && guard.hit_segment_a == 0);
+    assert(guard.hit_component_b == 1 && guard.hit_segment_b == 0);
+    const double expected = (0.3 - threshold) / 3.36;
+    assert(guard.safe_dt_fraction <= expected + 1e-12 && guard.safe_dt_fraction > expected - 1e-8);
+    const auto at_hit = std::vector<std::vector<Vec3>>{big, small(0.3 - 3.36 * guard.safe_dt_fraction)};
+    assert(sst::geometry::multi_component_clearance(at_hit).clearance >= threshold * (1.0 - 1e-9));
+    // With a zero threshold the guard stops exactly where the edges cross.
+    const auto touch = sst::topology::TopologyGuard::guard_step(before, after, 0.0, 3.36);
+    assert(touch.contact && std::abs(touch.safe_dt_fraction - 0.3 / 3.36) < 1e-12);
+    const auto result = sst::geometry::first_swept_contact(before, after, threshold);
+    assert(result.hit && result.fraction == guard.safe_dt_fraction && result.candidates == guard.swept_pairs);
+}
+
+}  // namespace
+
+int main() {
+    test_treecode_mutual_induction();
+    test_straight_segment_kernel();
+    test_rk4_stepper();
+    test_adaptive_integrator();
+    test_multirate_integrator();
+    test_thread_invariance();
+    test_remesh();
+    test_filament_evolution_modes();
+    test_trajectory_io();
+    test_ensemble_stepping();
+    test_imex_integrator();
+    test_neighbour_list();
+    test_cutoff_backend();
+    test_near_field_clearance();
+    test_segment_bvh_clearance();
+    test_swept_contact();
+    return 0;
+}
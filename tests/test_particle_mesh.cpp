@@ -0,0 +1,173 @@
+#include "../src/biot_savart.h"
+#include "../src/fft.h"
+#include "sst/knot.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+std::vector<sst::Vec3> trefoil(std::size_t n, double scale) {
+    std::vector<sst::Vec3> pts;
+    pts.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double s = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(n);
+        pts.push_back({scale * (2.0 + std::cos(3.0 * s)) * std::cos(2.0 * s),
+                       scale * (2.0 + std::cos(3.0 * s)) * std::sin(2.0 * s),
+                       scale * std::sin(3.0 * s)});
+    }
+    return pts;
+}
+
+std::vector<sst::Vec3> grid_points(const sst::RegularGrid3D& g) {
+    std::vector<sst::Vec3> pts;
+    for (int i = 0; i < g.shape[0]; ++i)
+        for (int j = 0; j < g.shape[1]; ++j)
+            for (int k = 0; k < g.shape[2]; ++k)
+                pts.push_back({g.origin[0] + g.spacing * i, g.origin[1] + g.spacing * j, g.origin[2] + g.spacing * k});
+    return pts;
+}
+
+// Relative L2 error of a against b.
+double rel_l2(const std::vector<sst::Vec3>& a, const std::vector<sst::Vec3>& b) {
+    assert(a.size() == b.size());
+    double num = 0.0, den = 0.0;
+    for (std::size_t i = 0; i < a.size(); ++i)
+        for (int c = 0; c < 3; ++c) {
+            num += (a[i][c] - b[i][c]) * (a[i][c] - b[i][c]);
+            den += b[i][c] * b[i][c];
+        }
+    return std::sqrt(num / den);
+}
+
+void check_fft() {
+    for (std::size_t n : {1u, 2u, 3u, 12u, 45u, 49u, 64u, 98u}) {
+        std::vector<sst::Complex> x(n), X(n);
+        for (std::size_t j = 0; j < n; ++j) x[j] = sst::Complex(std::sin(1.3 * j + 0.2), std::cos(0.7 * j * j));
+        for (std::size_t k = 0; k < n; ++k)
+            for (std::size_t j = 0; j < n; ++j)
+                X[k] += x[j] * std::polar(1.0, -2.0 * M_PI * static_cast<double>((j * k) % n) / static_cast<double>(n));
+        const sst::FFTPlan plan(n);
+        std::vector<sst::Complex> y = x;
+        plan.forward(y.data());
+        for (std::size_t k = 0; k < n; ++k) assert(std::abs(y[k] - X[k]) < 1e-10 * static_cast<double>(n));
+        plan.inverse(y.data());
+        for (std::size_t k = 0; k < n; ++k) assert(std::abs(y[k] / static_cast<double>(n) - x[k]) < 1e-12);
+    }
+    assert(sst::fft_good_size(1) == 1);
+    assert(sst::fft_good_size(7) == 8);
+    assert(sst::fft_good_size(11) == 12);
+    assert(sst::fft_good_size(61) == 64);
+    assert(sst::fft_good_size(73) == 75);
+
+    // 3-D transform against separable 1-D transforms of a product field.
+    const std::array<std::size_t, 3> shape{{6, 5, 4}};
+    std::vector<sst::Complex> f(6 * 5 * 4);
+    std::vector<sst::Complex> a(6), b(5), c(4);
+    for (std::size_t i = 0; i < 6; ++i) a[i] = sst::Complex(0.3 * i, 1.0 - i);
+    for (std::size_t j = 0; j < 5; ++j) b[j] = sst::Complex(std::cos(j), 0.5);
+    for (std::size_t k = 0; k < 4; ++k) c[k] = sst::Complex(1.0 + k * k, -0.25 * k);
+    for (std::size_t i = 0; i < 6; ++i)
+        for (std::size_t j = 0; j < 5; ++j)
+            for (std::size_t k = 0; k < 4; ++k) f[(i * 5 + j) * 4 + k] = a[i] * b[j] * c[k];
+    sst::FFTPlan(6).forward(a.data());
+    sst::FFTPlan(5).forward(b.data());
+    sst::FFTPlan(4).forward(c.data());
+    sst::fft3d(f, shape, false, 3);
+    for (std::size_t i = 0; i < 6; ++i)
+        for (std::size_t j = 0; j < 5; ++j)
+            for (std::size_t k = 0; k < 4; ++k) assert(std::abs(f[(i * 5 + j) * 4 + k] - a[i] * b[j] * c[k]) < 1e-10);
+}
+
+}  // namespace
+
+int main() {
+    check_fft();
+
+    const double gamma = 1.3;
+    const auto curve = trefoil(600, 0.5);
+    sst::RegularGrid3D grid;
+    grid.spacing = 0.1;
+    grid.shape = {{24, 24, 18}};
+    grid.origin = {{-1.15, -1.15, -0.85}};
+    const auto pts = grid_points(grid);
+    const auto direct = sst::BiotSavart::computeVelocity(curve, pts, gamma);
+
+    // P3M against the direct midpoint sum.
+    const auto pm = sst::BiotSavart::computeVelocityParticleMesh(curve, grid, gamma);
+    assert(pm.velocity.size() == pts.size());
+    assert(pm.near_interactions > 0);
+    assert(rel_l2(pm.velocity, direct) < 1e-3);
+
+    // Mesh part alone is the Gaussian-smoothed field (no near-field sum).
+    sst::ParticleMeshOptions smooth;
+    smooth.p3m = false;
+    const auto pm_smooth = sst::BiotSavart::computeVelocityParticleMesh(curve, grid, gamma, smooth);
+    assert(pm_smooth.near_interactions == 0);
+    assert(rel_l2(pm_smooth.velocity, direct) > 10.0 * rel_l2(pm.velocity, direct));
+
+    // Wider split (more mesh-resolved) stays accurate.
+    sst::ParticleMeshOptions wide;
+    wide.sigma = 2.0 * grid.spacing;
+    assert(rel_l2(sst::BiotSavart::computeVelocityParticleMesh(curve, grid, gamma, wide).velocity, direct) < 1e-3);
+
+    // Thread count does not change the result.
+    sst::ParticleMeshOptions one, four;
+    assert(one.num_threads == 1);  // multithreading is opt-in
+    four.num_threads = 4;
+    const auto r1 = sst::BiotSavart::computeVelocityParticleMesh(curve, grid, gamma, one);
+    const auto r4 = sst::BiotSavart::computeVelocityParticleMesh(curve, grid, gamma, four);
+    for (std::size_t i = 0; i < r1.velocity.size(); ++i) assert(r1.velocity[i] == r4.velocity[i]);
+
+    // Periodic mode: a small ring in a large box is close to the free-space field (images and
+    // the zero-mean constraint are the only differences) and invariant under a period shift.
+    {
+        std::vector<sst::Vec3> ring;
+        for (int i = 0; i < 400; ++i) {
+            const double s = 2.0 * M_PI * i / 400.0;
+            ring.push_back({0.4 * std::cos(s), 0.4 * std::sin(s), 0.0});
+        }
+        sst::RegularGrid3D box;
+        box.spacing = 0.1;
+        box.shape = {{48, 48, 48}};
+        box.origin = {{-2.4, -2.4, -2.4}};
+        sst::ParticleMeshOptions periodic;
+        periodic.periodic = true;
+        const auto per = sst::BiotSavart::computeVelocityParticleMesh(ring, box, gamma, periodic);
+        const auto free_space = sst::BiotSavart::computeVelocityParticleMesh(ring, box, gamma);
+        const auto ref = sst::BiotSavart::computeVelocity(ring, grid_points(box), gamma);
+        assert(rel_l2(free_space.velocity, ref) < 1e-3);
+        assert(rel_l2(per.velocity, ref) < 0.05);
+        assert(per.mesh_shape[0] == 48);
+
+        std::vector<sst::Vec3> shifted = ring;
+        for (auto& p : shifted) p[0] += 4.8;
+        const auto per_shifted = sst::BiotSavart::computeVelocityParticleMesh(shifted, box, gamma, periodic);
+        assert(rel_l2(per_shifted.velocity, per.velocity) < 1e-10);
+    }
+
+    // Helicity invariants through the particle-mesh switch track the direct-sum values.
+    {
+        sst::FourierBlock b;
+        b.a_x = {0, 0, 0}; b.b_x = {1, 2, 0};
+        b.a_y = {1, -2, 0}; b.b_y = {0, 0, 0};
+        b.a_z = {0, 0, 0}; b.b_z = {0, 0, -1};
+        const auto hd = sst::KnotDynamics::compute_helicity_from_fourier_block(b, 24, 0.3, 4, 400);
+        const auto hp = sst::KnotDynamics::compute_helicity_from_fourier_block(b, 24, 0.3, 4, 400, true);
+        assert(std::abs(std::get<0>(hp) - std::get<0>(hd)) < 1e-3 * std::abs(std::get<0>(hd)));
+        assert(std::abs(std::get<1>(hp) - std::get<1>(hd)) < 1e-3 * std::abs(std::get<1>(hd)));
+    }
+
+    bool threw = false;
+    try {
+        sst::RegularGrid3D bad = grid;
+        bad.spacing = 0.0;
+        sst::BiotSavart::computeVelocityParticleMesh(curve, bad, gamma);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    return 0;
+}
@@ -1,10 +1,14 @@
 #include "../src/resolved_tube_geometry.h"
+#include "../src/geometry/continuous_reach.h"
+#include "../src/geometry/segment_bvh.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -139,6 +143,116 @@ int main() {
         assert(!tightened.steps.front().solver_algorithm.empty());
     }
 
+    // Grid-searched dcsd candidates of a large curve match the brute-force list exactly.
+    const auto brute_candidates = [](const std::vector<Vec3>& pts, int skip, double tol) {
+        const std::size_t n = pts.size();
+        std::vector<double> cum(n, 0.0);
+        const auto seg_len = [&](std::size_t k) {
+            const Vec3& a = pts[k];
+            const Vec3& b = pts[(k + 1) % n];
+            return std::sqrt((b[0] - a[0]) * (b[0] - a[0]) + (b[1] - a[1]) * (b[1] - a[1]) + (b[2] - a[2]) * (b[2] - a[2]));
+        };
+        for (std::size_t k = 1; k < n; ++k) cum[k] = cum[k - 1] + seg_len(k - 1);
+        std::vector<sst::SegmentPair> all;
+        double best = 1e300;
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = i + 1; j < n; ++j) {
+                const std::size_t gap = j - i;
+                if (static_cast<int>(std::min(gap, n - gap)) <= skip) continue;
+                sst::SegmentPair pair;
+                pair.i = i;
+                pair.j = j;
+                pair.distance = sst::ResolvedTubeGeometry::segment_segment_distance(
+                    pts[i], pts[(i + 1) % n], pts[j], pts[(j + 1) % n], &pair.s, &pair.t);
+                pair.arclength_i = cum[i] + pair.s * seg_len(i);
+                pair.arclength_j = cum[j] + pair.t * seg_len(j);
+                best = std::min(best, pair.distance);
+                all.push_back(pair);
+            }
+        }
+        std::vector<sst::SegmentPair> kept;
+        for (const auto& pair : all) {
+            if (tol <= 0.0 ? pair.distance <= best + 1e-12 : pair.distance <= best * (1.0 + tol) + tol) kept.push_back(pair);
+        }
+        return kept;
+    };
+    std::vector<Vec3> trefoil, circle;
+    for (int k = 0; k < 400; ++k) {
+        const double t = 2.0 * 3.14159265358979323846 * static_cast<double>(k) / 400.0;
+        trefoil.push_back({std::sin(t) + 2.0 * std::sin(2.0 * t), std::cos(t) - 2.0 * std::cos(2.0 * t), -std::sin(3.0 * t)});
+        circle.push_back({std::cos(t), std::sin(t), 0.0});
+    }
+    // The same through a segment BVH accelerator, refit as the curve is displaced.
+    sst::geometry::SegmentBvhAccelerator accel;
+    std::vector<Vec3> wobbled = trefoil;
+    for (std::size_t k = 0; k < wobbled.size(); ++k) wobbled[k][2] += 0.02 * std::sin(13.0 * k);
+    for (const auto* curve : {&trefoil, &circle, &wobbled, &trefoil}) {
+        for (const double tol : {0.0, 1e-3, 5e-2}) {
+            for (auto* a : {static_cast<sst::geometry::SegmentBvhAccelerator*>(nullptr), &accel}) {
+                const auto fast = sst::ResolvedTubeGeometry::dcsd_candidates(*curve, 2, tol, a);
+                const auto slow = brute_candidates(*curve, 2, tol);
+                assert(!fast.empty());
+                assert(fast.size() == slow.size());
+                for (std::size_t k = 0; k < fast.size(); ++k) {
+                    assert(fast[k].i == slow[k].i && fast[k].j == slow[k].j);
+                    assert(fast[k].s == slow[k].s && fast[k].t == slow[k].t);
+                    assert(fast[k].distance == slow[k].distance);
+                    assert(fast[k].arclength_i == slow[k].arclength_i && fast[k].arclength_j == slow[k].arclength_j);
+                }
+            }
+        }
+    }
+    assert(accel.stats().builds >= 1 && accel.stats().refits > accel.stats().builds);
+    const auto plain = sst::ResolvedTubeGeometry::analyze(wobbled, 2, 1e-2, 1.0);
+    const auto accelerated = sst::ResolvedTubeGeometry::analyze(wobbled, 2, 1e-2, 1.0, &accel);
+    assert(plain.thickness_rad == accelerated.thickness_rad && plain.struts.size() == accelerated.struts.size());
+
+    // The tightener's line-search analyses share one tree, refit between trials.
+    std::vector<Vec3> knot;
+    for (int k = 0; k < 96; ++k) knot.push_back(trefoil[static_cast<std::size_t>(k) * 400 / 96]);
+    sst::TighteningOptions knot_opts = opts;
+    knot_opts.max_steps = 2;
+    const auto knot_tight = sst::ResolvedTubeTightener::tighten(knot, knot_opts);
+    assert(knot_tight.bvh_builds >= 1 && knot_tight.bvh_refits >= 1);
+
+    // Continuous reach of a chain of alternating rings 1.5 apart: pruning component pairs by
+    // their spline boxes keeps the unpruned minimum (every pair computed on its own), and
+    // the result is the same on one thread, the default, and several.
+    std::vector<std::vector<Vec3>> chain;
+    for (int c = 0; c < 6; ++c) {
+        std::vector<Vec3> ring;
+        for (int k = 0; k < 96; ++k) {
+            const double t = 2.0 * 3.14159265358979323846 * k / 96.0;
+            if (c % 2 == 0) {
+                ring.push_back({1.5 * c + std::cos(t), std::sin(t), 0.05 * std::sin(3.0 * t)});
+            } else {
+                ring.push_back({1.5 * c + std::cos(t), 0.05 * std::sin(2.0 * t), std::sin(t)});
+            }
+        }
+        chain.push_back(ring);
+    }
+    const auto reach = sst::geometry::ContinuousReachSolver::compute(chain);
+    double inter = std::numeric_limits<double>::infinity();
+    double self = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i < chain.size(); ++i) {
+        self = std::min(self, sst::geometry::ContinuousReachSolver::compute({chain[i]}).self_dcsd);
+        for (std::size_t j = i + 1; j < chain.size(); ++j) {
+            const auto pair = sst::geometry::ContinuousReachSolver::compute({chain[i], chain[j]});
+            if (pair.inter_component_distance < inter) inter = pair.inter_component_distance;
+        }
+    }
+    assert(reach.inter_component_distance == inter && reach.self_dcsd == self);
+    assert(std::abs(inter - 0.5) < 5e-3 && reach.component_count == 6);
+    assert(reach.inter_witness.component_b == reach.inter_witness.component_a + 1);
+    for (std::size_t threads : {1, 4}) {
+        const auto threaded = sst::geometry::ContinuousReachSolver::compute(chain, threads);
+        assert(threaded.reach == reach.reach && threaded.limiter == reach.limiter);
+        assert(threaded.inter_component_distance == reach.inter_component_distance);
+        assert(threaded.self_dcsd == reach.self_dcsd && threaded.orth_residual == reach.orth_residual);
+        assert(threaded.inter_witness.component_a == reach.inter_witness.component_a);
+        assert(threaded.inter_witness.s == reach.inter_witness.s && threaded.inter_witness.t == reach.inter_witness.t);
+    }
+
     const double lower = sst::ResolvedTubeGeometry::nontrivial_knot_lower_bound_rad();
     assert(std::abs(lower - (4.0 * 3.14159265358979323846 + 2.0 * 3.14159265358979323846 * std::sqrt(2.0))) < 1e-12);
     return 0;
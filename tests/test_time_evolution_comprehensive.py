@@ -107,12 +107,41 @@ def test_time_evolution():
     )
 
 
+def test_time_evolution_lia_rk4_ring():
+    """LIA + RK4 fast path: a circular ring translates along its axis without deforming."""
+    te_cls = sstcore.TimeEvolution
+    if not hasattr(te_cls, "set_evolution_options"):
+        pytest.skip("set_evolution_options not built")
+    n = 64
+    s = 2.0 * np.pi * np.arange(n) / n
+    positions = np.stack([np.cos(s), np.sin(s), np.zeros(n)], axis=1)
+    tangents = 0.5 * (np.roll(positions, -1, axis=0) - np.roll(positions, 1, axis=0))
+    te = te_cls(positions.tolist(), tangents.tolist(), 1.0)
+    te.set_evolution_options(model="lia", scheme="rk4", core_radius=0.01)
+    te.evolve(0.01, 10)
+    pos = np.asarray(te.get_positions())
+
+    log_test(
+        "TimeEvolution.set_evolution_options",
+        r"$\mathbf{v} = \frac{\Gamma}{4\pi}\,\Lambda\,\kappa\,\mathbf{b}$",
+        {"model": "lia", "scheme": "rk4", "dt": 0.01, "steps": 10},
+        {"z_mean": float(pos[:, 2].mean())},
+        "Local induction with RK4 stages",
+    )
+    assert pos[:, 2].mean() > 0.0
+    assert np.allclose(np.hypot(pos[:, 0], pos[:, 1]), 1.0, atol=1e-9)
+    assert np.allclose(pos[:, 2], pos[0, 2], atol=1e-12)
+    with pytest.raises(ValueError):
+        te.set_evolution_options(model="unknown")
+
+
 if __name__ == "__main__":
     print("\n" + "="*80)
     print("TIME EVOLUTION COMPREHENSIVE TEST SUITE")
     print("="*80)
     
     test_time_evolution()
+    test_time_evolution_lia_rk4_ring()
     
     print("\n" + "="*80)
     print("ALL TESTS COMPLETED")
@@ -51,6 +51,24 @@ def test_continuous_reach_two_circles():
     assert r["orth_residual"] < 1e-6
 
 
+def test_continuous_reach_ring_chain_matches_across_threads():
+    # Alternating rings 1.5 apart: neighbours come within 0.5, rings two apart are pruned by box.
+    chain = []
+    for c in range(10):
+        t = 2 * math.pi * np.arange(96) / 96
+        if c % 2 == 0:
+            ring = np.column_stack([1.5 * c + np.cos(t), np.sin(t), 0.05 * np.sin(3 * t)])
+        else:
+            ring = np.column_stack([1.5 * c + np.cos(t), 0.05 * np.sin(2 * t), np.sin(t)])
+        chain.append(ring)
+    r1 = sst.compute_continuous_reach(chain, num_threads=1)
+    r4 = sst.compute_continuous_reach(chain, num_threads=4)
+    assert r1 == r4
+    assert abs(r1["inter_component_distance"] - 0.5) < 5e-3
+    assert r1["component_count"] == 10
+    assert r1["orth_residual"] < 1e-6
+
+
 def test_topology_clearance_positive():
     r = sst.compute_topology_clearance([_circle(48)])
     assert r["clearance"] > 0.1
@@ -69,6 +87,162 @@ def test_filament_velocity_and_rk4_smoke():
     assert dt > 0.0
 
 
+def test_filament_velocity_treecode_backend_matches_direct():
+    a = _circle(200, 1.0, 0.0)
+    b = _circle(150, 0.7, 0.4)
+    fils = [
+        {"id": "a", "points": a, "circulation": 1.0},
+        {"id": "b", "points": b, "circulation": -0.6},
+    ]
+    opts = {"core_radius": 0.05, "a_sim": 0.05}
+    direct = sst.compute_filament_velocity(fils, opts)
+    tree = sst.compute_filament_velocity(
+        fils, {**opts, "mutual_backend": "treecode", "treecode_theta": 0.3, "treecode_min_segments": 0}
+    )
+    scale = direct["maximum_speed"]
+    for vd, vt in zip(direct["velocity"], tree["velocity"]):
+        assert np.max(np.abs(np.asarray(vd) - np.asarray(vt))) < 5e-3 * scale
+
+
+def test_integrate_adaptive_matches_fine_rk4():
+    if not hasattr(sst, "integrate_adaptive"):
+        pytest.skip("integrate_adaptive not built")
+    fils = [{"id": "0", "points": _circle(48), "circulation": 1.0}]
+    opts = {"a_sim": 0.02}
+    ref = sst.rk4_step(fils, 0.5 / 400, opts, steps=400)
+    for scheme in ("dopri5", "bs32"):
+        r = sst.integrate_adaptive(fils, 0.5, opts, {"scheme": scheme, "rtol": 1e-8, "atol": 1e-10})
+        assert r["completed"] and r["time"] == 0.5
+        assert r["accepted_steps"] < 40
+        err = np.max(np.abs(np.asarray(r["filaments"][0]["points"]) - np.asarray(ref["filaments"][0]["points"])))
+        assert err < 1e-6
+
+
+def test_multirate_step_single_level_matches_rk4():
+    if not hasattr(sst, "multirate_step"):
+        pytest.skip("multirate_step not built")
+    fils = [
+        {"id": "big", "points": _circle(100, 1.5, 0.0), "circulation": 1.0},
+        {"id": "small", "points": 0.05 * _circle(16) + np.array([0.0, 0.5, 0.3]), "circulation": 0.5},
+    ]
+    opts = {"a_sim": 0.01}
+    local = sst.estimate_filament_dt(fils, opts)
+    assert local[0] > 4 * local[1]
+    r = sst.multirate_step(fils, local[0], opts)
+    assert r["substeps"][0] < r["substeps"][1]
+    one = sst.multirate_step(fils, 1e-3, opts, {"max_level": 0})
+    ref = sst.rk4_step(fils, 1e-3, opts)
+    for a, b in zip(one["filaments"], ref["filaments"]):
+        assert np.array_equal(np.asarray(a["points"]), np.asarray(b["points"]))
+
+
+def test_remesh_filaments_follows_curvature():
+    if not hasattr(sst, "remesh_filaments"):
+        pytest.skip("remesh_filaments not built")
+    coarse = 0.1 * _circle(8)
+    fine = 2.0 * _circle(2000)
+    r = sst.remesh_filaments([{"points": coarse}, {"points": fine}], {"max_turning_angle": 0.25})
+    pts = [np.asarray(f["points"]) for f in r["filaments"]]
+    assert len(pts[0]) > 8 and len(pts[1]) < 2000
+    assert r["inserted"] > 0 and r["removed"] > 0
+    assert np.allclose(np.linalg.norm(pts[0][:, :2], axis=1), 0.1, atol=1e-3)
+    stepped = sst.rk4_step([{"points": fine}], 1e-3, {}, 2, {"max_turning_angle": 0.25})
+    assert stepped["removed"] > 0
+    assert len(stepped["filaments"][0]["points"]) < 2000
+
+
+def test_ensemble_rk4_step_matches_single_member_steps():
+    if not hasattr(sst, "ensemble_rk4_step"):
+        pytest.skip("ensemble_rk4_step not built")
+    members = [[{"points": _circle(40, 1.0 + 0.1 * k), "circulation": 1.0 + 0.2 * k}] for k in range(5)]
+    members.append([{"points": _circle(24)}, {"points": _circle(24, 0.5, 0.3)}])
+    options = [{"a_sim": 0.01 * k} for k in range(6)]
+    r = sst.ensemble_rk4_step(members, 1e-3, options, 2, {"num_threads": 2})
+    assert r["batched_members"] == 5
+    assert r["positions"].shape == (r["filament_offsets"][-1], 3)
+    assert r["member_filaments"] == [0, 1, 2, 3, 4, 5, 7]
+    for m, member in enumerate(members):
+        single = sst.rk4_step(member, 1e-3, options[m], 2)
+        assert r["maximum_stage_speed"][m] == single["maximum_stage_speed"]
+        for f, fil in enumerate(single["filaments"]):
+            g = r["member_filaments"][m] + f
+            rows = r["positions"][r["filament_offsets"][g]:r["filament_offsets"][g + 1]]
+            assert np.array_equal(rows, np.asarray(fil["points"]))
+
+
+def test_imex_step_is_stable_beyond_explicit_lia_limit():
+    if not hasattr(sst, "imex_step"):
+        pytest.skip("imex_step not built")
+    pts = _circle(128)
+    pts[::2, 2] += 1e-4  # zigzag seeds the stiffest LIA mode
+    fils = [{"points": pts, "circulation": 1.0}]
+    limit = sst.estimate_filament_dt(fils)[0]
+    dt = 6.0 * limit
+    r = sst.imex_step(fils, dt, {}, {"scheme": "midpoint"}, 20)
+    out = np.asarray(r["filaments"][0]["points"])
+    second = np.roll(out, -1, axis=0) - 2.0 * out + np.roll(out, 1, axis=0)
+    assert np.max(np.linalg.norm(second, axis=1)) < 5e-3
+    assert 0.0 < r["maximum_mutual_speed"] < r["maximum_stage_speed"]
+    with pytest.raises(ValueError):
+        sst.imex_step(fils, dt, {}, {"scheme": "euler", "theta": 0.2})
+
+
+def test_cutoff_backend_is_independent_of_neighbour_skin():
+    fils = [{"points": _circle(96), "circulation": 1.0}, {"points": _circle(64, 0.8, 0.4), "circulation": -0.5}]
+    base = {"mutual_backend": "cutoff", "mutual_cutoff": 0.6}
+    runs = [sst.rk4_step(fils, 2e-3, dict(base, neighbour_skin=skin), 5) for skin in (0.0, 0.2)]
+    for a, b in zip(runs[0]["filaments"], runs[1]["filaments"]):
+        assert np.array_equal(np.asarray(a["points"]), np.asarray(b["points"]))
+    assert runs[0]["neighbour_builds"] == 20
+    assert 1 <= runs[1]["neighbour_builds"] < 20 and runs[1]["neighbour_pairs"] > 0
+    wide = sst.rk4_step(fils, 2e-3, dict(base, mutual_cutoff=100.0), 1)
+    direct = sst.rk4_step(fils, 2e-3, {}, 1)
+    assert np.array_equal(np.asarray(wide["filaments"][0]["points"]), np.asarray(direct["filaments"][0]["points"]))
+
+
+def test_guard_topology_step_catches_crossing_between_samples():
+    big = np.array([[-1.0, -1.0, 0.0], [1.0, -1.0, 0.0], [1.0, 1.0, 0.0], [-1.0, 1.0, 0.0]])
+
+    def small(z):
+        return np.array([[0.0, -1.2, z], [0.0, -0.8, z], [0.0, -0.8, z + 0.4], [0.0, -1.2, z + 0.4]])
+
+    r = sst.guard_topology_step([big, small(0.3)], [big, small(0.3 - 3.36)], 0.1, 3.36)
+    assert r["contact"] and r["hit_pair"] == (0, 0, 1, 0)
+    assert abs(r["safe_dt_fraction"] - 0.2 / 3.36) < 1e-8 and r["swept_pairs"] > 0
+
+
+def test_filament_trajectory_and_checkpoint_roundtrip(tmp_path):
+    if not hasattr(sst, "FilamentTrajectoryWriter"):
+        pytest.skip("trajectory I/O not built")
+    path = str(tmp_path / "run.ssttraj")
+    fils = [{"id": "ring", "points": _circle(32), "circulation": 1.0}]
+    frames = []
+    with sst.FilamentTrajectoryWriter(path, ["speed"]) as w:
+        for step in range(3):
+            r = sst.rk4_step(fils, 1e-3)
+            fils = r["filaments"]
+            frames.append(np.asarray(fils[0]["points"]))
+            w.append(fils, 1e-3 * (step + 1), step + 1, diagnostics=[r["maximum_stage_speed"]])
+    reader = sst.FilamentTrajectoryReader(path)
+    assert len(reader) == 3
+    frame = reader.frame(1)
+    assert frame["step"] == 2 and "speed" in frame["diagnostics"]
+    assert np.array_equal(np.asarray(frame["filaments"][0]["points"]), frames[1])
+    pts, offsets = reader.positions(2)
+    assert list(offsets) == [0, 32] and np.array_equal(pts, frames[2])
+
+    with sst.FilamentTrajectoryWriter(path, ["speed"], append=True) as w:
+        assert w.frame_count == 3
+        w.append(fils, 4e-3, 4, diagnostics=[0.0])
+    assert reader.refresh() == 4
+
+    ckpt = str(tmp_path / "state.ckpt")
+    sst.save_filament_checkpoint(ckpt, fils, 4e-3, 4, {"next_dt": 1e-3})
+    c = sst.load_filament_checkpoint(ckpt)
+    assert c["step"] == 4 and c["values"]["next_dt"] == 1e-3
+    assert np.array_equal(np.asarray(c["filaments"][0]["points"]), frames[2])
+
+
 def test_intrinsic_frame_and_rigid_motion():
     pts = _circle(40)
     frame = sst.compute_intrinsic_frame(pts)